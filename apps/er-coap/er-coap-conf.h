@@ -71,4 +71,11 @@
 /* Interval in notifies in which NON notifies are changed to CON notifies to check client. */
 #define COAP_OBSERVE_REFRESH_INTERVAL  20
 
+/* Render a notification once for all observers of a resource and patch the
+   MID, Token, and Observe option of each copy, instead of calling the GET
+   handler and serializing the message again for every observer. */
+#ifndef COAP_OBSERVE_RENDER_ONCE
+#define COAP_OBSERVE_RENDER_ONCE       0
+#endif /* COAP_OBSERVE_RENDER_ONCE */
+
 #endif /* ER_COAP_CONF_H_ */
@@ -89,6 +89,12 @@ add_observer(uip_ipaddr_t *addr, uint16_t port, const uint8_t *token,
   return o;
 }
 /*---------------------------------------------------------------------------*/
+list_t
+coap_get_observers(void)
+{
+  return observers_list;
+}
+/*---------------------------------------------------------------------------*/
 /*- Removal -----------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 void
@@ -177,6 +183,116 @@ coap_remove_observer_by_mid(uip_ipaddr_t *addr, uint16_t port, uint16_t mid)
   }
   return removed;
 }
+#if COAP_OBSERVE_RENDER_ONCE
+/*---------------------------------------------------------------------------*/
+/*- Notification template ---------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
+static size_t
+option_field(const uint8_t *packet, size_t *i, unsigned int nibble)
+{
+  size_t value = nibble;
+
+  if(nibble == 13) {
+    value = 13 + packet[(*i)++];
+  } else if(nibble == 14) {
+    value = 269 + (packet[*i] << 8) + packet[*i + 1];
+    *i += 2;
+  }
+  return value;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Returns the offset of the Observe option in a serialized message or, if
+ * it has none, of the option that would follow it.
+ */
+static size_t
+observe_option_offset(const uint8_t *packet, size_t len)
+{
+  size_t i = COAP_HEADER_LEN
+    + (packet[0] & COAP_HEADER_TOKEN_LEN_MASK);
+  unsigned int number = 0;
+
+  while(i < len && packet[i] != 0xFF) {
+    size_t start = i++;
+    size_t length;
+
+    number += option_field(packet, &i, packet[start] >> 4);
+    if(number >= COAP_OPTION_OBSERVE) {
+      return start;
+    }
+    length = option_field(packet, &i, packet[start] & 0x0F);
+    i += length;
+  }
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Builds the notification for an observer from the one serialized for the
+ * first observer, which only differs in the type, MID, Token, and the value
+ * of the Observe option. Options before the Observe option have numbers
+ * below 6, so the Observe option header is always a single byte, and the
+ * encoding of the options after it does not depend on its value.
+ */
+static size_t
+copy_notification(uint8_t *packet, const uint8_t *template, size_t len,
+                  coap_message_type_t type, uint16_t mid,
+                  const coap_observer_t *obs)
+{
+  size_t token_end = COAP_HEADER_LEN
+    + (template[0] & COAP_HEADER_TOKEN_LEN_MASK);
+  size_t observe_start;
+  size_t observe_end;
+  uint32_t observe = obs->obs_counter;
+  size_t observe_len = 0;
+  size_t copy_len;
+  size_t i;
+
+  if(len == 0) {
+    /* serializing the template failed */
+    return 0;
+  }
+
+  observe_start = observe_option_offset(template, len);
+  observe_end = observe_start;
+  if(template[1] < BAD_REQUEST_4_00) {
+    observe_end += 1 + (template[observe_start] & 0x0F);
+    observe_len = (observe > 0xFFFF) + (observe > 0xFF) + (observe > 0);
+  }
+  copy_len = len - token_end + COAP_HEADER_LEN + obs->token_len
+    - (observe_end - observe_start);
+  if(observe_end > observe_start) {
+    copy_len += 1 + observe_len;
+  }
+  if(copy_len > COAP_MAX_PACKET_SIZE) {
+    return 0;
+  }
+
+  packet[0] = (template[0]
+               & ~(COAP_HEADER_TYPE_MASK | COAP_HEADER_TOKEN_LEN_MASK))
+    | (COAP_HEADER_TYPE_MASK & type << COAP_HEADER_TYPE_POSITION)
+    | (COAP_HEADER_TOKEN_LEN_MASK
+       & obs->token_len << COAP_HEADER_TOKEN_LEN_POSITION);
+  packet[1] = template[1];
+  packet[2] = (uint8_t)(mid >> 8);
+  packet[3] = (uint8_t)mid;
+  i = COAP_HEADER_LEN;
+
+  memcpy(&packet[i], obs->token, obs->token_len);
+  i += obs->token_len;
+  memcpy(&packet[i], &template[token_end], observe_start - token_end);
+  i += observe_start - token_end;
+
+  if(observe_end > observe_start) {
+    packet[i++] = (template[observe_start] & 0xF0) | observe_len;
+    while(observe_len > 0) {
+      packet[i++] = (uint8_t)(observe >> (8 * --observe_len));
+    }
+  }
+
+  memcpy(&packet[i], &template[observe_end], len - observe_end);
+  return copy_len;
+}
+#endif /* COAP_OBSERVE_RENDER_ONCE */
 /*---------------------------------------------------------------------------*/
 /*- Notification ------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -194,6 +310,10 @@ coap_notify_observers_sub(resource_t *resource, const char *subpath)
   coap_observer_t *obs = NULL;
   int url_len, obs_url_len;
   char url[COAP_OBSERVER_URL_LEN];
+#if COAP_OBSERVE_RENDER_ONCE
+  /* the notification of the first observer, sent after all others */
+  coap_transaction_t *template = NULL;
+#endif /* COAP_OBSERVE_RENDER_ONCE */
 
   url_len = strlen(resource->url);
   strncpy(url, resource->url, COAP_OBSERVER_URL_LEN - 1);
@@ -243,6 +363,22 @@ coap_notify_observers_sub(resource_t *resource, const char *subpath)
         /* prepare response */
         notification->mid = transaction->mid;
 
+#if COAP_OBSERVE_RENDER_ONCE
+        if(template != NULL) {
+          transaction->packet_len =
+            copy_notification(transaction->packet, template->packet,
+                              template->packet_len, notification->type,
+                              notification->mid, obs);
+          if(notification->code < BAD_REQUEST_4_00) {
+            (obs->obs_counter)++;
+            /* mask out to keep the CoAP observe option length <= 3 bytes */
+            obs->obs_counter &= 0xffffff;
+          }
+          coap_send_transaction(transaction);
+          continue;
+        }
+#endif /* COAP_OBSERVE_RENDER_ONCE */
+
         resource->get_handler(request, notification,
                               transaction->packet + COAP_MAX_HEADER_SIZE,
                               REST_MAX_CHUNK_SIZE, NULL);
@@ -257,10 +393,21 @@ coap_notify_observers_sub(resource_t *resource, const char *subpath)
         transaction->packet_len =
           coap_serialize_message(notification, transaction->packet);
 
+#if COAP_OBSERVE_RENDER_ONCE
+        /* a NON transaction is freed once sent, so hold the template back */
+        template = transaction;
+#else /* COAP_OBSERVE_RENDER_ONCE */
         coap_send_transaction(transaction);
+#endif /* COAP_OBSERVE_RENDER_ONCE */
       }
     }
   }
+
+#if COAP_OBSERVE_RENDER_ONCE
+  if(template != NULL) {
+    coap_send_transaction(template);
+  }
+#endif /* COAP_OBSERVE_RENDER_ONCE */
 }
 /*---------------------------------------------------------------------------*/
 void
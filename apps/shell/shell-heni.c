@@ -0,0 +1,95 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+
+/**
+ * \file
+ *         Shell command for printing HENI kernel statistics
+ */
+
+#include "contiki.h"
+#include "shell-heni.h"
+#include "heni-wrapper.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if HENI_KERNEL_WITH_STATS
+static const char *queue_names[HENI_STATS_QUEUE_COUNT] = {
+  "to-send", "being-routed", "already-sent", "to-receive", "already-received"
+};
+#endif /* HENI_KERNEL_WITH_STATS */
+/*---------------------------------------------------------------------------*/
+PROCESS(shell_heni_stats_process, "heni-stats");
+SHELL_COMMAND(heni_stats_command,
+	      "heni-stats",
+	      "heni-stats [reset]: show (or reset) HENI kernel statistics",
+	      &shell_heni_stats_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(shell_heni_stats_process, ev, data)
+{
+#if HENI_KERNEL_WITH_STATS
+  heni_stats_t *stats;
+  heni_instance_id_t iid;
+  heni_stats_queue_t queue;
+  uint_fast8_t i;
+  char buf[64];
+  int len;
+#endif /* HENI_KERNEL_WITH_STATS */
+
+  PROCESS_BEGIN();
+
+#if HENI_KERNEL_WITH_STATS
+  stats = heniGetStats();
+
+  if(data != NULL && strncmp(data, "reset", 5) == 0) {
+    heniStatsReset(stats);
+    shell_output_str(&heni_stats_command, "statistics reset", "");
+    PROCESS_EXIT();
+  }
+
+  /* Per-instance packet counts, by routing status; zeros are skipped. */
+  for(iid = HENI_INSTANCE_ID_INVALID; iid <= HENI_INSTANCE_ID_MAX; ++iid) {
+    for(i = 0; i < HENI_PACKET_ROUTING_ERROR_COUNT; ++i) {
+      if(heniStatsGetNumTxPackets(stats, iid, i) == 0 &&
+         heniStatsGetNumRxPackets(stats, iid, i) == 0) {
+        continue;
+      }
+      snprintf(buf, sizeof(buf), "iid %u status %u: tx %lu rx %lu",
+               (unsigned)iid, (unsigned)i,
+               (unsigned long)heniStatsGetNumTxPackets(stats, iid, i),
+               (unsigned long)heniStatsGetNumRxPackets(stats, iid, i));
+      shell_output_str(&heni_stats_command, buf, "");
+    }
+  }
+
+  /* Per-queue lengths, high-water marks, and log2 time histograms. */
+  for(queue = 0; queue < HENI_STATS_QUEUE_COUNT; ++queue) {
+    len = snprintf(buf, sizeof(buf), "%s: len %lu max %lu time",
+                   queue_names[queue],
+                   (unsigned long)heniStatsGetQueueLength(stats, queue),
+                   (unsigned long)heniStatsGetQueueHighWaterMark(stats, queue));
+    for(i = 0; i < HENI_STATS_NUM_HISTOGRAM_BINS && len > 0 && len < (int)sizeof(buf); ++i) {
+      len += snprintf(buf + len, sizeof(buf) - len, " %lu",
+                      (unsigned long)heniStatsGetQueueTimeHistogramBin(stats, queue, i));
+    }
+    shell_output_str(&heni_stats_command, buf, "");
+  }
+#else /* HENI_KERNEL_WITH_STATS */
+  shell_output_str(&heni_stats_command,
+                   "HENI statistics disabled (HENI_KERNEL_WITH_STATS=0)", "");
+#endif /* HENI_KERNEL_WITH_STATS */
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+void
+shell_heni_init(void)
+{
+  shell_register_command(&heni_stats_command);
+}
+/*---------------------------------------------------------------------------*/
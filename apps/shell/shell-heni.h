@@ -0,0 +1,21 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+
+/**
+ * \file
+ *         Shell command for printing HENI kernel statistics
+ */
+
+#ifndef SHELL_HENI_H_
+#define SHELL_HENI_H_
+
+#include "shell.h"
+
+void shell_heni_init(void);
+
+#endif /* SHELL_HENI_H_ */
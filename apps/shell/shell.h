@@ -379,6 +379,7 @@ struct shell_input {
 #include "shell-download.h"
 #include "shell-exec.h"
 #include "shell-file.h"
+#include "shell-heni.h"
 #include "shell-httpd.h"
 #include "shell-irc.h"
 #include "shell-memdebug.h"
@@ -58,6 +58,8 @@
 #include "cfs/cfs.h"
 #include "cfs-coffee-arch.h"
 #include "cfs/cfs-coffee.h"
+#include "sys/clock.h"
+#include "sys/process.h"
 
 /* Micro logs enable modifications on storage types that do not support
    in-place updates. This applies primarily to flash memories. */
@@ -84,6 +86,43 @@
 #define COFFEE_EXTENDED_WEAR_LEVELLING  1
 #endif
 
+/*
+ * Keep a RAM index from file names to file pages, so that opening a
+ * file that is not cached does not require a scan of the flash. The
+ * index holds up to COFFEE_NAME_INDEX_SIZE - 1 files, and must be a
+ * power of two. If there are more files, a scan is needed for those
+ * that do not fit. Set it to 0 to disable the index.
+ */
+#ifndef COFFEE_NAME_INDEX_SIZE
+#define COFFEE_NAME_INDEX_SIZE 0
+#endif
+
+#if COFFEE_NAME_INDEX_SIZE & (COFFEE_NAME_INDEX_SIZE - 1)
+#error COFFEE_NAME_INDEX_SIZE must be a power of two.
+#endif
+
+/*
+ * Erase sectors that hold no active pages from a process, one sector
+ * each time the process is scheduled, instead of within the file
+ * operation that runs out of space. The process is started by file
+ * removals on the same condition as the synchronous collection, so
+ * not with COFFEE_EXTENDED_WEAR_LEVELLING. It goes round the storage
+ * from where it left off, and files are allocated round the storage
+ * too rather than from its start, which spreads the wear. The greedy
+ * garbage collection remains as a fallback when space is needed
+ * before the process has caught up.
+ */
+#ifndef COFFEE_BACKGROUND_GC
+#define COFFEE_BACKGROUND_GC 0
+#endif
+
+/* Keep the garbage collection statistics of cfs_coffee_get_gc_stats()
+   and the erase counts of cfs_coffee_get_sector_erasures(). They are
+   kept in RAM only, and start from zero at every boot. */
+#ifndef COFFEE_GC_STATS
+#define COFFEE_GC_STATS 0
+#endif
+
 #if COFFEE_START & (COFFEE_SECTOR_SIZE - 1)
 #error COFFEE_START must point to the first byte in a sector.
 #endif
@@ -112,6 +151,11 @@
 /* "Reluctant" garbage collection stops after erasing one sector. */
 #define GC_RELUCTANT      1
 
+/* The states of the name index. */
+#define NAME_INDEX_UNBUILT  0 /* Not built since the last format or boot. */
+#define NAME_INDEX_COMPLETE 1 /* Holds all files. */
+#define NAME_INDEX_PARTIAL  2 /* Holds only some files. */
+
 /* File descriptor macros. */
 #define FD_VALID(fd)      ((fd) >= 0 && (fd) < COFFEE_FD_SET_SIZE && \
                            coffee_fd_set[(fd)].flags != COFFEE_FD_FREE)
@@ -190,6 +234,15 @@ struct file_header {
   char name[COFFEE_NAME_LENGTH];
 };
 
+#if COFFEE_NAME_INDEX_SIZE
+/* An entry of the name index. Keeping the hash of the name saves
+   reading the headers of files whose names do not match. */
+struct name_index_entry {
+  coffee_page_t page;
+  uint16_t hash;
+};
+#endif /* COFFEE_NAME_INDEX_SIZE */
+
 /* This is needed because of a buggy compiler. */
 struct log_param {
   cfs_offset_t offset;
@@ -206,6 +259,27 @@ static struct file_desc coffee_fd_set[COFFEE_FD_SET_SIZE];
 static coffee_page_t next_free;
 static char gc_wait;
 
+#if COFFEE_NAME_INDEX_SIZE
+/* Open-addressing hash table of active files, keyed by name. */
+static struct name_index_entry name_index[COFFEE_NAME_INDEX_SIZE];
+static coffee_page_t name_index_count;
+static uint8_t name_index_state;
+#endif /* COFFEE_NAME_INDEX_SIZE */
+
+#if COFFEE_GC_STATS
+static struct cfs_coffee_gc_stats gc_stats;
+/* Erase counts of the sectors since boot. */
+static unsigned long sector_erasures[COFFEE_SECTOR_COUNT];
+#endif /* COFFEE_GC_STATS */
+
+#if COFFEE_BACKGROUND_GC
+PROCESS(coffee_gc_process, "Coffee GC");
+/* The next sector that the background collection looks at, and the
+   number of sectors left to look at before it has gone round once. */
+static coffee_page_t gc_cursor;
+static coffee_page_t gc_remaining;
+#endif /* COFFEE_BACKGROUND_GC */
+
 /*---------------------------------------------------------------------------*/
 static void
 write_header(struct file_header *hdr, coffee_page_t page)
@@ -349,11 +423,46 @@ isolate_pages(coffee_page_t start, coffee_page_t skip_pages)
 }
 /*---------------------------------------------------------------------------*/
 static void
+erase_sector(coffee_page_t sector, coffee_page_t isolation_count)
+{
+  if(isolation_count > 0) {
+    isolate_pages((sector + 1) * COFFEE_PAGES_PER_SECTOR, isolation_count);
+  }
+
+  COFFEE_ERASE(sector);
+  PRINTF("Coffee: Erased sector %d!\n", sector);
+
+#if COFFEE_GC_STATS
+  sector_erasures[sector]++;
+  gc_stats.erased_pages += COFFEE_PAGES_PER_SECTOR;
+#endif /* COFFEE_GC_STATS */
+}
+/*---------------------------------------------------------------------------*/
+#if COFFEE_GC_STATS
+static void
+account_gc_time(clock_time_t start)
+{
+  clock_time_t elapsed;
+
+  elapsed = clock_time() - start;
+  gc_stats.gc_time += elapsed;
+  if(elapsed > gc_stats.max_gc_time) {
+    gc_stats.max_gc_time = elapsed;
+  }
+}
+#endif /* COFFEE_GC_STATS */
+/*---------------------------------------------------------------------------*/
+static void
 collect_garbage(int mode)
 {
   coffee_page_t sector;
   struct sector_status stats;
   coffee_page_t first_page, isolation_count;
+#if COFFEE_GC_STATS
+  clock_time_t start;
+
+  start = clock_time();
+#endif /* COFFEE_GC_STATS */
 
   PRINTF("Coffee: Running the garbage collector in %s mode\n",
          mode == GC_RELUCTANT ? "reluctant" : "greedy");
@@ -378,19 +487,90 @@ collect_garbage(int mode)
         next_free = first_page;
       }
 
-      if(isolation_count > 0) {
-        isolate_pages(first_page + COFFEE_PAGES_PER_SECTOR, isolation_count);
-      }
-
-      COFFEE_ERASE(sector);
-      PRINTF("Coffee: Erased sector %d!\n", sector);
+      erase_sector(sector, isolation_count);
+#if COFFEE_GC_STATS
+      gc_stats.foreground_erasures++;
+#endif /* COFFEE_GC_STATS */
 
       if(mode == GC_RELUCTANT && isolation_count > 0) {
         break;
       }
     }
   }
+
+#if COFFEE_GC_STATS
+  account_gc_time(start);
+#endif /* COFFEE_GC_STATS */
+}
+/*---------------------------------------------------------------------------*/
+#if COFFEE_BACKGROUND_GC
+/*
+ * Erases the next sector, from the cursor on, that holds obsolete
+ * pages and no active ones, except for the sector being filled. Only
+ * the sectors up to that one are looked at, so one round of the
+ * storage reads the status of every sector once, however many of them
+ * are erased. Unlike collect_garbage(), this leaves next_free alone,
+ * so that the allocation keeps moving forward and wraps around instead
+ * of wearing out the first sectors. Returns 1 if a sector has been
+ * erased, and 0 once the round is complete.
+ */
+static int
+collect_garbage_step(void)
+{
+  coffee_page_t sector, isolation_count;
+  struct sector_status stats;
+#if COFFEE_GC_STATS
+  clock_time_t start;
+
+  start = clock_time();
+#endif /* COFFEE_GC_STATS */
+
+  while(gc_remaining > 0) {
+    sector = gc_cursor;
+    gc_cursor = (gc_cursor + 1) % COFFEE_SECTOR_COUNT;
+    gc_remaining--;
+
+    isolation_count = get_sector_status(sector, &stats);
+    if(stats.active == 0 && stats.obsolete > 0 &&
+       next_free / COFFEE_PAGES_PER_SECTOR != sector) {
+      erase_sector(sector, isolation_count);
+#if COFFEE_GC_STATS
+      gc_stats.background_erasures++;
+      account_gc_time(start);
+#endif /* COFFEE_GC_STATS */
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+request_gc(void)
+{
+  /* Go round the storage once more, as any sector may hold the pages
+     that have just become obsolete. */
+  gc_remaining = COFFEE_SECTOR_COUNT;
+  if(!process_is_running(&coffee_gc_process)) {
+    process_start(&coffee_gc_process, NULL);
+  }
+  process_poll(&coffee_gc_process);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coffee_gc_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+    /* Let other processes run between the sector erasures. */
+    while(collect_garbage_step()) {
+      PROCESS_PAUSE();
+    }
+  }
+
+  PROCESS_END();
 }
+#endif /* COFFEE_BACKGROUND_GC */
 /*---------------------------------------------------------------------------*/
 static coffee_page_t
 next_file(coffee_page_t page, struct file_header *hdr)
@@ -452,6 +632,122 @@ load_file(coffee_page_t start, struct file_header *hdr)
   return file;
 }
 /*---------------------------------------------------------------------------*/
+#if COFFEE_NAME_INDEX_SIZE
+static uint16_t
+name_hash(const char *name)
+{
+  uint16_t hash = 5381;
+
+  while(*name != '\0') {
+    hash = (hash << 5) + hash + (uint8_t)*name++;
+  }
+  return hash;
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_add(const char *name, coffee_page_t page)
+{
+  uint16_t hash;
+  unsigned i;
+
+  if(name_index_state != NAME_INDEX_COMPLETE) {
+    return;
+  }
+  /* Keep a free slot to terminate the searches. */
+  if(name_index_count >= COFFEE_NAME_INDEX_SIZE - 1) {
+    name_index_state = NAME_INDEX_PARTIAL;
+    return;
+  }
+
+  hash = name_hash(name);
+  i = hash & (COFFEE_NAME_INDEX_SIZE - 1);
+  while(name_index[i].page != INVALID_PAGE) {
+    i = (i + 1) & (COFFEE_NAME_INDEX_SIZE - 1);
+  }
+  name_index[i].page = page;
+  name_index[i].hash = hash;
+  name_index_count++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_remove(const char *name, coffee_page_t page)
+{
+  unsigned i, j, home;
+
+  if(name_index_state == NAME_INDEX_UNBUILT) {
+    return;
+  }
+
+  for(i = name_hash(name) & (COFFEE_NAME_INDEX_SIZE - 1);
+      name_index[i].page != page;
+      i = (i + 1) & (COFFEE_NAME_INDEX_SIZE - 1)) {
+    if(name_index[i].page == INVALID_PAGE) {
+      /* Left out of a partial index. */
+      return;
+    }
+  }
+  name_index_count--;
+
+  /*
+   * Move back the following entries of the cluster that may no longer
+   * be reached from their home slot, so that no search stops at the
+   * emptied slot too early.
+   */
+  for(j = (i + 1) & (COFFEE_NAME_INDEX_SIZE - 1);
+      name_index[j].page != INVALID_PAGE;
+      j = (j + 1) & (COFFEE_NAME_INDEX_SIZE - 1)) {
+    home = name_index[j].hash & (COFFEE_NAME_INDEX_SIZE - 1);
+    if(((j - home) & (COFFEE_NAME_INDEX_SIZE - 1)) >=
+       ((j - i) & (COFFEE_NAME_INDEX_SIZE - 1))) {
+      name_index[i] = name_index[j];
+      i = j;
+    }
+  }
+  name_index[i].page = INVALID_PAGE;
+}
+/*---------------------------------------------------------------------------*/
+static void
+name_index_build(void)
+{
+  struct file_header hdr;
+  coffee_page_t page;
+  unsigned i;
+
+  for(i = 0; i < COFFEE_NAME_INDEX_SIZE; i++) {
+    name_index[i].page = INVALID_PAGE;
+  }
+  name_index_count = 0;
+  name_index_state = NAME_INDEX_COMPLETE;
+
+  for(page = 0; page < COFFEE_PAGE_COUNT; page = next_file(page, &hdr)) {
+    read_header(&hdr, page);
+    if(HDR_ACTIVE(hdr) && !HDR_LOG(hdr)) {
+      name_index_add(hdr.name, page);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static coffee_page_t
+name_index_find(const char *name, struct file_header *hdr)
+{
+  uint16_t hash;
+  unsigned i;
+
+  hash = name_hash(name);
+  for(i = hash & (COFFEE_NAME_INDEX_SIZE - 1);
+      name_index[i].page != INVALID_PAGE;
+      i = (i + 1) & (COFFEE_NAME_INDEX_SIZE - 1)) {
+    if(name_index[i].hash == hash) {
+      read_header(hdr, name_index[i].page);
+      if(strcmp(name, hdr->name) == 0) {
+        return name_index[i].page;
+      }
+    }
+  }
+  return INVALID_PAGE;
+}
+#endif /* COFFEE_NAME_INDEX_SIZE */
+/*---------------------------------------------------------------------------*/
 static struct file *
 find_file(const char *name)
 {
@@ -471,6 +767,23 @@ find_file(const char *name)
     }
   }
 
+#if COFFEE_NAME_INDEX_SIZE
+  /* Look the file up in the name index, which is built on first use.
+     A partial index that has room again is rebuilt instead of scanned. */
+  if(name_index_state == NAME_INDEX_UNBUILT ||
+     (name_index_state == NAME_INDEX_PARTIAL &&
+      name_index_count < COFFEE_NAME_INDEX_SIZE / 2)) {
+    name_index_build();
+  }
+  page = name_index_find(name, &hdr);
+  if(page != INVALID_PAGE) {
+    return load_file(page, &hdr);
+  }
+  if(name_index_state == NAME_INDEX_COMPLETE) {
+    return NULL;
+  }
+#endif /* COFFEE_NAME_INDEX_SIZE */
+
   /* Scan the flash memory sequentially otherwise. */
   for(page = 0; page < COFFEE_PAGE_COUNT; page = next_file(page, &hdr)) {
     read_header(&hdr, page);
@@ -572,6 +885,11 @@ remove_by_page(coffee_page_t page, int remove_log,
 
   hdr.flags |= HDR_FLAG_OBSOLETE;
   write_header(&hdr, page);
+#if COFFEE_NAME_INDEX_SIZE
+  if(!HDR_LOG(hdr)) {
+    name_index_remove(hdr.name, page);
+  }
+#endif /* COFFEE_NAME_INDEX_SIZE */
 
   gc_wait = 0;
 
@@ -593,7 +911,11 @@ remove_by_page(coffee_page_t page, int remove_log,
   }
 
   if(!COFFEE_EXTENDED_WEAR_LEVELLING && gc_allowed) {
+#if COFFEE_BACKGROUND_GC
+    request_gc();
+#else /* COFFEE_BACKGROUND_GC */
     collect_garbage(GC_RELUCTANT);
+#endif /* COFFEE_BACKGROUND_GC */
   }
 
   return 0;
@@ -619,6 +941,13 @@ reserve(const char *name, coffee_page_t pages,
   }
 
   page = find_contiguous_pages(pages);
+#if COFFEE_BACKGROUND_GC
+  if(page == INVALID_PAGE && next_free > 0) {
+    /* Wrap around to the sectors erased in the background. */
+    next_free = 0;
+    page = find_contiguous_pages(pages);
+  }
+#endif /* COFFEE_BACKGROUND_GC */
   if(page == INVALID_PAGE) {
     if(gc_wait) {
       return NULL;
@@ -636,6 +965,11 @@ reserve(const char *name, coffee_page_t pages,
   hdr.max_pages = pages;
   hdr.flags = HDR_FLAG_ALLOCATED | flags;
   write_header(&hdr, page);
+#if COFFEE_NAME_INDEX_SIZE
+  if(!HDR_LOG(hdr)) {
+    name_index_add(hdr.name, page);
+  }
+#endif /* COFFEE_NAME_INDEX_SIZE */
 
   PRINTF("Coffee: Reserved %u pages starting from %u for file %s\n",
          (unsigned)pages, (unsigned)page, name);
@@ -1330,6 +1664,9 @@ cfs_coffee_format(void)
 
   for(i = 0; i < COFFEE_SECTOR_COUNT; i++) {
     COFFEE_ERASE(i);
+#if COFFEE_GC_STATS
+    sector_erasures[i]++;
+#endif /* COFFEE_GC_STATS */
     PRINTF(".");
   }
 
@@ -1338,9 +1675,26 @@ cfs_coffee_format(void)
   memset(&coffee_fd_set, 0, sizeof(coffee_fd_set));
   next_free = 0;
   gc_wait = 1;
+#if COFFEE_NAME_INDEX_SIZE
+  name_index_state = NAME_INDEX_UNBUILT;
+#endif /* COFFEE_NAME_INDEX_SIZE */
 
   PRINTF(" done!\n");
 
   return 0;
 }
 /*---------------------------------------------------------------------------*/
+#if COFFEE_GC_STATS
+void
+cfs_coffee_get_gc_stats(struct cfs_coffee_gc_stats *stats)
+{
+  *stats = gc_stats;
+}
+/*---------------------------------------------------------------------------*/
+unsigned long
+cfs_coffee_get_sector_erasures(unsigned sector)
+{
+  return sector < COFFEE_SECTOR_COUNT ? sector_erasures[sector] : 0;
+}
+#endif /* COFFEE_GC_STATS */
+/*---------------------------------------------------------------------------*/
@@ -39,6 +39,7 @@
 #define CFS_COFFEE_H
 
 #include "cfs.h"
+#include "sys/clock.h"
 
 /**
  * Instruct Coffee that the access pattern to this file is adapted to 
@@ -140,6 +141,42 @@ int cfs_coffee_set_io_semantics(int fd, unsigned flags);
  */
 int cfs_coffee_format(void);
 
+/**
+ * Garbage collection statistics of Coffee, kept since boot if
+ * COFFEE_GC_STATS is set.
+ */
+struct cfs_coffee_gc_stats {
+  /** Pages in the sectors erased by the garbage collector. */
+  unsigned long erased_pages;
+  /** Sectors erased within file operations that ran out of space,
+      or directly after a file removal. */
+  unsigned long foreground_erasures;
+  /** Sectors erased by the background garbage collector. */
+  unsigned long background_erasures;
+  /** Total time spent collecting garbage, in clock ticks. */
+  clock_time_t gc_time;
+  /** Longest single garbage collection, in clock ticks. */
+  clock_time_t max_gc_time;
+};
+
+/**
+ * \brief Get the garbage collection statistics.
+ * \param stats The structure to fill in.
+ *
+ * Available if COFFEE_GC_STATS is set.
+ */
+void cfs_coffee_get_gc_stats(struct cfs_coffee_gc_stats *stats);
+
+/**
+ * \brief Get the number of times a sector has been erased.
+ * \param sector The sector number.
+ * \return The number of erasures since boot, including formatting.
+ *
+ * Available if COFFEE_GC_STATS is set. The counts are kept in RAM
+ * only, so they do not reflect the wear from before the last boot.
+ */
+unsigned long cfs_coffee_get_sector_erasures(unsigned sector);
+
 /** @} */
 /** @} */
 
@@ -38,6 +38,7 @@
 #include "lib/list.h"
 #include "lib/memb.h"
 #include "lib/mmem.h"
+#include "lib/sfmem.h"
 #include "lib/random.h"
 
 #endif /* CONTIKI_LIB_H_ */
@@ -15,6 +15,12 @@ prepare(const void *payload, unsigned short payload_len)
 }
 /*---------------------------------------------------------------------------*/
 static int
+prepare_segments(const struct radio_segment *segs, unsigned short num_segs)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
 transmit(unsigned short transmit_len)
 {
   return RADIO_TX_OK;
@@ -102,6 +108,7 @@ const struct radio_driver nullradio_driver =
     get_value,
     set_value,
     get_object,
-    set_object
+    set_object,
+    prepare_segments
   };
 /*---------------------------------------------------------------------------*/
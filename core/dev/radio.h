@@ -231,6 +231,15 @@ enum {
   RADIO_TX_NOACK,
 };
 
+/**
+ * A contiguous piece of an outgoing packet. A packet that is not
+ * stored in a single buffer is described by an array of segments.
+ */
+struct radio_segment {
+  const void *ptr;
+  unsigned short len;
+};
+
 /**
  * The structure of a device driver for a radio in Contiki.
  */
@@ -286,6 +295,15 @@ struct radio_driver {
   radio_result_t (* set_object)(radio_param_t param, const void *src,
                                 size_t size);
 
+  /**
+   * Prepare the radio with a packet made of several segments, which
+   * are written to the radio buffer one after another. Drivers that
+   * only accept a flat buffer leave this NULL, in which case the
+   * packet is copied into one buffer and passed to prepare().
+   */
+  int (* prepare_segments)(const struct radio_segment *segs,
+                           unsigned short num_segs);
+
 };
 
 #endif /* RADIO_H_ */
@@ -81,11 +81,17 @@ unsigned short crc16_add(unsigned char b, unsigned short crc);
  * \return     The CRC16 checksum.
  *
  *             This function calculates the CRC16 checksum of a data area.
+ *             The result equals that of feeding the bytes one by one
+ *             to crc16_add(), so a block can be checksummed in pieces
+ *             by passing the CRC of one piece as \p acc of the next.
  *
- *             \note The algorithm used in this implementation is
- *             tailored for a running checksum and does not perform as
- *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             \note By default, this function uses the same bitwise
+ *             algorithm as crc16_add(). Setting CRC16_CONF_WITH_TABLE
+ *             to 1 makes it use a 256-entry lookup table (512 bytes of
+ *             ROM) instead. With the table, CRC16_CONF_SLICE_BY set to
+ *             4 or 8 further processes 4 or 8 bytes per round with as
+ *             many tables (2 or 4 KB of ROM), which pays off on 32-bit
+ *             targets.
  */
 unsigned short crc16_data(const unsigned char *data, int datalen,
 			  unsigned short acc);
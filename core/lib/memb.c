@@ -53,51 +53,59 @@ memb_init(struct memb *m)
 {
   memset(m->count, 0, m->num);
   memset(m->mem, 0, m->size * m->num);
+  m->free = 0;
+  m->fresh = 0;
 }
 /*---------------------------------------------------------------------------*/
 void *
 memb_alloc(struct memb *m)
 {
-  int i;
+  unsigned short i;
 
-  for(i = 0; i < m->num; ++i) {
-    if(m->count[i] == 0) {
-      /* If this block was unused, we increase the reference count to
-	 indicate that it now is used and return a pointer to the
-	 memory block. */
-      ++(m->count[i]);
-      return (void *)((char *)m->mem + (i * m->size));
-    }
+  if(m->free != 0) {
+    /* Reuse the most recently freed block. */
+    i = m->free - 1;
+    m->free = m->next[i];
+  } else if(m->fresh < m->num) {
+    /* Hand out a block that has never been allocated. */
+    i = m->fresh++;
+  } else {
+    /* No free block was found, so we return NULL to indicate failure
+       to allocate block. */
+    return NULL;
   }
 
-  /* No free block was found, so we return NULL to indicate failure to
-     allocate block. */
-  return NULL;
+  /* The block is now used, so its reference count is increased. */
+  ++(m->count[i]);
+  return (void *)((char *)m->mem + (i * m->size));
 }
 /*---------------------------------------------------------------------------*/
 char
 memb_free(struct memb *m, void *ptr)
 {
-  int i;
-  char *ptr2;
+  unsigned long offset;
+  unsigned short i;
 
-  /* Walk through the list of blocks and try to find the block to
-     which the pointer "ptr" points to. */
-  ptr2 = (char *)m->mem;
-  for(i = 0; i < m->num; ++i) {
-    
-    if(ptr2 == (char *)ptr) {
-      /* We've found to block to which "ptr" points so we decrease the
-	 reference count and return the new value of it. */
-      if(m->count[i] > 0) {
-	/* Make sure that we don't deallocate free memory. */
-	--(m->count[i]);
-      }
-      return m->count[i];
+  /* The index of the block to which "ptr" points follows from its
+     offset in the memory of the blocks. */
+  if(!memb_inmemb(m, ptr)) {
+    return -1;
+  }
+  offset = (unsigned long)((char *)ptr - (char *)m->mem);
+  i = (unsigned short)(offset / m->size);
+  if(offset != (unsigned long)i * m->size) {
+    return -1;
+  }
+
+  /* Make sure that we don't deallocate free memory. */
+  if(m->count[i] > 0) {
+    --(m->count[i]);
+    if(m->count[i] == 0) {
+      m->next[i] = m->free;
+      m->free = i + 1;
     }
-    ptr2 += m->size;
   }
-  return -1;
+  return m->count[i];
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -48,6 +48,12 @@
  * memory by the memb_alloc() function, and are deallocated with the
  * memb_free() function.
  *
+ * Both memb_alloc() and memb_free() run in constant time. Blocks that
+ * have never been allocated are handed out in order, and freed blocks
+ * are kept on a free list whose links are stored in a separate array
+ * of two bytes per block, so that memb_free() leaves the contents of
+ * a block untouched.
+ *
  * @{
  */
 
@@ -88,16 +94,27 @@ MEMB(connections, struct connection, 16);
  */
 #define MEMB(name, structure, num) \
         static char CC_CONCAT(name,_memb_count)[num]; \
+        static unsigned short CC_CONCAT(name,_memb_next)[num]; \
         static structure CC_CONCAT(name,_memb_mem)[num]; \
         static struct memb name = {sizeof(structure), num, \
                                           CC_CONCAT(name,_memb_count), \
-                                          (void *)CC_CONCAT(name,_memb_mem)}
+                                          (void *)CC_CONCAT(name,_memb_mem), \
+                                          CC_CONCAT(name,_memb_next), \
+                                          0, 0}
 
 struct memb {
   unsigned short size;
   unsigned short num;
   char *count;
   void *mem;
+  /* For each free block, one plus the index of the next block on the
+     free list, or 0 if it is the last. */
+  unsigned short *next;
+  /* One plus the index of the first block on the free list, or 0 if
+     the list is empty. */
+  unsigned short free;
+  /* The blocks from this index on have never been allocated. */
+  unsigned short fresh;
 };
 
 /**
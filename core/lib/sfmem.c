@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+/**
+ * \addtogroup sfmem
+ * @{
+ */
+
+/**
+ * \file
+ *         Implementation of the segregated-fit memory allocator
+ */
+
+#include "sfmem.h"
+#include "contiki-conf.h"
+#include <stddef.h>
+
+#ifdef SFMEM_CONF_SIZE
+#define SFMEM_SIZE SFMEM_CONF_SIZE
+#else
+#define SFMEM_SIZE 4096
+#endif
+
+/* The number of free lists. Free blocks of 2^k to 2^(k+1) - 1 bytes
+   go to list k; the last list also takes all larger blocks. */
+#ifdef SFMEM_CONF_NUM_CLASSES
+#define NUM_CLASSES SFMEM_CONF_NUM_CLASSES
+#else
+#define NUM_CLASSES 16
+#endif
+
+/* The number of blocks in the list of a requested size that are tried
+   before a larger class is used. Trying more blocks fragments the heap
+   less, but bounds the time an allocation takes less tightly. */
+#ifdef SFMEM_CONF_FIT_TRIES
+#define FIT_TRIES SFMEM_CONF_FIT_TRIES
+#else
+#define FIT_TRIES 4
+#endif
+
+#define ALIGNMENT sizeof(void *)
+#define ALIGN_UP(s) (((s) + ALIGNMENT - 1) & ~(ALIGNMENT - 1))
+
+/* Every block, free or not, starts with this header. The sizes
+   include the header. */
+struct header {
+  unsigned int size;
+  /* The size of the block just below this one in the heap, or 0 for
+     the first block. */
+  unsigned int prev_size;
+};
+
+/* The block is allocated. Sizes are multiples of ALIGNMENT, so the
+   lowest bit of a size is free to hold this flag. */
+#define USED 1
+
+struct free_block {
+  struct header h;
+  struct free_block *next, *prev;
+};
+
+#define HEADER_SIZE ALIGN_UP(sizeof(struct header))
+#define MIN_BLOCK_SIZE ALIGN_UP(sizeof(struct free_block))
+#define HEAP_SIZE (SFMEM_SIZE & ~(ALIGNMENT - 1))
+
+static union {
+  char memory[SFMEM_SIZE];
+  void *align;
+} heap;
+
+static struct free_block *free_lists[NUM_CLASSES];
+static unsigned int avail_memory;
+
+#define BLOCK_AT(p) ((struct free_block *)(void *)(p))
+#define HEAP_END (&heap.memory[HEAP_SIZE])
+
+/*---------------------------------------------------------------------------*/
+static unsigned char
+size_class(unsigned int size)
+{
+  unsigned char c;
+
+  for(c = 0; c < NUM_CLASSES - 1 && (size >> (c + 1)) != 0; c++);
+  return c;
+}
+/*---------------------------------------------------------------------------*/
+static void
+insert_free(struct free_block *b)
+{
+  struct free_block **head;
+
+  head = &free_lists[size_class(b->h.size)];
+  b->prev = NULL;
+  b->next = *head;
+  if(*head != NULL) {
+    (*head)->prev = b;
+  }
+  *head = b;
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_free(struct free_block *b)
+{
+  if(b->prev != NULL) {
+    b->prev->next = b->next;
+  } else {
+    free_lists[size_class(b->h.size)] = b->next;
+  }
+  if(b->next != NULL) {
+    b->next->prev = b->prev;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static struct free_block *
+first_fit(struct free_block *b, unsigned int size, unsigned char tries)
+{
+  for(; b != NULL && b->h.size < size; b = b->next) {
+    if(tries != 0 && --tries == 0) {
+      return NULL;
+    }
+  }
+  return b;
+}
+/*---------------------------------------------------------------------------*/
+/* Find a free block of at least size bytes. The first few blocks of the
+   list of the size itself are tried first, as they fit best. Otherwise,
+   any block in a class above the one of the size is large enough, so
+   the head of the first non-empty such list is taken. Only the last
+   list, whose blocks have no upper bound, is searched all the way. */
+static struct free_block *
+find_block(unsigned int size)
+{
+  struct free_block *b;
+  unsigned char c, k;
+
+  c = size_class(size);
+  if(c < NUM_CLASSES - 1) {
+    b = first_fit(free_lists[c], size, FIT_TRIES);
+    if(b != NULL) {
+      return b;
+    }
+  }
+  for(k = c + 1; k < NUM_CLASSES - 1; k++) {
+    if(free_lists[k] != NULL) {
+      return free_lists[k];
+    }
+  }
+  return first_fit(free_lists[NUM_CLASSES - 1], size, 0);
+}
+/*---------------------------------------------------------------------------*/
+/* Tell the block above b in the heap, if any, the size of b. */
+static void
+update_next(struct free_block *b)
+{
+  char *next;
+
+  next = (char *)b + (b->h.size & ~USED);
+  if(next < HEAP_END) {
+    BLOCK_AT(next)->h.prev_size = b->h.size & ~USED;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief      Allocate a memory block
+ * \param m    A pointer to a struct mmem.
+ * \param size The size of the requested memory block
+ * \return     Non-zero if the memory could be allocated, zero if no
+ *             free block was large enough.
+ *
+ *             The block is split if what remains of it is large
+ *             enough to be used on its own.
+ */
+int
+sfmem_alloc(struct mmem *m, unsigned int size)
+{
+  struct free_block *b, *rest;
+  unsigned int total;
+
+  if(size > HEAP_SIZE) {
+    return 0;
+  }
+  total = HEADER_SIZE + ALIGN_UP(size);
+  if(total < MIN_BLOCK_SIZE) {
+    total = MIN_BLOCK_SIZE;
+  }
+
+  b = find_block(total);
+  if(b == NULL) {
+    return 0;
+  }
+  remove_free(b);
+
+  if(b->h.size - total >= MIN_BLOCK_SIZE) {
+    rest = BLOCK_AT((char *)b + total);
+    rest->h.size = b->h.size - total;
+    rest->h.prev_size = total;
+    update_next(rest);
+    insert_free(rest);
+    b->h.size = total;
+  }
+  avail_memory -= b->h.size;
+  b->h.size |= USED;
+
+  m->next = NULL;
+  m->ptr = (char *)b + HEADER_SIZE;
+  m->size = size;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief      Deallocate a memory block
+ * \param m    A pointer to a struct mmem filled in by sfmem_alloc()
+ *
+ *             The block is merged with the blocks just below and
+ *             above it in the heap, if these are free.
+ */
+void
+sfmem_free(struct mmem *m)
+{
+  struct free_block *b, *neighbor;
+  char *next;
+
+  b = BLOCK_AT((char *)m->ptr - HEADER_SIZE);
+  b->h.size &= ~USED;
+  avail_memory += b->h.size;
+
+  next = (char *)b + b->h.size;
+  if(next < HEAP_END && !(BLOCK_AT(next)->h.size & USED)) {
+    neighbor = BLOCK_AT(next);
+    remove_free(neighbor);
+    b->h.size += neighbor->h.size;
+  }
+  if(b->h.prev_size != 0) {
+    neighbor = BLOCK_AT((char *)b - b->h.prev_size);
+    if(!(neighbor->h.size & USED)) {
+      remove_free(neighbor);
+      neighbor->h.size += b->h.size;
+      b = neighbor;
+    }
+  }
+  update_next(b);
+  insert_free(b);
+}
+/*---------------------------------------------------------------------------*/
+unsigned int
+sfmem_avail(void)
+{
+  return avail_memory;
+}
+/*---------------------------------------------------------------------------*/
+unsigned int
+sfmem_largest(void)
+{
+  struct free_block *b;
+  unsigned int largest;
+  signed char c;
+
+  largest = 0;
+  for(c = NUM_CLASSES - 1; c >= 0 && largest == 0; c--) {
+    for(b = free_lists[c]; b != NULL; b = b->next) {
+      if(b->h.size > largest) {
+        largest = b->h.size;
+      }
+    }
+  }
+  return largest == 0 ? 0 : largest - HEADER_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief      Initialize the segregated-fit memory allocator
+ *
+ *             The whole heap starts out as a single free block.
+ */
+void
+sfmem_init(void)
+{
+  static int inited = 0;
+  struct free_block *b;
+  unsigned char c;
+
+  if(inited) {
+    return;
+  }
+  for(c = 0; c < NUM_CLASSES; c++) {
+    free_lists[c] = NULL;
+  }
+  b = BLOCK_AT(heap.memory);
+  b->h.size = HEAP_SIZE;
+  b->h.prev_size = 0;
+  insert_free(b);
+  avail_memory = HEAP_SIZE;
+  inited = 1;
+}
+/*---------------------------------------------------------------------------*/
+
+/** @} */
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+/**
+ * \addtogroup mem
+ * @{
+ */
+
+/**
+ * \defgroup sfmem Segregated-fit memory allocator
+ *
+ * The segregated-fit memory allocator manages a static heap, like
+ * the managed memory allocator (mmem), but never moves allocated
+ * memory. Free blocks are kept in lists by power-of-two size class
+ * and are merged with their free neighbours when they are released,
+ * and pointers to allocated memory stay valid until the memory is
+ * freed. The price is that the heap can fragment.
+ *
+ * Deallocation takes time bounded by the number of size classes
+ * (SFMEM_CONF_NUM_CLASSES). So does allocation, plus a few tries in
+ * the list of the requested size (SFMEM_CONF_FIT_TRIES), unless the
+ * request falls in the top class, which also takes all larger blocks:
+ * that list is searched linearly. With enough classes for the top one
+ * to start above the largest allocation, allocation is bounded too.
+ *
+ * The allocator fills in the same struct mmem as mmem_alloc(), so a
+ * module can switch between the two allocators by changing only the
+ * allocation and deallocation calls; MMEM_PTR() works with both. A
+ * block must be freed by the allocator that allocated it.
+ * @{
+ */
+
+/**
+ * \file
+ *         Header file for the segregated-fit memory allocator
+ */
+
+#ifndef SFMEM_H_
+#define SFMEM_H_
+
+#include "lib/mmem.h"
+
+/**
+ * \brief      Allocate a memory block
+ * \param m    A pointer to a struct mmem.
+ * \param size The size of the requested memory block
+ * \return     Non-zero if the memory could be allocated, zero if no
+ *             free block was large enough.
+ *
+ *             The memory can be accessed through MMEM_PTR(m) and
+ *             does not move until it is freed with sfmem_free().
+ */
+int sfmem_alloc(struct mmem *m, unsigned int size);
+
+/**
+ * \brief      Deallocate a memory block
+ * \param m    A pointer to a struct mmem filled in by sfmem_alloc()
+ */
+void sfmem_free(struct mmem *m);
+
+/**
+ * \brief      Get the amount of free memory
+ * \return     The number of free bytes in the heap, including the
+ *             block headers that an allocation would take from them
+ */
+unsigned int sfmem_avail(void);
+
+/**
+ * \brief      Get the size of the largest free block
+ * \return     The usable size of the largest free block, in bytes
+ *
+ *             Together with sfmem_avail(), this tells how fragmented
+ *             the heap is. An allocation of this size may still fail,
+ *             when the block is not among the first
+ *             SFMEM_CONF_FIT_TRIES blocks of its class and no larger
+ *             class has a free block.
+ */
+unsigned int sfmem_largest(void);
+
+/**
+ * \brief      Initialize the segregated-fit memory allocator
+ *
+ *             This function must be called before any other function
+ *             of the module.
+ */
+void sfmem_init(void);
+
+#endif /* SFMEM_H_ */
+
+/** @} */
+/** @} */
@@ -1,4 +1,3 @@
-#include "ieee-addr.h"
 #include <stdio.h>
 #include "string.h"
 #include "linkaddr.h"
@@ -8,17 +7,22 @@ int_fast8_t heniLinkAddrCmp(
         uint8_t const * laddrPtr2
 )
 {
-    linkaddr_t const * addr1 = (linkaddr_t const *)laddrPtr1;
-    linkaddr_t const * addr2 = (linkaddr_t const *)laddrPtr2;
-    return linkaddr_cmp(addr1, addr2);
+    int res = memcmp(laddrPtr1, laddrPtr2, LINKADDR_SIZE);
+    return res < 0 ? (int_fast8_t)-1 : (res > 0 ? (int_fast8_t)1 : 0);
 }
 
 size_t heniLinkAddrHash(
         uint8_t const * laddrPtr
 )
 {
-    // linkaddr_t const * addr = (linkaddr_t const *)laddrPtr;
-    return (size_t)(*laddrPtr);
+    /* FNV-1a over the whole address: the neighbor table
+       derives both the bucket and the fingerprint from it. */
+    uint32_t res = 2166136261UL;
+    int i;
+    for (i = 0; i < LINKADDR_SIZE; ++i) {
+        res = (res ^ laddrPtr[i]) * 16777619UL;
+    }
+    return (size_t)res;
 }
 
 void heniLinkAddrCopy(
@@ -46,7 +50,7 @@ int_fast8_t heniLinkAddrIsValid(
     linkaddr_t tmp;
     heniLinkAddrInvalidate((uint8_t *)&tmp);
     linkaddr_t const * addr = (linkaddr_t const *)laddrPtr;
-    return heniLinkAddrCmp((uint8_t *)&tmp, (uint8_t *)addr) == 0 ? (int_fast8_t)1 : 0;
+    return heniLinkAddrCmp((uint8_t *)&tmp, (uint8_t *)addr) != 0 ? (int_fast8_t)1 : 0;
 }
 
 void heniLinkAddrFetchMine(
@@ -62,7 +66,7 @@ int_fast8_t heniLinkAddrIsMine(
 {
     linkaddr_t const * addr = (linkaddr_t const *)laddrPtr;
     linkaddr_t myAddr = linkaddr_node_addr;
-    return heniLinkAddrCmp((uint8_t *) addr, (uint8_t *) &myAddr);
+    return heniLinkAddrCmp((uint8_t *) addr, (uint8_t *) &myAddr) == 0 ? (int_fast8_t)1 : 0;
 }
 
 void heniLinkAddrFetchAllNeighbors(
@@ -80,7 +84,7 @@ int_fast8_t heniLinkAddrIsAllNeighbors(
     linkaddr_t tmp;
     heniLinkAddrFetchAllNeighbors((uint8_t *) &tmp);
     linkaddr_t const * addr = (linkaddr_t const *)laddrPtr;
-    return heniLinkAddrCmp((uint8_t *) &tmp, (uint8_t *) addr);
+    return heniLinkAddrCmp((uint8_t *) &tmp, (uint8_t *) addr) == 0 ? (int_fast8_t)1 : 0;
 }
 
 int_fast8_t heniLinkAddrIsMulticast(
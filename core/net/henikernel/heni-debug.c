@@ -5,7 +5,6 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <strformat.h>
 #include <string.h>
 #include <strings.h>
 
@@ -11,10 +11,18 @@
 #include "lib/memb.h"
 #include "lib/list.h"
 #include "pt.h"
+#include "sys/clock.h"
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 
 
+/* The largest 802.15.4 frame, of which the radio takes the last bytes
+   for the FCS, and the header to assume when the framer cannot tell */
+#define MAX_FRAME_SIZE 127
+#define FCS_LEN 2
+#define FIXED_HDRLEN 21
+
 MEMB(InstanceAllocator, heni_instance_t, HENI_PORT_DEFAULT_MAX_INSTANCES);
 MEMB(PacketAllocator, heni_packet_t, HENI_PORT_DEFAULT_MAX_PACKETS);
 MEMB(NeighborAllocator, heni_neighbor_t, HENI_PORT_DEFAULT_MAX_NEIGHBORS);
@@ -24,10 +32,11 @@ MEMB(ReceivedMessageAllocator, message_info_rx_t, HENI_PORT_DEFAULT_MAX_PACKETS)
 static struct pt computation_thread_pt, buffer_thread_pt;
 
 heni_kernel_t m_kernel;
+static struct radio_segment tx_segments[PACKETBUF_MAX_SEGMENTS];
 sent_callback sent_callback_f = 0;
 received_callback received_callback_f = 0;
 
-inline message_info_rx_t * iovToRxMsg(heni_iobuf_list_t * iov)
+static inline message_info_rx_t * iovToRxMsg(heni_iobuf_list_t * iov)
 {
     return (message_info_rx_t *)((uint8_t *)iov - offsetof(message_info_rx_t, iovList));
 }
@@ -38,6 +47,20 @@ void heniSetCallbacks(sent_callback _sent_callback, received_callback _received_
 }
 
 
+/* The room left for the payload in a frame to the receiver in the
+   packetbuf, or -1 if the framer cannot frame it */
+static int frame_payload_budget(void)
+{
+    int hdrLen;
+
+    hdrLen = NETSTACK_FRAMER.length();
+    if (hdrLen < 0) {
+      return -1;
+    }
+    return MAX_FRAME_SIZE - FCS_LEN - hdrLen;
+}
+
+
 PT_THREAD(computation_thread(struct pt *pt))
 {
     PT_BEGIN(pt);
@@ -101,6 +124,15 @@ packet_sent(void *ptr, int status, int num_tx)
     PRINTF("[HeniKernelWrapper] error %d after %d tx\n", status, num_tx);
   }
   heniFrameTxInfoReset(&finfo);
+  for(; num_tx > 0; --num_tx) {
+    heniFrameTxInfoIncNumAttempts(&finfo);
+  }
+  if(status == MAC_TX_OK || status == MAC_TX_NOACK) {
+    heniFrameTxInfoMarkTransmissionByLowLevelStack(&finfo);
+  }
+  if(status == MAC_TX_OK) {
+    heniFrameTxInfoMarkAcknowledgmentByLowLevelStack(&finfo);
+  }
   packetbuf_clear();
   heniKernelFrameSendFinish(&m_kernel, (heni_iobuf_list_t *)ptr, &finfo);
 }
@@ -128,7 +160,9 @@ int_fast8_t heniKernelFrameSendStart(
     heni_iobuf_list_fiter_t   payloadIter;
     uint8_t *                 payloadPtr;
     uint16_t                  payloadLen;
+    uint8_t                   numSegments;
     linkaddr_t                address;
+    int                       budget;
 
     payloadLen = heniIOBufListGetCapacity(fpld);
 
@@ -137,18 +171,34 @@ int_fast8_t heniKernelFrameSendStart(
       return -1;
     }
 
-    packetbuf_set_datalen(payloadLen);
-    payloadPtr = packetbuf_dataptr();
-
-    heniIOBufListFIterInit(
-        &payloadIter,
-        fpld
-    );
-    heniIOBufListFIterTryCopyIntoOneBufAndAdvance(
-        &payloadIter,
-        payloadPtr,
-        payloadLen
-    );
+    if (heniIOBufListGetCount(fpld) <= PACKETBUF_MAX_SEGMENTS) {
+      // The packetbuf only references the frame, which stays
+      // with us until packet_sent, so that the radio driver
+      // can gather it after the header.
+      numSegments = 0;
+      heniIOBufListFIterInit(&payloadIter, fpld);
+      while (heniIOBufListFIterIsActive(&payloadIter)) {
+        tx_segments[numSegments].ptr = heniIOBufListFiterGetMemPtr(&payloadIter);
+        tx_segments[numSegments].len = heniIOBufListFiterGetMemLen(&payloadIter);
+        heniIOBufListFIterTryAdvance(&payloadIter, tx_segments[numSegments].len);
+        ++numSegments;
+      }
+      packetbuf_reference_segments(tx_segments, numSegments);
+    } else {
+      packetbuf_clear();
+      packetbuf_set_datalen(payloadLen);
+      payloadPtr = packetbuf_dataptr();
+
+      heniIOBufListFIterInit(
+          &payloadIter,
+          fpld
+      );
+      heniIOBufListFIterTryCopyIntoOneBufAndAdvance(
+          &payloadIter,
+          payloadPtr,
+          payloadLen
+      );
+    }
 
     heniLinkAddrCopy(heniFrameAddrGetSrcLinkAddrConstPtr(faddr), (uint8_t *)&address);
     packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &address);
@@ -156,6 +206,15 @@ int_fast8_t heniKernelFrameSendStart(
     heniLinkAddrCopy(heniFrameAddrGetDstLinkAddrConstPtr(faddr), (uint8_t *)&address);
     packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &address);
 
+    // The radio would reject, or silently truncate, a frame that
+    // does not fit once the header and the FCS are added.
+    budget = frame_payload_budget();
+    if (budget < 0 || payloadLen > budget) {
+      PRINTF("Payload too big for the frame\n");
+      packetbuf_clear();
+      return -1;
+    }
+
     NETSTACK_LLSEC.send(packet_sent, fpld);
 
     return (int_fast8_t)0;
@@ -190,9 +249,27 @@ void heniKernelFrameReceiveFinish(
 {
     HENI_DASSERT(ker == &m_kernel);
     message_info_rx_t *msg = iovToRxMsg(fpld);
+#if HENI_PORT_RX_ZERO_COPY
+    queuebuf_free(msg->qbuf);
+#endif
     memb_free(&ReceivedMessageAllocator, msg);
 }
 
+#if HENI_KERNEL_WITH_STATS
+heni_stats_t * heniGetStats(void)
+{
+    return heniKernelAccessorsGetStatsForKernel(&m_kernel);
+}
+
+heni_stats_timestamp_t heniStatsGetTimestamp(
+        heni_kernel_t * ker
+)
+{
+    HENI_DASSERT(ker == &m_kernel);
+    return (heni_stats_timestamp_t)clock_time();
+}
+#endif
+
 int heniStartSending(heni_instance_id_t iid,
         heni_packet_addr_t const * paddr,
         heni_iobuf_list_t * ppld)
@@ -243,17 +320,46 @@ input(void)
   }
 
   original_datalen = packetbuf_datalen();
-  original_dataptr = packetbuf_dataptr();
-  memcpy(msg->data, original_dataptr, original_datalen);
-  heniIOBufNodeInitMem(&msg->iovNode, msg->data, original_datalen);
+#if HENI_PORT_RX_ZERO_COPY
+  // The framer has already reduced the MAC header, so the queuebuf
+  // holds only what is left in front of the payload (usually nothing)
+  // and the payload itself, which ends the queuebuf. It stays with
+  // the message until the kernel is done with it.
+  msg->qbuf = queuebuf_new_from_packetbuf();
+  if (msg->qbuf == NULL) {
+    PRINTF("queuebuf_new_from_packetbuf failed to allocate a buffer\n");
+    memb_free(&ReceivedMessageAllocator, msg);
+    return;
+  }
+  original_dataptr = (uint8_t *)queuebuf_dataptr(msg->qbuf)
+      + queuebuf_datalen(msg->qbuf) - original_datalen;
+#else
+  if (original_datalen > MAX_MESSAGE_SIZE) {
+    PRINTF("Payload too big\n");
+    memb_free(&ReceivedMessageAllocator, msg);
+    return;
+  }
+  original_dataptr = msg->data;
+  memcpy(original_dataptr, packetbuf_dataptr(), original_datalen);
+#endif
+  heniIOBufNodeInitMem(&msg->iovNode, original_dataptr, original_datalen);
   heniIOBufListInit(&msg->iovList);
   heniIOBufNodeAddBack(&msg->iovList, &msg->iovNode);
-  heniKernelFrameReceiveStart(&m_kernel, &faddr, &msg->iovList, &finfo);
+  if (heniKernelFrameReceiveStart(&m_kernel, &faddr, &msg->iovList, &finfo) != 0) {
+    PRINTF("heniKernelFrameReceiveStart rejected a frame\n");
+#if HENI_PORT_RX_ZERO_COPY
+    queuebuf_free(msg->qbuf);
+#endif
+    memb_free(&ReceivedMessageAllocator, msg);
+  }
 }
 /*---------------------------------------------------------------------------*/
 static void
 init(void)
 {
+  linkaddr_t unicast;
+  int budget;
+
   queuebuf_init();
   packetbuf_clear();
   PT_INIT(&computation_thread_pt);
@@ -264,6 +370,17 @@ init(void)
   memb_init(&ZoneAllocator);
   memb_init(&ReceivedMessageAllocator);
   heniKernelInit(&m_kernel);
+  /* Fragment for the header of a unicast frame, which is the longest */
+  memset(&unicast, 0x01, sizeof(unicast));
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &unicast);
+  budget = frame_payload_budget();
+  if(budget < 0) {
+    budget = MAX_FRAME_SIZE - FCS_LEN - FIXED_HDRLEN;
+  }
+  packetbuf_clear();
+  heniKernelSetMaxFramePayloadSize(&m_kernel,
+      budget < MAX_MESSAGE_SIZE ? budget : MAX_MESSAGE_SIZE);
   heniKernelInstanceStart(&m_kernel, 1);
 }
 
@@ -19,6 +19,27 @@ extern const struct network_driver heni_driver;
 #define HENI_PORT_DEFAULT_MAX_NEIGHBORS 10
 #define HENI_PORT_DEFAULT_MAX_ZONES 10
 #define MAX_MESSAGE_SIZE 256
+
+/* When enabled, a received frame is kept in a queuebuf and the kernel
+   reads it in place; otherwise, it is copied into the message itself.
+   Swapped-out queuebufs have no stable data pointer, hence the default.
+   A received frame holds its queuebuf until the application calls
+   heniReceiveFinish, so up to HENI_PORT_DEFAULT_MAX_PACKETS queuebufs
+   (one per received message) are taken from the QUEUEBUF_NUM ones that
+   the MAC layer also uses for transmission. */
+#ifdef HENI_PORT_CONF_RX_ZERO_COPY
+#define HENI_PORT_RX_ZERO_COPY HENI_PORT_CONF_RX_ZERO_COPY
+#elif WITH_SWAP
+#define HENI_PORT_RX_ZERO_COPY 0
+#else
+#define HENI_PORT_RX_ZERO_COPY 1
+#endif
+#if HENI_PORT_RX_ZERO_COPY && WITH_SWAP
+#error "HENI zero-copy reception requires queuebufs to stay in RAM"
+#endif
+#if HENI_PORT_RX_ZERO_COPY && QUEUEBUF_NUM <= HENI_PORT_DEFAULT_MAX_PACKETS
+#error "HENI zero-copy reception would leave no queuebufs for transmission"
+#endif
 typedef void (*sent_callback)(heni_packet_addr_t const *, heni_iobuf_list_t *, heni_packet_tx_info_t const *);
 typedef int (*received_callback)(heni_packet_addr_t const *, heni_iobuf_list_t *, heni_packet_rx_info_t const *);
 
@@ -30,11 +51,20 @@ void heniSetCallbacks(sent_callback _sent_callback, received_callback _received_
 
 void heniReceiveFinish(heni_iobuf_list_t * fpld);
 
+#if HENI_KERNEL_WITH_STATS
+/* The run-time statistics of the kernel, e.g., for the heni-stats shell command. */
+heni_stats_t * heniGetStats(void);
+#endif
+
 typedef struct message_info_rx
 {
     heni_iobuf_list_t         iovList;
     heni_iobuf_list_node_t    iovNode;
-    char *data[MAX_MESSAGE_SIZE];
+#if HENI_PORT_RX_ZERO_COPY
+    struct queuebuf *         qbuf;
+#else
+    uint8_t                   data[MAX_MESSAGE_SIZE];
+#endif
 } message_info_rx_t;
 
 #endif /* HENI_WRAPPER_H_ */
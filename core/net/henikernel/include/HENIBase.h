@@ -277,6 +277,22 @@ typedef struct heni_kernel_s   heni_kernel_t;
 
 
 
+struct heni_zone_table_s;
+/**
+ * A zone table in HENI.
+ */
+typedef struct heni_zone_table_s   heni_zone_table_t;
+
+
+
+struct heni_neighbor_table_s;
+/**
+ * A neighbor table in HENI.
+ */
+typedef struct heni_neighbor_table_s   heni_neighbor_table_t;
+
+
+
 struct heni_packet_addr_s;
 /** Addressing information for a HENI packet. */
 typedef struct heni_packet_addr_s   heni_packet_addr_t;
@@ -297,6 +313,12 @@ enum
     HENI_PACKET_ROUTING_ERROR_OUT_OF_TOKENS,
     HENI_PACKET_ROUTING_ERROR_HOP_BY_HOP_ACK_FAILED,
     HENI_PACKET_ROUTING_ERROR_NOT_FOR_ME,
+    HENI_PACKET_ROUTING_ERROR_NO_ROUTE,
+    HENI_PACKET_ROUTING_ERROR_PAYLOAD_TOO_LARGE,
+    HENI_PACKET_ROUTING_ERROR_MALFORMED_FRAME,
+    HENI_PACKET_ROUTING_ERROR_UNEXPECTED_FRAGMENT,
+    /* ------------------------------------------------------------------ */
+    HENI_PACKET_ROUTING_ERROR_COUNT,
 };
 
 
@@ -13,6 +13,7 @@
 #include "HENILinkedList.h"
 #include "HENIPacket.h"
 #include "HENIScheduler.h"
+#include "HENIStats.h"
 #include "HENIVectoredIO.h"
 
 
@@ -28,6 +29,84 @@
  *                                                                        *
  * ---------------------------------------------------------------------- */
 
+/**
+ * The default maximal number of packets that a single
+ * packet-processing task of a HENI kernel handles per
+ * list in one dispatch before reposting itself.
+ */
+#ifndef HENI_KERNEL_TASK_BATCH_LIMIT
+#define HENI_KERNEL_TASK_BATCH_LIMIT 4
+#else
+#if ((HENI_KERNEL_TASK_BATCH_LIMIT) <= 0 || (HENI_KERNEL_TASK_BATCH_LIMIT) > 255)
+#error "HENI_KERNEL_TASK_BATCH_LIMIT must be between 1 and 255!"
+#endif /* HENI_KERNEL_TASK_BATCH_LIMIT out of bounds */
+#endif /* HENI_KERNEL_TASK_BATCH_LIMIT */
+
+/** A type holding the number of packets processed by a task in one dispatch. */
+typedef uint_fast8_t   heni_kernel_task_batch_t;
+
+/**
+ * The maximal number of frames that a HENI kernel
+ * may have handed over to the lower layer without
+ * having been notified that their transmission
+ * has finished.
+ */
+#ifndef HENI_KERNEL_MAX_FRAMES_IN_FLIGHT
+#define HENI_KERNEL_MAX_FRAMES_IN_FLIGHT 4
+#else
+#if ((HENI_KERNEL_MAX_FRAMES_IN_FLIGHT) <= 0 || (HENI_KERNEL_MAX_FRAMES_IN_FLIGHT) > 255)
+#error "HENI_KERNEL_MAX_FRAMES_IN_FLIGHT must be between 1 and 255!"
+#endif /* HENI_KERNEL_MAX_FRAMES_IN_FLIGHT out of bounds */
+#endif /* HENI_KERNEL_MAX_FRAMES_IN_FLIGHT */
+
+/** A type holding the number of frames being transmitted. */
+typedef uint_fast8_t   heni_kernel_frame_count_t;
+
+/**
+ * The number of bytes of the header that a HENI
+ * kernel prepends to each frame of a packet: a packet
+ * tag, flags, and the offset of the fragment within
+ * the packet payload.
+ */
+#define HENI_KERNEL_FRAGMENT_HEADER_SIZE 4
+
+/**
+ * The default maximal number of payload bytes, including
+ * the fragment header, that a HENI kernel puts into a single
+ * frame. Packets with larger payloads are fragmented.
+ */
+#ifndef HENI_KERNEL_DEFAULT_MAX_FRAME_PAYLOAD_SIZE
+#define HENI_KERNEL_DEFAULT_MAX_FRAME_PAYLOAD_SIZE 96
+#else
+#if ((HENI_KERNEL_DEFAULT_MAX_FRAME_PAYLOAD_SIZE) <= (HENI_KERNEL_FRAGMENT_HEADER_SIZE) || (HENI_KERNEL_DEFAULT_MAX_FRAME_PAYLOAD_SIZE) > 65535)
+#error "HENI_KERNEL_DEFAULT_MAX_FRAME_PAYLOAD_SIZE must be greater than the fragment header and at most 65535!"
+#endif /* HENI_KERNEL_DEFAULT_MAX_FRAME_PAYLOAD_SIZE out of bounds */
+#endif /* HENI_KERNEL_DEFAULT_MAX_FRAME_PAYLOAD_SIZE */
+
+/**
+ * The maximal number of frames into which
+ * a HENI kernel may fragment a single packet.
+ */
+#ifndef HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET
+#define HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET 4
+#else
+#if ((HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET) <= 0 || (HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET) > 255)
+#error "HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET must be between 1 and 255!"
+#endif /* HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET out of bounds */
+#endif /* HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET */
+
+/**
+ * The maximal number of packets that a single HENI
+ * instance may be reassembling from fragments at
+ * the same time.
+ */
+#ifndef HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE
+#define HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE 2
+#else
+#if ((HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE) <= 0 || (HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE) > 255)
+#error "HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE must be between 1 and 255!"
+#endif /* HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE out of bounds */
+#endif /* HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE */
 
 
 
@@ -127,6 +206,63 @@ HENI_API_FUNCT_DEC_PREFIX int_fast8_t heniKernelInstanceIsStopping(
         heni_instance_id_t iid
 ) HENI_API_FUNCT_DEC_SUFFIX;
 
+/**
+ * Sets the neighbor table that a HENI kernel
+ * consults when selecting next hops for packets.
+ * The table must remain valid until it is
+ * replaced or the kernel is cleaned up.
+ * @param ker The HENI kernel.
+ * @param nbt The neighbor table or NULL if
+ *   the kernel is not to use any. In the latter
+ *   case, packets are forwarded to all neighbors.
+ */
+HENI_API_FUNCT_DEC_PREFIX void heniKernelSetNeighborTable(
+        heni_kernel_t * ker,
+        heni_neighbor_table_t * nbt
+) HENI_API_FUNCT_DEC_SUFFIX;
+
+/**
+ * Sets the maximal number of bytes that a HENI kernel
+ * may pass to the lower layer in a single frame. Packets
+ * whose payloads, together with the fragment header, do
+ * not fit into one frame are fragmented and reassembled
+ * at the receiver.
+ * @param ker The HENI kernel.
+ * @param size The maximal size of a frame payload.
+ * @return Zero if the size has been set or a negative
+ *   value if the size cannot accommodate the fragment
+ *   header or the largest packet would not be
+ *   addressable by fragment offsets.
+ */
+HENI_API_FUNCT_DEC_PREFIX int_fast8_t heniKernelSetMaxFramePayloadSize(
+        heni_kernel_t * ker,
+        size_t size
+) HENI_API_FUNCT_DEC_SUFFIX;
+
+/**
+ * Sets the routing state of a running HENI instance,
+ * that is, the label of the present node and the
+ * zone table, the entries of which provide next
+ * hops toward the zones. The zone table must have
+ * been initialized for the instance and must remain
+ * valid until the instance has stopped.
+ * @param ker The HENI kernel.
+ * @param iid The ID of the instance.
+ * @param labPtr A pointer to the label of the present
+ *   node. The label is copied to the kernel.
+ * @param zt The zone table or NULL if the instance is
+ *   not to use any. In the latter case, packets of
+ *   the instance are forwarded to all neighbors.
+ * @return Zero if the state has been set or a negative
+ *   value if the instance is not running.
+ */
+HENI_API_FUNCT_DEC_PREFIX int_fast8_t heniKernelInstanceSetRoutingState(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid,
+        uint8_t const * labPtr,
+        heni_zone_table_t * zt
+) HENI_API_FUNCT_DEC_SUFFIX;
+
 /**
  * Schedules execution of deferred computations
  * within a HENI kernel. The computations are
@@ -491,6 +627,46 @@ HENI_INL_FUNCT_DEC_PREFIX heni_kernel_t * heniKernelAccessorsGetKernelForSchedul
         heni_kernel_task_scheduler_t * ker
 ) HENI_INL_FUNCT_DEC_SUFFIX;
 
+#if HENI_KERNEL_WITH_STATS
+
+/**
+ * Returns the run-time statistics of
+ * a given HENI kernel.
+ * @param ker The HENI kernel.
+ * @return The statistics of the kernel.
+ */
+HENI_INL_FUNCT_DEC_PREFIX heni_stats_t * heniKernelAccessorsGetStatsForKernel(
+        heni_kernel_t * ker
+) HENI_INL_FUNCT_DEC_SUFFIX;
+
+#endif /* HENI_KERNEL_WITH_STATS */
+
+/**
+ * Returns the maximal number of packets that
+ * a packet-processing task of a given HENI kernel
+ * handles per list in a single dispatch.
+ * @param ker The HENI kernel.
+ * @return The batch limit of the kernel.
+ */
+HENI_INL_FUNCT_DEC_PREFIX heni_kernel_task_batch_t heniKernelAccessorsGetTaskBatchLimit(
+        heni_kernel_t const * ker
+) HENI_INL_FUNCT_DEC_SUFFIX;
+
+/**
+ * Sets the maximal number of packets that
+ * a packet-processing task of a given HENI kernel
+ * handles per list in a single dispatch.
+ * The kernel is initialized with
+ * HENI_KERNEL_TASK_BATCH_LIMIT.
+ * @param ker The HENI kernel.
+ * @param limit The new batch limit, which must
+ *   be positive.
+ */
+HENI_INL_FUNCT_DEC_PREFIX void heniKernelAccessorsSetTaskBatchLimit(
+        heni_kernel_t * ker,
+        heni_kernel_task_batch_t limit
+) HENI_INL_FUNCT_DEC_SUFFIX;
+
 
 
 /* ---------------------------------------------------------------------- *
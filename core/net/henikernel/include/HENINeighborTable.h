@@ -20,10 +20,36 @@
  */
 
 /**
- * A neighbor table in HENI.
- */
-struct heni_neighbor_table_s;
-typedef struct heni_neighbor_table_s   heni_neighbor_table_t;
+ * If nonzero, a HENI neighbor table is an open-addressing
+ * hash table whose elements are groups of neighbor slots.
+ * Each group keeps a one-byte fingerprint of the link-layer
+ * address hash for every slot next to the slot pointers,
+ * so that most probes for absent neighbors are rejected
+ * without dereferencing any neighbor entry.
+ * Otherwise, each element of a neighbor table is a bucket
+ * with a list of neighbors sorted by their addresses.
+ */
+#ifndef HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS
+#define HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS 0
+#else
+#if ((HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS) != 0 && (HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS) != 1)
+#error "HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS must be either 0 or 1!"
+#endif /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS out of bounds */
+#endif /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
+
+/**
+ * The number of neighbor slots in an element of
+ * a HENI neighbor table with fingerprints.
+ * The fingerprints of a group are probed together,
+ * so the group should fit in a few cache lines.
+ */
+#ifndef HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM
+#define HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM 8
+#else
+#if ((HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM) <= 0 || (HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM) > 255)
+#error "HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM must be between 1 and 255!"
+#endif /* HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM out of bounds */
+#endif /* HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM */
 
 /**
  * An element of a neighbor table in HENI.
@@ -56,6 +82,9 @@ typedef struct heni_neighbor_table_piter_s    heni_neighbor_table_piter_t;
  * @param bufPtr A pointer to the memory buffer
  *   that will hold the table.
  * @param bufLen The length of the memory buffer.
+ *   With fingerprints, the table can hold at most
+ *   bufLen * HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM
+ *   neighbors.
  */
 HENI_API_FUNCT_DEC_PREFIX void heniNeighborTableInit(
         heni_neighbor_table_t * nbt,
@@ -69,6 +98,8 @@ HENI_API_FUNCT_DEC_PREFIX void heniNeighborTableInit(
  * address to a HENI neighbor table. An entry with
  * the same link-layer address must not exist in
  * the table; otherwise, a fatal error occurs.
+ * With fingerprints, the same holds if the table
+ * is full.
  * @param nbt The neighbor table.
  * @param laddrPtr The link address.
  * @param nbr The neighbor entry.
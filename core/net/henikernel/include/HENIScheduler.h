@@ -17,9 +17,45 @@
  */
 
 
+/**
+ * Determines whether the scheduler of a HENI kernel
+ * maintains, for every task, the number of times the
+ * task has been run and the maximal latency with which
+ * it has been run after having been scheduled.
+ */
+#ifndef HENI_KERNEL_TASK_WITH_STATS
+#define HENI_KERNEL_TASK_WITH_STATS 0
+#else
+#if ((HENI_KERNEL_TASK_WITH_STATS) != 0 && (HENI_KERNEL_TASK_WITH_STATS) != 1)
+#error "HENI_KERNEL_TASK_WITH_STATS must be either 0 or 1!"
+#endif /* HENI_KERNEL_TASK_WITH_STATS out of bounds */
+#endif /* HENI_KERNEL_TASK_WITH_STATS */
+
+
+
 /** A type holding the number of HENI kernel tasks. */
 typedef uint_fast8_t   heni_kernel_task_count_t;
 
+/** A type holding the priority class of a HENI kernel task. */
+typedef uint_fast8_t   heni_kernel_task_prio_t;
+
+/** A type holding a statistic of a HENI kernel task. */
+typedef uint32_t   heni_kernel_task_stat_t;
+
+/**
+ * The priority classes of HENI kernel tasks.
+ * A task is extracted only if no task of a
+ * higher class (with a lower number) has been
+ * scheduled. Tasks of the same class are
+ * extracted in the order of their scheduling.
+ */
+enum
+{
+    HENI_KERNEL_TASK_PRIO_HIGH = 0,
+    HENI_KERNEL_TASK_PRIO_LOW = 1,
+    HENI_KERNEL_TASK_PRIO_COUNT = 2,
+};
+
 
 
 struct heni_kernel_task_scheduler_s;
@@ -85,7 +121,9 @@ HENI_HID_FUNCT_DEC_PREFIX int_fast8_t heniKernelTaskSchedulerAddTask(
 
 /**
  * Extracts the next task that should be executed
- * within a HENI kernel. There must be a task
+ * within a HENI kernel, that is, the earliest
+ * scheduled task of the highest priority class
+ * among the scheduled tasks. There must be a task
  * to be executed.
  * @param sched The scheduler.
  * @return The identifier of the task that should
@@ -105,6 +143,60 @@ HENI_HID_FUNCT_DEC_PREFIX void heniKernelTaskSchedulerExecuteTask(
         heni_kernel_task_count_t taskId
 ) HENI_HID_FUNCT_DEC_SUFFIX;
 
+/**
+ * Returns the priority class of a given
+ * HENI kernel task.
+ * @param taskId The identifier of the task.
+ * @return The priority class of the task.
+ */
+HENI_HID_FUNCT_DEC_PREFIX heni_kernel_task_prio_t heniKernelTaskSchedulerGetTaskPriority(
+        heni_kernel_task_count_t taskId
+) HENI_HID_FUNCT_DEC_SUFFIX;
+
+#if HENI_KERNEL_TASK_WITH_STATS
+
+/**
+ * Returns the number of times a given task
+ * has been extracted for execution by a HENI
+ * kernel scheduler since the scheduler was
+ * initialized or its statistics were reset.
+ * @param sched The scheduler.
+ * @param taskId The identifier of the task.
+ * @return The number of runs of the task.
+ */
+HENI_INL_FUNCT_DEC_PREFIX heni_kernel_task_stat_t heniKernelTaskSchedulerGetNumRuns(
+        heni_kernel_task_scheduler_t const * sched,
+        heni_kernel_task_count_t taskId
+) HENI_INL_FUNCT_DEC_SUFFIX;
+
+/**
+ * Returns the maximal latency with which a given
+ * task has been extracted for execution by a HENI
+ * kernel scheduler since the scheduler was
+ * initialized or its statistics were reset.
+ * The latency is measured as the number of other
+ * tasks extracted between scheduling the task
+ * and extracting it.
+ * @param sched The scheduler.
+ * @param taskId The identifier of the task.
+ * @return The maximal latency of the task.
+ */
+HENI_INL_FUNCT_DEC_PREFIX heni_kernel_task_stat_t heniKernelTaskSchedulerGetMaxLatency(
+        heni_kernel_task_scheduler_t const * sched,
+        heni_kernel_task_count_t taskId
+) HENI_INL_FUNCT_DEC_SUFFIX;
+
+/**
+ * Resets the statistics of all tasks
+ * of a HENI kernel scheduler.
+ * @param sched The scheduler.
+ */
+HENI_HID_FUNCT_DEC_PREFIX void heniKernelTaskSchedulerResetStats(
+        heni_kernel_task_scheduler_t * sched
+) HENI_HID_FUNCT_DEC_SUFFIX;
+
+#endif /* HENI_KERNEL_TASK_WITH_STATS */
+
 /**
  * Cleans up a scheduler for deferred computations,
  * so-called tasks, within a HENI kernel.
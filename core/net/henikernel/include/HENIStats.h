@@ -0,0 +1,268 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+#ifndef __HENI_STATS_H__
+#define __HENI_STATS_H__
+
+#include "HENIBase.h"
+
+/**
+ * @file
+ * HENI: Run-time statistics of a HENI kernel: per-instance
+ * packet counters, broken down by routing status, and,
+ * for each internal packet queue of the kernel, its length,
+ * its high-water mark, and a histogram of the times that
+ * packets have spent in it.
+ */
+
+
+/**
+ * Determines whether a HENI kernel maintains
+ * run-time statistics. The platform must then
+ * provide heniStatsGetTimestamp.
+ */
+#ifndef HENI_KERNEL_WITH_STATS
+#define HENI_KERNEL_WITH_STATS 0
+#else
+#if ((HENI_KERNEL_WITH_STATS) != 0 && (HENI_KERNEL_WITH_STATS) != 1)
+#error "HENI_KERNEL_WITH_STATS must be either 0 or 1!"
+#endif /* HENI_KERNEL_WITH_STATS out of bounds */
+#endif /* HENI_KERNEL_WITH_STATS */
+
+/**
+ * The number of bins of a time-in-queue histogram.
+ * Bin 0 counts packets that have spent no time in
+ * a queue and bin i > 0 those that have spent
+ * between 2^(i-1) and 2^i - 1 timestamp units.
+ * The last bin also counts all longer times.
+ */
+#ifndef HENI_STATS_NUM_HISTOGRAM_BINS
+#define HENI_STATS_NUM_HISTOGRAM_BINS 8
+#else
+#if ((HENI_STATS_NUM_HISTOGRAM_BINS) < 2 || (HENI_STATS_NUM_HISTOGRAM_BINS) > 33)
+#error "HENI_STATS_NUM_HISTOGRAM_BINS must be between 2 and 33!"
+#endif /* HENI_STATS_NUM_HISTOGRAM_BINS out of bounds */
+#endif /* HENI_STATS_NUM_HISTOGRAM_BINS */
+
+
+
+/** A type holding a statistics counter. */
+typedef uint32_t   heni_stats_counter_t;
+
+/** A type holding a timestamp of the platform clock. */
+typedef uint32_t   heni_stats_timestamp_t;
+
+/** A type identifying a packet queue of a HENI kernel. */
+typedef uint_fast8_t   heni_stats_queue_t;
+
+/**
+ * The packet queues of a HENI kernel.
+ */
+enum
+{
+    /** Packets just passed to the kernel for sending. */
+    HENI_STATS_QUEUE_TO_SEND = 0,
+    /** Packets awaiting a free transmission slot. */
+    HENI_STATS_QUEUE_BEING_ROUTED,
+    /** Packets whose sending has completed, awaiting a signal to the user. */
+    HENI_STATS_QUEUE_ALREADY_SENT,
+    /** Reassembled packets awaiting delivery to the user. */
+    HENI_STATS_QUEUE_TO_RECEIVE,
+    /** Packets delivered to the user, awaiting a finish notification. */
+    HENI_STATS_QUEUE_ALREADY_RECEIVED,
+    /* ------------------------------------------------------------------ */
+    HENI_STATS_QUEUE_COUNT,
+};
+
+
+
+struct heni_stats_s;
+/**
+ * Run-time statistics of a HENI kernel.
+ */
+typedef struct heni_stats_s   heni_stats_t;
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                              Reading API                               *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+/**
+ * Returns the number of outgoing packets of a given
+ * HENI instance whose sending has finished with
+ * a given routing status. For a status other than
+ * HENI_PACKET_ROUTING_ERROR_NONE, this is the number
+ * of outgoing packets dropped for that reason, including
+ * those rejected already when sending was requested.
+ * @param stats The statistics.
+ * @param iid The identifier of the instance or
+ *   HENI_INSTANCE_ID_INVALID for packets that could
+ *   not be attributed to any instance.
+ * @param status The routing status.
+ * @return The number of packets.
+ */
+HENI_INL_FUNCT_DEC_PREFIX heni_stats_counter_t heniStatsGetNumTxPackets(
+        heni_stats_t const * stats,
+        heni_instance_id_t iid,
+        uint_fast8_t status
+) HENI_INL_FUNCT_DEC_SUFFIX;
+
+/**
+ * Returns the number of incoming packets of a given
+ * HENI instance that have been delivered to the user,
+ * for status HENI_PACKET_ROUTING_ERROR_NONE, or the
+ * number of incoming frames that have been dropped
+ * with a given status otherwise.
+ * @param stats The statistics.
+ * @param iid The identifier of the instance or
+ *   HENI_INSTANCE_ID_INVALID for frames that could
+ *   not be attributed to any instance.
+ * @param status The routing status.
+ * @return The number of packets or frames.
+ */
+HENI_INL_FUNCT_DEC_PREFIX heni_stats_counter_t heniStatsGetNumRxPackets(
+        heni_stats_t const * stats,
+        heni_instance_id_t iid,
+        uint_fast8_t status
+) HENI_INL_FUNCT_DEC_SUFFIX;
+
+/**
+ * Returns the number of packets that are
+ * currently in a given queue of a HENI kernel.
+ * @param stats The statistics.
+ * @param queue The queue.
+ * @return The length of the queue.
+ */
+HENI_INL_FUNCT_DEC_PREFIX heni_stats_counter_t heniStatsGetQueueLength(
+        heni_stats_t const * stats,
+        heni_stats_queue_t queue
+) HENI_INL_FUNCT_DEC_SUFFIX;
+
+/**
+ * Returns the maximal number of packets that
+ * have been in a given queue of a HENI kernel
+ * at the same time.
+ * @param stats The statistics.
+ * @param queue The queue.
+ * @return The high-water mark of the queue.
+ */
+HENI_INL_FUNCT_DEC_PREFIX heni_stats_counter_t heniStatsGetQueueHighWaterMark(
+        heni_stats_t const * stats,
+        heni_stats_queue_t queue
+) HENI_INL_FUNCT_DEC_SUFFIX;
+
+/**
+ * Returns the number of packets that have left
+ * a given queue of a HENI kernel after having spent
+ * in it a time falling into a given histogram bin
+ * (see HENI_STATS_NUM_HISTOGRAM_BINS).
+ * @param stats The statistics.
+ * @param queue The queue.
+ * @param bin The bin of the histogram.
+ * @return The number of packets.
+ */
+HENI_INL_FUNCT_DEC_PREFIX heni_stats_counter_t heniStatsGetQueueTimeHistogramBin(
+        heni_stats_t const * stats,
+        heni_stats_queue_t queue,
+        uint_fast8_t bin
+) HENI_INL_FUNCT_DEC_SUFFIX;
+
+/**
+ * Resets all counters, histograms, and high-water
+ * marks of HENI kernel statistics. The high-water
+ * marks start at the present queue lengths.
+ * @param stats The statistics.
+ */
+HENI_API_FUNCT_DEC_PREFIX void heniStatsReset(
+        heni_stats_t * stats
+) HENI_API_FUNCT_DEC_SUFFIX;
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                             Updating API                               *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+/**
+ * Initializes HENI kernel statistics.
+ * @param stats The statistics.
+ */
+HENI_HID_FUNCT_DEC_PREFIX void heniStatsInit(
+        heni_stats_t * stats
+) HENI_HID_FUNCT_DEC_SUFFIX;
+
+/**
+ * Accounts for an outgoing packet whose
+ * sending has finished with a given status.
+ * @param stats The statistics.
+ * @param iid The identifier of the instance.
+ * @param status The routing status.
+ */
+HENI_HID_FUNCT_DEC_PREFIX void heniStatsCountTxPacket(
+        heni_stats_t * stats,
+        heni_instance_id_t iid,
+        uint_fast8_t status
+) HENI_HID_FUNCT_DEC_SUFFIX;
+
+/**
+ * Accounts for an incoming packet delivered
+ * to the user or an incoming frame dropped
+ * with a given status.
+ * @param stats The statistics.
+ * @param iid The identifier of the instance.
+ * @param status The routing status.
+ */
+HENI_HID_FUNCT_DEC_PREFIX void heniStatsCountRxPacket(
+        heni_stats_t * stats,
+        heni_instance_id_t iid,
+        uint_fast8_t status
+) HENI_HID_FUNCT_DEC_SUFFIX;
+
+/**
+ * Accounts for a packet entering a queue.
+ * @param stats The statistics.
+ * @param queue The queue.
+ */
+HENI_HID_FUNCT_DEC_PREFIX void heniStatsCountQueueEntry(
+        heni_stats_t * stats,
+        heni_stats_queue_t queue
+) HENI_HID_FUNCT_DEC_SUFFIX;
+
+/**
+ * Accounts for a packet leaving a queue.
+ * @param stats The statistics.
+ * @param queue The queue.
+ * @param timeInQueue The time the packet
+ *   has spent in the queue.
+ */
+HENI_HID_FUNCT_DEC_PREFIX void heniStatsCountQueueExit(
+        heni_stats_t * stats,
+        heni_stats_queue_t queue,
+        heni_stats_timestamp_t timeInQueue
+) HENI_HID_FUNCT_DEC_SUFFIX;
+
+/**
+ * Returns the present time of a platform clock,
+ * which is used to measure the time that packets
+ * spend in the queues of a HENI kernel. The clock
+ * may wrap around. Implemented by the platform
+ * if HENI_KERNEL_WITH_STATS is set.
+ * @param ker The HENI kernel.
+ * @return The present timestamp.
+ */
+HENI_EXT_FUNCT_DEC_PREFIX heni_stats_timestamp_t heniStatsGetTimestamp(
+        heni_kernel_t * ker
+) HENI_EXT_FUNCT_DEC_SUFFIX;
+
+#include "detail/HENIStatsDetail.h"
+
+#endif /* __HENI_STATS_H__ */
@@ -10,6 +10,7 @@
 
 #include "HENIBase.h"
 #include "HENILabel.h"
+#include "HENILinkAddress.h"
 
 /**
  * @file
@@ -43,6 +44,31 @@ HENI_INL_FUNCT_DEC_PREFIX heni_zone_discr_t heniZoneEntryGetDiscr(
         heni_zone_t const * zone
 ) HENI_INL_FUNCT_DEC_SUFFIX;
 
+/**
+ * Returns a pointer to the link-layer address of
+ * the neighbor through which the zone corresponding
+ * to a zone entry can be reached. The address can
+ * be modified through the pointer. Until it has been
+ * set, the address is undefined.
+ * @param zone The zone entry.
+ * @return A pointer to the next-hop link-layer address.
+ */
+HENI_INL_FUNCT_DEC_PREFIX uint8_t * heniZoneEntryGetNextHopLinkAddrPtr(
+        heni_zone_t * zone
+) HENI_INL_FUNCT_DEC_SUFFIX;
+
+/**
+ * Returns a pointer to the link-layer address of
+ * the neighbor through which the zone corresponding
+ * to a zone entry can be reached. The address can
+ * only be read.
+ * @param zone The zone entry.
+ * @return A pointer to the next-hop link-layer address.
+ */
+HENI_INL_FUNCT_DEC_PREFIX uint8_t const * heniZoneEntryGetNextHopLinkAddrConstPtr(
+        heni_zone_t const * zone
+) HENI_INL_FUNCT_DEC_SUFFIX;
+
 /**
  * Allocates an entry for a HENI zone table.
  * @param ker The HENI kernel for which
@@ -20,14 +20,25 @@
  */
 
 /**
- * A zone table in HENI.
+ * If nonzero, a HENI zone table keeps the zones of
+ * each level in a contiguous array sorted by LID
+ * and discriminator, which is searched by bisection.
+ * Otherwise, the zones of a level are hashed by LID
+ * into buckets, each of which is a linked list.
  */
-struct heni_zone_table_s;
-typedef struct heni_zone_table_s   heni_zone_table_t;
+#ifndef HENI_ZONE_TABLE_WITH_SORTED_ROWS
+#define HENI_ZONE_TABLE_WITH_SORTED_ROWS 0
+#else
+#if ((HENI_ZONE_TABLE_WITH_SORTED_ROWS) != 0 && (HENI_ZONE_TABLE_WITH_SORTED_ROWS) != 1)
+#error "HENI_ZONE_TABLE_WITH_SORTED_ROWS must be either 0 or 1!"
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS out of bounds */
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
 
 /**
  * A bucket in a HENI zone table.
- * It corresponds to a hierarchy level.
+ * With hashed rows, it is a list of zones with
+ * some LIDs at a hierarchy level. With sorted
+ * rows, it is a slot for one zone of a level.
  */
 struct heni_zone_table_bucket_s;
 typedef struct heni_zone_table_bucket_s   heni_zone_table_bucket_t;
@@ -65,7 +76,8 @@ typedef struct heni_zone_table_piter_s    heni_zone_table_piter_t;
  *   the length given as the next parameter. These
  *   tables will be taken over by the zone table.
  * @param bucketCountPerRow The length of each of
- *   the bucket tables.
+ *   the bucket tables. With sorted rows, it is
+ *   also the maximal number of zones per level.
  */
 HENI_API_FUNCT_DEC_PREFIX void heniZoneTableInit(
         heni_zone_table_t * zt,
@@ -79,6 +91,8 @@ HENI_API_FUNCT_DEC_PREFIX void heniZoneTableInit(
  * and discriminator to a HENI neighbor table.
  * An entry with the same data must not exist in
  * the table; otherwise, a fatal error occurs.
+ * With sorted rows, the same holds if the row
+ * for the level is full.
  * @param zt The zone table.
  * @param level The level.
  * @param lid The LID.
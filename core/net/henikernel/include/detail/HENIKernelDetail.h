@@ -25,6 +25,45 @@
 #define heniKernelIdxToIID(idx) ((idx) + 1)
 
 
+#define heniKernelGetReassemblyPtrFromPayloadPtr(iolp) \
+    (heni_kernel_reassembly_t *)((uint8_t *)(iolp) - offsetof(struct heni_kernel_reassembly_s, ppld))
+
+#define HENI_KERNEL_FRAGMENT_HEADER_FLAG_MORE 0x01
+
+
+
+/**
+ * A frame received as a fragment of a packet. The
+ * frame payload retains the fragment header, whereas
+ * the remainder of the payload is lent to the packet
+ * being reassembled.
+ */
+typedef struct heni_kernel_rx_fragment_s
+{
+    heni_iobuf_list_t *      fpld;
+    heni_iobuf_list_node_t   extraNode;
+    uint16_t                 len;
+} heni_kernel_rx_fragment_t;
+
+
+/**
+ * A buffer in which a packet is reassembled
+ * from its fragments.
+ */
+typedef struct heni_kernel_reassembly_s
+{
+    /** The packet or NULL if the buffer is free. */
+    heni_packet_t *             packet;
+    heni_iobuf_list_t           ppld;
+    uint16_t                    offset;
+    uint8_t                     tag;
+    uint8_t                     stamp;
+    uint8_t                     complete;
+    uint8_t                     numFragments;
+    heni_kernel_rx_fragment_t   fragments[HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET];
+} heni_kernel_reassembly_t;
+
+
 
 struct heni_instance_s
 {
@@ -33,10 +72,39 @@ struct heni_instance_s
     heni_instance_id_t   iid;
     heni_lspec_t         lspec;
     uint8_t              logNumZoneDiscrBitsPlusOne; // 0,1,2,4,8,16,32,64 //0,1,2,3,4,5,6,7
+    heni_zone_table_t *      zoneTable;
+    heni_label_container_t   label;
+    heni_kernel_reassembly_t   reassemblies[HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE];
+    uint8_t                    reassemblyClock;
 };
 
 
 
+/**
+ * A transmission slot of a HENI kernel, which holds a
+ * packet from sending its first fragment until sending
+ * its last fragment has finished. The payload of the
+ * packet is split into fragments in place: the fragment
+ * being sent is borrowed into the frame payload and the
+ * fragments already sent are returned to the packet.
+ */
+typedef struct heni_kernel_tx_slot_s
+{
+    /** The packet or NULL if the slot is free. */
+    heni_packet_t *          packet;
+    heni_iobuf_list_t        fpld;
+    heni_iobuf_list_t        rest;
+    heni_iobuf_list_node_t   hdrNode;
+    heni_iobuf_list_node_t   extraNodes[2];
+    uint16_t                 offset;
+    uint8_t                  tag;
+    uint8_t                  nextExtraNodeIdx;
+    uint8_t                  frameInFlight;
+    uint8_t                  hdr[HENI_KERNEL_FRAGMENT_HEADER_SIZE];
+} heni_kernel_tx_slot_t;
+
+
+
 typedef struct heni_kernel_instance_flags_s
 {
     uint_fast8_t   running[HENI_MAX_NUM_INSTANCE_FLAGS];
@@ -52,6 +120,7 @@ struct heni_kernel_s
     heni_kernel_instance_flags_t   instanceFlags;
     heni_instance_count_t          numRunningInstances;
     heni_instance_count_t          numStoppingInstances;
+    heni_kernel_task_batch_t       taskBatchLimit;
     /** Packets just passed to the HENI kernel for sending. */
     heni_linked_list_t             pktsToSend;
     /** Packets whose sending has completed that await only a signal to the user. */
@@ -60,8 +129,16 @@ struct heni_kernel_s
     heni_linked_list_t             pktsToReceive;
     /** Packets being received, awaiting a finish notification. */
     heni_linked_list_t             pktsAlreadyReceived;
-    /** Packets currently being routed. */
-    heni_linked_list_t             pktsBeingRouted;  ///< FIXME: this is rather a temporary structure
+    /** Packets currently being routed, awaiting a free transmission slot. */
+    heni_linked_list_t             pktsBeingRouted;
+    heni_kernel_frame_count_t      numFramesInFlight;
+    heni_neighbor_table_t *        neighborTable;
+    heni_kernel_tx_slot_t          txSlots[HENI_KERNEL_MAX_FRAMES_IN_FLIGHT];
+    uint16_t                       maxFramePayloadSize;
+    uint8_t                        nextFragmentTag;
+#if HENI_KERNEL_WITH_STATS
+    heni_stats_t                   stats;
+#endif /* HENI_KERNEL_WITH_STATS */
 };
 
 
@@ -100,6 +177,39 @@ HENI_INL_FUNCT_DEF_PREFIX heni_kernel_t * heniKernelAccessorsGetKernelForSchedul
 
 
 
+#if HENI_KERNEL_WITH_STATS
+
+HENI_INL_FUNCT_DEF_PREFIX heni_stats_t * heniKernelAccessorsGetStatsForKernel(
+        heni_kernel_t * ker
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    return &ker->stats;
+}
+
+#endif /* HENI_KERNEL_WITH_STATS */
+
+
+
+HENI_INL_FUNCT_DEF_PREFIX heni_kernel_task_batch_t heniKernelAccessorsGetTaskBatchLimit(
+        heni_kernel_t const * ker
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    return ker->taskBatchLimit;
+}
+
+
+
+HENI_INL_FUNCT_DEF_PREFIX void heniKernelAccessorsSetTaskBatchLimit(
+        heni_kernel_t * ker,
+        heni_kernel_task_batch_t limit
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(limit > 0);
+    ker->taskBatchLimit = limit;
+}
+
+
+
 /**
  * This is a private implementation function.
  *
@@ -141,7 +141,9 @@ HENI_INL_FUNCT_DEF_PREFIX heni_zone_discr_t heniZoneDiscrSpecGetZoneDiscrAny(
         uint8_t numDiscrBits
 ) HENI_INL_FUNCT_DEF_SUFFIX
 {
-    return numDiscrBits == 0 ? (heni_zone_discr_t)0 : (((heni_zone_discr_t)1 << numDiscrBits) - 1);
+    return numDiscrBits == 0 ? (heni_zone_discr_t)0 :
+            (numDiscrBits >= (sizeof(heni_zone_discr_t) << 3) ? ~(heni_zone_discr_t)0 :
+                    (((heni_zone_discr_t)1 << numDiscrBits) - 1));
 }
 
 
@@ -17,11 +17,30 @@
 
 
 
+#if ! HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS
+
 struct heni_neighbor_table_elem_s
 {
     heni_linked_list_t   bucketList;
 };
 
+#else /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
+
+/** A fingerprint of a slot that has never been used. */
+#define HENI_NEIGHBOR_TABLE_FINGERPRINT_EMPTY 0
+/** A fingerprint of a slot whose neighbor has been removed. */
+#define HENI_NEIGHBOR_TABLE_FINGERPRINT_DELETED 1
+/** The smallest fingerprint of a slot holding a neighbor. */
+#define HENI_NEIGHBOR_TABLE_FINGERPRINT_MIN_USED 2
+
+struct heni_neighbor_table_elem_s
+{
+    uint8_t             fingerprints[HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM];
+    heni_neighbor_t *   neighbors[HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM];
+};
+
+#endif /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
+
 
 struct heni_neighbor_table_s
 {
@@ -31,6 +50,8 @@ struct heni_neighbor_table_s
 };
 
 
+#if ! HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS
+
 struct heni_neighbor_table_titer_s
 {
     heni_neighbor_table_t *    nbt;
@@ -45,6 +66,27 @@ struct heni_neighbor_table_piter_s
     heni_link_addr_container_t   currNeighborLinkAddr;
 };
 
+#else /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
+
+struct heni_neighbor_table_titer_s
+{
+    heni_neighbor_table_t *    nbt;
+    size_t                     bucketIdx;
+    size_t                     slotIdx;
+};
+
+
+struct heni_neighbor_table_piter_s
+{
+    heni_neighbor_table_t *      nbt;
+    heni_link_addr_container_t   currNeighborLinkAddr;
+    size_t                       bucketIdx;  /* neighbors never move, */
+    size_t                       slotIdx;    /* so this is where to   */
+                                             /* resume if it is gone  */
+};
+
+#endif /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
+
 /**
  * This is a private implementation function.
  *
@@ -73,6 +115,9 @@ HENI_INL_FUNCT_DEC_PREFIX size_t heniNeighborTableGetBucketForLinkAddr(
  * @param laddrPtr A pointer to the link-layer address.
  * @return Nonzero if the neighbor exists in the table
  *   or zero otherwise.
+ * With fingerprints, the insertion position is the first
+ * free slot on the probe sequence for the address, or
+ * the iterator is finished if the table is full.
  */
 HENI_HID_FUNCT_DEC_PREFIX int_fast8_t heniNeighborTableTIterInitAtOrBeforeNeighbor(
         heni_neighbor_table_titer_t * nbtti,
@@ -121,9 +166,13 @@ HENI_INL_FUNCT_DEF_PREFIX heni_neighbor_t * heniNeighborTableTIterGetNeighbor(
 ) HENI_INL_FUNCT_DEF_SUFFIX
 {
     HENI_DASSERT(heniNeighborTableTIterIsActive(nbtti));
+#if ! HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS
     return heniNeighborEntryFromBucketListNode(
             heniLinkedListFIterGetNode(&nbtti->bucketIter)
     );
+#else
+    return nbtti->nbt->bucketsPtr[nbtti->bucketIdx].neighbors[nbtti->slotIdx];
+#endif /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
 }
 
 
@@ -15,6 +15,7 @@
 #include <string.h>
 #include "HENILinkAddress.h"
 #include "HENILinkedList.h"
+#include "HENIStats.h"
 #include "HENIVectoredIO.h"
 
 
@@ -54,7 +55,12 @@ struct heni_packet_s
     heni_packet_addr_t           paddr;
     heni_iobuf_list_t *          ppld;
     heni_link_addr_container_t   linkLayerSrcNeighborAddr;
+    heni_link_addr_container_t   linkLayerDstNeighborAddr;
     heni_packet_op_info_t        opInfo;
+#if HENI_KERNEL_WITH_STATS
+    /** The time the packet entered its present kernel queue. */
+    heni_stats_timestamp_t       queuedAt;
+#endif /* HENI_KERNEL_WITH_STATS */
 };
 
 
@@ -214,6 +220,43 @@ HENI_INL_FUNCT_DEF_PREFIX uint8_t const * heniPacketGetLinkLayerSrcNeighborAddrC
 
 
 
+/**
+ * This is a private implementation function.
+ *
+ * Returns a pointer to the link-layer address
+ * of the neighbor to which the frames of
+ * a HENI packet are to be forwarded.
+ * @param packet The packet.
+ * @return A pointer to the next-hop address.
+ */
+HENI_INL_FUNCT_DEF_PREFIX uint8_t * heniPacketGetLinkLayerDstNeighborAddrPtr(
+        heni_packet_t * packet
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    return &(packet->linkLayerDstNeighborAddr.data8[0]);
+}
+
+
+
+/**
+ * This is a private implementation function.
+ *
+ * Returns a pointer to the link-layer address
+ * of the neighbor to which the frames of
+ * a HENI packet are to be forwarded.
+ * The address can only be read.
+ * @param packet The packet.
+ * @return A pointer to the next-hop address.
+ */
+HENI_INL_FUNCT_DEF_PREFIX uint8_t const * heniPacketGetLinkLayerDstNeighborAddrConstPtr(
+        heni_packet_t const * packet
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    return &(packet->linkLayerDstNeighborAddr.data8[0]);
+}
+
+
+
 /* ---------------------------------------------------------------------- *
  *                                                                        *
  *                          Packet operations API                         *
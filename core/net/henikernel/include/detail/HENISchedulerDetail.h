@@ -21,6 +21,15 @@
  */
 #define HENI_KERNEL_TASK_ASSIGN_NUMBER(taskName) HENI_KERNEL_TASK_##taskName
 
+/**
+ * Assigns a priority class to a HENI kernel task.
+ * @param taskName The name of the task.
+ * @param prio The priority class of the task.
+ */
+#define HENI_KERNEL_TASK_ASSIGN_PRIORITY(taskName, prio) \
+        case HENI_KERNEL_TASK_GET_UID(taskName): \
+            return (prio);
+
 /**
  * Dispatches computations of a HENI kernel
  * task to the function implementing the task.
@@ -53,9 +62,15 @@ enum
 
 struct heni_kernel_task_scheduler_s
 {
-    heni_kernel_task_count_t   frontId;
-    heni_kernel_task_count_t   backId;
+    heni_kernel_task_count_t   frontIds[HENI_KERNEL_TASK_PRIO_COUNT];
+    heni_kernel_task_count_t   backIds[HENI_KERNEL_TASK_PRIO_COUNT];
     heni_kernel_task_count_t   nextIds[HENI_KERNEL_TASK_COUNT];
+#if HENI_KERNEL_TASK_WITH_STATS
+    heni_kernel_task_stat_t    numExtracted;
+    heni_kernel_task_stat_t    scheduledAt[HENI_KERNEL_TASK_COUNT];
+    heni_kernel_task_stat_t    numRuns[HENI_KERNEL_TASK_COUNT];
+    heni_kernel_task_stat_t    maxLatencies[HENI_KERNEL_TASK_COUNT];
+#endif /* HENI_KERNEL_TASK_WITH_STATS */
 };
 
 
@@ -64,7 +79,15 @@ HENI_INL_FUNCT_DEC_PREFIX int_fast8_t heniKernelTaskSchedulerIsAnyScheduled(
         heni_kernel_task_scheduler_t const * sched
 ) HENI_INL_FUNCT_DEC_SUFFIX
 {
-    return sched->frontId != HENI_KERNEL_TASK_NULL ? 1 : 0;
+    heni_kernel_task_prio_t   prio;
+    for (prio = 0; prio < HENI_KERNEL_TASK_PRIO_COUNT; ++prio)
+    {
+        if (sched->frontIds[prio] != HENI_KERNEL_TASK_NULL)
+        {
+            return 1;
+        }
+    }
+    return 0;
 }
 
 
@@ -74,17 +97,55 @@ HENI_INL_FUNCT_DEF_PREFIX int_fast8_t heniKernelTaskSchedulerIsParticularSchedul
         heni_kernel_task_count_t taskId
 ) HENI_INL_FUNCT_DEF_SUFFIX
 {
+    heni_kernel_task_prio_t   prio;
     HENI_DASSERT(taskId > HENI_KERNEL_TASK_NULL && taskId < HENI_KERNEL_TASK_LAST);
-    return (sched->backId == taskId || sched->nextIds[taskId - 1] != HENI_KERNEL_TASK_NULL) ? 1 : 0;
+    if (sched->nextIds[taskId - 1] != HENI_KERNEL_TASK_NULL)
+    {
+        return 1;
+    }
+    for (prio = 0; prio < HENI_KERNEL_TASK_PRIO_COUNT; ++prio)
+    {
+        if (sched->backIds[prio] == taskId)
+        {
+            return 1;
+        }
+    }
+    return 0;
 }
 
 
 
+#if HENI_KERNEL_TASK_WITH_STATS
+
+HENI_INL_FUNCT_DEF_PREFIX heni_kernel_task_stat_t heniKernelTaskSchedulerGetNumRuns(
+        heni_kernel_task_scheduler_t const * sched,
+        heni_kernel_task_count_t taskId
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(taskId > HENI_KERNEL_TASK_NULL && taskId < HENI_KERNEL_TASK_LAST);
+    return sched->numRuns[taskId - 1];
+}
+
+
+
+HENI_INL_FUNCT_DEF_PREFIX heni_kernel_task_stat_t heniKernelTaskSchedulerGetMaxLatency(
+        heni_kernel_task_scheduler_t const * sched,
+        heni_kernel_task_count_t taskId
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(taskId > HENI_KERNEL_TASK_NULL && taskId < HENI_KERNEL_TASK_LAST);
+    return sched->maxLatencies[taskId - 1];
+}
+
+#endif /* HENI_KERNEL_TASK_WITH_STATS */
+
+
+
 HENI_INL_FUNCT_DEF_PREFIX void heniKernelTaskSchedulerCleanup(
         heni_kernel_task_scheduler_t * sched
 ) HENI_INL_FUNCT_DEF_SUFFIX
 {
-    HENI_DASSERT(sched->frontId == HENI_KERNEL_TASK_NULL && sched->backId == HENI_KERNEL_TASK_NULL);
+    HENI_DASSERT(! heniKernelTaskSchedulerIsAnyScheduled(sched));
 }
 
 
@@ -0,0 +1,108 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+#ifndef __HENI_STATS_DETAIL_H__
+#define __HENI_STATS_DETAIL_H__
+
+#ifndef __HENI_STATS_H__
+#error This is a file with implementation details. Do not include it directly!
+#endif /* __HENI_STATS_H__ */
+
+#include "HENIError.h"
+
+
+
+/**
+ * The packet counters of a single HENI
+ * instance, indexed by routing status.
+ */
+typedef struct heni_stats_instance_s
+{
+    heni_stats_counter_t   numTxPackets[HENI_PACKET_ROUTING_ERROR_COUNT];
+    heni_stats_counter_t   numRxPackets[HENI_PACKET_ROUTING_ERROR_COUNT];
+} heni_stats_instance_t;
+
+
+/**
+ * The statistics of a single packet queue.
+ */
+typedef struct heni_stats_queue_info_s
+{
+    heni_stats_counter_t   length;
+    heni_stats_counter_t   highWaterMark;
+    heni_stats_counter_t   timeHistogram[HENI_STATS_NUM_HISTOGRAM_BINS];
+} heni_stats_queue_info_t;
+
+
+struct heni_stats_s
+{
+    /** Entry 0 is for packets of no valid instance. */
+    heni_stats_instance_t     instances[HENI_MAX_NUM_INSTANCES + 1];
+    heni_stats_queue_info_t   queues[HENI_STATS_QUEUE_COUNT];
+};
+
+
+
+HENI_INL_FUNCT_DEF_PREFIX heni_stats_counter_t heniStatsGetNumTxPackets(
+        heni_stats_t const * stats,
+        heni_instance_id_t iid,
+        uint_fast8_t status
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(iid <= HENI_INSTANCE_ID_MAX && status < HENI_PACKET_ROUTING_ERROR_COUNT);
+    return stats->instances[iid].numTxPackets[status];
+}
+
+
+
+HENI_INL_FUNCT_DEF_PREFIX heni_stats_counter_t heniStatsGetNumRxPackets(
+        heni_stats_t const * stats,
+        heni_instance_id_t iid,
+        uint_fast8_t status
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(iid <= HENI_INSTANCE_ID_MAX && status < HENI_PACKET_ROUTING_ERROR_COUNT);
+    return stats->instances[iid].numRxPackets[status];
+}
+
+
+
+HENI_INL_FUNCT_DEF_PREFIX heni_stats_counter_t heniStatsGetQueueLength(
+        heni_stats_t const * stats,
+        heni_stats_queue_t queue
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(queue < HENI_STATS_QUEUE_COUNT);
+    return stats->queues[queue].length;
+}
+
+
+
+HENI_INL_FUNCT_DEF_PREFIX heni_stats_counter_t heniStatsGetQueueHighWaterMark(
+        heni_stats_t const * stats,
+        heni_stats_queue_t queue
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(queue < HENI_STATS_QUEUE_COUNT);
+    return stats->queues[queue].highWaterMark;
+}
+
+
+
+HENI_INL_FUNCT_DEF_PREFIX heni_stats_counter_t heniStatsGetQueueTimeHistogramBin(
+        heni_stats_t const * stats,
+        heni_stats_queue_t queue,
+        uint_fast8_t bin
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(queue < HENI_STATS_QUEUE_COUNT && bin < HENI_STATS_NUM_HISTOGRAM_BINS);
+    return stats->queues[queue].timeHistogram[bin];
+}
+
+
+
+#endif /* __HENI_STATS_DETAIL_H__ */
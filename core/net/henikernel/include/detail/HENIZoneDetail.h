@@ -27,6 +27,7 @@ struct heni_zone_s
 {
     heni_linked_list_node_t      bucketListNode;   /* for the zone table */
     heni_zone_entry_key_t        key;
+    heni_link_addr_container_t   nextHopLinkAddr;  /* for routing */
 };
 
 
@@ -92,6 +93,24 @@ HENI_INL_FUNCT_DEF_PREFIX heni_zone_discr_t heniZoneEntryGetDiscr(
 
 
 
+HENI_INL_FUNCT_DEF_PREFIX uint8_t * heniZoneEntryGetNextHopLinkAddrPtr(
+        heni_zone_t * zone
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    return &(zone->nextHopLinkAddr.data8[0]);
+}
+
+
+
+HENI_INL_FUNCT_DEF_PREFIX uint8_t const * heniZoneEntryGetNextHopLinkAddrConstPtr(
+        heni_zone_t const * zone
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    return &(zone->nextHopLinkAddr.data8[0]);
+}
+
+
+
 HENI_INL_FUNCT_DEF_PREFIX heni_linked_list_node_t * heniZoneEntryToBucketListNode(
         heni_zone_t * zone
 ) HENI_INL_FUNCT_DEF_SUFFIX
@@ -21,6 +21,8 @@
 
 
 
+#if ! HENI_ZONE_TABLE_WITH_SORTED_ROWS
+
 struct heni_zone_table_bucket_s
 {
     heni_linked_list_t   bucketList;
@@ -44,6 +46,35 @@ struct heni_zone_table_titer_s
     heni_zone_table_t *        zt;
 };
 
+#else /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
+
+struct heni_zone_table_bucket_s
+{
+    heni_zone_lid_t     lid;    /* copies of the zone key, so that */
+    heni_zone_discr_t   discr;  /* a search touches only the row   */
+    heni_zone_t *       zone;
+};
+
+struct heni_zone_table_s
+{
+    heni_zone_table_bucket_t *   bucketPtrsPerRow[HENI_MAX_LIDS_IN_LABEL + 1];
+    size_t                       zoneCountPerRow[HENI_MAX_LIDS_IN_LABEL + 1];
+    size_t                       bucketCountPerRow; // the capacity of each row
+                                                    // apart from row 0, which
+                                                    // always has 1 bucket
+    heni_instance_t *            inst;
+    heni_zone_table_bucket_t     rootZoneBucketBuf;
+};
+
+struct heni_zone_table_titer_s
+{
+    size_t                     inrowBucketIdx;
+    heni_level_t               rowLevel;
+    heni_zone_table_t *        zt;
+};
+
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
+
 struct heni_zone_table_piter_s
 {
     heni_zone_table_t *        zt;
@@ -53,6 +84,8 @@ struct heni_zone_table_piter_s
 };
 
 
+#if ! HENI_ZONE_TABLE_WITH_SORTED_ROWS
+
 /**
  * This is a private implementation function.
  *
@@ -69,6 +102,8 @@ HENI_INL_FUNCT_DEC_PREFIX size_t heniZoneTableGetBucketForLevelAndLID(
         heni_zone_lid_t lid
 ) HENI_INL_FUNCT_DEC_SUFFIX;
 
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
+
 /**
  * This is a private implementation function.
  *
@@ -135,9 +170,13 @@ HENI_INL_FUNCT_DEF_PREFIX heni_zone_t * heniZoneTableTIterGetZone(
 ) HENI_INL_FUNCT_DEF_SUFFIX
 {
     HENI_DASSERT(heniZoneTableTIterIsActive(iter));
+#if ! HENI_ZONE_TABLE_WITH_SORTED_ROWS
     return heniZoneEntryFromBucketListNode(
             heniLinkedListFIterGetNode(&iter->inrowBucketIter)
     );
+#else
+    return iter->zt->bucketPtrsPerRow[iter->rowLevel][iter->inrowBucketIdx].zone;
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
 }
 
 
@@ -156,7 +195,12 @@ HENI_INL_FUNCT_DEF_PREFIX heni_zone_lid_t heniZoneTableTIterGetLID(
         heni_zone_table_titer_t const * iter
 ) HENI_INL_FUNCT_DEF_SUFFIX
 {
+#if ! HENI_ZONE_TABLE_WITH_SORTED_ROWS
     return heniZoneEntryGetLID(heniZoneTableTIterGetZone(iter));
+#else
+    HENI_DASSERT(heniZoneTableTIterIsActive(iter));
+    return iter->zt->bucketPtrsPerRow[iter->rowLevel][iter->inrowBucketIdx].lid;
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
 }
 
 
@@ -165,11 +209,18 @@ HENI_INL_FUNCT_DEF_PREFIX heni_zone_discr_t heniZoneTableTIterGetDiscr(
         heni_zone_table_titer_t const * iter
 ) HENI_INL_FUNCT_DEF_SUFFIX
 {
+#if ! HENI_ZONE_TABLE_WITH_SORTED_ROWS
     return heniZoneEntryGetDiscr(heniZoneTableTIterGetZone(iter));
+#else
+    HENI_DASSERT(heniZoneTableTIterIsActive(iter));
+    return iter->zt->bucketPtrsPerRow[iter->rowLevel][iter->inrowBucketIdx].discr;
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
 }
 
 
 
+#if ! HENI_ZONE_TABLE_WITH_SORTED_ROWS
+
 HENI_INL_FUNCT_DEF_PREFIX size_t heniZoneTableGetBucketForLevelAndLID(
         heni_zone_table_t const * zt,
         heni_level_t level,
@@ -179,5 +230,7 @@ HENI_INL_FUNCT_DEF_PREFIX size_t heniZoneTableGetBucketForLevelAndLID(
     return level == 0 ? 0 : (size_t)(lid % zt->bucketCountPerRow);
 }
 
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
+
 
 #endif /* __HENI_ZONE_TABLE_DETAIL_H__ */
@@ -8,9 +8,13 @@
 #include "HENIBase.h"
 #include "HENIFrame.h"
 #include "HENIKernel.h"
+#include "HENILabel.h"
 #include "HENILinkAddress.h"
+#include "HENINeighborTable.h"
 #include "HENIPacket.h"
 #include "HENIScheduler.h"
+#include "HENIStats.h"
+#include "HENIZoneTable.h"
 
 
 
@@ -119,6 +123,204 @@ HENI_PRV_FUNCT_DEC_PREFIX uint_fast8_t heniKernelStartRoutingPacket(
         heni_packet_t * packet
 ) HENI_PRV_FUNCT_DEC_SUFFIX;
 
+/**
+ * This is a private implementation function.
+ *
+ * Selects the neighbor to which the frames of
+ * a given packet are to be forwarded and stores
+ * its link-layer address in the packet.
+ * @param ker The HENI kernel.
+ * @param inst The instance the packet belongs to.
+ * @param packet The packet to be routed.
+ * @return Nonzero if a next hop has been selected
+ *   or zero if there is no route for the packet.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX int_fast8_t heniKernelSelectNextHopForPacket(
+        heni_kernel_t * ker,
+        heni_instance_t * inst,
+        heni_packet_t * packet
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Returns the maximal size of a packet payload
+ * that can be sent in fragments by a HENI kernel.
+ * @param ker The HENI kernel.
+ * @return The maximal size of a packet payload.
+ */
+HENI_INL_FUNCT_DEC_PREFIX size_t heniKernelGetMaxPacketPayloadSize(
+        heni_kernel_t const * ker
+) HENI_INL_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Looks up a transmission slot that is either free
+ * or holds a packet that awaits sending its next
+ * fragment.
+ * @param ker The HENI kernel.
+ * @param awaitingFragment Nonzero if a slot with a packet
+ *   awaiting its next fragment is to be found
+ *   or zero if a free slot is to be found.
+ * @return The slot or NULL if there is none.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX heni_kernel_tx_slot_t * heniKernelFindTxSlot(
+        heni_kernel_t * ker,
+        uint8_t awaitingFragment
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Returns the transmission slot from which a frame
+ * with a given payload has been sent.
+ * @param ker The HENI kernel.
+ * @param fpld The payload of the frame.
+ * @return The slot or NULL if there is none.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX heni_kernel_tx_slot_t * heniKernelFindTxSlotForFrame(
+        heni_kernel_t * ker,
+        heni_iobuf_list_t const * fpld
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Places a packet in a free transmission slot,
+ * taking over the payload of the packet.
+ * @param ker The HENI kernel.
+ * @param slot The slot.
+ * @param packet The packet.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX void heniKernelTxSlotStart(
+        heni_kernel_t * ker,
+        heni_kernel_tx_slot_t * slot,
+        heni_packet_t * packet
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Cuts the next fragment off the payload of
+ * the packet held in a transmission slot and
+ * hands a frame with the fragment over to the
+ * lower layer.
+ * @param ker The HENI kernel.
+ * @param slot The slot.
+ * @return Zero if the lower layer has accepted the
+ *   frame or nonzero otherwise. In the latter case,
+ *   the fragment is returned to the payload.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX int_fast8_t heniKernelTxSlotSendNextFragment(
+        heni_kernel_t * ker,
+        heni_kernel_tx_slot_t * slot
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Returns the fragment carried by the last frame
+ * sent from a transmission slot to the payload of
+ * the packet held in the slot.
+ * @param slot The slot.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX void heniKernelTxSlotReclaimFragment(
+        heni_kernel_tx_slot_t * slot
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Merges a part of the payload of a packet held
+ * in a transmission slot back into a list, joining
+ * the I/O buffers that were split when cutting
+ * fragments.
+ * @param slot The slot.
+ * @param iolHead The list to which the part is appended.
+ * @param iolTail The part.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX void heniKernelTxSlotMergePayload(
+        heni_kernel_tx_slot_t * slot,
+        heni_iobuf_list_t * iolHead,
+        heni_iobuf_list_t * iolTail
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Frees a transmission slot, restoring the payload
+ * of the packet held in the slot and marking the
+ * packet as sent.
+ * @param ker The HENI kernel.
+ * @param slot The slot.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX void heniKernelTxSlotFinish(
+        heni_kernel_t * ker,
+        heni_kernel_tx_slot_t * slot
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Checks whether the packet-routing task
+ * of a HENI kernel has any work to do.
+ * @param ker The HENI kernel.
+ * @return Nonzero if the task has any work
+ *   or zero otherwise.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX int_fast8_t heniKernelHasRoutingWork(
+        heni_kernel_t * ker
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Looks up a buffer in which a packet with a given
+ * tag from a given neighbor is being reassembled.
+ * @param inst The HENI instance.
+ * @param srcAddrPtr The link-layer address of the neighbor.
+ * @param tag The tag of the packet.
+ * @return The buffer or NULL if there is none.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX heni_kernel_reassembly_t * heniKernelFindReassembly(
+        heni_instance_t * inst,
+        uint8_t const * srcAddrPtr,
+        uint8_t tag
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Obtains a buffer for reassembling a new packet.
+ * If all buffers of the instance are taken, the
+ * incomplete packet whose reassembly started
+ * earliest is dropped.
+ * @param ker The HENI kernel.
+ * @param inst The HENI instance.
+ * @return The buffer or NULL if all buffers hold
+ *   complete packets.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX heni_kernel_reassembly_t * heniKernelAcquireReassembly(
+        heni_kernel_t * ker,
+        heni_instance_t * inst
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Releases a reassembly buffer, returning the
+ * fragments to their frames, finishing the
+ * reception of the frames, and freeing the
+ * packet.
+ * @param ker The HENI kernel.
+ * @param ras The reassembly buffer.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX void heniKernelReleaseReassembly(
+        heni_kernel_t * ker,
+        heni_kernel_reassembly_t * ras
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
 
 /**
  * This is a private implementation function.
@@ -145,6 +347,56 @@ HENI_PRV_FUNCT_DEC_PREFIX void heniKernelDisposeOfReceivedPacket(
         heni_packet_t * packet
 ) HENI_PRV_FUNCT_DEC_SUFFIX;
 
+/**
+ * This is a private implementation function.
+ *
+ * Accounts in the kernel statistics, if any,
+ * for a packet entering a kernel queue.
+ * @param ker The HENI kernel.
+ * @param queue The queue.
+ * @param packet The packet.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX void heniKernelStatsCountQueueEntry(
+        heni_kernel_t * ker,
+        heni_stats_queue_t queue,
+        heni_packet_t * packet
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Accounts in the kernel statistics, if any,
+ * for a packet leaving a kernel queue.
+ * @param ker The HENI kernel.
+ * @param queue The queue.
+ * @param packet The packet.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX void heniKernelStatsCountQueueExit(
+        heni_kernel_t * ker,
+        heni_stats_queue_t queue,
+        heni_packet_t const * packet
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Accounts in the kernel statistics, if any,
+ * for an outgoing packet finished with a given
+ * status or for an incoming packet delivered
+ * (or frame dropped) with a given status.
+ * @param ker The HENI kernel.
+ * @param iid The identifier of the instance.
+ * @param status The routing status.
+ * @param outgoing Nonzero for an outgoing packet
+ *   or zero for an incoming one.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX void heniKernelStatsCountPacket(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid,
+        uint_fast8_t status,
+        uint_fast8_t outgoing
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
 
 
 HENI_API_FUNCT_DEF_PREFIX int_fast8_t heniKernelInit(
@@ -152,6 +404,9 @@ HENI_API_FUNCT_DEF_PREFIX int_fast8_t heniKernelInit(
 ) HENI_API_FUNCT_DEF_SUFFIX
 {
     heni_instance_count_t   icount;
+#if ((HENI_KERNEL_DEFAULT_MAX_FRAME_PAYLOAD_SIZE) - (HENI_KERNEL_FRAGMENT_HEADER_SIZE)) * (HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET) > 65535
+#error "Fragment offsets cannot address the largest packet!"
+#endif
     // FIXME: uncomment this if we have some failures
     /*int_fast8_t   step = 0;
     --step;*/
@@ -167,11 +422,24 @@ HENI_API_FUNCT_DEF_PREFIX int_fast8_t heniKernelInit(
     }
     ker->numRunningInstances = 0;
     ker->numStoppingInstances = 0;
+    ker->taskBatchLimit = HENI_KERNEL_TASK_BATCH_LIMIT;
     heniLinkedListInit(&ker->pktsToSend);
     heniLinkedListInit(&ker->pktsAlreadySent);
     heniLinkedListInit(&ker->pktsToReceive);
     heniLinkedListInit(&ker->pktsAlreadyReceived);
     heniLinkedListInit(&ker->pktsBeingRouted);
+    ker->numFramesInFlight = 0;
+    ker->neighborTable = NULL;
+    for (icount = 0; icount < HENI_KERNEL_MAX_FRAMES_IN_FLIGHT; ++icount)
+    {
+        ker->txSlots[icount].packet = NULL;
+        ker->txSlots[icount].frameInFlight = 0;
+    }
+    ker->maxFramePayloadSize = HENI_KERNEL_DEFAULT_MAX_FRAME_PAYLOAD_SIZE;
+    ker->nextFragmentTag = 0;
+#if HENI_KERNEL_WITH_STATS
+    heniStatsInit(&ker->stats);
+#endif /* HENI_KERNEL_WITH_STATS */
 
     // FIXME: add more if necessary
     return 0;
@@ -277,6 +545,73 @@ HENI_API_FUNCT_DEF_PREFIX int_fast8_t heniKernelInstanceIsStopping(
 
 
 
+HENI_API_FUNCT_DEF_PREFIX void heniKernelSetNeighborTable(
+        heni_kernel_t * ker,
+        heni_neighbor_table_t * nbt
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    ker->neighborTable = nbt;
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX int_fast8_t heniKernelSetMaxFramePayloadSize(
+        heni_kernel_t * ker,
+        size_t size
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    if (size <= HENI_KERNEL_FRAGMENT_HEADER_SIZE ||
+            (size - HENI_KERNEL_FRAGMENT_HEADER_SIZE) * HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET > 65535U)
+    {
+        return -1;
+    }
+    ker->maxFramePayloadSize = (uint16_t)size;
+    return 0;
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX int_fast8_t heniKernelInstanceSetRoutingState(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid,
+        uint8_t const * labPtr,
+        heni_zone_table_t * zt
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    heni_instance_t *       inst;
+    heni_level_t            level;
+    heni_level_t            numLevels;
+    int_fast8_t             step = 0;
+    --step;
+    if (iid < HENI_INSTANCE_ID_MIN || iid > HENI_INSTANCE_ID_MAX)
+    {
+        goto FAILURE_ROLLBACK_INVALID_IID;
+    }
+    --step;
+    inst = ker->instancePtrs[heniKernelIIDToIdx(iid)];
+    if (inst == NULL || ! heniKernelAccessorsInstanceFlagRunningIsSet(ker, iid))
+    {
+        goto FAILURE_ROLLBACK_INSTANCE_NOT_RUNNING;
+    }
+    for (level = 0, numLevels = heniLabelSpecGetNumLevels(inst->lspec); level < numLevels; ++level)
+    {
+        heniLabelSetElement(
+                &(inst->label.data8[0]),
+                inst->lspec,
+                level,
+                heniLabelGetElement(labPtr, inst->lspec, level)
+        );
+    }
+    inst->zoneTable = zt;
+    return 0;
+
+FAILURE_ROLLBACK_INSTANCE_NOT_RUNNING:
+FAILURE_ROLLBACK_INVALID_IID:
+    return step;
+}
+
+
+
 HENI_API_FUNCT_DEF_PREFIX void heniKernelInstanceStopTrigger(
         heni_kernel_t * ker,
         heni_instance_id_t iid
@@ -394,7 +729,9 @@ HENI_PRV_FUNCT_DEF_PREFIX int_fast8_t heniKernelHasInstanceAnyOngoingOperations(
             heniLinkedListIsEmpty(&ker->pktsAlreadySent) &&
             heniLinkedListIsEmpty(&ker->pktsToReceive) &&
             heniLinkedListIsEmpty(&ker->pktsAlreadyReceived) &&
-            heniLinkedListIsEmpty(&ker->pktsBeingRouted));
+            heniLinkedListIsEmpty(&ker->pktsBeingRouted) &&
+            heniKernelFindTxSlot(ker, 1) == NULL &&
+            ker->numFramesInFlight == 0);
 }
 
 
@@ -483,6 +820,9 @@ HENI_API_FUNCT_DEF_PREFIX void heniKernelCleanup(
     HENI_DASSERT(heniLinkedListIsEmpty(&ker->pktsToReceive));
     HENI_DASSERT(heniLinkedListIsEmpty(&ker->pktsAlreadyReceived));
     HENI_DASSERT(heniLinkedListIsEmpty(&ker->pktsBeingRouted));
+    HENI_DASSERT(ker->numFramesInFlight == 0);
+    HENI_DASSERT(heniKernelFindTxSlot(ker, 1) == NULL);
+    ker->neighborTable = NULL;
     heniKernelTaskSchedulerCleanup(&ker->taskScheduler);
 }
 
@@ -536,6 +876,7 @@ HENI_API_FUNCT_DEF_PREFIX int_fast8_t heniPacketSendStart(
         &ker->pktsToSend,
         heniPacketGetActiveListNodeForPacket(packet)
     );
+    heniKernelStatsCountQueueEntry(ker, HENI_STATS_QUEUE_TO_SEND, packet);
     HENI_KERNEL_TASK_POST(ker, heniKernelProcessOutgoingPacketsTask);
     return HENI_PACKET_ROUTING_ERROR_NONE;
 
@@ -543,6 +884,7 @@ FAILURE_ROLLBACK_UNABLE_TO_ALLOCATE_PACKET:
 FAILURE_ROLLBACK_INSTANCE_INACTIVE:
 FAILURE_ROLLBACK_INSTANCE_NONEXISTING:
 FAILURE_ROLLBACK_INVALID_IID:
+    heniKernelStatsCountPacket(ker, iid, (uint_fast8_t)status, 1);
     return -status;
 }
 
@@ -557,13 +899,19 @@ HENI_HID_FUNCT_DEF_PREFIX void heniKernelProcessOutgoingPacketsTask(
     heni_linked_list_node_t *   lnode;
     heni_packet_t *             packet;
     heni_instance_id_t          iid;
+    heni_kernel_task_batch_t    budget;
     uint8_t                     needsReposting = 0;
     uint8_t                     stoppingInstanceAffected = 0;
 
-    lnode = heniLinkedListNodeTryRemoveFront(&ker->pktsToSend);
-    if (lnode != NULL)
+    for (budget = ker->taskBatchLimit; budget > 0; --budget)
     {
+        lnode = heniLinkedListNodeTryRemoveFront(&ker->pktsToSend);
+        if (lnode == NULL)
+        {
+            break;
+        }
         packet = heniPacketGetPacketForActiveListNode(lnode);
+        heniKernelStatsCountQueueExit(ker, HENI_STATS_QUEUE_TO_SEND, packet);
         iid = heniKernelAccessorsGetIIDForPacket(ker, packet);
         HENI_DASSERT(iid >= HENI_INSTANCE_ID_MIN && iid <= HENI_INSTANCE_ID_MAX);
         HENI_DASSERT(ker->instancePtrs[heniKernelIIDToIdx(iid)] != NULL);
@@ -571,6 +919,7 @@ HENI_HID_FUNCT_DEF_PREFIX void heniKernelProcessOutgoingPacketsTask(
         {
             heniKernelMarkOutgoingPacketAsNotSentDueToInstanceStop(packet);
             heniLinkedListNodeAddBack(&ker->pktsAlreadySent, lnode);
+            heniKernelStatsCountQueueEntry(ker, HENI_STATS_QUEUE_ALREADY_SENT, packet);
             /* NOTICE iwanicki 2016-10-20:   */
             /* The stopping instance is not  */
             /* really affected here.         */
@@ -587,6 +936,7 @@ HENI_HID_FUNCT_DEF_PREFIX void heniKernelProcessOutgoingPacketsTask(
             {
                 heniKernelMarkOutgoingPacketAsNotSentDueToFailureAtRoutingInitiation(packet, status);
                 heniLinkedListNodeAddBack(&ker->pktsAlreadySent, lnode);
+                heniKernelStatsCountQueueEntry(ker, HENI_STATS_QUEUE_ALREADY_SENT, packet);
                 /* NOTICE iwanicki 2016-10-20:   */
                 /* The stopping instance is not  */
                 /* really affected here.         */
@@ -597,32 +947,38 @@ HENI_HID_FUNCT_DEF_PREFIX void heniKernelProcessOutgoingPacketsTask(
                 /* packets is below.                        */
             }
         }
-        if (! heniLinkedListIsEmpty(&ker->pktsToSend))
-        {
-            needsReposting = 1;
-        }
     }
-    lnode = heniLinkedListNodeTryRemoveFront(&ker->pktsAlreadySent);
-    if (lnode != NULL)
+    if (! heniLinkedListIsEmpty(&ker->pktsToSend))
+    {
+        needsReposting = 1;
+    }
+    for (budget = ker->taskBatchLimit; budget > 0; --budget)
     {
         heni_iobuf_list_t *   payloadIOVPtr;
 
+        lnode = heniLinkedListNodeTryRemoveFront(&ker->pktsAlreadySent);
+        if (lnode == NULL)
+        {
+            break;
+        }
         packet = heniPacketGetPacketForActiveListNode(lnode);
+        heniKernelStatsCountQueueExit(ker, HENI_STATS_QUEUE_ALREADY_SENT, packet);
         iid = heniKernelAccessorsGetIIDForPacket(ker, packet);
         payloadIOVPtr = heniPacketGetPayloadIOVectorPtr(packet);
         heniPacketAddrCopy(&packet->paddr, &paddr);
         heniPacketTxInfoCopy(&packet->opInfo.ptx, &psts);
+        heniKernelStatsCountPacket(ker, iid, psts.status, 1);
         heniPacketFree(ker, iid, packet);
         if (! heniKernelAccessorsInstanceFlagRunningIsSet(ker, iid))
         {
             stoppingInstanceAffected = 1;
         }
-        if (! heniLinkedListIsEmpty(&ker->pktsAlreadySent))
-        {
-            needsReposting = 1;
-        }
         heniPacketSendFinish(ker, &paddr, payloadIOVPtr, &psts);
     }
+    if (! heniLinkedListIsEmpty(&ker->pktsAlreadySent))
+    {
+        needsReposting = 1;
+    }
     if (needsReposting)
     {
         HENI_KERNEL_TASK_POST(ker, heniKernelProcessOutgoingPacketsTask);
@@ -666,15 +1022,25 @@ HENI_PRV_FUNCT_DEF_PREFIX uint_fast8_t heniKernelStartRoutingPacket(
         heni_packet_t * packet
 ) HENI_PRV_FUNCT_DEF_SUFFIX
 {
-    /* FIXME iwanicki 2016-10-25:              */
-    /* This is a temporary implementation.     */
-    /* It should be fixed as soon as possible. */
     heni_linked_list_node_t *   lnode;
+    heni_instance_t *           inst;
     int_fast8_t                 needsAction;
 
+    inst = ker->instancePtrs[heniKernelIIDToIdx(heniKernelAccessorsGetIIDForPacket(ker, packet))];
+    HENI_DASSERT(inst != NULL);
+    if (heniIOBufListGetCapacity(heniPacketGetPayloadIOVectorPtr(packet)) >
+            heniKernelGetMaxPacketPayloadSize(ker))
+    {
+        return HENI_PACKET_ROUTING_ERROR_PAYLOAD_TOO_LARGE;
+    }
+    if (! heniKernelSelectNextHopForPacket(ker, inst, packet))
+    {
+        return HENI_PACKET_ROUTING_ERROR_NO_ROUTE;
+    }
     needsAction = heniLinkedListIsEmpty(&ker->pktsBeingRouted);
     lnode = heniPacketGetActiveListNodeForPacket(packet);
     heniLinkedListNodeAddBack(&ker->pktsBeingRouted, lnode);
+    heniKernelStatsCountQueueEntry(ker, HENI_STATS_QUEUE_BEING_ROUTED, packet);
     if (needsAction)
     {
         HENI_KERNEL_TASK_POST(ker, heniKernelRoutePacketsTask);
@@ -684,43 +1050,331 @@ HENI_PRV_FUNCT_DEF_PREFIX uint_fast8_t heniKernelStartRoutingPacket(
 
 
 
+HENI_PRV_FUNCT_DEF_PREFIX int_fast8_t heniKernelSelectNextHopForPacket(
+        heni_kernel_t * ker,
+        heni_instance_t * inst,
+        heni_packet_t * packet
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_zone_table_titer_t     iter;
+    uint8_t const *             dstLabPtr;
+    uint8_t *                   nextHopPtr;
+    heni_zone_lid_t             lid;
+    heni_level_t                level;
+    heni_level_t                numLevels;
+
+    nextHopPtr = heniPacketGetLinkLayerDstNeighborAddrPtr(packet);
+    if (ker->neighborTable == NULL || inst->zoneTable == NULL)
+    {
+        /* Without routing state, the packet is */
+        /* simply forwarded to all neighbors.   */
+        heniLinkAddrFetchAllNeighbors(nextHopPtr);
+        return 1;
+    }
+    /* The next hop leads toward the largest zone that */
+    /* contains the destination but not the present    */
+    /* node, that is, the zone identified by the first */
+    /* label element in which the two labels differ.   */
+    dstLabPtr = heniPacketAddrGetDstLabelConstPtr(&packet->paddr);
+    numLevels = heniLabelSpecGetNumLevels(inst->lspec);
+    for (level = 0; level < numLevels; ++level)
+    {
+        lid = heniLabelGetElement(dstLabPtr, inst->lspec, level);
+        if (lid != heniLabelGetElement(&(inst->label.data8[0]), inst->lspec, level))
+        {
+            break;
+        }
+    }
+    if (level >= numLevels || ! heniLabelSpecIsZoneLIDAssignable(lid, inst->lspec))
+    {
+        /* The destination is a group of nodes */
+        /* or the present node itself.         */
+        heniLinkAddrFetchAllNeighbors(nextHopPtr);
+        return 1;
+    }
+    heniZoneTableTIterSetAtLevelAndLID(&iter, inst->zoneTable, level + 1, lid);
+    while (heniZoneTableTIterIsActive(&iter))
+    {
+        uint8_t const * zoneNextHopPtr =
+                heniZoneEntryGetNextHopLinkAddrConstPtr(
+                        heniZoneTableTIterGetZone(&iter)
+                );
+        if (heniNeighborTableFind(ker->neighborTable, zoneNextHopPtr) != NULL)
+        {
+            heniLinkAddrCopy(zoneNextHopPtr, nextHopPtr);
+            return 1;
+        }
+        heniZoneTableTIterAdvancePreservingLevelAndLID(&iter);
+    }
+    return 0;
+}
+
+
 
 HENI_HID_FUNCT_DEF_PREFIX void heniKernelRoutePacketsTask(
         heni_kernel_t * ker
 ) HENI_HID_FUNCT_DEF_SUFFIX
 {
-    /* FIXME iwanicki 2016-10-25:              */
-    /* This is a temporary implementation.     */
-    /* It should be fixed as soon as possible. */
-    heni_frame_addr_t           faddr;
     heni_linked_list_node_t *   lnode;
-    heni_packet_t *             packet;
+    heni_kernel_tx_slot_t *     slot;
+    heni_kernel_task_batch_t    budget;
+    uint8_t                     anyFailed = 0;
 
-    lnode = heniLinkedListNodeGetFront(&ker->pktsBeingRouted);
-    HENI_PASSERT(lnode != NULL);
-    packet = heniPacketGetPacketForActiveListNode(lnode);
+    for (budget = ker->taskBatchLimit; budget > 0; --budget)
+    {
+        /* Packets already being fragmented take */
+        /* precedence over those awaiting a slot. */
+        slot = heniKernelFindTxSlot(ker, 1);
+        if (slot == NULL)
+        {
+            slot = heniKernelFindTxSlot(ker, 0);
+            if (slot == NULL)
+            {
+                break;
+            }
+            lnode = heniLinkedListNodeTryRemoveFront(&ker->pktsBeingRouted);
+            if (lnode == NULL)
+            {
+                break;
+            }
+            heniKernelStatsCountQueueExit(ker, HENI_STATS_QUEUE_BEING_ROUTED, heniPacketGetPacketForActiveListNode(lnode));
+            heniKernelTxSlotStart(ker, slot, heniPacketGetPacketForActiveListNode(lnode));
+        }
+        if (heniKernelTxSlotSendNextFragment(ker, slot))
+        {
+            heniKernelMarkOutgoingPacketAsNotSentDueToLowerLayerFailureUponFrameForwarding(slot->packet);
+            heniKernelTxSlotFinish(ker, slot);
+            anyFailed = 1;
+        }
+    }
+    if (anyFailed)
+    {
+        HENI_KERNEL_TASK_POST(ker, heniKernelProcessOutgoingPacketsTask);
+    }
+    if (heniKernelHasRoutingWork(ker))
+    {
+        HENI_KERNEL_TASK_POST(ker, heniKernelRoutePacketsTask);
+    }
+}
+
+
+
+HENI_INL_FUNCT_DEF_PREFIX size_t heniKernelGetMaxPacketPayloadSize(
+        heni_kernel_t const * ker
+) HENI_INL_FUNCT_DEF_SUFFIX
+{
+    return (size_t)(ker->maxFramePayloadSize - HENI_KERNEL_FRAGMENT_HEADER_SIZE) *
+            HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_kernel_tx_slot_t * heniKernelFindTxSlot(
+        heni_kernel_t * ker,
+        uint8_t awaitingFragment
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_kernel_frame_count_t   i;
+
+    for (i = 0; i < HENI_KERNEL_MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        heni_kernel_tx_slot_t * slot = &ker->txSlots[i];
+        if (awaitingFragment ?
+                (slot->packet != NULL && ! slot->frameInFlight) :
+                (slot->packet == NULL))
+        {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_kernel_tx_slot_t * heniKernelFindTxSlotForFrame(
+        heni_kernel_t * ker,
+        heni_iobuf_list_t const * fpld
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_kernel_frame_count_t   i;
+
+    for (i = 0; i < HENI_KERNEL_MAX_FRAMES_IN_FLIGHT; ++i)
+    {
+        if (&ker->txSlots[i].fpld == fpld)
+        {
+            return ker->txSlots[i].frameInFlight ? &ker->txSlots[i] : NULL;
+        }
+    }
+    return NULL;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void heniKernelTxSlotStart(
+        heni_kernel_t * ker,
+        heni_kernel_tx_slot_t * slot,
+        heni_packet_t * packet
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(slot->packet == NULL);
+    slot->packet = packet;
+    heniIOBufListInit(&slot->rest);
+    heniIOBufListMerge(&slot->rest, heniPacketGetPayloadIOVectorPtr(packet));
+    slot->offset = 0;
+    slot->tag = ker->nextFragmentTag++;
+    slot->nextExtraNodeIdx = 0;
+    slot->frameInFlight = 0;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX int_fast8_t heniKernelTxSlotSendNextFragment(
+        heni_kernel_t * ker,
+        heni_kernel_tx_slot_t * slot
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_frame_addr_t         faddr;
+    heni_iobuf_list_fiter_t   iter;
+    heni_iobuf_list_t         tail;
+    size_t                    len;
+
+    HENI_DASSERT(slot->packet != NULL && ! slot->frameInFlight);
+    /* The fragment is cut off the front of the remaining */
+    /* payload without copying. If an I/O buffer has to   */
+    /* be split, one of the two extra nodes is used; the  */
+    /* other one is always free by then, as the fragment  */
+    /* it started has been merged back into the payload.  */
+    heniIOBufListInit(&tail);
+    heniIOBufListFIterInit(&iter, &slot->rest);
+    len = heniIOBufListFIterTryAdvance(
+            &iter,
+            ker->maxFramePayloadSize - HENI_KERNEL_FRAGMENT_HEADER_SIZE
+    );
+    if (heniIOBufListFIterSplitAt(&iter, &tail, &slot->extraNodes[slot->nextExtraNodeIdx]))
+    {
+        slot->nextExtraNodeIdx ^= 1;
+    }
+    slot->hdr[0] = slot->tag;
+    slot->hdr[1] = heniIOBufListIsEmpty(&tail) ? 0 : HENI_KERNEL_FRAGMENT_HEADER_FLAG_MORE;
+    slot->hdr[2] = (uint8_t)(slot->offset >> 8);
+    slot->hdr[3] = (uint8_t)(slot->offset);
+    slot->offset += (uint16_t)len;
+    heniIOBufListInit(&slot->fpld);
+    heniIOBufNodeInitMem(&slot->hdrNode, &(slot->hdr[0]), HENI_KERNEL_FRAGMENT_HEADER_SIZE);
+    heniIOBufNodeAddBack(&slot->fpld, &slot->hdrNode);
+    heniIOBufListMerge(&slot->fpld, &slot->rest);
+    heniIOBufListMerge(&slot->rest, &tail);
     heniLinkAddrFetchMine(
             heniFrameAddrGetSrcLinkAddrPtr(&faddr)
     );
-    heniLinkAddrFetchAllNeighbors(
+    heniLinkAddrCopy(
+            heniPacketGetLinkLayerDstNeighborAddrConstPtr(slot->packet),
             heniFrameAddrGetDstLinkAddrPtr(&faddr)
     );
+    /* The slot is marked as having a frame in flight */
+    /* before the lower layer is invoked, as the      */
+    /* latter may report completion right away.      */
+    slot->frameInFlight = 1;
+    ++ker->numFramesInFlight;
+    if (heniKernelFrameSendStart(ker, &faddr, &slot->fpld))
+    {
+        slot->frameInFlight = 0;
+        --ker->numFramesInFlight;
+        heniKernelTxSlotReclaimFragment(slot);
+        return 1;
+    }
+    return 0;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void heniKernelTxSlotReclaimFragment(
+        heni_kernel_tx_slot_t * slot
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_iobuf_list_fiter_t   iter;
+    heni_iobuf_list_t         fragment;
+    int_fast8_t               usedExtra;
+
+    /* The header occupies a whole node, so */
+    /* no extra node is needed to detach it. */
+    heniIOBufListInit(&fragment);
+    heniIOBufListFIterInit(&iter, &slot->fpld);
+    heniIOBufListFIterTryAdvance(&iter, HENI_KERNEL_FRAGMENT_HEADER_SIZE);
+    usedExtra = heniIOBufListFIterSplitAt(&iter, &fragment, NULL);
+    HENI_DASSERT(! usedExtra);
+    (void)usedExtra;
+    heniKernelTxSlotMergePayload(
+            slot,
+            heniPacketGetPayloadIOVectorPtr(slot->packet),
+            &fragment
+    );
+}
 
-    if (heniKernelFrameSendStart(ker, &faddr, heniPacketGetPayloadIOVectorPtr(packet)))
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void heniKernelTxSlotMergePayload(
+        heni_kernel_tx_slot_t * slot,
+        heni_iobuf_list_t * iolHead,
+        heni_iobuf_list_t * iolTail
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_iobuf_list_fiter_t    iter;
+    heni_iobuf_list_node_t *   ionode;
+
+    heniIOBufListFIterSetAfterMerge(&iter, iolHead, iolTail);
+    if (! heniIOBufListFIterIsActive(&iter))
     {
-        heniLinkedListNodeTryRemoveFront(&ker->pktsBeingRouted);
-        heniKernelMarkOutgoingPacketAsNotSentDueToLowerLayerFailureUponFrameForwarding(packet);
-        heniLinkedListNodeAddBack(&ker->pktsAlreadySent, lnode);
-        HENI_KERNEL_TASK_POST(ker, heniKernelProcessOutgoingPacketsTask);
-        if (! heniLinkedListIsEmpty(&ker->pktsBeingRouted))
-        {
-            HENI_KERNEL_TASK_POST(ker, heniKernelRoutePacketsTask);
-        }
+        return;
+    }
+    ionode = heniIOBufListFIterGetNode(&iter);
+    if (ionode == &slot->extraNodes[0] || ionode == &slot->extraNodes[1])
+    {
+        ionode = heniIOBufListFIterTryConcatenateWithPrevious(&iter);
+        HENI_PASSERT(ionode != NULL);
     }
 }
 
 
 
+HENI_PRV_FUNCT_DEF_PREFIX void heniKernelTxSlotFinish(
+        heni_kernel_t * ker,
+        heni_kernel_tx_slot_t * slot
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_packet_t *   packet;
+
+    HENI_DASSERT(slot->packet != NULL && ! slot->frameInFlight);
+    packet = slot->packet;
+    heniKernelTxSlotMergePayload(
+            slot,
+            heniPacketGetPayloadIOVectorPtr(packet),
+            &slot->rest
+    );
+    slot->packet = NULL;
+    heniLinkedListNodeAddBack(
+            &ker->pktsAlreadySent,
+            heniPacketGetActiveListNodeForPacket(packet)
+    );
+    heniKernelStatsCountQueueEntry(ker, HENI_STATS_QUEUE_ALREADY_SENT, packet);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX int_fast8_t heniKernelHasRoutingWork(
+        heni_kernel_t * ker
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    if (heniKernelFindTxSlot(ker, 1) != NULL)
+    {
+        return 1;
+    }
+    return ! heniLinkedListIsEmpty(&ker->pktsBeingRouted) &&
+            heniKernelFindTxSlot(ker, 0) != NULL;
+}
+
+
+
 HENI_PRV_FUNCT_DEF_PREFIX void heniKernelMarkOutgoingPacketAsNotSentDueToLowerLayerFailureUponFrameForwarding(
         heni_packet_t * packet
 ) HENI_PRV_FUNCT_DEF_SUFFIX
@@ -739,28 +1393,32 @@ HENI_API_FUNCT_DEF_PREFIX void heniKernelFrameSendFinish(
         heni_frame_tx_info_t const * fsts
 ) HENI_API_FUNCT_DEF_SUFFIX
 {
-    /* FIXME iwanicki 2016-10-25:              */
-    /* This is a temporary implementation.     */
-    /* It should be fixed as soon as possible. */
-    /* In particular, it assumes that a packet */
-    /* consists of just one frame.             */
-    heni_linked_list_node_t *   lnode;
-    heni_packet_t *             packet;
-
-    lnode = heniLinkedListNodeTryRemoveFront(&ker->pktsBeingRouted);
-    HENI_PASSERT(lnode != NULL);
-    packet = heniPacketGetPacketForActiveListNode(lnode);
-    HENI_PASSERT(fpld == heniPacketGetPayloadIOVectorPtr(packet));
+    heni_kernel_tx_slot_t *   slot;
+    heni_packet_t *           packet;
+
+    slot = heniKernelFindTxSlotForFrame(ker, fpld);
+    HENI_PASSERT(slot != NULL);
+    slot->frameInFlight = 0;
+    HENI_DASSERT(ker->numFramesInFlight > 0);
+    --ker->numFramesInFlight;
+    packet = slot->packet;
     heniPacketTxInfoUpdateWithFrameTxInfo(
             &packet->opInfo.ptx,
             fsts
     );
-    heniLinkedListNodeAddBack(&ker->pktsAlreadySent, lnode);
-    HENI_KERNEL_TASK_POST(ker, heniKernelProcessOutgoingPacketsTask);
-    /* NOTICE iwanicki 2016-10-27:                  */
-    /* If the instance is stopping, the posted task */
-    /* will behave accordingly.                     */
-    if (! heniLinkedListIsEmpty(&ker->pktsBeingRouted))
+    heniKernelTxSlotReclaimFragment(slot);
+    /* A packet whose fragment has not made it */
+    /* is not worth sending any further.       */
+    if (heniIOBufListIsEmpty(&slot->rest) ||
+            packet->opInfo.ptx.status != HENI_PACKET_ROUTING_ERROR_NONE)
+    {
+        heniKernelTxSlotFinish(ker, slot);
+        HENI_KERNEL_TASK_POST(ker, heniKernelProcessOutgoingPacketsTask);
+        /* NOTICE iwanicki 2016-10-27:                  */
+        /* If the instance is stopping, the posted task */
+        /* will behave accordingly.                     */
+    }
+    if (heniKernelHasRoutingWork(ker))
     {
         HENI_KERNEL_TASK_POST(ker, heniKernelRoutePacketsTask);
     }
@@ -775,16 +1433,20 @@ HENI_API_FUNCT_DEF_PREFIX int_fast8_t heniKernelFrameReceiveStart(
         heni_frame_rx_info_t const * fsts
 ) HENI_API_FUNCT_DEF_SUFFIX
 {
-    /* FIXME iwanicki 2016-11-22:              */
-    /* This is a temporary implementation.     */
-    /* It should be fixed as soon as possible. */
-    /* In particular, it assumes that a packet */
-    /* consists of just one frame.             */
-    heni_instance_t *    inst;
-    heni_packet_t *      packet;
-    heni_instance_id_t   iid;
-    int_fast8_t          status;
-
+    heni_iobuf_list_fiter_t       iter;
+    heni_iobuf_list_t             body;
+    uint8_t                       hdr[HENI_KERNEL_FRAGMENT_HEADER_SIZE];
+    heni_instance_t *             inst;
+    heni_packet_t *               packet;
+    heni_kernel_reassembly_t *    ras;
+    heni_kernel_rx_fragment_t *   frag;
+    uint8_t const *               srcAddrPtr;
+    size_t                        len;
+    uint16_t                      offset;
+    heni_instance_id_t            iid;
+    int_fast8_t                   status;
+
+    iid = HENI_INSTANCE_ID_INVALID;
     if (! heniKernelFrameReceivedCanBeAcceptedLocally(faddr))
     {
         status = HENI_PACKET_ROUTING_ERROR_NOT_FOR_ME;
@@ -813,44 +1475,200 @@ HENI_API_FUNCT_DEF_PREFIX int_fast8_t heniKernelFrameReceiveStart(
 
         goto FAILURE_ROLLBACK_INSTANCE_INACTIVE;
     }
-    /* FIXME iwanicki 2016-12-28:                  */
-    /* Normally, a packet for the frame should be  */
-    /* looked up.                                  */
-    packet = heniPacketAlloc(ker, iid);
-    if (packet == NULL)
+    heniIOBufListFIterInit(&iter, fpld);
+    if (heniIOBufListFIterTryCopyIntoOneBufAndAdvance(&iter, &(hdr[0]), HENI_KERNEL_FRAGMENT_HEADER_SIZE) !=
+            HENI_KERNEL_FRAGMENT_HEADER_SIZE)
     {
-        status = HENI_PACKET_ROUTING_ERROR_OUT_OF_TOKENS;
-        goto FAILURE_ROLLBACK_UNABLE_TO_ALLOCATE_PACKET;
+        status = HENI_PACKET_ROUTING_ERROR_MALFORMED_FRAME;
+        goto FAILURE_ROLLBACK_MALFORMED_FRAME;
     }
-    heniKernelResetFreshPacket(packet);
-    heniPacketRxInfoReset(&packet->opInfo.prx);
-    heniLinkAddrCopy(
-            heniFrameAddrGetSrcLinkAddrConstPtr(faddr),
-            heniPacketGetLinkLayerSrcNeighborAddrPtr(packet)
-    );
-    heniPacketAddrSetInstanceID(&packet->paddr, iid);
+    offset = (uint16_t)(((uint16_t)hdr[2] << 8) | hdr[3]);
+    srcAddrPtr = heniFrameAddrGetSrcLinkAddrConstPtr(faddr);
+    ras = heniKernelFindReassembly(inst, srcAddrPtr, hdr[0]);
+    if (offset == 0)
+    {
+        /* The first fragment of a packet supersedes */
+        /* any leftovers of a packet with the same   */
+        /* tag from the same neighbor.               */
+        if (ras != NULL)
+        {
+            heniKernelReleaseReassembly(ker, ras);
+        }
+        ras = heniKernelAcquireReassembly(ker, inst);
+        if (ras == NULL)
+        {
+            status = HENI_PACKET_ROUTING_ERROR_OUT_OF_TOKENS;
+            goto FAILURE_ROLLBACK_UNABLE_TO_ACQUIRE_REASSEMBLY;
+        }
+        packet = heniPacketAlloc(ker, iid);
+        if (packet == NULL)
+        {
+            status = HENI_PACKET_ROUTING_ERROR_OUT_OF_TOKENS;
+            goto FAILURE_ROLLBACK_UNABLE_TO_ALLOCATE_PACKET;
+        }
+        heniKernelResetFreshPacket(packet);
+        heniPacketRxInfoReset(&packet->opInfo.prx);
+        heniLinkAddrCopy(
+                srcAddrPtr,
+                heniPacketGetLinkLayerSrcNeighborAddrPtr(packet)
+        );
+        heniPacketAddrSetInstanceID(&packet->paddr, iid);
+        ras->packet = packet;
+        heniIOBufListInit(&ras->ppld);
+        ras->offset = 0;
+        ras->tag = hdr[0];
+        ras->stamp = inst->reassemblyClock++;
+        ras->complete = 0;
+        ras->numFragments = 0;
+    }
+    else if (ras == NULL)
+    {
+        status = HENI_PACKET_ROUTING_ERROR_UNEXPECTED_FRAGMENT;
+        goto FAILURE_ROLLBACK_UNEXPECTED_FRAGMENT;
+    }
+    len = heniIOBufListGetCapacity(fpld) - HENI_KERNEL_FRAGMENT_HEADER_SIZE;
+    if (ras->offset != offset || ras->numFragments >= HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET ||
+            (size_t)offset + len > 65535U)
+    {
+        /* The fragment does not continue the */
+        /* packet, so the latter is dropped.  */
+        heniKernelReleaseReassembly(ker, ras);
+        status = HENI_PACKET_ROUTING_ERROR_UNEXPECTED_FRAGMENT;
+        goto FAILURE_ROLLBACK_UNEXPECTED_FRAGMENT;
+    }
+    packet = ras->packet;
+    /* The remainder of the frame payload is lent */
+    /* to the packet without copying. The frame   */
+    /* retains the header until it is released.   */
+    frag = &ras->fragments[ras->numFragments++];
+    frag->fpld = fpld;
+    heniIOBufListInit(&body);
+    heniIOBufListFIterSplitAt(&iter, &body, &frag->extraNode);
+    frag->len = (uint16_t)len;
+    heniIOBufListMerge(&ras->ppld, &body);
+    ras->offset += (uint16_t)len;
     heniPacketRxInfoUpdateWithFrameRxInfo(&packet->opInfo.prx, fsts);
-    /* FIXME iwanicki 2016-11-22:                    */
-    /* These addresses are invalid.                  */
-    /* The payload is not reassembled.               */
-    packet->ppld = fpld;
-    heniLinkedListNodeAddBack(
-        &ker->pktsToReceive,
-        heniPacketGetActiveListNodeForPacket(packet)
-    );
-    HENI_KERNEL_TASK_POST(ker, heniKernelProcessIncomingPacketsTask);
+    if ((hdr[1] & HENI_KERNEL_FRAGMENT_HEADER_FLAG_MORE) == 0)
+    {
+        ras->complete = 1;
+        packet->ppld = &ras->ppld;
+        heniLinkedListNodeAddBack(
+            &ker->pktsToReceive,
+            heniPacketGetActiveListNodeForPacket(packet)
+        );
+        heniKernelStatsCountQueueEntry(ker, HENI_STATS_QUEUE_TO_RECEIVE, packet);
+        HENI_KERNEL_TASK_POST(ker, heniKernelProcessIncomingPacketsTask);
+    }
     return HENI_PACKET_ROUTING_ERROR_NONE;
 
 FAILURE_ROLLBACK_UNABLE_TO_ALLOCATE_PACKET:
+FAILURE_ROLLBACK_UNABLE_TO_ACQUIRE_REASSEMBLY:
+FAILURE_ROLLBACK_UNEXPECTED_FRAGMENT:
+FAILURE_ROLLBACK_MALFORMED_FRAME:
 FAILURE_ROLLBACK_INSTANCE_INACTIVE:
 FAILURE_ROLLBACK_INSTANCE_NONEXISTING:
 FAILURE_ROLLBACK_INVALID_IID:
 FAILURE_ROLLBACK_FRAME_NOT_FOR_ME:
+    heniKernelStatsCountPacket(ker, iid, (uint_fast8_t)status, 0);
     return -status;
 }
 
 
 
+HENI_PRV_FUNCT_DEF_PREFIX heni_kernel_reassembly_t * heniKernelFindReassembly(
+        heni_instance_t * inst,
+        uint8_t const * srcAddrPtr,
+        uint8_t tag
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    uint_fast8_t   i;
+
+    for (i = 0; i < HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE; ++i)
+    {
+        heni_kernel_reassembly_t * ras = &inst->reassemblies[i];
+        if (ras->packet != NULL && ! ras->complete && ras->tag == tag &&
+                heniLinkAddrCmp(
+                        heniPacketGetLinkLayerSrcNeighborAddrConstPtr(ras->packet),
+                        srcAddrPtr) == 0)
+        {
+            return ras;
+        }
+    }
+    return NULL;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_kernel_reassembly_t * heniKernelAcquireReassembly(
+        heni_kernel_t * ker,
+        heni_instance_t * inst
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_kernel_reassembly_t *   oldest = NULL;
+    uint8_t                      oldestAge = 0;
+    uint_fast8_t                 i;
+
+    for (i = 0; i < HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE; ++i)
+    {
+        heni_kernel_reassembly_t * ras = &inst->reassemblies[i];
+        if (ras->packet == NULL)
+        {
+            return ras;
+        }
+        if (! ras->complete &&
+                (oldest == NULL || (uint8_t)(inst->reassemblyClock - ras->stamp) > oldestAge))
+        {
+            oldest = ras;
+            oldestAge = (uint8_t)(inst->reassemblyClock - ras->stamp);
+        }
+    }
+    if (oldest != NULL)
+    {
+        heniKernelReleaseReassembly(ker, oldest);
+    }
+    return oldest;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void heniKernelReleaseReassembly(
+        heni_kernel_t * ker,
+        heni_kernel_reassembly_t * ras
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_iobuf_list_fiter_t    iter;
+    heni_iobuf_list_t          tail;
+    heni_iobuf_list_node_t *   ionode;
+    uint_fast8_t               i;
+
+    HENI_DASSERT(ras->packet != NULL);
+    /* The fragments lie on the payload in the order  */
+    /* of their frames and each one starts at a node, */
+    /* so they can be split off without extra nodes.  */
+    for (i = 0; i < ras->numFragments; ++i)
+    {
+        heni_kernel_rx_fragment_t * frag = &ras->fragments[i];
+        heniIOBufListInit(&tail);
+        heniIOBufListFIterInit(&iter, &ras->ppld);
+        heniIOBufListFIterTryAdvance(&iter, frag->len);
+        heniIOBufListFIterSplitAt(&iter, &tail, NULL);
+        heniIOBufListFIterSetAfterMerge(&iter, frag->fpld, &ras->ppld);
+        if (heniIOBufListFIterIsActive(&iter) &&
+                heniIOBufListFIterGetNode(&iter) == &frag->extraNode)
+        {
+            ionode = heniIOBufListFIterTryConcatenateWithPrevious(&iter);
+            HENI_PASSERT(ionode != NULL);
+        }
+        heniIOBufListMerge(&ras->ppld, &tail);
+        heniKernelFrameReceiveFinish(ker, frag->fpld);
+    }
+    ras->numFragments = 0;
+    heniPacketFree(ker, heniKernelAccessorsGetIIDForPacket(ker, ras->packet), ras->packet);
+    ras->packet = NULL;
+}
+
+
+
 HENI_PRV_FUNCT_DEF_PREFIX int_fast8_t heniKernelFrameReceivedCanBeAcceptedLocally(
         heni_frame_addr_t const * faddr
 ) HENI_PRV_FUNCT_DEF_SUFFIX
@@ -869,18 +1687,24 @@ HENI_HID_FUNCT_DEF_PREFIX void heniKernelProcessIncomingPacketsTask(
     heni_linked_list_node_t *   lnode;
     heni_packet_t *             packet;
     heni_instance_id_t          iid;
-    uint8_t                     needsReposting = 0;
+    heni_kernel_task_batch_t    budget;
     uint8_t                     stoppingInstanceAffected = 0;
 
-    lnode = heniLinkedListNodeTryRemoveFront(&ker->pktsToReceive);
-    if (lnode != NULL)
+    for (budget = ker->taskBatchLimit; budget > 0; --budget)
     {
+        lnode = heniLinkedListNodeTryRemoveFront(&ker->pktsToReceive);
+        if (lnode == NULL)
+        {
+            break;
+        }
         packet = heniPacketGetPacketForActiveListNode(lnode);
+        heniKernelStatsCountQueueExit(ker, HENI_STATS_QUEUE_TO_RECEIVE, packet);
         iid = heniKernelAccessorsGetIIDForPacket(ker, packet);
         HENI_DASSERT(iid >= HENI_INSTANCE_ID_MIN && iid <= HENI_INSTANCE_ID_MAX);
         HENI_DASSERT(ker->instancePtrs[heniKernelIIDToIdx(iid)] != NULL);
         if (! heniKernelAccessorsInstanceFlagRunningIsSet(ker, iid))
         {
+            heniKernelStatsCountPacket(ker, iid, HENI_PACKET_ROUTING_ERROR_INSTANCE_NOT_RUNNING, 0);
             heniKernelDisposeOfReceivedPacket(ker, packet);
             if (heniLinkedListIsEmpty(&ker->pktsToReceive) &&
                     heniLinkedListIsEmpty(&ker->pktsAlreadyReceived))
@@ -895,9 +1719,11 @@ HENI_HID_FUNCT_DEF_PREFIX void heniKernelProcessIncomingPacketsTask(
             /* We should do it and signal reception    */
             /* only if the packet is for us.           */
             heniLinkedListNodeAddBack(&ker->pktsAlreadyReceived, lnode);
+            heniKernelStatsCountQueueEntry(ker, HENI_STATS_QUEUE_ALREADY_RECEIVED, packet);
             if (heniPacketReceiveStart(ker, &packet->paddr, packet->ppld, &packet->opInfo.prx))
             {
                 HENI_PASSERT(heniLinkedListNodeTryRemoveBack(&ker->pktsAlreadyReceived) == lnode);
+                heniKernelStatsCountQueueExit(ker, HENI_STATS_QUEUE_ALREADY_RECEIVED, packet);
                 heniKernelDisposeOfReceivedPacket(ker, packet);
                 if (! heniKernelAccessorsInstanceFlagRunningIsSet(ker, iid) &&
                         heniLinkedListIsEmpty(&ker->pktsToReceive) &&
@@ -906,14 +1732,13 @@ HENI_HID_FUNCT_DEF_PREFIX void heniKernelProcessIncomingPacketsTask(
                     stoppingInstanceAffected = 1;
                 }
             }
-            /* When the reception went fine, there is not much to do here. */
-        }
-        if (! heniLinkedListIsEmpty(&ker->pktsToReceive))
-        {
-            needsReposting = 1;
+            else
+            {
+                heniKernelStatsCountPacket(ker, iid, HENI_PACKET_ROUTING_ERROR_NONE, 0);
+            }
         }
     }
-    if (needsReposting)
+    if (! heniLinkedListIsEmpty(&ker->pktsToReceive))
     {
         HENI_KERNEL_TASK_POST(ker, heniKernelProcessIncomingPacketsTask);
     }
@@ -932,21 +1757,18 @@ HENI_PRV_FUNCT_DEF_PREFIX void heniKernelDisposeOfReceivedPacket(
 {
     /* FIXME iwanicki 2016-11-22:              */
     /* This is a temporary implementation.     */
-    /* It should be fixed as soon as possible. */
     /* The true implementation should check    */
     /* where the packet originated (i.e.,      */
     /* local send or network (based on the     */
     /* neighbors link-local address) and       */
-    /* return it there (e.g., free up all      */
-    /* frames).                                */
-    heni_instance_id_t   iid;
+    /* return it there.                        */
+    heni_kernel_reassembly_t *   ras;
 
-    iid = heniKernelAccessorsGetIIDForPacket(ker, packet);
-    HENI_DASSERT(iid >= HENI_INSTANCE_ID_MIN && iid <= HENI_INSTANCE_ID_MAX);
-    HENI_DASSERT(ker->instancePtrs[heniKernelIIDToIdx(iid)] != NULL);
-    heniKernelFrameReceiveFinish(ker, packet->ppld);
+    HENI_DASSERT(ker->instancePtrs[heniKernelIIDToIdx(heniKernelAccessorsGetIIDForPacket(ker, packet))] != NULL);
+    ras = heniKernelGetReassemblyPtrFromPayloadPtr(packet->ppld);
+    HENI_DASSERT(ras->packet == packet && ras->complete);
     packet->ppld = NULL;
-    heniPacketFree(ker, iid, packet);
+    heniKernelReleaseReassembly(ker, ras);
 }
 
 
@@ -972,6 +1794,7 @@ HENI_API_FUNCT_DEF_PREFIX void heniPacketReceiveFinish(
             HENI_DASSERT(iid >= HENI_INSTANCE_ID_MIN && iid <= HENI_INSTANCE_ID_MAX);
             HENI_DASSERT(ker->instancePtrs[heniKernelIIDToIdx(iid)] != NULL);
             heniLinkedListFIterRemoveAndAdvance(&fiter);
+            heniKernelStatsCountQueueExit(ker, HENI_STATS_QUEUE_ALREADY_RECEIVED, packet);
             heniKernelDisposeOfReceivedPacket(ker, packet);
             if (! heniKernelAccessorsInstanceFlagRunningIsSet(ker, iid) &&
                     heniLinkedListIsEmpty(&ker->pktsToReceive) &&
@@ -991,6 +1814,71 @@ HENI_API_FUNCT_DEF_PREFIX void heniPacketReceiveFinish(
 
 
 
+HENI_PRV_FUNCT_DEF_PREFIX void heniKernelStatsCountQueueEntry(
+        heni_kernel_t * ker,
+        heni_stats_queue_t queue,
+        heni_packet_t * packet
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+#if HENI_KERNEL_WITH_STATS
+    packet->queuedAt = heniStatsGetTimestamp(ker);
+    heniStatsCountQueueEntry(&ker->stats, queue);
+#else
+    (void)ker;
+    (void)queue;
+    (void)packet;
+#endif /* HENI_KERNEL_WITH_STATS */
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void heniKernelStatsCountQueueExit(
+        heni_kernel_t * ker,
+        heni_stats_queue_t queue,
+        heni_packet_t const * packet
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+#if HENI_KERNEL_WITH_STATS
+    heniStatsCountQueueExit(
+            &ker->stats,
+            queue,
+            (heni_stats_timestamp_t)(heniStatsGetTimestamp(ker) - packet->queuedAt)
+    );
+#else
+    (void)ker;
+    (void)queue;
+    (void)packet;
+#endif /* HENI_KERNEL_WITH_STATS */
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void heniKernelStatsCountPacket(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid,
+        uint_fast8_t status,
+        uint_fast8_t outgoing
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+#if HENI_KERNEL_WITH_STATS
+    if (outgoing)
+    {
+        heniStatsCountTxPacket(&ker->stats, iid, status);
+    }
+    else
+    {
+        heniStatsCountRxPacket(&ker->stats, iid, status);
+    }
+#else
+    (void)ker;
+    (void)iid;
+    (void)status;
+    (void)outgoing;
+#endif /* HENI_KERNEL_WITH_STATS */
+}
+
+
+
 /* ---------------------------------------------------------------------- *
  *                                                                        *
  *                        Kernel object accessors                         *
@@ -1097,6 +1985,7 @@ HENI_PRV_FUNCT_DEF_PREFIX void heniKernelResetFreshPacket(
     heniPacketAddrReset(&packet->paddr);
     packet->ppld = NULL;
     heniLinkAddrInvalidate(heniPacketGetLinkLayerSrcNeighborAddrPtr(packet));
+    heniLinkAddrInvalidate(heniPacketGetLinkLayerDstNeighborAddrPtr(packet));
     /* packet->opInfo; */
 }
 
@@ -1108,6 +1997,7 @@ HENI_HID_FUNCT_DEF_PREFIX heni_instance_t * heniKernelInstanceCreate(
 ) HENI_HID_FUNCT_DEF_SUFFIX
 {
     heni_instance_t *   inst;
+    uint_fast8_t        i;
 
     inst = heniKernelInstanceAlloc(ker, iid);
     if (inst == NULL)
@@ -1120,6 +2010,14 @@ HENI_HID_FUNCT_DEF_PREFIX heni_instance_t * heniKernelInstanceCreate(
     /* The spec should be configurable. */
     inst->lspec = 7;
     inst->logNumZoneDiscrBitsPlusOne = 7; /* a discriminator has 64 bits */
+    inst->zoneTable = NULL;
+    memset(&inst->label, 0, sizeof(heni_label_container_t));
+    for (i = 0; i < HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE; ++i)
+    {
+        inst->reassemblies[i].packet = NULL;
+        inst->reassemblies[i].numFragments = 0;
+    }
+    inst->reassemblyClock = 0;
     return inst;
 FAILURE_ROLLBACK_ALLOC_FAILED:
     return NULL;
@@ -1132,6 +2030,15 @@ HENI_HID_FUNCT_DEF_PREFIX void heniKernelInstanceDestroy(
 ) HENI_HID_FUNCT_DEF_SUFFIX
 {
     HENI_DASSERT(inst != NULL);
+#ifdef HENI_DEBUG
+    {
+        uint_fast8_t   i;
+        for (i = 0; i < HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE; ++i)
+        {
+            HENI_DASSERT(inst->reassemblies[i].packet == NULL);
+        }
+    }
+#endif /* HENI_DEBUG */
     heniKernelInstanceFree(inst->ker, inst->iid, inst);
 }
 
@@ -1152,8 +2059,17 @@ HENI_HID_FUNCT_DEF_PREFIX void heniKernelInstanceOnStopTrigger(
         heni_instance_t * inst
 ) HENI_HID_FUNCT_DEF_SUFFIX
 {
-    /* NOTICE iwanicki 2016-12-29:                   */
-    /* Currently, there are no initialization steps. */
+    uint_fast8_t   i;
+
+    /* Packets that have not been reassembled */
+    /* completely will never be delivered.    */
+    for (i = 0; i < HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE; ++i)
+    {
+        if (inst->reassemblies[i].packet != NULL && ! inst->reassemblies[i].complete)
+        {
+            heniKernelReleaseReassembly(inst->ker, &inst->reassemblies[i]);
+        }
+    }
 }
 
 
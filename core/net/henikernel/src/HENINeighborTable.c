@@ -8,6 +8,41 @@
 #include "HENINeighborTable.h"
 
 
+#if HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS
+
+/**
+ * This is a private implementation function.
+ *
+ * Returns a fingerprint of a link-layer address
+ * for a HENI neighbor table.
+ * @param laddrHash The hash of the address.
+ * @return The fingerprint, which is at least
+ *   HENI_NEIGHBOR_TABLE_FINGERPRINT_MIN_USED.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX uint8_t heniNeighborTableGetFingerprintForHash(
+        size_t laddrHash
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Frees a slot of a HENI neighbor table. The slot
+ * becomes empty if its element has an empty slot,
+ * as no probe sequence continues past such an
+ * element; otherwise, the slot is marked as deleted.
+ * @param elem The element of the table.
+ * @param slotIdx The index of the slot.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX void heniNeighborTableFreeSlot(
+        heni_neighbor_table_elem_t * elem,
+        size_t slotIdx
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+#endif /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
+
+
+
+#if ! HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS
 
 HENI_HID_FUNCT_DEF_PREFIX int_fast8_t heniNeighborTableTIterInitAtOrBeforeNeighbor(
         heni_neighbor_table_titer_t * nbtti,
@@ -89,6 +124,106 @@ HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableInit(
     }
 }
 
+#else /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
+
+HENI_HID_FUNCT_DEF_PREFIX int_fast8_t heniNeighborTableTIterInitAtOrBeforeNeighbor(
+        heni_neighbor_table_titer_t * nbtti,
+        heni_neighbor_table_t * nbt,
+        uint8_t const * laddrPtr
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    size_t    laddrHash = heniLinkAddrHash(laddrPtr);
+    uint8_t   fp = heniNeighborTableGetFingerprintForHash(laddrHash);
+    size_t    bucketIdx = laddrHash % nbt->bucketsCount;
+    size_t    numProbes;
+    nbtti->nbt = nbt;
+    nbtti->bucketIdx = nbt->bucketsCount;
+    nbtti->slotIdx = 0;
+    for (numProbes = 0; numProbes < nbt->bucketsCount; ++numProbes)
+    {
+        heni_neighbor_table_elem_t const *   elem = &(nbt->bucketsPtr[bucketIdx]);
+        int_fast8_t                          hasEmpty = 0;
+        size_t                               slotIdx;
+        for (slotIdx = 0; slotIdx < HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM; ++slotIdx)
+        {
+            uint8_t   fpTmp = elem->fingerprints[slotIdx];
+            if (fpTmp == fp)
+            {
+                if (heniLinkAddrCmp(
+                        heniNeighborEntryGetLinkAddrConstPtr(elem->neighbors[slotIdx]),
+                        laddrPtr) == 0)
+                {
+                    nbtti->bucketIdx = bucketIdx;
+                    nbtti->slotIdx = slotIdx;
+                    return 1;
+                }
+            }
+            else if (fpTmp < HENI_NEIGHBOR_TABLE_FINGERPRINT_MIN_USED)
+            {
+                if (nbtti->bucketIdx >= nbt->bucketsCount)
+                {
+                    nbtti->bucketIdx = bucketIdx;
+                    nbtti->slotIdx = slotIdx;
+                }
+                hasEmpty |= fpTmp == HENI_NEIGHBOR_TABLE_FINGERPRINT_EMPTY;
+            }
+        }
+        if (hasEmpty)
+        {
+            break;
+        }
+        bucketIdx = bucketIdx + 1 < nbt->bucketsCount ? bucketIdx + 1 : 0;
+    }
+    return 0;
+}
+
+
+
+HENI_HID_FUNCT_DEC_PREFIX void heniNeighborTableTIterSeekNextNeighbor(
+        heni_neighbor_table_titer_t * nbtti
+) HENI_HID_FUNCT_DEC_SUFFIX
+{
+    for (; nbtti->bucketIdx < nbtti->nbt->bucketsCount; ++nbtti->bucketIdx)
+    {
+        uint8_t const *   fps = &(nbtti->nbt->bucketsPtr[nbtti->bucketIdx].fingerprints[0]);
+        for (; nbtti->slotIdx < HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM; ++nbtti->slotIdx)
+        {
+            if (fps[nbtti->slotIdx] >= HENI_NEIGHBOR_TABLE_FINGERPRINT_MIN_USED)
+            {
+                return;
+            }
+        }
+        nbtti->slotIdx = 0;
+    }
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableInit(
+        heni_neighbor_table_t * nbt,
+        heni_kernel_t * ker,
+        heni_neighbor_table_elem_t * bufPtr,
+        size_t bufLen
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    size_t   bucketIdx, slotIdx;
+    HENI_PASSERT(bufPtr != NULL && bufLen > 0);
+    nbt->bucketsCount = bufLen;
+    nbt->bucketsPtr = bufPtr;
+    nbt->ker = ker;
+    for (bucketIdx = 0; bucketIdx < bufLen; ++bucketIdx)
+    {
+        for (slotIdx = 0; slotIdx < HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM; ++slotIdx)
+        {
+            nbt->bucketsPtr[bucketIdx].fingerprints[slotIdx] =
+                    HENI_NEIGHBOR_TABLE_FINGERPRINT_EMPTY;
+            nbt->bucketsPtr[bucketIdx].neighbors[slotIdx] = NULL;
+        }
+    }
+}
+
+#endif /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
+
 
 
 HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableCleanup(
@@ -104,6 +239,8 @@ HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableCleanup(
 
 
 
+#if ! HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS
+
 HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableAddNonexisting(
         heni_neighbor_table_t * nbt,
         uint8_t const * laddrPtr,
@@ -120,6 +257,28 @@ HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableAddNonexisting(
     );
 }
 
+#else /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
+
+HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableAddNonexisting(
+        heni_neighbor_table_t * nbt,
+        uint8_t const * laddrPtr,
+        heni_neighbor_t * nbr
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    heni_neighbor_table_titer_t   nbtti;
+    heni_neighbor_table_elem_t *  elem;
+
+    heniLinkAddrCopy(laddrPtr, heniNeighborEntryGetLinkAddrPtr(nbr));
+    HENI_PASSERT(! heniNeighborTableTIterInitAtOrBeforeNeighbor(&nbtti, nbt, laddrPtr));
+    HENI_PASSERT(heniNeighborTableTIterIsActive(&nbtti));
+    elem = &(nbt->bucketsPtr[nbtti.bucketIdx]);
+    elem->fingerprints[nbtti.slotIdx] =
+            heniNeighborTableGetFingerprintForHash(heniLinkAddrHash(laddrPtr));
+    elem->neighbors[nbtti.slotIdx] = nbr;
+}
+
+#endif /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
+
 
 
 HENI_API_FUNCT_DEF_PREFIX heni_neighbor_t * heniNeighborTableFind(
@@ -137,6 +296,8 @@ HENI_API_FUNCT_DEF_PREFIX heni_neighbor_t * heniNeighborTableFind(
 
 
 
+#if ! HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS
+
 HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableRemoveExisting(
         heni_neighbor_table_t * nbt,
         uint8_t const * laddrPtr
@@ -243,3 +404,158 @@ HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableTIterRemoveAndAdvance(
     heniLinkedListFIterRemoveAndAdvance(&nbtti->bucketIter);
     heniNeighborTableTIterSeekNextNeighbor(nbtti);
 }
+
+#else /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
+
+HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableRemoveExisting(
+        heni_neighbor_table_t * nbt,
+        uint8_t const * laddrPtr
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    heni_neighbor_table_titer_t   nbtti;
+    HENI_PASSERT(heniNeighborTableTIterInitAtOrBeforeNeighbor(&nbtti, nbt, laddrPtr));
+    heniNeighborTableFreeSlot(&(nbt->bucketsPtr[nbtti.bucketIdx]), nbtti.slotIdx);
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableTIterInit(
+        heni_neighbor_table_titer_t * nbtti,
+        heni_neighbor_table_t * nbt
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    nbtti->nbt = nbt;
+    nbtti->bucketIdx = 0;
+    nbtti->slotIdx = 0;
+    heniNeighborTableTIterSeekNextNeighbor(nbtti);
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableTIterCopy(
+        heni_neighbor_table_titer_t const * nbttiSrc,
+        heni_neighbor_table_titer_t * nbttiDst
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    nbttiDst->nbt = nbttiSrc->nbt;
+    nbttiDst->bucketIdx = nbttiSrc->bucketIdx;
+    nbttiDst->slotIdx = nbttiSrc->slotIdx;
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableTIterToPIter(
+        heni_neighbor_table_titer_t const * nbtti,
+        heni_neighbor_table_piter_t * nbtpi
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    nbtpi->nbt = nbtti->nbt;
+    nbtpi->bucketIdx = nbtti->bucketIdx;
+    nbtpi->slotIdx = nbtti->slotIdx;
+    if (heniNeighborTableTIterIsActive(nbtti))
+    {
+        heniLinkAddrCopy(
+                heniNeighborEntryGetLinkAddrConstPtr(
+                        heniNeighborTableTIterGetNeighbor(nbtti)
+                ),
+                &(nbtpi->currNeighborLinkAddr.data8[0])
+        );
+    }
+    else
+    {
+        heniLinkAddrInvalidate(&(nbtpi->currNeighborLinkAddr.data8[0]));
+    }
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniNeighborTablePIterToTIter(
+        heni_neighbor_table_piter_t const * nbtpi,
+        heni_neighbor_table_titer_t * nbtti
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    if (heniLinkAddrIsValid(&(nbtpi->currNeighborLinkAddr.data8[0])))
+    {
+        if (heniNeighborTableTIterInitAtOrBeforeNeighbor(
+                nbtti,
+                nbtpi->nbt,
+                &(nbtpi->currNeighborLinkAddr.data8[0])))
+        {
+            return;
+        }
+        /* The neighbor is gone: resume at its former slot. */
+        nbtti->bucketIdx = nbtpi->bucketIdx;
+        nbtti->slotIdx = nbtpi->slotIdx;
+        heniNeighborTableTIterSeekNextNeighbor(nbtti);
+    }
+    else
+    {
+        nbtti->nbt = nbtpi->nbt;
+        nbtti->bucketIdx = nbtti->nbt->bucketsCount;
+        nbtti->slotIdx = 0;
+    }
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableTIterAdvance(
+        heni_neighbor_table_titer_t * nbtti
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(heniNeighborTableTIterIsActive(nbtti));
+    ++nbtti->slotIdx;
+    heniNeighborTableTIterSeekNextNeighbor(nbtti);
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniNeighborTableTIterRemoveAndAdvance(
+        heni_neighbor_table_titer_t * nbtti
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(heniNeighborTableTIterIsActive(nbtti));
+    heniNeighborTableFreeSlot(
+            &(nbtti->nbt->bucketsPtr[nbtti->bucketIdx]),
+            nbtti->slotIdx
+    );
+    ++nbtti->slotIdx;
+    heniNeighborTableTIterSeekNextNeighbor(nbtti);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX uint8_t heniNeighborTableGetFingerprintForHash(
+        size_t laddrHash
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    /* The bucket is taken from the low bits of the hash, */
+    /* so the fingerprint mixes in all of them.            */
+    uint32_t   mix = (uint32_t)laddrHash * (uint32_t)2654435761UL;
+    uint8_t    fp = (uint8_t)(mix >> 24);
+    return fp < HENI_NEIGHBOR_TABLE_FINGERPRINT_MIN_USED ?
+            (uint8_t)(fp + HENI_NEIGHBOR_TABLE_FINGERPRINT_MIN_USED) : fp;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void heniNeighborTableFreeSlot(
+        heni_neighbor_table_elem_t * elem,
+        size_t slotIdx
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    uint8_t   fpNew = HENI_NEIGHBOR_TABLE_FINGERPRINT_DELETED;
+    size_t    i;
+    HENI_DASSERT(elem->fingerprints[slotIdx] >= HENI_NEIGHBOR_TABLE_FINGERPRINT_MIN_USED);
+    for (i = 0; i < HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM; ++i)
+    {
+        if (elem->fingerprints[i] == HENI_NEIGHBOR_TABLE_FINGERPRINT_EMPTY)
+        {
+            fpNew = HENI_NEIGHBOR_TABLE_FINGERPRINT_EMPTY;
+            break;
+        }
+    }
+    elem->fingerprints[slotIdx] = fpNew;
+    elem->neighbors[slotIdx] = NULL;
+}
+
+#endif /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
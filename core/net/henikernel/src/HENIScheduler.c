@@ -17,12 +17,19 @@ HENI_HID_FUNCT_DEF_PREFIX void heniKernelTaskSchedulerInit(
 ) HENI_HID_FUNCT_DEF_SUFFIX
 {
     heni_kernel_task_count_t   taskId;
-    sched->frontId = HENI_KERNEL_TASK_NULL;
-    sched->backId = HENI_KERNEL_TASK_NULL;
+    heni_kernel_task_prio_t    prio;
+    for (prio = 0; prio < HENI_KERNEL_TASK_PRIO_COUNT; ++prio)
+    {
+        sched->frontIds[prio] = HENI_KERNEL_TASK_NULL;
+        sched->backIds[prio] = HENI_KERNEL_TASK_NULL;
+    }
     for (taskId = 0; taskId < HENI_KERNEL_TASK_COUNT; ++taskId)
     {
         sched->nextIds[taskId] = HENI_KERNEL_TASK_NULL;
     }
+#if HENI_KERNEL_TASK_WITH_STATS
+    heniKernelTaskSchedulerResetStats(sched);
+#endif /* HENI_KERNEL_TASK_WITH_STATS */
 }
 
 
@@ -32,19 +39,24 @@ HENI_HID_FUNCT_DEF_PREFIX int_fast8_t heniKernelTaskSchedulerAddTask(
         heni_kernel_task_count_t taskId
 ) HENI_HID_FUNCT_DEF_SUFFIX
 {
+    heni_kernel_task_prio_t   prio;
     if (heniKernelTaskSchedulerIsParticularScheduled(sched, taskId))
     {
         return 0;
     }
-    if (sched->backId == HENI_KERNEL_TASK_NULL)
+    prio = heniKernelTaskSchedulerGetTaskPriority(taskId);
+    if (sched->backIds[prio] == HENI_KERNEL_TASK_NULL)
     {
-        sched->frontId = taskId;
+        sched->frontIds[prio] = taskId;
     }
     else
     {
-        sched->nextIds[sched->backId - 1] = taskId;
+        sched->nextIds[sched->backIds[prio] - 1] = taskId;
     }
-    sched->backId = taskId;
+    sched->backIds[prio] = taskId;
+#if HENI_KERNEL_TASK_WITH_STATS
+    sched->scheduledAt[taskId - 1] = sched->numExtracted;
+#endif /* HENI_KERNEL_TASK_WITH_STATS */
     return 1;
 }
 
@@ -55,17 +67,33 @@ HENI_HID_FUNCT_DEF_PREFIX heni_kernel_task_count_t heniKernelTaskSchedulerExtrac
 ) HENI_HID_FUNCT_DEF_SUFFIX
 {
     heni_kernel_task_count_t   taskId;
+    heni_kernel_task_prio_t    prio;
     HENI_DASSERT(heniKernelTaskSchedulerIsAnyScheduled(sched));
-    taskId = sched->frontId;
-    sched->frontId = sched->nextIds[taskId - 1];
-    if (sched->frontId == HENI_KERNEL_TASK_NULL)
+    for (prio = 0; sched->frontIds[prio] == HENI_KERNEL_TASK_NULL; ++prio)
+    {
+        HENI_DASSERT(prio + 1 < HENI_KERNEL_TASK_PRIO_COUNT);
+    }
+    taskId = sched->frontIds[prio];
+    sched->frontIds[prio] = sched->nextIds[taskId - 1];
+    if (sched->frontIds[prio] == HENI_KERNEL_TASK_NULL)
     {
-        sched->backId = HENI_KERNEL_TASK_NULL;
+        sched->backIds[prio] = HENI_KERNEL_TASK_NULL;
     }
     else
     {
         sched->nextIds[taskId - 1] = HENI_KERNEL_TASK_NULL;
     }
+#if HENI_KERNEL_TASK_WITH_STATS
+    {
+        heni_kernel_task_stat_t   latency = sched->numExtracted - sched->scheduledAt[taskId - 1];
+        if (latency > sched->maxLatencies[taskId - 1])
+        {
+            sched->maxLatencies[taskId - 1] = latency;
+        }
+        ++sched->numRuns[taskId - 1];
+        ++sched->numExtracted;
+    }
+#endif /* HENI_KERNEL_TASK_WITH_STATS */
     return taskId;
 }
 
@@ -91,3 +119,42 @@ HENI_HID_FUNCT_DEF_PREFIX void heniKernelTaskSchedulerExecuteTask(
     }
 }
 
+
+
+HENI_HID_FUNCT_DEF_PREFIX heni_kernel_task_prio_t heniKernelTaskSchedulerGetTaskPriority(
+        heni_kernel_task_count_t taskId
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    switch (taskId)
+    {
+    /* ----- All tasks must have their priority classes assigned here. -- */
+    HENI_KERNEL_TASK_ASSIGN_PRIORITY(heniKernelControlTask, HENI_KERNEL_TASK_PRIO_HIGH);
+    HENI_KERNEL_TASK_ASSIGN_PRIORITY(heniKernelProcessOutgoingPacketsTask, HENI_KERNEL_TASK_PRIO_LOW);
+    HENI_KERNEL_TASK_ASSIGN_PRIORITY(heniKernelProcessIncomingPacketsTask, HENI_KERNEL_TASK_PRIO_LOW);
+    HENI_KERNEL_TASK_ASSIGN_PRIORITY(heniKernelRoutePacketsTask, HENI_KERNEL_TASK_PRIO_HIGH);
+    /* ------------------------------------------------------------------ */
+    default:
+        HENI_PASSERTM(0, "An unrecognized task %lu", (long unsigned)taskId);
+    }
+    return HENI_KERNEL_TASK_PRIO_LOW;
+}
+
+
+
+#if HENI_KERNEL_TASK_WITH_STATS
+
+HENI_HID_FUNCT_DEF_PREFIX void heniKernelTaskSchedulerResetStats(
+        heni_kernel_task_scheduler_t * sched
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    heni_kernel_task_count_t   taskId;
+    sched->numExtracted = 0;
+    for (taskId = 0; taskId < HENI_KERNEL_TASK_COUNT; ++taskId)
+    {
+        sched->scheduledAt[taskId] = 0;
+        sched->numRuns[taskId] = 0;
+        sched->maxLatencies[taskId] = 0;
+    }
+}
+
+#endif /* HENI_KERNEL_TASK_WITH_STATS */
@@ -0,0 +1,122 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+#include "HENIBase.h"
+#include "HENIError.h"
+#include "HENIStats.h"
+
+
+
+HENI_HID_FUNCT_DEF_PREFIX void heniStatsInit(
+        heni_stats_t * stats
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    heni_stats_queue_t   queue;
+    for (queue = 0; queue < HENI_STATS_QUEUE_COUNT; ++queue)
+    {
+        stats->queues[queue].length = 0;
+    }
+    heniStatsReset(stats);
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniStatsReset(
+        heni_stats_t * stats
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    heni_instance_count_t   icount;
+    heni_stats_queue_t      queue;
+    uint_fast8_t            i;
+    for (icount = 0; icount <= HENI_MAX_NUM_INSTANCES; ++icount)
+    {
+        for (i = 0; i < HENI_PACKET_ROUTING_ERROR_COUNT; ++i)
+        {
+            stats->instances[icount].numTxPackets[i] = 0;
+            stats->instances[icount].numRxPackets[i] = 0;
+        }
+    }
+    for (queue = 0; queue < HENI_STATS_QUEUE_COUNT; ++queue)
+    {
+        heni_stats_queue_info_t * qinfo = &stats->queues[queue];
+        qinfo->highWaterMark = qinfo->length;
+        for (i = 0; i < HENI_STATS_NUM_HISTOGRAM_BINS; ++i)
+        {
+            qinfo->timeHistogram[i] = 0;
+        }
+    }
+}
+
+
+
+HENI_HID_FUNCT_DEF_PREFIX void heniStatsCountTxPacket(
+        heni_stats_t * stats,
+        heni_instance_id_t iid,
+        uint_fast8_t status
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(status < HENI_PACKET_ROUTING_ERROR_COUNT);
+    if (iid > HENI_INSTANCE_ID_MAX)
+    {
+        iid = HENI_INSTANCE_ID_INVALID;
+    }
+    ++stats->instances[iid].numTxPackets[status];
+}
+
+
+
+HENI_HID_FUNCT_DEF_PREFIX void heniStatsCountRxPacket(
+        heni_stats_t * stats,
+        heni_instance_id_t iid,
+        uint_fast8_t status
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(status < HENI_PACKET_ROUTING_ERROR_COUNT);
+    if (iid > HENI_INSTANCE_ID_MAX)
+    {
+        iid = HENI_INSTANCE_ID_INVALID;
+    }
+    ++stats->instances[iid].numRxPackets[status];
+}
+
+
+
+HENI_HID_FUNCT_DEF_PREFIX void heniStatsCountQueueEntry(
+        heni_stats_t * stats,
+        heni_stats_queue_t queue
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    heni_stats_queue_info_t * qinfo;
+    HENI_DASSERT(queue < HENI_STATS_QUEUE_COUNT);
+    qinfo = &stats->queues[queue];
+    ++qinfo->length;
+    if (qinfo->length > qinfo->highWaterMark)
+    {
+        qinfo->highWaterMark = qinfo->length;
+    }
+}
+
+
+
+HENI_HID_FUNCT_DEF_PREFIX void heniStatsCountQueueExit(
+        heni_stats_t * stats,
+        heni_stats_queue_t queue,
+        heni_stats_timestamp_t timeInQueue
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    heni_stats_queue_info_t * qinfo;
+    uint_fast8_t              bin;
+    HENI_DASSERT(queue < HENI_STATS_QUEUE_COUNT);
+    qinfo = &stats->queues[queue];
+    HENI_DASSERT(qinfo->length > 0);
+    --qinfo->length;
+    for (bin = 0; timeInQueue > 0 && bin < HENI_STATS_NUM_HISTOGRAM_BINS - 1; ++bin)
+    {
+        timeInQueue >>= 1;
+    }
+    ++qinfo->timeHistogram[bin];
+}
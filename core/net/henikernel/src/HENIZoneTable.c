@@ -5,6 +5,7 @@
  * All rights reserved.
  *
  */
+#include <string.h>
 #include "HENIKernel.h"
 #include "HENILabel.h"
 #include "HENILinkedList.h"
@@ -29,7 +30,64 @@ HENI_HID_FUNCT_DEC_PREFIX int_fast8_t heniZoneTableTIterSeekNextZoneInRow(
         heni_zone_table_titer_t * iter
 ) HENI_HID_FUNCT_DEC_SUFFIX;
 
+#if HENI_ZONE_TABLE_WITH_SORTED_ROWS
 
+/**
+ * This is a private implementation function.
+ *
+ * Returns the maximal number of zones that
+ * a given row of a HENI zone table can hold.
+ * @param zt The zone table.
+ * @param level The level of the row.
+ * @return The capacity of the row.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX size_t heniZoneTableGetRowCapacity(
+        heni_zone_table_t const * zt,
+        heni_level_t level
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Bisects a sorted row of a HENI zone table
+ * for the first zone whose LID and discriminator
+ * are not smaller than the given ones.
+ * @param zt The zone table.
+ * @param level The level of the row.
+ * @param lid The LID.
+ * @param discr The discriminator.
+ * @return The index of the zone in the row or
+ *   the number of zones in the row if no such
+ *   zone exists.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX size_t heniZoneTableBisectRow(
+        heni_zone_table_t const * zt,
+        heni_level_t level,
+        heni_zone_lid_t lid,
+        heni_zone_discr_t discr
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+/**
+ * This is a private implementation function.
+ *
+ * Removes a zone at a given index from a sorted
+ * row of a HENI zone table, shifting the
+ * subsequent zones of the row.
+ * @param zt The zone table.
+ * @param level The level of the row.
+ * @param idx The index of the zone.
+ */
+HENI_PRV_FUNCT_DEC_PREFIX void heniZoneTableRemoveFromRow(
+        heni_zone_table_t * zt,
+        heni_level_t level,
+        size_t idx
+) HENI_PRV_FUNCT_DEC_SUFFIX;
+
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
+
+
+
+#if ! HENI_ZONE_TABLE_WITH_SORTED_ROWS
 
 HENI_API_FUNCT_DEF_PREFIX void heniZoneTableInit(
         heni_zone_table_t * zt,
@@ -85,6 +143,67 @@ HENI_API_FUNCT_DEF_PREFIX void heniZoneTableAddNonexisting(
     );
 }
 
+#else /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
+
+HENI_API_FUNCT_DEF_PREFIX void heniZoneTableInit(
+        heni_zone_table_t * zt,
+        heni_instance_t * inst,
+        heni_zone_table_bucket_t * const * bucketPtrsPerRow,
+        size_t bucketCountPerRow
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    heni_level_t   numLevels, levelIdx;
+
+    HENI_DASSERT(inst != NULL);
+    numLevels = heniKernelInstanceGetNumLevelsForInstancePtr(inst);
+    HENI_PASSERT(numLevels >= 1 && numLevels <= HENI_MAX_LIDS_IN_LABEL);
+    zt->bucketPtrsPerRow[0] = &zt->rootZoneBucketBuf;
+    zt->zoneCountPerRow[0] = 0;
+    for (levelIdx = 1; levelIdx <= numLevels; ++levelIdx)
+    {
+        zt->bucketPtrsPerRow[levelIdx] = bucketPtrsPerRow[levelIdx - 1];
+        HENI_PASSERT(zt->bucketPtrsPerRow[levelIdx] != NULL);
+        zt->zoneCountPerRow[levelIdx] = 0;
+    }
+    for (; levelIdx <= HENI_MAX_LIDS_IN_LABEL; ++levelIdx)
+    {
+        zt->bucketPtrsPerRow[levelIdx] = NULL;
+        zt->zoneCountPerRow[levelIdx] = 0;
+    }
+    zt->bucketCountPerRow = bucketCountPerRow;
+    zt->inst = inst;
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniZoneTableAddNonexisting(
+        heni_zone_table_t * zt,
+        heni_level_t level,
+        heni_zone_lid_t lid,
+        heni_zone_discr_t discr,
+        heni_zone_t * zone
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    heni_zone_table_bucket_t *   row;
+    size_t                       idx, count;
+    HENI_DASSERT((level == 0 && lid == heniLabelSpecGetZoneLIDInvalid(heniKernelInstanceGetLabelSpecForInstancePtr(zt->inst))) ||
+            (level > 0 && heniLabelSpecIsZoneLIDAssignable(lid, heniKernelInstanceGetLabelSpecForInstancePtr(zt->inst))));
+    HENI_DASSERT(heniZoneDiscrSpecIsZoneDiscrAssignable(discr, heniKernelInstanceGetNumZoneDiscrBitsForInstancePtr(zt->inst)));
+    count = zt->zoneCountPerRow[level];
+    HENI_PASSERT(count < heniZoneTableGetRowCapacity(zt, level));
+    row = zt->bucketPtrsPerRow[level];
+    idx = heniZoneTableBisectRow(zt, level, lid, discr);
+    HENI_PASSERT(idx == count || row[idx].lid != lid || row[idx].discr != discr);
+    memmove(&row[idx + 1], &row[idx], (count - idx) * sizeof(row[0]));
+    row[idx].lid = lid;
+    row[idx].discr = discr;
+    row[idx].zone = zone;
+    zt->zoneCountPerRow[level] = count + 1;
+    heniZoneEntrySetKey(zone, level, lid, discr);
+}
+
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
+
 
 
 HENI_API_FUNCT_DEF_PREFIX heni_zone_t * heniZoneTableFind(
@@ -106,6 +225,8 @@ HENI_API_FUNCT_DEF_PREFIX heni_zone_t * heniZoneTableFind(
 
 
 
+#if ! HENI_ZONE_TABLE_WITH_SORTED_ROWS
+
 HENI_API_FUNCT_DEF_PREFIX void heniZoneTableRemoveExisting(
         heni_zone_table_t * zt,
         heni_level_t level,
@@ -232,6 +353,111 @@ HENI_API_FUNCT_DEF_PREFIX void heniZoneTableTIterSetAtLevel(
     }
 }
 
+#else /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
+
+HENI_API_FUNCT_DEF_PREFIX void heniZoneTableRemoveExisting(
+        heni_zone_table_t * zt,
+        heni_level_t level,
+        heni_zone_lid_t lid,
+        heni_zone_discr_t discr
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    heni_zone_table_titer_t   iter;
+    HENI_DASSERT((level == 0 && lid == heniLabelSpecGetZoneLIDInvalid(heniKernelInstanceGetLabelSpecForInstancePtr(zt->inst))) ||
+            (level > 0 && heniLabelSpecIsZoneLIDAssignable(lid, heniKernelInstanceGetLabelSpecForInstancePtr(zt->inst))));
+    HENI_DASSERT(heniZoneDiscrSpecIsZoneDiscrAssignable(discr, heniKernelInstanceGetNumZoneDiscrBitsForInstancePtr(zt->inst)));
+    HENI_PASSERT(heniZoneTableTIterInitAtOrBeforeZoneWithLevelAndLidAndDiscr(&iter, zt, level, lid, discr));
+    heniZoneTableRemoveFromRow(zt, level, iter.inrowBucketIdx);
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniZoneTableCleanup(
+        heni_zone_table_t * zt
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    heni_level_t   levelIdx;
+    for (levelIdx = 0; levelIdx <= HENI_MAX_LIDS_IN_LABEL; ++levelIdx)
+    {
+        HENI_PASSERT(zt->zoneCountPerRow[levelIdx] == 0);
+        zt->bucketPtrsPerRow[levelIdx] = NULL;
+    }
+    zt->bucketCountPerRow = 0;
+    zt->inst = NULL;
+}
+
+
+
+HENI_HID_FUNCT_DEF_PREFIX int_fast8_t heniZoneTableTIterInitAtOrBeforeZoneWithLevelAndLid(
+        heni_zone_table_titer_t * iter,
+        heni_zone_table_t * zt,
+        heni_level_t zoneLevel,
+        heni_zone_lid_t zoneLID
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    size_t   idx;
+    HENI_DASSERT(zoneLevel <= heniKernelInstanceGetNumLevelsForInstancePtr(zt->inst));
+    HENI_DASSERT(zt->bucketCountPerRow > 0);
+    HENI_DASSERT(zt->bucketPtrsPerRow[zoneLevel] != NULL);
+    idx = heniZoneTableBisectRow(zt, zoneLevel, zoneLID, 0);
+    iter->inrowBucketIdx = idx;
+    iter->rowLevel = zoneLevel;
+    iter->zt = zt;
+    return idx < zt->zoneCountPerRow[zoneLevel] &&
+            zt->bucketPtrsPerRow[zoneLevel][idx].lid == zoneLID ?
+                    (int_fast8_t)1 : (int_fast8_t)0;
+}
+
+
+
+HENI_HID_FUNCT_DEF_PREFIX int_fast8_t heniZoneTableTIterInitAtOrBeforeZoneWithLevelAndLidAndDiscr(
+        heni_zone_table_titer_t * iter,
+        heni_zone_table_t * zt,
+        heni_level_t zoneLevel,
+        heni_zone_lid_t zoneLID,
+        heni_zone_discr_t zoneDiscr
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    heni_zone_table_bucket_t const *   bucket;
+    size_t                             idx;
+    HENI_DASSERT(zoneLevel <= heniKernelInstanceGetNumLevelsForInstancePtr(zt->inst));
+    HENI_DASSERT(zt->bucketCountPerRow > 0);
+    HENI_DASSERT(zt->bucketPtrsPerRow[zoneLevel] != NULL);
+    idx = heniZoneTableBisectRow(zt, zoneLevel, zoneLID, zoneDiscr);
+    iter->inrowBucketIdx = idx;
+    iter->rowLevel = zoneLevel;
+    iter->zt = zt;
+    if (idx >= zt->zoneCountPerRow[zoneLevel])
+    {
+        return (int_fast8_t)0;
+    }
+    bucket = &(zt->bucketPtrsPerRow[zoneLevel][idx]);
+    return bucket->lid == zoneLID && bucket->discr == zoneDiscr ?
+            (int_fast8_t)1 : (int_fast8_t)0;
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniZoneTableTIterSetAtLevel(
+        heni_zone_table_titer_t * iter,
+        heni_zone_table_t * zt,
+        heni_level_t zoneLevel
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(zoneLevel <= heniKernelInstanceGetNumLevelsForInstancePtr(zt->inst));
+    HENI_DASSERT(zt->bucketCountPerRow > 0);
+    HENI_DASSERT(zt->bucketPtrsPerRow[zoneLevel] != NULL);
+    iter->inrowBucketIdx = 0;
+    iter->rowLevel = zoneLevel;
+    iter->zt = zt;
+    if (! heniZoneTableTIterSeekNextZoneInRow(iter))
+    {
+        heniZoneTableTIterFinish(iter);
+    }
+}
+
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
+
 
 
 HENI_API_FUNCT_DEF_PREFIX void heniZoneTableTIterSetAtLevelAndLID(
@@ -275,6 +501,8 @@ HENI_API_FUNCT_DEF_PREFIX void heniZoneTableTIterSetAtLevelAndLIDAndDiscr(
 
 
 
+#if ! HENI_ZONE_TABLE_WITH_SORTED_ROWS
+
 HENI_API_FUNCT_DEF_PREFIX void heniZoneTableTIterCopy(
         heni_zone_table_titer_t const * iterSrc,
         heni_zone_table_titer_t * iterDst
@@ -431,6 +659,161 @@ HENI_HID_FUNCT_DEF_PREFIX int_fast8_t heniZoneTableTIterSeekNextZoneInRow(
     return (int_fast8_t)0;
 }
 
+#else /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
+
+HENI_API_FUNCT_DEF_PREFIX void heniZoneTableTIterCopy(
+        heni_zone_table_titer_t const * iterSrc,
+        heni_zone_table_titer_t * iterDst
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    iterDst->inrowBucketIdx = iterSrc->inrowBucketIdx;
+    iterDst->rowLevel = iterSrc->rowLevel;
+    iterDst->zt = iterSrc->zt;
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniZoneTableTIterFinish(
+        heni_zone_table_titer_t * iter
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(iter->zt != NULL);
+    HENI_DASSERT(iter->zt->bucketCountPerRow > 0);
+    iter->inrowBucketIdx = iter->zt->bucketCountPerRow + 1;
+    iter->rowLevel = heniKernelInstanceGetNumLevelsForInstancePtr(iter->zt->inst) + 1;
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniZoneTableTIterAdvancePreservingLevel(
+        heni_zone_table_titer_t * iter
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(heniZoneTableTIterIsActive(iter));
+    HENI_DASSERT(iter->inrowBucketIdx < iter->zt->zoneCountPerRow[iter->rowLevel]);
+    ++iter->inrowBucketIdx;
+    if (! heniZoneTableTIterSeekNextZoneInRow(iter))
+    {
+        heniZoneTableTIterFinish(iter);
+    }
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniZoneTableTIterAdvancePreservingLevelAndLID(
+        heni_zone_table_titer_t * iter
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    heni_zone_table_bucket_t const *   row;
+    HENI_DASSERT(heniZoneTableTIterIsActive(iter));
+    HENI_DASSERT(iter->inrowBucketIdx < iter->zt->zoneCountPerRow[iter->rowLevel]);
+    row = iter->zt->bucketPtrsPerRow[iter->rowLevel];
+    ++iter->inrowBucketIdx;
+    if (! heniZoneTableTIterSeekNextZoneInRow(iter) ||
+            row[iter->inrowBucketIdx].lid != row[iter->inrowBucketIdx - 1].lid)
+    {
+        heniZoneTableTIterFinish(iter);
+    }
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniZoneTableTIterRemoveAndAdvancePreservingLevel(
+        heni_zone_table_titer_t * iter
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(heniZoneTableTIterIsActive(iter));
+    HENI_DASSERT(iter->inrowBucketIdx < iter->zt->zoneCountPerRow[iter->rowLevel]);
+    heniZoneTableRemoveFromRow(iter->zt, iter->rowLevel, iter->inrowBucketIdx);
+    if (! heniZoneTableTIterSeekNextZoneInRow(iter))
+    {
+        heniZoneTableTIterFinish(iter);
+    }
+}
+
+
+
+HENI_API_FUNCT_DEF_PREFIX void heniZoneTableTIterRemoveAndAdvancePreservingLevelAndLID(
+        heni_zone_table_titer_t * iter
+) HENI_API_FUNCT_DEF_SUFFIX
+{
+    heni_zone_lid_t   lid;
+    HENI_DASSERT(heniZoneTableTIterIsActive(iter));
+    HENI_DASSERT(iter->inrowBucketIdx < iter->zt->zoneCountPerRow[iter->rowLevel]);
+    lid = heniZoneTableTIterGetLID(iter);
+    heniZoneTableRemoveFromRow(iter->zt, iter->rowLevel, iter->inrowBucketIdx);
+    if (! heniZoneTableTIterSeekNextZoneInRow(iter) ||
+            heniZoneTableTIterGetLID(iter) != lid)
+    {
+        heniZoneTableTIterFinish(iter);
+    }
+}
+
+
+
+HENI_HID_FUNCT_DEF_PREFIX int_fast8_t heniZoneTableTIterSeekNextZoneInRow(
+        heni_zone_table_titer_t * iter
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    HENI_DASSERT(iter->rowLevel <= heniKernelInstanceGetNumLevelsForInstancePtr(iter->zt->inst));
+    return iter->inrowBucketIdx < iter->zt->zoneCountPerRow[iter->rowLevel] ?
+            (int_fast8_t)1 : (int_fast8_t)0;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX size_t heniZoneTableGetRowCapacity(
+        heni_zone_table_t const * zt,
+        heni_level_t level
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    return level == 0 ? 1 : zt->bucketCountPerRow;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX size_t heniZoneTableBisectRow(
+        heni_zone_table_t const * zt,
+        heni_level_t level,
+        heni_zone_lid_t lid,
+        heni_zone_discr_t discr
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_zone_table_bucket_t const *   row = zt->bucketPtrsPerRow[level];
+    size_t                             lo = 0;
+    size_t                             len = zt->zoneCountPerRow[level];
+    /* The number of steps depends only on the row length. */
+    while (len > 1)
+    {
+        size_t                             half = len >> 1;
+        heni_zone_table_bucket_t const *   b = &row[lo + half - 1];
+        lo += (b->lid < lid || (b->lid == lid && b->discr < discr)) ? half : 0;
+        len -= half;
+    }
+    if (len == 1 && (row[lo].lid < lid || (row[lo].lid == lid && row[lo].discr < discr)))
+    {
+        ++lo;
+    }
+    return lo;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void heniZoneTableRemoveFromRow(
+        heni_zone_table_t * zt,
+        heni_level_t level,
+        size_t idx
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_zone_table_bucket_t *   row = zt->bucketPtrsPerRow[level];
+    size_t                       count = zt->zoneCountPerRow[level];
+    HENI_DASSERT(idx < count);
+    memmove(&row[idx], &row[idx + 1], (count - idx - 1) * sizeof(row[0]));
+    zt->zoneCountPerRow[level] = count - 1;
+}
+
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
+
 
 
 HENI_API_FUNCT_DEF_PREFIX void heniZoneTableTIterToPIter(
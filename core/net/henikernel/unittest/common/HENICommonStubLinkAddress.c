@@ -120,3 +120,66 @@ HENI_EXT_FUNCT_DEF_PREFIX int_fast8_t heniLinkAddrIsValid(
     }
     return (int_fast8_t)0;
 }
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniLinkAddrFetchMine(
+        uint8_t * laddrPtr
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    heniLinkAddrStubFill(laddrPtr, HENI_UT_STUB_LINK_ADDR_MINE_SEED);
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX int_fast8_t heniLinkAddrIsMine(
+        uint8_t const * laddrPtr
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    heni_link_addr_container_t   mine;
+    heniLinkAddrFetchMine(&(mine.data8[0]));
+    return heniLinkAddrCmp(laddrPtr, &(mine.data8[0])) == 0 ? (int_fast8_t)1 : (int_fast8_t)0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniLinkAddrFetchAllNeighbors(
+        uint8_t * laddrPtr
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    heni_link_addr_container_t *   a =
+            (heni_link_addr_container_t *)laddrPtr;
+    size_t   i;
+    for (i = 0; i < HENI_LINK_ADDR_MAX_BYTE_SIZE; ++i)
+    {
+        a->data8[i] = 0xff;
+    }
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX int_fast8_t heniLinkAddrIsAllNeighbors(
+        uint8_t const * laddrPtr
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    heni_link_addr_container_t const *   a =
+            (heni_link_addr_container_t const *)laddrPtr;
+    size_t   i;
+    for (i = 0; i < HENI_LINK_ADDR_MAX_BYTE_SIZE; ++i)
+    {
+        if (a->data8[i] != 0xff)
+        {
+            return (int_fast8_t)0;
+        }
+    }
+    return (int_fast8_t)1;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX int_fast8_t heniLinkAddrIsMulticast(
+        uint8_t const * laddrPtr
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    return heniLinkAddrIsAllNeighbors(laddrPtr);
+}
@@ -24,6 +24,12 @@
  * @param laddrPtr A pointer to the address.
  * @param seed The seed.
  */
+/**
+ * The seed from which the stub link-layer
+ * address of the present node is generated.
+ */
+#define HENI_UT_STUB_LINK_ADDR_MINE_SEED 1
+
 HENI_EXT_FUNCT_DEC_PREFIX void heniLinkAddrStubFill(
         uint8_t * laddrPtr,
         size_t seed
@@ -0,0 +1,716 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+#include <string.h>
+#include "HENIFrame.h"
+#include "HENIKernel.h"
+#include "HENIUnitTest.h"
+#include "HENICommonStubLinkAddress.h"
+
+
+/**
+ * @file
+ * Type: heniUnitTestSynchronouslyRunAll
+ */
+
+
+enum
+{
+    UT_DEF_NUM_PACKETS = 8,
+    UT_DEF_NUM_RX_FRAMES = 8,
+    UT_DEF_IID = HENI_INSTANCE_ID_MIN,
+    UT_DEF_MAX_FRAME_SIZE = 16,
+    UT_DEF_MAX_CHUNK_SIZE = UT_DEF_MAX_FRAME_SIZE - HENI_KERNEL_FRAGMENT_HEADER_SIZE,
+    UT_DEF_MAX_PAYLOAD_SIZE = UT_DEF_MAX_CHUNK_SIZE * HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET,
+    UT_DEF_BUF_LEN_1 = 10,
+    UT_DEF_BUF_LEN_2 = UT_DEF_MAX_PAYLOAD_SIZE - UT_DEF_BUF_LEN_1,
+    /* The header of a received frame straddles two nodes. */
+    UT_DEF_RX_SPLIT = 2,
+};
+
+
+enum
+{
+    UT_DEF_LLA_SEED1 = 19,
+    UT_DEF_LLA_SEED2 = 42,
+};
+
+
+typedef struct ut_def_packet_slot_s
+{
+    heni_packet_t                packet;
+    uint8_t                      used;
+} ut_def_packet_slot_t;
+
+typedef struct ut_def_rx_frame_s
+{
+    heni_iobuf_list_t            iol;
+    heni_iobuf_list_node_t       nodes[2];
+    uint8_t                      data[UT_DEF_MAX_FRAME_SIZE];
+    size_t                       len;
+    uint8_t                      released;
+} ut_def_rx_frame_t;
+
+
+heni_kernel_t                  g_utDefKernel;
+heni_instance_t                g_utDefInstance;
+uint8_t                        g_utDefInstanceUsed;
+ut_def_packet_slot_t           g_utDefPackets[UT_DEF_NUM_PACKETS];
+
+uint8_t                        g_utDefTxBuf1[UT_DEF_BUF_LEN_1];
+uint8_t                        g_utDefTxBuf2[UT_DEF_BUF_LEN_2];
+heni_iobuf_list_node_t         g_utDefTxNodes[2];
+heni_iobuf_list_t              g_utDefTxPayload;
+ut_def_rx_frame_t              g_utDefRxFrames[UT_DEF_NUM_RX_FRAMES];
+
+uint8_t                        g_utDefComputationsPostponed;
+heni_iobuf_list_t *            g_utDefFramesInFlight[UT_DEF_NUM_PACKETS];
+size_t                         g_utDefNumFramesInFlight;
+size_t                         g_utDefNumFramesSent;
+uint8_t                        g_utDefLastSentStatus;
+size_t                         g_utDefNumPacketsSent;
+heni_iobuf_list_t *            g_utDefLastReceivedPayload;
+uint8_t                        g_utDefLastReceivedData[UT_DEF_MAX_PAYLOAD_SIZE];
+size_t                         g_utDefLastReceivedLen;
+size_t                         g_utDefNumPacketsReceived;
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                          Kernel environment                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_EXT_FUNCT_DEF_PREFIX heni_instance_t * heniKernelInstanceAlloc(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    if (g_utDefInstanceUsed)
+    {
+        return NULL;
+    }
+    g_utDefInstanceUsed = 1;
+    return &g_utDefInstance;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelInstanceFree(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid,
+        heni_instance_t * inst
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    g_utDefInstanceUsed = 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX heni_packet_t * heniPacketAlloc(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    size_t   i;
+    for (i = 0; i < UT_DEF_NUM_PACKETS; ++i)
+    {
+        if (! g_utDefPackets[i].used)
+        {
+            g_utDefPackets[i].used = 1;
+            return &g_utDefPackets[i].packet;
+        }
+    }
+    return NULL;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniPacketFree(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid,
+        heni_packet_t * packet
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    ((ut_def_packet_slot_t *)packet)->used = 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelPostponeComputations(
+        heni_kernel_t * ker
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_CHECK(! g_utDefComputationsPostponed);
+    g_utDefComputationsPostponed = 1;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelInstanceStopDone(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelInstanceStopAllDone(
+        heni_kernel_t * ker
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX int_fast8_t heniKernelFrameSendStart(
+        heni_kernel_t * ker,
+        heni_frame_addr_t const * faddr,
+        heni_iobuf_list_t * fpld
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_CHECK(g_utDefNumFramesInFlight < UT_DEF_NUM_PACKETS);
+    HENI_UT_CHECK(heniIOBufListGetCapacity(fpld) <= UT_DEF_MAX_FRAME_SIZE);
+    g_utDefFramesInFlight[g_utDefNumFramesInFlight++] = fpld;
+    ++g_utDefNumFramesSent;
+    return 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniPacketSendFinish(
+        heni_kernel_t * ker,
+        heni_packet_addr_t const * paddr,
+        heni_iobuf_list_t * ppld,
+        heni_packet_tx_info_t const * psts
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_CHECK_PTR_EQ(ppld, &g_utDefTxPayload);
+    g_utDefLastSentStatus = psts->status;
+    ++g_utDefNumPacketsSent;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX int_fast8_t heniPacketReceiveStart(
+        heni_kernel_t * ker,
+        heni_packet_addr_t const * paddr,
+        heni_iobuf_list_t * ppld,
+        heni_packet_rx_info_t const * psts
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    heni_iobuf_list_fiter_t   iter;
+
+    g_utDefLastReceivedPayload = ppld;
+    heniIOBufListFIterInit(&iter, ppld);
+    g_utDefLastReceivedLen =
+            heniIOBufListFIterTryCopyIntoOneBufAndAdvance(
+                    &iter,
+                    &(g_utDefLastReceivedData[0]),
+                    UT_DEF_MAX_PAYLOAD_SIZE
+            );
+    HENI_UT_CHECK(! heniIOBufListFIterIsActive(&iter));
+    ++g_utDefNumPacketsReceived;
+    return 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelFrameReceiveFinish(
+        heni_kernel_t * ker,
+        heni_iobuf_list_t * fpld
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    ut_def_rx_frame_t *   frame = (ut_def_rx_frame_t *)fpld;
+    HENI_UT_CHECK(frame >= &g_utDefRxFrames[0] && frame < &g_utDefRxFrames[UT_DEF_NUM_RX_FRAMES]);
+    HENI_UT_CHECK(! frame->released);
+    /* The frame must be returned in its original shape. */
+    HENI_UT_CHECK_SZ_EQ(heniIOBufListGetCount(fpld), frame->len > UT_DEF_RX_SPLIT ? 2 : 1);
+    HENI_UT_CHECK_SZ_EQ(heniIOBufListGetCapacity(fpld), frame->len);
+    frame->released = 1;
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                            Helper functions                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_PRV_FUNCT_DEF_PREFIX void doRunPostponedComputations(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    while (g_utDefComputationsPostponed)
+    {
+        g_utDefComputationsPostponed = 0;
+        heniKernelResumeComputations(&g_utDefKernel);
+    }
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doFinishFrameInFlight(
+        uint8_t acked
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_frame_tx_info_t   finfo;
+    heni_iobuf_list_t *    fpld;
+
+    HENI_UT_CHECK(g_utDefNumFramesInFlight > 0);
+    fpld = g_utDefFramesInFlight[0];
+    memmove(&g_utDefFramesInFlight[0], &g_utDefFramesInFlight[1],
+            --g_utDefNumFramesInFlight * sizeof(g_utDefFramesInFlight[0]));
+    heniFrameTxInfoReset(&finfo);
+    heniFrameTxInfoIncNumAttempts(&finfo);
+    heniFrameTxInfoMarkTransmissionByLowLevelStack(&finfo);
+    if (acked)
+    {
+        heniFrameTxInfoMarkAcknowledgmentByLowLevelStack(&finfo);
+    }
+    heniKernelFrameSendFinish(&g_utDefKernel, fpld, &finfo);
+    doRunPostponedComputations();
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doStartKernel(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    memset(g_utDefPackets, 0, sizeof(g_utDefPackets));
+    memset(g_utDefRxFrames, 0, sizeof(g_utDefRxFrames));
+    g_utDefComputationsPostponed = 0;
+    g_utDefNumFramesInFlight = 0;
+    g_utDefNumFramesSent = 0;
+    g_utDefLastSentStatus = HENI_PACKET_ROUTING_ERROR_NONE;
+    g_utDefNumPacketsSent = 0;
+    g_utDefLastReceivedPayload = NULL;
+    g_utDefLastReceivedLen = 0;
+    g_utDefNumPacketsReceived = 0;
+    HENI_UT_CHECK(heniKernelInit(&g_utDefKernel) == 0);
+    HENI_UT_CHECK(heniKernelSetMaxFramePayloadSize(&g_utDefKernel, HENI_KERNEL_FRAGMENT_HEADER_SIZE) < 0);
+    HENI_UT_CHECK(heniKernelSetMaxFramePayloadSize(&g_utDefKernel, UT_DEF_MAX_FRAME_SIZE) == 0);
+    HENI_UT_CHECK(heniKernelInstanceStart(&g_utDefKernel, UT_DEF_IID) == 0);
+    doRunPostponedComputations();
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doStopKernel(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    doRunPostponedComputations();
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesInFlight, 0);
+    heniKernelInstanceStopAllTrigger(&g_utDefKernel);
+    doRunPostponedComputations();
+    HENI_UT_CHECK(! g_utDefInstanceUsed);
+    heniKernelCleanup(&g_utDefKernel);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doSendPacket(
+        size_t len
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_packet_addr_t   paddr;
+    size_t               i;
+
+    for (i = 0; i < UT_DEF_BUF_LEN_1; ++i)
+    {
+        g_utDefTxBuf1[i] = (uint8_t)(i + 1);
+    }
+    for (i = 0; i < UT_DEF_BUF_LEN_2; ++i)
+    {
+        g_utDefTxBuf2[i] = (uint8_t)(i + 1 + UT_DEF_BUF_LEN_1);
+    }
+    HENI_UT_CHECK(len > UT_DEF_BUF_LEN_1 && len <= UT_DEF_BUF_LEN_1 + UT_DEF_BUF_LEN_2);
+    heniIOBufListInit(&g_utDefTxPayload);
+    heniIOBufNodeInitMem(&g_utDefTxNodes[0], &(g_utDefTxBuf1[0]), UT_DEF_BUF_LEN_1);
+    heniIOBufNodeAddBack(&g_utDefTxPayload, &g_utDefTxNodes[0]);
+    heniIOBufNodeInitMem(&g_utDefTxNodes[1], &(g_utDefTxBuf2[0]), len - UT_DEF_BUF_LEN_1);
+    heniIOBufNodeAddBack(&g_utDefTxPayload, &g_utDefTxNodes[1]);
+    heniPacketAddrReset(&paddr);
+    heniPacketAddrSetInstanceID(&paddr, UT_DEF_IID);
+    HENI_UT_CHECK(heniPacketSendStart(&g_utDefKernel, &paddr, &g_utDefTxPayload) == 0);
+    doRunPostponedComputations();
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doCheckTxPayloadRestored(
+        size_t len
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_iobuf_list_fiter_t   iter;
+
+    HENI_UT_CHECK_SZ_EQ(heniIOBufListGetCount(&g_utDefTxPayload), 2);
+    HENI_UT_CHECK_SZ_EQ(heniIOBufListGetCapacity(&g_utDefTxPayload), len);
+    heniIOBufListFIterInit(&iter, &g_utDefTxPayload);
+    HENI_UT_CHECK_PTR_EQ(heniIOBufListFIterGetNode(&iter), &g_utDefTxNodes[0]);
+    HENI_UT_CHECK_PTR_EQ(heniIOBufListFiterGetMemPtr(&iter), &(g_utDefTxBuf1[0]));
+    heniIOBufListFIterTryAdvance(&iter, UT_DEF_BUF_LEN_1);
+    HENI_UT_CHECK_PTR_EQ(heniIOBufListFIterGetNode(&iter), &g_utDefTxNodes[1]);
+    HENI_UT_CHECK_PTR_EQ(heniIOBufListFiterGetMemPtr(&iter), &(g_utDefTxBuf2[0]));
+    HENI_UT_CHECK_SZ_EQ(heniIOBufListFiterGetMemLen(&iter), len - UT_DEF_BUF_LEN_1);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doReadHeader(
+        heni_iobuf_list_t * fpld,
+        uint8_t * hdr
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_iobuf_list_fiter_t   iter;
+
+    heniIOBufListFIterInit(&iter, fpld);
+    HENI_UT_CHECK_SZ_EQ(
+            heniIOBufListFIterTryCopyIntoOneBufAndAdvance(&iter, hdr, HENI_KERNEL_FRAGMENT_HEADER_SIZE),
+            HENI_KERNEL_FRAGMENT_HEADER_SIZE
+    );
+}
+
+
+
+/**
+ * Passes to the kernel a received frame
+ * with given contents, the first bytes of
+ * which reside in a separate node.
+ */
+HENI_PRV_FUNCT_DEF_PREFIX int_fast8_t doReceiveFrame(
+        size_t idx,
+        size_t srcSeed,
+        uint8_t const * data,
+        size_t len
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_frame_addr_t      faddr;
+    heni_frame_rx_info_t   finfo;
+    ut_def_rx_frame_t *    frame = &g_utDefRxFrames[idx];
+
+    HENI_UT_CHECK(len <= UT_DEF_MAX_FRAME_SIZE);
+    memcpy(&(frame->data[0]), data, len);
+    frame->len = len;
+    frame->released = 0;
+    heniIOBufListInit(&frame->iol);
+    if (len > UT_DEF_RX_SPLIT)
+    {
+        heniIOBufNodeInitMem(&frame->nodes[0], &(frame->data[0]), UT_DEF_RX_SPLIT);
+        heniIOBufNodeAddBack(&frame->iol, &frame->nodes[0]);
+        heniIOBufNodeInitMem(&frame->nodes[1], &(frame->data[UT_DEF_RX_SPLIT]), len - UT_DEF_RX_SPLIT);
+        heniIOBufNodeAddBack(&frame->iol, &frame->nodes[1]);
+    }
+    else
+    {
+        heniIOBufNodeInitMem(&frame->nodes[0], &(frame->data[0]), len);
+        heniIOBufNodeAddBack(&frame->iol, &frame->nodes[0]);
+    }
+    heniFrameAddrReset(&faddr);
+    heniLinkAddrStubFill(heniFrameAddrGetSrcLinkAddrPtr(&faddr), srcSeed);
+    heniLinkAddrFetchAllNeighbors(heniFrameAddrGetDstLinkAddrPtr(&faddr));
+    return heniKernelFrameReceiveStart(&g_utDefKernel, &faddr, &frame->iol, &finfo);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX int_fast8_t doReceiveFragment(
+        size_t idx,
+        size_t srcSeed,
+        uint8_t tag,
+        uint8_t more,
+        uint16_t offset,
+        size_t len
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    uint8_t   data[UT_DEF_MAX_FRAME_SIZE];
+    size_t    i;
+
+    data[0] = tag;
+    data[1] = more ? 0x01 : 0x00;
+    data[2] = (uint8_t)(offset >> 8);
+    data[3] = (uint8_t)offset;
+    for (i = 0; i < len; ++i)
+    {
+        data[HENI_KERNEL_FRAGMENT_HEADER_SIZE + i] = (uint8_t)(offset + i);
+    }
+    return doReceiveFrame(idx, srcSeed, &(data[0]), HENI_KERNEL_FRAGMENT_HEADER_SIZE + len);
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                            Individual tests                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_UT_FUNCT_DEF_PREFIX void
+sendLargePayload_ShouldSendFragmentsOneByOneWithoutCopying(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_iobuf_list_fiter_t   iter;
+    uint8_t                   hdr[HENI_KERNEL_FRAGMENT_HEADER_SIZE];
+    uint8_t                   tag;
+    size_t                    len = UT_DEF_BUF_LEN_1 + 2 * UT_DEF_MAX_CHUNK_SIZE - 2;
+
+    doStartKernel();
+
+    doSendPacket(len);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesInFlight, 1);
+    HENI_UT_CHECK_SZ_EQ(heniIOBufListGetCapacity(g_utDefFramesInFlight[0]), UT_DEF_MAX_FRAME_SIZE);
+    doReadHeader(g_utDefFramesInFlight[0], &(hdr[0]));
+    tag = hdr[0];
+    HENI_UT_CHECK_EQ(hdr[1], 0x01, "%u");
+    HENI_UT_CHECK_EQ(hdr[2], 0, "%u");
+    HENI_UT_CHECK_EQ(hdr[3], 0, "%u");
+    heniIOBufListFIterInit(&iter, g_utDefFramesInFlight[0]);
+    heniIOBufListFIterTryAdvance(&iter, HENI_KERNEL_FRAGMENT_HEADER_SIZE);
+    HENI_UT_CHECK_PTR_EQ(heniIOBufListFiterGetMemPtr(&iter), &(g_utDefTxBuf1[0]));
+    heniIOBufListFIterTryAdvance(&iter, UT_DEF_BUF_LEN_1);
+    HENI_UT_CHECK_PTR_EQ(heniIOBufListFiterGetMemPtr(&iter), &(g_utDefTxBuf2[0]));
+    HENI_UT_CHECK_SZ_EQ(heniIOBufListFiterGetMemLen(&iter), UT_DEF_MAX_CHUNK_SIZE - UT_DEF_BUF_LEN_1);
+
+    doFinishFrameInFlight(1);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesInFlight, 1);
+    HENI_UT_CHECK_SZ_EQ(heniIOBufListGetCapacity(g_utDefFramesInFlight[0]), UT_DEF_MAX_FRAME_SIZE);
+    doReadHeader(g_utDefFramesInFlight[0], &(hdr[0]));
+    HENI_UT_CHECK_EQ(hdr[0], tag, "%u");
+    HENI_UT_CHECK_EQ(hdr[1], 0x01, "%u");
+    HENI_UT_CHECK_EQ(hdr[3], UT_DEF_MAX_CHUNK_SIZE, "%u");
+    heniIOBufListFIterInit(&iter, g_utDefFramesInFlight[0]);
+    heniIOBufListFIterTryAdvance(&iter, HENI_KERNEL_FRAGMENT_HEADER_SIZE);
+    HENI_UT_CHECK_PTR_EQ(
+            heniIOBufListFiterGetMemPtr(&iter),
+            &(g_utDefTxBuf2[UT_DEF_MAX_CHUNK_SIZE - UT_DEF_BUF_LEN_1])
+    );
+
+    doFinishFrameInFlight(1);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesInFlight, 1);
+    HENI_UT_CHECK_SZ_EQ(
+            heniIOBufListGetCapacity(g_utDefFramesInFlight[0]),
+            HENI_KERNEL_FRAGMENT_HEADER_SIZE + len - 2 * UT_DEF_MAX_CHUNK_SIZE
+    );
+    doReadHeader(g_utDefFramesInFlight[0], &(hdr[0]));
+    HENI_UT_CHECK_EQ(hdr[0], tag, "%u");
+    HENI_UT_CHECK_EQ(hdr[1], 0x00, "%u");
+    HENI_UT_CHECK_EQ(hdr[3], 2 * UT_DEF_MAX_CHUNK_SIZE, "%u");
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumPacketsSent, 0);
+
+    doFinishFrameInFlight(1);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesInFlight, 0);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesSent, 3);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumPacketsSent, 1);
+    HENI_UT_CHECK_EQ(g_utDefLastSentStatus, HENI_PACKET_ROUTING_ERROR_NONE, "%u");
+    doCheckTxPayloadRestored(len);
+
+    doStopKernel();
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+sendTooLargePayload_ShouldFinishWithPayloadTooLarge(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    doStartKernel();
+
+    HENI_UT_CHECK(heniKernelSetMaxFramePayloadSize(&g_utDefKernel, UT_DEF_MAX_FRAME_SIZE - 1) == 0);
+    doSendPacket(UT_DEF_MAX_PAYLOAD_SIZE);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesSent, 0);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumPacketsSent, 1);
+    HENI_UT_CHECK_EQ(g_utDefLastSentStatus, HENI_PACKET_ROUTING_ERROR_PAYLOAD_TOO_LARGE, "%u");
+    doCheckTxPayloadRestored(UT_DEF_MAX_PAYLOAD_SIZE);
+
+    HENI_UT_CHECK(heniKernelSetMaxFramePayloadSize(&g_utDefKernel, UT_DEF_MAX_FRAME_SIZE) == 0);
+    doSendPacket(UT_DEF_MAX_PAYLOAD_SIZE);
+    while (g_utDefNumFramesInFlight > 0)
+    {
+        doFinishFrameInFlight(1);
+    }
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesSent, HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET);
+    HENI_UT_CHECK_EQ(g_utDefLastSentStatus, HENI_PACKET_ROUTING_ERROR_NONE, "%u");
+    doCheckTxPayloadRestored(UT_DEF_MAX_PAYLOAD_SIZE);
+
+    doStopKernel();
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+sendWithUnacknowledgedFragment_ShouldStopAndRestorePayload(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    size_t   len = UT_DEF_BUF_LEN_1 + 2 * UT_DEF_MAX_CHUNK_SIZE;
+
+    doStartKernel();
+
+    doSendPacket(len);
+    doFinishFrameInFlight(1);
+    doFinishFrameInFlight(0);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesInFlight, 0);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesSent, 2);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumPacketsSent, 1);
+    HENI_UT_CHECK_EQ(g_utDefLastSentStatus, HENI_PACKET_ROUTING_ERROR_HOP_BY_HOP_ACK_FAILED, "%u");
+    doCheckTxPayloadRestored(len);
+
+    doStopKernel();
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+sendAndReceiveLargePayload_ShouldReassembleOriginalBytes(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    uint8_t   data[UT_DEF_MAX_FRAME_SIZE];
+    size_t    len = UT_DEF_MAX_PAYLOAD_SIZE - 3;
+    size_t    numFrames = 0;
+    size_t    i;
+
+    doStartKernel();
+
+    doSendPacket(len);
+    while (g_utDefNumFramesInFlight > 0)
+    {
+        heni_iobuf_list_fiter_t   iter;
+        size_t                    flen;
+
+        heniIOBufListFIterInit(&iter, g_utDefFramesInFlight[0]);
+        flen = heniIOBufListFIterTryCopyIntoOneBufAndAdvance(&iter, &(data[0]), UT_DEF_MAX_FRAME_SIZE);
+        HENI_UT_CHECK(doReceiveFrame(numFrames++, UT_DEF_LLA_SEED1, &(data[0]), flen) == 0);
+        doFinishFrameInFlight(1);
+    }
+    HENI_UT_CHECK_SZ_EQ(numFrames, HENI_KERNEL_MAX_FRAGMENTS_PER_PACKET);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumPacketsSent, 1);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumPacketsReceived, 1);
+    HENI_UT_CHECK_SZ_EQ(g_utDefLastReceivedLen, len);
+    HENI_UT_CHECK(memcmp(&(g_utDefLastReceivedData[0]), &(g_utDefTxBuf1[0]), UT_DEF_BUF_LEN_1) == 0);
+    HENI_UT_CHECK(memcmp(&(g_utDefLastReceivedData[UT_DEF_BUF_LEN_1]), &(g_utDefTxBuf2[0]), len - UT_DEF_BUF_LEN_1) == 0);
+    for (i = 0; i < numFrames; ++i)
+    {
+        HENI_UT_CHECK(! g_utDefRxFrames[i].released);
+    }
+
+    heniPacketReceiveFinish(&g_utDefKernel, g_utDefLastReceivedPayload);
+    doRunPostponedComputations();
+    for (i = 0; i < numFrames; ++i)
+    {
+        HENI_UT_CHECK(g_utDefRxFrames[i].released);
+    }
+
+    doStopKernel();
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+receiveMalformedOrUnexpectedFrames_ShouldRejectThem(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    uint8_t   data[HENI_KERNEL_FRAGMENT_HEADER_SIZE] = { 0, 0, 0, 0 };
+
+    doStartKernel();
+
+    HENI_UT_CHECK_EQ(
+            doReceiveFrame(0, UT_DEF_LLA_SEED1, &(data[0]), HENI_KERNEL_FRAGMENT_HEADER_SIZE - 1),
+            -HENI_PACKET_ROUTING_ERROR_MALFORMED_FRAME,
+            "%d"
+    );
+    HENI_UT_CHECK_EQ(
+            doReceiveFragment(1, UT_DEF_LLA_SEED1, 5, 0, UT_DEF_MAX_CHUNK_SIZE, UT_DEF_MAX_CHUNK_SIZE),
+            -HENI_PACKET_ROUTING_ERROR_UNEXPECTED_FRAGMENT,
+            "%d"
+    );
+
+    /* A gap drops the whole packet. */
+    HENI_UT_CHECK(doReceiveFragment(2, UT_DEF_LLA_SEED1, 6, 1, 0, UT_DEF_MAX_CHUNK_SIZE) == 0);
+    HENI_UT_CHECK(! g_utDefRxFrames[2].released);
+    HENI_UT_CHECK_EQ(
+            doReceiveFragment(3, UT_DEF_LLA_SEED1, 6, 0, 2 * UT_DEF_MAX_CHUNK_SIZE, 1),
+            -HENI_PACKET_ROUTING_ERROR_UNEXPECTED_FRAGMENT,
+            "%d"
+    );
+    HENI_UT_CHECK(g_utDefRxFrames[2].released);
+    HENI_UT_CHECK_EQ(
+            doReceiveFragment(4, UT_DEF_LLA_SEED1, 6, 0, UT_DEF_MAX_CHUNK_SIZE, 1),
+            -HENI_PACKET_ROUTING_ERROR_UNEXPECTED_FRAGMENT,
+            "%d"
+    );
+
+    /* Fragments of another neighbor do not match. */
+    HENI_UT_CHECK(doReceiveFragment(5, UT_DEF_LLA_SEED1, 7, 1, 0, UT_DEF_MAX_CHUNK_SIZE) == 0);
+    HENI_UT_CHECK_EQ(
+            doReceiveFragment(6, UT_DEF_LLA_SEED2, 7, 0, UT_DEF_MAX_CHUNK_SIZE, 1),
+            -HENI_PACKET_ROUTING_ERROR_UNEXPECTED_FRAGMENT,
+            "%d"
+    );
+    HENI_UT_CHECK(! g_utDefRxFrames[5].released);
+    HENI_UT_CHECK(doReceiveFragment(6, UT_DEF_LLA_SEED1, 7, 0, UT_DEF_MAX_CHUNK_SIZE, 1) == 0);
+    doRunPostponedComputations();
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumPacketsReceived, 1);
+    HENI_UT_CHECK_SZ_EQ(g_utDefLastReceivedLen, UT_DEF_MAX_CHUNK_SIZE + 1);
+    heniPacketReceiveFinish(&g_utDefKernel, g_utDefLastReceivedPayload);
+    HENI_UT_CHECK(g_utDefRxFrames[5].released);
+    HENI_UT_CHECK(g_utDefRxFrames[6].released);
+
+    doStopKernel();
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+receiveMorePacketsThanReassemblyBuffers_ShouldDropOldestIncomplete(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    size_t   i;
+
+    doStartKernel();
+
+    for (i = 0; i <= HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE; ++i)
+    {
+        HENI_UT_CHECK(doReceiveFragment(i, UT_DEF_LLA_SEED1, (uint8_t)i, 1, 0, UT_DEF_MAX_CHUNK_SIZE) == 0);
+    }
+    HENI_UT_CHECK(g_utDefRxFrames[0].released);
+    for (i = 1; i <= HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE; ++i)
+    {
+        HENI_UT_CHECK(! g_utDefRxFrames[i].released);
+    }
+    HENI_UT_CHECK_EQ(
+            doReceiveFragment(UT_DEF_NUM_RX_FRAMES - 1, UT_DEF_LLA_SEED1, 0, 0, UT_DEF_MAX_CHUNK_SIZE, 1),
+            -HENI_PACKET_ROUTING_ERROR_UNEXPECTED_FRAGMENT,
+            "%d"
+    );
+
+    /* The incomplete packets are dropped on stop. */
+    doStopKernel();
+    for (i = 0; i <= HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE; ++i)
+    {
+        HENI_UT_CHECK(g_utDefRxFrames[i].released);
+    }
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                          The main test method                          *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniUnitTestSynchronouslyRunAll(
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_RUN_TEST(sendLargePayload_ShouldSendFragmentsOneByOneWithoutCopying);
+    HENI_UT_RUN_TEST(sendTooLargePayload_ShouldFinishWithPayloadTooLarge);
+    HENI_UT_RUN_TEST(sendWithUnacknowledgedFragment_ShouldStopAndRestorePayload);
+    HENI_UT_RUN_TEST(sendAndReceiveLargePayload_ShouldReassembleOriginalBytes);
+    HENI_UT_RUN_TEST(receiveMalformedOrUnexpectedFrames_ShouldRejectThem);
+    HENI_UT_RUN_TEST(receiveMorePacketsThanReassemblyBuffers_ShouldDropOldestIncomplete);
+}
@@ -0,0 +1,597 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+#include <string.h>
+#include "HENIFrame.h"
+#include "HENIKernel.h"
+#include "HENINeighborTable.h"
+#include "HENIZoneTable.h"
+#include "HENIUnitTest.h"
+#include "HENICommonStubLinkAddress.h"
+
+
+/**
+ * @file
+ * Type: heniUnitTestSynchronouslyRunAll
+ */
+
+
+enum
+{
+    UT_DEF_NUM_PACKETS = 2 * HENI_KERNEL_MAX_FRAMES_IN_FLIGHT,
+    UT_DEF_MAX_NBT_SIZE = 5,
+    UT_DEF_ZT_BUCKETS = 3,
+    UT_DEF_IID = HENI_INSTANCE_ID_MIN,
+};
+
+
+enum
+{
+    UT_DEF_LLA_SEED1 = 19,
+    UT_DEF_LLA_SEED2 = 42,
+    UT_DEF_LLA_SEED3 = 77,
+};
+
+
+typedef struct ut_def_packet_slot_s
+{
+    heni_packet_t                packet;
+    uint8_t                      used;
+} ut_def_packet_slot_t;
+
+typedef struct ut_def_frame_s
+{
+    heni_iobuf_list_t *          fpld;
+    heni_link_addr_container_t   dstLinkAddr;
+} ut_def_frame_t;
+
+
+heni_kernel_t                  g_utDefKernel;
+heni_instance_t                g_utDefInstance;
+uint8_t                        g_utDefInstanceUsed;
+ut_def_packet_slot_t           g_utDefPackets[UT_DEF_NUM_PACKETS];
+heni_iobuf_list_t              g_utDefPayloads[UT_DEF_NUM_PACKETS];
+
+heni_neighbor_table_t          g_utDefNeighborTable;
+heni_neighbor_table_elem_t     g_utDefNTBuffer[UT_DEF_MAX_NBT_SIZE];
+heni_neighbor_t                g_utDefNeighbors[UT_DEF_MAX_NBT_SIZE];
+heni_zone_table_t              g_utDefZoneTable;
+heni_zone_table_bucket_t       g_utDefZoneTableAllBuckets[HENI_MAX_LIDS_IN_LABEL * UT_DEF_ZT_BUCKETS];
+heni_zone_table_bucket_t *     g_utDefZoneTableBuckets[HENI_MAX_LIDS_IN_LABEL];
+heni_zone_t                    g_utDefZones[4];
+
+uint8_t                        g_utDefComputationsPostponed;
+ut_def_frame_t                 g_utDefFramesInFlight[UT_DEF_NUM_PACKETS];
+size_t                         g_utDefNumFramesInFlight;
+size_t                         g_utDefNumFramesSent;
+heni_iobuf_list_t *            g_utDefLastSentPayload;
+uint8_t                        g_utDefLastSentStatus;
+size_t                         g_utDefNumPacketsSent;
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                          Kernel environment                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_EXT_FUNCT_DEF_PREFIX heni_instance_t * heniKernelInstanceAlloc(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    if (g_utDefInstanceUsed)
+    {
+        return NULL;
+    }
+    g_utDefInstanceUsed = 1;
+    return &g_utDefInstance;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelInstanceFree(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid,
+        heni_instance_t * inst
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    g_utDefInstanceUsed = 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX heni_packet_t * heniPacketAlloc(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    size_t   i;
+    for (i = 0; i < UT_DEF_NUM_PACKETS; ++i)
+    {
+        if (! g_utDefPackets[i].used)
+        {
+            g_utDefPackets[i].used = 1;
+            return &g_utDefPackets[i].packet;
+        }
+    }
+    return NULL;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniPacketFree(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid,
+        heni_packet_t * packet
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    ((ut_def_packet_slot_t *)packet)->used = 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelPostponeComputations(
+        heni_kernel_t * ker
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_CHECK(! g_utDefComputationsPostponed);
+    g_utDefComputationsPostponed = 1;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelInstanceStopDone(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelInstanceStopAllDone(
+        heni_kernel_t * ker
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX int_fast8_t heniKernelFrameSendStart(
+        heni_kernel_t * ker,
+        heni_frame_addr_t const * faddr,
+        heni_iobuf_list_t * fpld
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    ut_def_frame_t *   frame;
+    HENI_UT_CHECK(g_utDefNumFramesInFlight < UT_DEF_NUM_PACKETS);
+    frame = &g_utDefFramesInFlight[g_utDefNumFramesInFlight++];
+    frame->fpld = fpld;
+    heniLinkAddrCopy(
+            heniFrameAddrGetDstLinkAddrConstPtr(faddr),
+            &(frame->dstLinkAddr.data8[0])
+    );
+    ++g_utDefNumFramesSent;
+    return 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniPacketSendFinish(
+        heni_kernel_t * ker,
+        heni_packet_addr_t const * paddr,
+        heni_iobuf_list_t * ppld,
+        heni_packet_tx_info_t const * psts
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    g_utDefLastSentPayload = ppld;
+    g_utDefLastSentStatus = psts->status;
+    ++g_utDefNumPacketsSent;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX int_fast8_t heniPacketReceiveStart(
+        heni_kernel_t * ker,
+        heni_packet_addr_t const * paddr,
+        heni_iobuf_list_t * ppld,
+        heni_packet_rx_info_t const * psts
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_CHECK(0);
+    return -1;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelFrameReceiveFinish(
+        heni_kernel_t * ker,
+        heni_iobuf_list_t * fpld
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_CHECK(0);
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                            Helper functions                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_PRV_FUNCT_DEF_PREFIX void doRunPostponedComputations(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    while (g_utDefComputationsPostponed)
+    {
+        g_utDefComputationsPostponed = 0;
+        heniKernelResumeComputations(&g_utDefKernel);
+    }
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doFinishFrameInFlight(
+        size_t idx
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_frame_tx_info_t   finfo;
+    heni_iobuf_list_t *    fpld;
+
+    HENI_UT_CHECK(idx < g_utDefNumFramesInFlight);
+    fpld = g_utDefFramesInFlight[idx].fpld;
+    memmove(&g_utDefFramesInFlight[idx], &g_utDefFramesInFlight[idx + 1],
+            (--g_utDefNumFramesInFlight - idx) * sizeof(g_utDefFramesInFlight[0]));
+    heniFrameTxInfoReset(&finfo);
+    heniFrameTxInfoIncNumAttempts(&finfo);
+    heniFrameTxInfoMarkTransmissionByLowLevelStack(&finfo);
+    heniFrameTxInfoMarkAcknowledgmentByLowLevelStack(&finfo);
+    heniKernelFrameSendFinish(&g_utDefKernel, fpld, &finfo);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doRunUntilIdle(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    doRunPostponedComputations();
+    while (g_utDefNumFramesInFlight > 0)
+    {
+        doFinishFrameInFlight(0);
+        doRunPostponedComputations();
+    }
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doStartKernel(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    memset(g_utDefPackets, 0, sizeof(g_utDefPackets));
+    g_utDefComputationsPostponed = 0;
+    g_utDefNumFramesInFlight = 0;
+    g_utDefNumFramesSent = 0;
+    g_utDefLastSentPayload = NULL;
+    g_utDefLastSentStatus = HENI_PACKET_ROUTING_ERROR_NONE;
+    g_utDefNumPacketsSent = 0;
+    HENI_UT_CHECK(heniKernelInit(&g_utDefKernel) == 0);
+    HENI_UT_CHECK(heniKernelInstanceStart(&g_utDefKernel, UT_DEF_IID) == 0);
+    doRunPostponedComputations();
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doStopKernel(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    doRunUntilIdle();
+    heniKernelInstanceStopAllTrigger(&g_utDefKernel);
+    doRunUntilIdle();
+    HENI_UT_CHECK(! g_utDefInstanceUsed);
+    heniKernelCleanup(&g_utDefKernel);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_lspec_t utLSpec(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    return heniKernelInstanceGetLabelSpecForInstancePtr(&g_utDefInstance);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_zone_lid_t sampleLID(
+        uint8_t seed
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_zone_lid_t   lid = heniLabelSpecGetZoneLIDMinAssignable(utLSpec()) + seed;
+    HENI_PASSERT(heniLabelSpecIsZoneLIDAssignable(lid, utLSpec()));
+    return lid;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_zone_discr_t sampleDiscr(
+        uint8_t seed
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    uint8_t   numBits = heniKernelInstanceGetNumZoneDiscrBitsForInstancePtr(&g_utDefInstance);
+    return heniZoneDiscrSpecGetZoneDiscrMinAssignable(numBits) + seed;
+}
+
+
+
+/**
+ * Fills a label whose first two elements are
+ * given and whose remaining elements are all
+ * equal to a sample LID.
+ */
+HENI_PRV_FUNCT_DEF_PREFIX uint8_t * doFillLabel(
+        heni_label_container_t * cont,
+        heni_zone_lid_t firstLID,
+        heni_zone_lid_t secondLID
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_level_t   level, numLevels;
+
+    memset(cont, 0, sizeof(heni_label_container_t));
+    heniLabelSetElement(&(cont->data8[0]), utLSpec(), 0, firstLID);
+    heniLabelSetElement(&(cont->data8[0]), utLSpec(), 1, secondLID);
+    for (level = 2, numLevels = heniLabelSpecGetNumLevels(utLSpec()); level < numLevels; ++level)
+    {
+        heniLabelSetElement(&(cont->data8[0]), utLSpec(), level, sampleLID(0));
+    }
+    return &(cont->data8[0]);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doAttachRoutingState(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_label_container_t   lab;
+    heni_level_t             level;
+
+    for (level = 0; level < HENI_MAX_LIDS_IN_LABEL; ++level)
+    {
+        g_utDefZoneTableBuckets[level] = &(g_utDefZoneTableAllBuckets[level * UT_DEF_ZT_BUCKETS]);
+    }
+    heniZoneTableInit(&g_utDefZoneTable, &g_utDefInstance, &(g_utDefZoneTableBuckets[0]), UT_DEF_ZT_BUCKETS);
+    heniNeighborTableInit(&g_utDefNeighborTable, &g_utDefKernel, &(g_utDefNTBuffer[0]), UT_DEF_MAX_NBT_SIZE);
+    heniKernelSetNeighborTable(&g_utDefKernel, &g_utDefNeighborTable);
+    HENI_UT_CHECK(heniKernelInstanceSetRoutingState(
+            &g_utDefKernel,
+            UT_DEF_IID,
+            doFillLabel(&lab, sampleLID(1), sampleLID(1)),
+            &g_utDefZoneTable) == 0);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doDetachRoutingState(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heniKernelSetNeighborTable(&g_utDefKernel, NULL);
+    heniNeighborTableCleanup(&g_utDefNeighborTable);
+    heniZoneTableCleanup(&g_utDefZoneTable);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doAddNeighbor(
+        size_t idx,
+        size_t seed
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_link_addr_container_t   laddr;
+    heniLinkAddrStubFill(&(laddr.data8[0]), seed);
+    heniNeighborTableAddNonexisting(&g_utDefNeighborTable, &(laddr.data8[0]), &g_utDefNeighbors[idx]);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doAddZone(
+        size_t idx,
+        heni_level_t level,
+        heni_zone_lid_t lid,
+        heni_zone_discr_t discr,
+        size_t nextHopSeed
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_zone_t *   zone = &g_utDefZones[idx];
+    heniLinkAddrStubFill(heniZoneEntryGetNextHopLinkAddrPtr(zone), nextHopSeed);
+    heniZoneTableAddNonexisting(&g_utDefZoneTable, level, lid, discr, zone);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doSendPacket(
+        size_t idx,
+        heni_zone_lid_t firstLID,
+        heni_zone_lid_t secondLID
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_packet_addr_t   paddr;
+
+    heniPacketAddrReset(&paddr);
+    heniPacketAddrSetInstanceID(&paddr, UT_DEF_IID);
+    doFillLabel(
+            (heni_label_container_t *)heniPacketAddrGetDstLabelPtr(&paddr),
+            firstLID,
+            secondLID
+    );
+    heniIOBufListInit(&g_utDefPayloads[idx]);
+    HENI_UT_CHECK(heniPacketSendStart(&g_utDefKernel, &paddr, &g_utDefPayloads[idx]) == 0);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX int_fast8_t lastFrameWentTo(
+        size_t seed
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_link_addr_container_t   laddr;
+    heniLinkAddrStubFill(&(laddr.data8[0]), seed);
+    return g_utDefNumFramesInFlight > 0 &&
+            heniLinkAddrCmp(
+                    &(g_utDefFramesInFlight[g_utDefNumFramesInFlight - 1].dstLinkAddr.data8[0]),
+                    &(laddr.data8[0])) == 0;
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                            Individual tests                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_UT_FUNCT_DEF_PREFIX void
+sendWithoutRoutingState_ShouldForwardToAllNeighbors(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    doStartKernel();
+
+    doSendPacket(0, sampleLID(2), sampleLID(1));
+    doRunPostponedComputations();
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesInFlight, 1);
+    HENI_UT_CHECK(heniLinkAddrIsAllNeighbors(&(g_utDefFramesInFlight[0].dstLinkAddr.data8[0])));
+    doRunUntilIdle();
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumPacketsSent, 1);
+    HENI_UT_CHECK_EQ(g_utDefLastSentStatus, HENI_PACKET_ROUTING_ERROR_NONE, "%u");
+
+    doStopKernel();
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+sendToOtherTopLevelZone_ShouldForwardToNextHopOfThatZone(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    doStartKernel();
+    doAttachRoutingState();
+    doAddNeighbor(0, UT_DEF_LLA_SEED1);
+    doAddNeighbor(1, UT_DEF_LLA_SEED2);
+    doAddZone(0, 1, sampleLID(2), sampleDiscr(0), UT_DEF_LLA_SEED1);
+    doAddZone(1, 2, sampleLID(2), sampleDiscr(0), UT_DEF_LLA_SEED2);
+
+    doSendPacket(0, sampleLID(2), sampleLID(2));
+    doRunPostponedComputations();
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesInFlight, 1);
+    HENI_UT_CHECK(lastFrameWentTo(UT_DEF_LLA_SEED1));
+    doRunUntilIdle();
+    HENI_UT_CHECK_EQ(g_utDefLastSentStatus, HENI_PACKET_ROUTING_ERROR_NONE, "%u");
+
+    doSendPacket(1, sampleLID(1), sampleLID(2));
+    doRunPostponedComputations();
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesInFlight, 1);
+    HENI_UT_CHECK(lastFrameWentTo(UT_DEF_LLA_SEED2));
+    doRunUntilIdle();
+    HENI_UT_CHECK_EQ(g_utDefLastSentStatus, HENI_PACKET_ROUTING_ERROR_NONE, "%u");
+
+    doDetachRoutingState();
+    doStopKernel();
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+sendViaZoneWithStaleNextHop_ShouldSkipEntriesWithoutNeighbors(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    doStartKernel();
+    doAttachRoutingState();
+    doAddNeighbor(0, UT_DEF_LLA_SEED2);
+    doAddZone(0, 1, sampleLID(3), sampleDiscr(0), UT_DEF_LLA_SEED3);
+    doAddZone(1, 1, sampleLID(3), sampleDiscr(1), UT_DEF_LLA_SEED2);
+
+    doSendPacket(0, sampleLID(3), sampleLID(1));
+    doRunPostponedComputations();
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesInFlight, 1);
+    HENI_UT_CHECK(lastFrameWentTo(UT_DEF_LLA_SEED2));
+    doRunUntilIdle();
+
+    doDetachRoutingState();
+    doStopKernel();
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+sendToUnknownZone_ShouldFinishWithNoRoute(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    doStartKernel();
+    doAttachRoutingState();
+    doAddNeighbor(0, UT_DEF_LLA_SEED1);
+    doAddZone(0, 1, sampleLID(2), sampleDiscr(0), UT_DEF_LLA_SEED3);
+
+    doSendPacket(0, sampleLID(2), sampleLID(1));
+    doSendPacket(1, sampleLID(4), sampleLID(1));
+    doRunUntilIdle();
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesSent, 0);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumPacketsSent, 2);
+    HENI_UT_CHECK_PTR_EQ(g_utDefLastSentPayload, &g_utDefPayloads[1]);
+    HENI_UT_CHECK_EQ(g_utDefLastSentStatus, HENI_PACKET_ROUTING_ERROR_NO_ROUTE, "%u");
+
+    doDetachRoutingState();
+    doStopKernel();
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+sendMany_ShouldKeepAtMostMaxFramesInFlightAndAcceptAnyCompletionOrder(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    size_t   i;
+
+    doStartKernel();
+
+    for (i = 0; i < UT_DEF_NUM_PACKETS; ++i)
+    {
+        doSendPacket(i, sampleLID(2), sampleLID(1));
+    }
+    doRunPostponedComputations();
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesInFlight, HENI_KERNEL_MAX_FRAMES_IN_FLIGHT);
+
+    /* Complete the most recent frame first. */
+    doFinishFrameInFlight(g_utDefNumFramesInFlight - 1);
+    doRunPostponedComputations();
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumPacketsSent, 1);
+    HENI_UT_CHECK_PTR_EQ(g_utDefLastSentPayload, &g_utDefPayloads[HENI_KERNEL_MAX_FRAMES_IN_FLIGHT - 1]);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesInFlight, HENI_KERNEL_MAX_FRAMES_IN_FLIGHT);
+
+    doRunUntilIdle();
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumFramesSent, UT_DEF_NUM_PACKETS);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumPacketsSent, UT_DEF_NUM_PACKETS);
+
+    doStopKernel();
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                          The main test method                          *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniUnitTestSynchronouslyRunAll(
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_RUN_TEST(sendWithoutRoutingState_ShouldForwardToAllNeighbors);
+    HENI_UT_RUN_TEST(sendToOtherTopLevelZone_ShouldForwardToNextHopOfThatZone);
+    HENI_UT_RUN_TEST(sendViaZoneWithStaleNextHop_ShouldSkipEntriesWithoutNeighbors);
+    HENI_UT_RUN_TEST(sendToUnknownZone_ShouldFinishWithNoRoute);
+    HENI_UT_RUN_TEST(sendMany_ShouldKeepAtMostMaxFramesInFlightAndAcceptAnyCompletionOrder);
+}
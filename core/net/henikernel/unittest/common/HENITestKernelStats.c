@@ -0,0 +1,530 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+#define HENI_KERNEL_WITH_STATS 1
+
+#include <string.h>
+#include "HENIFrame.h"
+#include "HENIKernel.h"
+#include "HENIStats.h"
+#include "HENIUnitTest.h"
+#include "HENICommonStubLinkAddress.h"
+
+
+/**
+ * @file
+ * Type: heniUnitTestSynchronouslyRunAll
+ */
+
+
+enum
+{
+    UT_DEF_NUM_PACKETS = 2 * HENI_KERNEL_MAX_FRAMES_IN_FLIGHT,
+    UT_DEF_NUM_RX_FRAMES = 2,
+    UT_DEF_IID = HENI_INSTANCE_ID_MIN,
+    UT_DEF_RX_BODY_SIZE = 3,
+    UT_DEF_MAX_FRAME_SIZE = HENI_KERNEL_FRAGMENT_HEADER_SIZE + UT_DEF_RX_BODY_SIZE,
+};
+
+
+enum
+{
+    UT_DEF_LLA_SEED1 = 19,
+    UT_DEF_LLA_SEED2 = 42,
+};
+
+
+typedef struct ut_def_packet_slot_s
+{
+    heni_packet_t                packet;
+    uint8_t                      used;
+} ut_def_packet_slot_t;
+
+typedef struct ut_def_rx_frame_s
+{
+    heni_iobuf_list_t            iol;
+    heni_iobuf_list_node_t       node;
+    uint8_t                      data[UT_DEF_MAX_FRAME_SIZE];
+    uint8_t                      released;
+} ut_def_rx_frame_t;
+
+
+heni_kernel_t                  g_utDefKernel;
+heni_instance_t                g_utDefInstance;
+uint8_t                        g_utDefInstanceUsed;
+ut_def_packet_slot_t           g_utDefPackets[UT_DEF_NUM_PACKETS];
+heni_iobuf_list_t              g_utDefPayloads[UT_DEF_NUM_PACKETS];
+ut_def_rx_frame_t              g_utDefRxFrames[UT_DEF_NUM_RX_FRAMES];
+
+heni_stats_timestamp_t         g_utDefNow;
+uint8_t                        g_utDefComputationsPostponed;
+heni_iobuf_list_t *            g_utDefFramesInFlight[UT_DEF_NUM_PACKETS];
+size_t                         g_utDefNumFramesInFlight;
+size_t                         g_utDefNumPacketsSent;
+heni_iobuf_list_t *            g_utDefLastReceivedPayload;
+size_t                         g_utDefNumPacketsReceived;
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                          Kernel environment                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_EXT_FUNCT_DEF_PREFIX heni_instance_t * heniKernelInstanceAlloc(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    if (g_utDefInstanceUsed)
+    {
+        return NULL;
+    }
+    g_utDefInstanceUsed = 1;
+    return &g_utDefInstance;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelInstanceFree(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid,
+        heni_instance_t * inst
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    g_utDefInstanceUsed = 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX heni_packet_t * heniPacketAlloc(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    size_t   i;
+    for (i = 0; i < UT_DEF_NUM_PACKETS; ++i)
+    {
+        if (! g_utDefPackets[i].used)
+        {
+            g_utDefPackets[i].used = 1;
+            return &g_utDefPackets[i].packet;
+        }
+    }
+    return NULL;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniPacketFree(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid,
+        heni_packet_t * packet
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    ((ut_def_packet_slot_t *)packet)->used = 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelPostponeComputations(
+        heni_kernel_t * ker
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_CHECK(! g_utDefComputationsPostponed);
+    g_utDefComputationsPostponed = 1;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelInstanceStopDone(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelInstanceStopAllDone(
+        heni_kernel_t * ker
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX int_fast8_t heniKernelFrameSendStart(
+        heni_kernel_t * ker,
+        heni_frame_addr_t const * faddr,
+        heni_iobuf_list_t * fpld
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_CHECK(g_utDefNumFramesInFlight < UT_DEF_NUM_PACKETS);
+    g_utDefFramesInFlight[g_utDefNumFramesInFlight++] = fpld;
+    return 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniPacketSendFinish(
+        heni_kernel_t * ker,
+        heni_packet_addr_t const * paddr,
+        heni_iobuf_list_t * ppld,
+        heni_packet_tx_info_t const * psts
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    ++g_utDefNumPacketsSent;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX int_fast8_t heniPacketReceiveStart(
+        heni_kernel_t * ker,
+        heni_packet_addr_t const * paddr,
+        heni_iobuf_list_t * ppld,
+        heni_packet_rx_info_t const * psts
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_CHECK_SZ_EQ(heniIOBufListGetCapacity(ppld), UT_DEF_RX_BODY_SIZE);
+    g_utDefLastReceivedPayload = ppld;
+    ++g_utDefNumPacketsReceived;
+    return 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelFrameReceiveFinish(
+        heni_kernel_t * ker,
+        heni_iobuf_list_t * fpld
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    ut_def_rx_frame_t *   frame = (ut_def_rx_frame_t *)fpld;
+    HENI_UT_CHECK(frame >= &g_utDefRxFrames[0] && frame < &g_utDefRxFrames[UT_DEF_NUM_RX_FRAMES]);
+    HENI_UT_CHECK(! frame->released);
+    frame->released = 1;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX heni_stats_timestamp_t heniStatsGetTimestamp(
+        heni_kernel_t * ker
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    return g_utDefNow;
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                            Helper functions                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_PRV_FUNCT_DEF_PREFIX void doRunPostponedComputations(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    while (g_utDefComputationsPostponed)
+    {
+        g_utDefComputationsPostponed = 0;
+        heniKernelResumeComputations(&g_utDefKernel);
+    }
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doFinishFrameInFlight(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_frame_tx_info_t   finfo;
+    heni_iobuf_list_t *    fpld;
+
+    HENI_UT_CHECK(g_utDefNumFramesInFlight > 0);
+    fpld = g_utDefFramesInFlight[0];
+    memmove(&g_utDefFramesInFlight[0], &g_utDefFramesInFlight[1],
+            --g_utDefNumFramesInFlight * sizeof(g_utDefFramesInFlight[0]));
+    heniFrameTxInfoReset(&finfo);
+    heniFrameTxInfoIncNumAttempts(&finfo);
+    heniFrameTxInfoMarkTransmissionByLowLevelStack(&finfo);
+    heniFrameTxInfoMarkAcknowledgmentByLowLevelStack(&finfo);
+    heniKernelFrameSendFinish(&g_utDefKernel, fpld, &finfo);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doRunUntilIdle(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    doRunPostponedComputations();
+    while (g_utDefNumFramesInFlight > 0)
+    {
+        doFinishFrameInFlight();
+        doRunPostponedComputations();
+    }
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doStartKernel(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    memset(g_utDefPackets, 0, sizeof(g_utDefPackets));
+    memset(g_utDefRxFrames, 0, sizeof(g_utDefRxFrames));
+    g_utDefNow = 0;
+    g_utDefComputationsPostponed = 0;
+    g_utDefNumFramesInFlight = 0;
+    g_utDefNumPacketsSent = 0;
+    g_utDefLastReceivedPayload = NULL;
+    g_utDefNumPacketsReceived = 0;
+    HENI_UT_CHECK(heniKernelInit(&g_utDefKernel) == 0);
+    HENI_UT_CHECK(heniKernelInstanceStart(&g_utDefKernel, UT_DEF_IID) == 0);
+    doRunPostponedComputations();
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doStopKernel(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    doRunUntilIdle();
+    heniKernelInstanceStopAllTrigger(&g_utDefKernel);
+    doRunUntilIdle();
+    HENI_UT_CHECK(! g_utDefInstanceUsed);
+    heniKernelCleanup(&g_utDefKernel);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_stats_t * utStats(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    return heniKernelAccessorsGetStatsForKernel(&g_utDefKernel);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX int_fast8_t doSendPacket(
+        size_t idx,
+        heni_instance_id_t iid
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_packet_addr_t   paddr;
+
+    heniPacketAddrReset(&paddr);
+    heniPacketAddrSetInstanceID(&paddr, iid);
+    heniIOBufListInit(&g_utDefPayloads[idx]);
+    return heniPacketSendStart(&g_utDefKernel, &paddr, &g_utDefPayloads[idx]);
+}
+
+
+
+/**
+ * Passes to the kernel a received frame carrying
+ * a whole packet and addressed either to all
+ * neighbors or to a node with a given seed.
+ */
+HENI_PRV_FUNCT_DEF_PREFIX int_fast8_t doReceiveFrame(
+        size_t idx,
+        size_t dstSeed
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_frame_addr_t      faddr;
+    heni_frame_rx_info_t   finfo;
+    ut_def_rx_frame_t *    frame = &g_utDefRxFrames[idx];
+
+    memset(&(frame->data[0]), 0, UT_DEF_MAX_FRAME_SIZE);
+    frame->data[0] = (uint8_t)idx;
+    frame->released = 0;
+    heniIOBufListInit(&frame->iol);
+    heniIOBufNodeInitMem(&frame->node, &(frame->data[0]), UT_DEF_MAX_FRAME_SIZE);
+    heniIOBufNodeAddBack(&frame->iol, &frame->node);
+    heniFrameAddrReset(&faddr);
+    heniLinkAddrStubFill(heniFrameAddrGetSrcLinkAddrPtr(&faddr), UT_DEF_LLA_SEED1);
+    if (dstSeed == 0)
+    {
+        heniLinkAddrFetchAllNeighbors(heniFrameAddrGetDstLinkAddrPtr(&faddr));
+    }
+    else
+    {
+        heniLinkAddrStubFill(heniFrameAddrGetDstLinkAddrPtr(&faddr), dstSeed);
+    }
+    return heniKernelFrameReceiveStart(&g_utDefKernel, &faddr, &frame->iol, &finfo);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doCheckAllQueuesEmpty(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_stats_queue_t   queue;
+    for (queue = 0; queue < HENI_STATS_QUEUE_COUNT; ++queue)
+    {
+        HENI_UT_CHECK(heniStatsGetQueueLength(utStats(), queue) == 0);
+    }
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                            Individual tests                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_UT_FUNCT_DEF_PREFIX void
+init_ShouldZeroAllStatistics(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_stats_queue_t   queue;
+    uint_fast8_t         i;
+
+    doStartKernel();
+
+    for (i = 0; i < HENI_PACKET_ROUTING_ERROR_COUNT; ++i)
+    {
+        HENI_UT_CHECK(heniStatsGetNumTxPackets(utStats(), UT_DEF_IID, i) == 0);
+        HENI_UT_CHECK(heniStatsGetNumRxPackets(utStats(), UT_DEF_IID, i) == 0);
+        HENI_UT_CHECK(heniStatsGetNumTxPackets(utStats(), HENI_INSTANCE_ID_INVALID, i) == 0);
+        HENI_UT_CHECK(heniStatsGetNumRxPackets(utStats(), HENI_INSTANCE_ID_INVALID, i) == 0);
+    }
+    for (queue = 0; queue < HENI_STATS_QUEUE_COUNT; ++queue)
+    {
+        HENI_UT_CHECK(heniStatsGetQueueHighWaterMark(utStats(), queue) == 0);
+        for (i = 0; i < HENI_STATS_NUM_HISTOGRAM_BINS; ++i)
+        {
+            HENI_UT_CHECK(heniStatsGetQueueTimeHistogramBin(utStats(), queue, i) == 0);
+        }
+    }
+    doCheckAllQueuesEmpty();
+
+    doStopKernel();
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+sendMany_ShouldCountPacketsAndQueueTimes(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    size_t   i;
+
+    doStartKernel();
+
+    for (i = 0; i < UT_DEF_NUM_PACKETS; ++i)
+    {
+        HENI_UT_CHECK(doSendPacket(i, UT_DEF_IID) == 0);
+    }
+    HENI_UT_CHECK(heniStatsGetQueueLength(utStats(), HENI_STATS_QUEUE_TO_SEND) == UT_DEF_NUM_PACKETS);
+
+    /* Times in [4, 7] fall into bin 3. */
+    g_utDefNow = 5;
+    doRunPostponedComputations();
+    HENI_UT_CHECK(heniStatsGetQueueLength(utStats(), HENI_STATS_QUEUE_TO_SEND) == 0);
+    HENI_UT_CHECK(heniStatsGetQueueTimeHistogramBin(utStats(), HENI_STATS_QUEUE_TO_SEND, 3) == UT_DEF_NUM_PACKETS);
+    HENI_UT_CHECK(heniStatsGetQueueLength(utStats(), HENI_STATS_QUEUE_BEING_ROUTED) ==
+            UT_DEF_NUM_PACKETS - HENI_KERNEL_MAX_FRAMES_IN_FLIGHT);
+
+    doRunUntilIdle();
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumPacketsSent, UT_DEF_NUM_PACKETS);
+    HENI_UT_CHECK(heniStatsGetNumTxPackets(utStats(), UT_DEF_IID, HENI_PACKET_ROUTING_ERROR_NONE) ==
+            UT_DEF_NUM_PACKETS);
+    HENI_UT_CHECK(heniStatsGetQueueHighWaterMark(utStats(), HENI_STATS_QUEUE_TO_SEND) == UT_DEF_NUM_PACKETS);
+    HENI_UT_CHECK(heniStatsGetQueueHighWaterMark(utStats(), HENI_STATS_QUEUE_ALREADY_SENT) > 0);
+    HENI_UT_CHECK(heniStatsGetQueueTimeHistogramBin(utStats(), HENI_STATS_QUEUE_ALREADY_SENT, 0) ==
+            UT_DEF_NUM_PACKETS);
+    doCheckAllQueuesEmpty();
+
+    /* A reset keeps the lengths but clears the rest. */
+    heniStatsReset(utStats());
+    HENI_UT_CHECK(heniStatsGetNumTxPackets(utStats(), UT_DEF_IID, HENI_PACKET_ROUTING_ERROR_NONE) == 0);
+    HENI_UT_CHECK(heniStatsGetQueueHighWaterMark(utStats(), HENI_STATS_QUEUE_TO_SEND) == 0);
+    HENI_UT_CHECK(heniStatsGetQueueTimeHistogramBin(utStats(), HENI_STATS_QUEUE_TO_SEND, 3) == 0);
+
+    doStopKernel();
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+sendWithInvalidInstance_ShouldCountUnderInvalidInstance(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    doStartKernel();
+
+    HENI_UT_CHECK_EQ(
+            doSendPacket(0, HENI_INSTANCE_ID_INVALID),
+            -HENI_PACKET_ROUTING_ERROR_INVALID_IID,
+            "%d"
+    );
+    HENI_UT_CHECK_EQ(
+            doSendPacket(0, UT_DEF_IID + 1),
+            -HENI_PACKET_ROUTING_ERROR_INSTANCE_NOT_RUNNING,
+            "%d"
+    );
+    HENI_UT_CHECK(heniStatsGetNumTxPackets(utStats(), HENI_INSTANCE_ID_INVALID,
+            HENI_PACKET_ROUTING_ERROR_INVALID_IID) == 1);
+    HENI_UT_CHECK(heniStatsGetNumTxPackets(utStats(), UT_DEF_IID + 1,
+            HENI_PACKET_ROUTING_ERROR_INSTANCE_NOT_RUNNING) == 1);
+    doCheckAllQueuesEmpty();
+
+    doStopKernel();
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+receive_ShouldCountDeliveredAndDroppedPackets(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    doStartKernel();
+
+    HENI_UT_CHECK(doReceiveFrame(0, 0) == 0);
+    HENI_UT_CHECK(heniStatsGetQueueLength(utStats(), HENI_STATS_QUEUE_TO_RECEIVE) == 1);
+    doRunPostponedComputations();
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumPacketsReceived, 1);
+    HENI_UT_CHECK(heniStatsGetNumRxPackets(utStats(), UT_DEF_IID, HENI_PACKET_ROUTING_ERROR_NONE) == 1);
+    HENI_UT_CHECK(heniStatsGetQueueLength(utStats(), HENI_STATS_QUEUE_ALREADY_RECEIVED) == 1);
+
+    g_utDefNow = 1;
+    heniPacketReceiveFinish(&g_utDefKernel, g_utDefLastReceivedPayload);
+    doRunPostponedComputations();
+    HENI_UT_CHECK(g_utDefRxFrames[0].released);
+    HENI_UT_CHECK(heniStatsGetQueueHighWaterMark(utStats(), HENI_STATS_QUEUE_TO_RECEIVE) == 1);
+    HENI_UT_CHECK(heniStatsGetQueueHighWaterMark(utStats(), HENI_STATS_QUEUE_ALREADY_RECEIVED) == 1);
+    HENI_UT_CHECK(heniStatsGetQueueTimeHistogramBin(utStats(), HENI_STATS_QUEUE_ALREADY_RECEIVED, 1) == 1);
+
+    HENI_UT_CHECK_EQ(
+            doReceiveFrame(1, UT_DEF_LLA_SEED2),
+            -HENI_PACKET_ROUTING_ERROR_NOT_FOR_ME,
+            "%d"
+    );
+    HENI_UT_CHECK(heniStatsGetNumRxPackets(utStats(), HENI_INSTANCE_ID_INVALID,
+            HENI_PACKET_ROUTING_ERROR_NOT_FOR_ME) == 1);
+    HENI_UT_CHECK_SZ_EQ(g_utDefNumPacketsReceived, 1);
+    doCheckAllQueuesEmpty();
+
+    doStopKernel();
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                          The main test method                          *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniUnitTestSynchronouslyRunAll(
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_RUN_TEST(init_ShouldZeroAllStatistics);
+    HENI_UT_RUN_TEST(sendMany_ShouldCountPacketsAndQueueTimes);
+    HENI_UT_RUN_TEST(sendWithInvalidInstance_ShouldCountUnderInvalidInstance);
+    HENI_UT_RUN_TEST(receive_ShouldCountDeliveredAndDroppedPackets);
+}
@@ -0,0 +1,367 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+#define HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS 1
+#include <string.h>
+#include "HENINeighborTable.h"
+#include "HENIUnitTest.h"
+#include "HENICommonStubLinkAddress.h"
+
+
+/**
+ * @file
+ * Type: heniUnitTestSynchronouslyRunAll
+ *
+ * The tests for the neighbor table backend that
+ * probes groups of slots with address fingerprints
+ * (HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS).
+ */
+
+
+enum
+{
+    UT_DEF_MAX_NBT_SIZE = 3,
+    UT_DEF_MAX_NBT_CAPACITY = UT_DEF_MAX_NBT_SIZE * HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM,
+    UT_DEF_NUM_COLLIDING = HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM + 2,
+};
+
+
+enum
+{
+    UT_DEF_LLA_HASH = 40,
+    UT_DEF_LLA_SEED1 = 19,
+    UT_DEF_LLA_SEED2 = 42,
+};
+
+
+struct heni_kernel_s
+{
+    int PLACEHOLDER;
+};
+
+heni_kernel_t                g_utDefKernel;
+heni_neighbor_table_elem_t   g_utDefNTBuffer[UT_DEF_MAX_NBT_SIZE];
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                            Helper functions                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_PRV_FUNCT_DEF_PREFIX uint8_t * doFillAddr(
+        heni_link_addr_container_t * cont,
+        size_t seed
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heniLinkAddrStubFill(&(cont->data8[0]), seed);
+    return &(cont->data8[0]);
+}
+
+
+
+/**
+ * Returns a seed of a stub address whose hash, and
+ * hence whose element and fingerprint, are the same
+ * for all values of the index.
+ */
+HENI_PRV_FUNCT_DEF_PREFIX size_t doGetCollidingSeed(
+        size_t idx
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    HENI_PASSERT(idx <= UT_DEF_LLA_HASH);
+    return (UT_DEF_LLA_HASH - idx) + (idx << 8);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_neighbor_t * doInitNbr(
+        heni_neighbor_t * nbr
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    return nbr;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX size_t doCountNbrsAndCheckEachOnce(
+        heni_neighbor_table_t * nbt,
+        heni_neighbor_t const * nbrs,
+        size_t numNbrs
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_neighbor_table_titer_t   nbtti;
+    uint8_t                       seen[UT_DEF_MAX_NBT_CAPACITY];
+    size_t                        i, count = 0;
+
+    HENI_PASSERT(numNbrs <= UT_DEF_MAX_NBT_CAPACITY);
+    for (i = 0; i < numNbrs; ++i)
+    {
+        seen[i] = 0;
+    }
+    for (heniNeighborTableTIterInit(&nbtti, nbt);
+            heniNeighborTableTIterIsActive(&nbtti);
+            heniNeighborTableTIterAdvance(&nbtti))
+    {
+        heni_neighbor_t const *   nbr = heniNeighborTableTIterGetNeighbor(&nbtti);
+        HENI_UT_CHECK(nbr >= nbrs && nbr < nbrs + numNbrs);
+        HENI_UT_CHECK(! seen[nbr - nbrs]);
+        seen[nbr - nbrs] = 1;
+        ++count;
+    }
+    return count;
+}
+
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                            Individual tests                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_UT_FUNCT_DEF_PREFIX void
+initNT_ShouldContainNoElements(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_neighbor_table_t         nbt;
+    heni_neighbor_table_titer_t   nbtti;
+    heni_link_addr_container_t    la1;
+
+    heniNeighborTableInit(&nbt, &g_utDefKernel, g_utDefNTBuffer, UT_DEF_MAX_NBT_SIZE);
+
+    HENI_UT_CHECK_PTR_EQ(heniNeighborTableFind(&nbt, doFillAddr(&la1, UT_DEF_LLA_SEED1)), NULL);
+    HENI_UT_CHECK_PTR_EQ(heniNeighborTableFind(&nbt, doFillAddr(&la1, UT_DEF_LLA_SEED2)), NULL);
+
+    heniNeighborTableTIterInit(&nbtti, &nbt);
+    HENI_UT_CHECK(! heniNeighborTableTIterIsActive(&nbtti));
+
+    heniNeighborTableCleanup(&nbt);
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+addCollidingBeyondElement_ShouldOverflowAndFindAll(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_neighbor_table_t         nbt;
+    heni_link_addr_container_t    la1;
+    heni_neighbor_t               nbs[UT_DEF_NUM_COLLIDING];
+    size_t                        i;
+
+    heniNeighborTableInit(&nbt, &g_utDefKernel, g_utDefNTBuffer, UT_DEF_MAX_NBT_SIZE);
+
+    for (i = 0; i < UT_DEF_NUM_COLLIDING; ++i)
+    {
+        heniNeighborTableAddNonexisting(&nbt, doFillAddr(&la1, doGetCollidingSeed(i)), doInitNbr(&(nbs[i])));
+    }
+    for (i = 0; i < UT_DEF_NUM_COLLIDING; ++i)
+    {
+        HENI_UT_CHECK_PTR_EQ(heniNeighborTableFind(&nbt, doFillAddr(&la1, doGetCollidingSeed(i))), &(nbs[i]));
+    }
+    HENI_UT_CHECK_PTR_EQ(heniNeighborTableFind(&nbt, doFillAddr(&la1, doGetCollidingSeed(UT_DEF_NUM_COLLIDING))), NULL);
+    HENI_UT_CHECK_PTR_EQ(heniNeighborTableFind(&nbt, doFillAddr(&la1, UT_DEF_LLA_SEED1)), NULL);
+    HENI_UT_CHECK(doCountNbrsAndCheckEachOnce(&nbt, nbs, UT_DEF_NUM_COLLIDING) == UT_DEF_NUM_COLLIDING);
+
+    for (i = 0; i < UT_DEF_NUM_COLLIDING; ++i)
+    {
+        heniNeighborTableRemoveExisting(&nbt, doFillAddr(&la1, doGetCollidingSeed(i)));
+    }
+    HENI_UT_CHECK(doCountNbrsAndCheckEachOnce(&nbt, nbs, UT_DEF_NUM_COLLIDING) == 0);
+
+    heniNeighborTableCleanup(&nbt);
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+removeFromFullElement_ShouldKeepOverflowedReachable(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_neighbor_table_t         nbt;
+    heni_link_addr_container_t    la1;
+    heni_neighbor_t               nbs[UT_DEF_NUM_COLLIDING];
+    size_t                        i;
+
+    heniNeighborTableInit(&nbt, &g_utDefKernel, g_utDefNTBuffer, UT_DEF_MAX_NBT_SIZE);
+
+    for (i = 0; i < UT_DEF_NUM_COLLIDING; ++i)
+    {
+        heniNeighborTableAddNonexisting(&nbt, doFillAddr(&la1, doGetCollidingSeed(i)), doInitNbr(&(nbs[i])));
+    }
+
+    /* The first entries occupy the home element, the last ones overflow. */
+    heniNeighborTableRemoveExisting(&nbt, doFillAddr(&la1, doGetCollidingSeed(0)));
+    heniNeighborTableRemoveExisting(&nbt, doFillAddr(&la1, doGetCollidingSeed(1)));
+    HENI_UT_CHECK_PTR_EQ(heniNeighborTableFind(&nbt, doFillAddr(&la1, doGetCollidingSeed(0))), NULL);
+    HENI_UT_CHECK_PTR_EQ(heniNeighborTableFind(&nbt, doFillAddr(&la1, doGetCollidingSeed(1))), NULL);
+    for (i = 2; i < UT_DEF_NUM_COLLIDING; ++i)
+    {
+        HENI_UT_CHECK_PTR_EQ(heniNeighborTableFind(&nbt, doFillAddr(&la1, doGetCollidingSeed(i))), &(nbs[i]));
+    }
+    HENI_UT_CHECK(doCountNbrsAndCheckEachOnce(&nbt, nbs, UT_DEF_NUM_COLLIDING) == UT_DEF_NUM_COLLIDING - 2);
+
+    /* The freed slots are reused. */
+    heniNeighborTableAddNonexisting(&nbt, doFillAddr(&la1, doGetCollidingSeed(1)), doInitNbr(&(nbs[1])));
+    heniNeighborTableAddNonexisting(&nbt, doFillAddr(&la1, doGetCollidingSeed(0)), doInitNbr(&(nbs[0])));
+    for (i = 0; i < UT_DEF_NUM_COLLIDING; ++i)
+    {
+        HENI_UT_CHECK_PTR_EQ(heniNeighborTableFind(&nbt, doFillAddr(&la1, doGetCollidingSeed(i))), &(nbs[i]));
+    }
+    HENI_UT_CHECK(doCountNbrsAndCheckEachOnce(&nbt, nbs, UT_DEF_NUM_COLLIDING) == UT_DEF_NUM_COLLIDING);
+
+    for (i = UT_DEF_NUM_COLLIDING; i > 0; --i)
+    {
+        heniNeighborTableRemoveExisting(&nbt, doFillAddr(&la1, doGetCollidingSeed(i - 1)));
+        HENI_UT_CHECK_PTR_EQ(heniNeighborTableFind(&nbt, doFillAddr(&la1, doGetCollidingSeed(i - 1))), NULL);
+        if (i > 1)
+        {
+            HENI_UT_CHECK_PTR_EQ(heniNeighborTableFind(&nbt, doFillAddr(&la1, doGetCollidingSeed(0))), &(nbs[0]));
+        }
+    }
+    HENI_UT_CHECK(doCountNbrsAndCheckEachOnce(&nbt, nbs, UT_DEF_NUM_COLLIDING) == 0);
+
+    heniNeighborTableCleanup(&nbt);
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+fillToCapacityAndRemoveViaTIter_ShouldVisitEachOnce(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_neighbor_table_t         nbt;
+    heni_neighbor_table_titer_t   nbtti;
+    heni_link_addr_container_t    la1;
+    heni_neighbor_t               nbs[UT_DEF_MAX_NBT_CAPACITY];
+    size_t                        i;
+
+    heniNeighborTableInit(&nbt, &g_utDefKernel, g_utDefNTBuffer, UT_DEF_MAX_NBT_SIZE);
+
+    for (i = 0; i < UT_DEF_MAX_NBT_CAPACITY; ++i)
+    {
+        heniNeighborTableAddNonexisting(&nbt, doFillAddr(&la1, UT_DEF_LLA_SEED1 + i), doInitNbr(&(nbs[i])));
+    }
+    for (i = 0; i < UT_DEF_MAX_NBT_CAPACITY; ++i)
+    {
+        HENI_UT_CHECK_PTR_EQ(heniNeighborTableFind(&nbt, doFillAddr(&la1, UT_DEF_LLA_SEED1 + i)), &(nbs[i]));
+    }
+    HENI_UT_CHECK_PTR_EQ(heniNeighborTableFind(&nbt, doFillAddr(&la1, UT_DEF_LLA_SEED1 + UT_DEF_MAX_NBT_CAPACITY)), NULL);
+    HENI_UT_CHECK(doCountNbrsAndCheckEachOnce(&nbt, nbs, UT_DEF_MAX_NBT_CAPACITY) == UT_DEF_MAX_NBT_CAPACITY);
+
+    /* Remove every other neighbor. */
+    i = 0;
+    heniNeighborTableTIterInit(&nbtti, &nbt);
+    while (heniNeighborTableTIterIsActive(&nbtti))
+    {
+        if (i % 2 == 0)
+        {
+            heniNeighborTableTIterRemoveAndAdvance(&nbtti);
+        }
+        else
+        {
+            heniNeighborTableTIterAdvance(&nbtti);
+        }
+        ++i;
+    }
+    HENI_UT_CHECK(i == UT_DEF_MAX_NBT_CAPACITY);
+    HENI_UT_CHECK(doCountNbrsAndCheckEachOnce(&nbt, nbs, UT_DEF_MAX_NBT_CAPACITY) == UT_DEF_MAX_NBT_CAPACITY / 2);
+
+    heniNeighborTableTIterInit(&nbtti, &nbt);
+    while (heniNeighborTableTIterIsActive(&nbtti))
+    {
+        heniNeighborTableTIterRemoveAndAdvance(&nbtti);
+    }
+    HENI_UT_CHECK(doCountNbrsAndCheckEachOnce(&nbt, nbs, UT_DEF_MAX_NBT_CAPACITY) == 0);
+    for (i = 0; i < UT_DEF_MAX_NBT_CAPACITY; ++i)
+    {
+        HENI_UT_CHECK_PTR_EQ(heniNeighborTableFind(&nbt, doFillAddr(&la1, UT_DEF_LLA_SEED1 + i)), NULL);
+    }
+
+    heniNeighborTableCleanup(&nbt);
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+iterConversionsWithRemovals_ShouldResumeAtSuccessor(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_neighbor_table_t         nbt;
+    heni_neighbor_table_titer_t   nbtti;
+    heni_neighbor_table_piter_t   nbtpi;
+    heni_link_addr_container_t    la1;
+    heni_neighbor_t               nbs[3];
+    heni_neighbor_t *             order[3];
+    size_t                        i;
+
+    heniNeighborTableInit(&nbt, &g_utDefKernel, g_utDefNTBuffer, UT_DEF_MAX_NBT_SIZE);
+    heniNeighborTableAddNonexisting(&nbt, doFillAddr(&la1, UT_DEF_LLA_SEED1), doInitNbr(&(nbs[0])));
+    heniNeighborTableAddNonexisting(&nbt, doFillAddr(&la1, UT_DEF_LLA_SEED2), doInitNbr(&(nbs[1])));
+    heniNeighborTableAddNonexisting(&nbt, doFillAddr(&la1, doGetCollidingSeed(0)), doInitNbr(&(nbs[2])));
+
+    heniNeighborTableTIterInit(&nbtti, &nbt);
+    for (i = 0; i < 3; ++i)
+    {
+        HENI_UT_CHECK(heniNeighborTableTIterIsActive(&nbtti));
+        order[i] = heniNeighborTableTIterGetNeighbor(&nbtti);
+        heniNeighborTableTIterAdvance(&nbtti);
+    }
+    HENI_UT_CHECK(! heniNeighborTableTIterIsActive(&nbtti));
+
+    /* A persistent iterator at an existing neighbor. */
+    heniNeighborTableTIterInit(&nbtti, &nbt);
+    heniNeighborTableTIterAdvance(&nbtti);
+    heniNeighborTableTIterToPIter(&nbtti, &nbtpi);
+    memset(&nbtti, 0x11, sizeof(nbtti));
+    heniNeighborTablePIterToTIter(&nbtpi, &nbtti);
+    HENI_UT_CHECK(heniNeighborTableTIterIsActive(&nbtti));
+    HENI_UT_CHECK_PTR_EQ(heniNeighborTableTIterGetNeighbor(&nbtti), order[1]);
+
+    /* The neighbor is removed: resume at its successor. */
+    heniNeighborTableRemoveExisting(&nbt, heniNeighborEntryGetLinkAddrConstPtr(order[1]));
+    memset(&nbtti, 0x22, sizeof(nbtti));
+    heniNeighborTablePIterToTIter(&nbtpi, &nbtti);
+    HENI_UT_CHECK(heniNeighborTableTIterIsActive(&nbtti));
+    HENI_UT_CHECK_PTR_EQ(heniNeighborTableTIterGetNeighbor(&nbtti), order[2]);
+
+    /* The successor is removed too: the iteration is finished. */
+    heniNeighborTableRemoveExisting(&nbt, heniNeighborEntryGetLinkAddrConstPtr(order[2]));
+    memset(&nbtti, 0x33, sizeof(nbtti));
+    heniNeighborTablePIterToTIter(&nbtpi, &nbtti);
+    HENI_UT_CHECK(! heniNeighborTableTIterIsActive(&nbtti));
+
+    /* A finished iterator stays finished. */
+    heniNeighborTableTIterToPIter(&nbtti, &nbtpi);
+    memset(&nbtti, 0x44, sizeof(nbtti));
+    heniNeighborTablePIterToTIter(&nbtpi, &nbtti);
+    HENI_UT_CHECK(! heniNeighborTableTIterIsActive(&nbtti));
+
+    heniNeighborTableRemoveExisting(&nbt, heniNeighborEntryGetLinkAddrConstPtr(order[0]));
+    heniNeighborTableCleanup(&nbt);
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                          The main test method                          *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniUnitTestSynchronouslyRunAll(
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_RUN_TEST(initNT_ShouldContainNoElements);
+    HENI_UT_RUN_TEST(addCollidingBeyondElement_ShouldOverflowAndFindAll);
+    HENI_UT_RUN_TEST(removeFromFullElement_ShouldKeepOverflowedReachable);
+    HENI_UT_RUN_TEST(fillToCapacityAndRemoveViaTIter_ShouldVisitEachOnce);
+    HENI_UT_RUN_TEST(iterConversionsWithRemovals_ShouldResumeAtSuccessor);
+}
@@ -0,0 +1,286 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+#define HENI_KERNEL_TASK_WITH_STATS 1
+#include "HENIKernel.h"
+#include "HENIScheduler.h"
+#include "HENIUnitTest.h"
+
+
+/**
+ * @file
+ * Type: heniUnitTestSynchronouslyRunAll
+ *
+ * The tests for the priority classes and the
+ * statistics (HENI_KERNEL_TASK_WITH_STATS) of
+ * the HENI kernel task scheduler.
+ */
+
+enum
+{
+    UT_MAX_EXECUTED_TASKS = 8,
+};
+
+heni_kernel_t                  g_utDefKernel;
+heni_kernel_task_count_t       g_utExecutedTaskIds[UT_MAX_EXECUTED_TASKS];
+size_t                         g_utNumExecutedTasks;
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                               Task stubs                               *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_PRV_FUNCT_DEF_PREFIX void doRecordExecutedTask(
+        heni_kernel_t * ker,
+        heni_kernel_task_count_t taskId
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_CHECK_PTR_EQ(ker, &g_utDefKernel);
+    HENI_UT_CHECK(g_utNumExecutedTasks < UT_MAX_EXECUTED_TASKS);
+    g_utExecutedTaskIds[g_utNumExecutedTasks++] = taskId;
+}
+
+
+
+HENI_HID_FUNCT_DEF_PREFIX void heniKernelControlTask(
+        heni_kernel_t * ker
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    doRecordExecutedTask(ker, HENI_KERNEL_TASK_GET_UID(heniKernelControlTask));
+}
+
+
+
+HENI_HID_FUNCT_DEF_PREFIX void heniKernelProcessOutgoingPacketsTask(
+        heni_kernel_t * ker
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    doRecordExecutedTask(ker, HENI_KERNEL_TASK_GET_UID(heniKernelProcessOutgoingPacketsTask));
+}
+
+
+
+HENI_HID_FUNCT_DEF_PREFIX void heniKernelProcessIncomingPacketsTask(
+        heni_kernel_t * ker
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    doRecordExecutedTask(ker, HENI_KERNEL_TASK_GET_UID(heniKernelProcessIncomingPacketsTask));
+}
+
+
+
+HENI_HID_FUNCT_DEF_PREFIX void heniKernelRoutePacketsTask(
+        heni_kernel_t * ker
+) HENI_HID_FUNCT_DEF_SUFFIX
+{
+    doRecordExecutedTask(ker, HENI_KERNEL_TASK_GET_UID(heniKernelRoutePacketsTask));
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                            Individual tests                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+#define UT_CONTROL HENI_KERNEL_TASK_GET_UID(heniKernelControlTask)
+#define UT_OUTGOING HENI_KERNEL_TASK_GET_UID(heniKernelProcessOutgoingPacketsTask)
+#define UT_INCOMING HENI_KERNEL_TASK_GET_UID(heniKernelProcessIncomingPacketsTask)
+#define UT_ROUTE HENI_KERNEL_TASK_GET_UID(heniKernelRoutePacketsTask)
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+init_ShouldNothingBeScheduled(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_kernel_task_scheduler_t * const   sched = &(g_utDefKernel.taskScheduler);
+    heni_kernel_task_count_t               taskId;
+
+    heniKernelTaskSchedulerInit(sched);
+
+    HENI_UT_CHECK(! heniKernelTaskSchedulerIsAnyScheduled(sched));
+    for (taskId = HENI_KERNEL_TASK_NULL + 1; taskId < HENI_KERNEL_TASK_LAST; ++taskId)
+    {
+        HENI_UT_CHECK(! heniKernelTaskSchedulerIsParticularScheduled(sched, taskId));
+        HENI_UT_CHECK(heniKernelTaskSchedulerGetNumRuns(sched, taskId) == 0);
+        HENI_UT_CHECK(heniKernelTaskSchedulerGetMaxLatency(sched, taskId) == 0);
+    }
+
+    heniKernelTaskSchedulerCleanup(sched);
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+addSameTaskTwice_ShouldTaskBeScheduledOnce(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_kernel_task_scheduler_t * const   sched = &(g_utDefKernel.taskScheduler);
+
+    heniKernelTaskSchedulerInit(sched);
+
+    HENI_UT_CHECK(heniKernelTaskSchedulerAddTask(sched, UT_OUTGOING));
+    HENI_UT_CHECK(! heniKernelTaskSchedulerAddTask(sched, UT_OUTGOING));
+    HENI_UT_CHECK(heniKernelTaskSchedulerAddTask(sched, UT_ROUTE));
+    HENI_UT_CHECK(! heniKernelTaskSchedulerAddTask(sched, UT_ROUTE));
+    HENI_UT_CHECK(heniKernelTaskSchedulerIsParticularScheduled(sched, UT_OUTGOING));
+    HENI_UT_CHECK(heniKernelTaskSchedulerIsParticularScheduled(sched, UT_ROUTE));
+    HENI_UT_CHECK(! heniKernelTaskSchedulerIsParticularScheduled(sched, UT_CONTROL));
+    HENI_UT_CHECK(! heniKernelTaskSchedulerIsParticularScheduled(sched, UT_INCOMING));
+
+    HENI_UT_CHECK(heniKernelTaskSchedulerExtractTask(sched) == UT_ROUTE);
+    HENI_UT_CHECK(heniKernelTaskSchedulerExtractTask(sched) == UT_OUTGOING);
+    HENI_UT_CHECK(! heniKernelTaskSchedulerIsAnyScheduled(sched));
+
+    heniKernelTaskSchedulerCleanup(sched);
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+extractTasksOfBothClasses_ShouldHighPrecedeLowAndEachClassBeFifo(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_kernel_task_scheduler_t * const   sched = &(g_utDefKernel.taskScheduler);
+
+    heniKernelTaskSchedulerInit(sched);
+
+    HENI_UT_CHECK(heniKernelTaskSchedulerGetTaskPriority(UT_CONTROL) == HENI_KERNEL_TASK_PRIO_HIGH);
+    HENI_UT_CHECK(heniKernelTaskSchedulerGetTaskPriority(UT_ROUTE) == HENI_KERNEL_TASK_PRIO_HIGH);
+    HENI_UT_CHECK(heniKernelTaskSchedulerGetTaskPriority(UT_OUTGOING) == HENI_KERNEL_TASK_PRIO_LOW);
+    HENI_UT_CHECK(heniKernelTaskSchedulerGetTaskPriority(UT_INCOMING) == HENI_KERNEL_TASK_PRIO_LOW);
+
+    heniKernelTaskSchedulerAddTask(sched, UT_INCOMING);
+    heniKernelTaskSchedulerAddTask(sched, UT_ROUTE);
+    heniKernelTaskSchedulerAddTask(sched, UT_OUTGOING);
+    heniKernelTaskSchedulerAddTask(sched, UT_CONTROL);
+
+    HENI_UT_CHECK(heniKernelTaskSchedulerExtractTask(sched) == UT_ROUTE);
+    HENI_UT_CHECK(heniKernelTaskSchedulerExtractTask(sched) == UT_CONTROL);
+    HENI_UT_CHECK(heniKernelTaskSchedulerExtractTask(sched) == UT_INCOMING);
+    HENI_UT_CHECK(heniKernelTaskSchedulerIsAnyScheduled(sched));
+    HENI_UT_CHECK(heniKernelTaskSchedulerExtractTask(sched) == UT_OUTGOING);
+    HENI_UT_CHECK(! heniKernelTaskSchedulerIsAnyScheduled(sched));
+
+    heniKernelTaskSchedulerCleanup(sched);
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+addHighWhileLowPending_ShouldHighBeExtractedFirst(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_kernel_task_scheduler_t * const   sched = &(g_utDefKernel.taskScheduler);
+
+    heniKernelTaskSchedulerInit(sched);
+
+    heniKernelTaskSchedulerAddTask(sched, UT_OUTGOING);
+    heniKernelTaskSchedulerAddTask(sched, UT_INCOMING);
+    HENI_UT_CHECK(heniKernelTaskSchedulerExtractTask(sched) == UT_OUTGOING);
+    heniKernelTaskSchedulerAddTask(sched, UT_CONTROL);
+    heniKernelTaskSchedulerAddTask(sched, UT_OUTGOING);
+    HENI_UT_CHECK(heniKernelTaskSchedulerExtractTask(sched) == UT_CONTROL);
+    heniKernelTaskSchedulerAddTask(sched, UT_ROUTE);
+    HENI_UT_CHECK(heniKernelTaskSchedulerExtractTask(sched) == UT_ROUTE);
+    HENI_UT_CHECK(heniKernelTaskSchedulerExtractTask(sched) == UT_INCOMING);
+    HENI_UT_CHECK(heniKernelTaskSchedulerExtractTask(sched) == UT_OUTGOING);
+    HENI_UT_CHECK(! heniKernelTaskSchedulerIsAnyScheduled(sched));
+
+    heniKernelTaskSchedulerCleanup(sched);
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+executeTasks_ShouldDispatchToTaskFunctions(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_kernel_task_scheduler_t * const   sched = &(g_utDefKernel.taskScheduler);
+
+    heniKernelTaskSchedulerInit(sched);
+    g_utNumExecutedTasks = 0;
+
+    heniKernelTaskSchedulerAddTask(sched, UT_OUTGOING);
+    heniKernelTaskSchedulerAddTask(sched, UT_ROUTE);
+    heniKernelTaskSchedulerAddTask(sched, UT_INCOMING);
+    heniKernelTaskSchedulerAddTask(sched, UT_CONTROL);
+    while (heniKernelTaskSchedulerIsAnyScheduled(sched))
+    {
+        heniKernelTaskSchedulerExecuteTask(sched, heniKernelTaskSchedulerExtractTask(sched));
+    }
+
+    HENI_UT_CHECK(g_utNumExecutedTasks == 4);
+    HENI_UT_CHECK(g_utExecutedTaskIds[0] == UT_ROUTE);
+    HENI_UT_CHECK(g_utExecutedTaskIds[1] == UT_CONTROL);
+    HENI_UT_CHECK(g_utExecutedTaskIds[2] == UT_OUTGOING);
+    HENI_UT_CHECK(g_utExecutedTaskIds[3] == UT_INCOMING);
+
+    heniKernelTaskSchedulerCleanup(sched);
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+extractTasks_ShouldStatsCountRunsAndMaxLatencies(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_kernel_task_scheduler_t * const   sched = &(g_utDefKernel.taskScheduler);
+
+    heniKernelTaskSchedulerInit(sched);
+
+    heniKernelTaskSchedulerAddTask(sched, UT_OUTGOING);
+    heniKernelTaskSchedulerAddTask(sched, UT_INCOMING);
+    heniKernelTaskSchedulerAddTask(sched, UT_CONTROL);
+    heniKernelTaskSchedulerAddTask(sched, UT_ROUTE);
+    while (heniKernelTaskSchedulerIsAnyScheduled(sched))
+    {
+        heniKernelTaskSchedulerExtractTask(sched);
+    }
+    heniKernelTaskSchedulerAddTask(sched, UT_OUTGOING);
+    heniKernelTaskSchedulerExtractTask(sched);
+
+    HENI_UT_CHECK(heniKernelTaskSchedulerGetNumRuns(sched, UT_CONTROL) == 1);
+    HENI_UT_CHECK(heniKernelTaskSchedulerGetNumRuns(sched, UT_ROUTE) == 1);
+    HENI_UT_CHECK(heniKernelTaskSchedulerGetNumRuns(sched, UT_OUTGOING) == 2);
+    HENI_UT_CHECK(heniKernelTaskSchedulerGetNumRuns(sched, UT_INCOMING) == 1);
+    HENI_UT_CHECK(heniKernelTaskSchedulerGetMaxLatency(sched, UT_CONTROL) == 0);
+    HENI_UT_CHECK(heniKernelTaskSchedulerGetMaxLatency(sched, UT_ROUTE) == 1);
+    HENI_UT_CHECK(heniKernelTaskSchedulerGetMaxLatency(sched, UT_OUTGOING) == 2);
+    HENI_UT_CHECK(heniKernelTaskSchedulerGetMaxLatency(sched, UT_INCOMING) == 3);
+
+    heniKernelTaskSchedulerResetStats(sched);
+
+    HENI_UT_CHECK(heniKernelTaskSchedulerGetNumRuns(sched, UT_OUTGOING) == 0);
+    HENI_UT_CHECK(heniKernelTaskSchedulerGetMaxLatency(sched, UT_INCOMING) == 0);
+
+    heniKernelTaskSchedulerCleanup(sched);
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                          The main test method                          *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniUnitTestSynchronouslyRunAll(
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_RUN_TEST(init_ShouldNothingBeScheduled);
+    HENI_UT_RUN_TEST(addSameTaskTwice_ShouldTaskBeScheduledOnce);
+    HENI_UT_RUN_TEST(extractTasksOfBothClasses_ShouldHighPrecedeLowAndEachClassBeFifo);
+    HENI_UT_RUN_TEST(addHighWhileLowPending_ShouldHighBeExtractedFirst);
+    HENI_UT_RUN_TEST(executeTasks_ShouldDispatchToTaskFunctions);
+    HENI_UT_RUN_TEST(extractTasks_ShouldStatsCountRunsAndMaxLatencies);
+}
@@ -0,0 +1,450 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+#define HENI_ZONE_TABLE_WITH_SORTED_ROWS 1
+#include "HENIZoneTable.h"
+#include "HENIUnitTest.h"
+
+
+/**
+ * @file
+ * Type: heniUnitTestSynchronouslyRunAll
+ *
+ * The tests for the zone table backend that
+ * keeps each row as an array sorted by LID and
+ * discriminator (HENI_ZONE_TABLE_WITH_SORTED_ROWS).
+ */
+
+enum
+{
+    UT_MAX_ZT_ROWS = 16,
+    UT_DEF_ZT_ZONES_PER_ROW = 6,
+    UT_DEF_LSPEC = 4,
+    UT_DEF_DISCRBITS = 4,
+};
+
+heni_instance_t                g_utDefInstance;
+heni_zone_table_bucket_t       g_utDefZoneTableAllBuckets[UT_MAX_ZT_ROWS * UT_DEF_ZT_ZONES_PER_ROW];
+heni_zone_table_bucket_t *     g_utDefZoneTableBuckets[UT_MAX_ZT_ROWS];
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                            Helper functions                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_level_t utMaxLevel() HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_lspec_t      lspec = heniKernelInstanceGetLabelSpecForInstancePtr(&g_utDefInstance);
+    return heniLabelSpecGetNumLevels(lspec);
+}
+
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_instance_t * doInitInst() HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    g_utDefInstance.ker = NULL;
+    g_utDefInstance.iid = 1;
+    g_utDefInstance.lspec = UT_DEF_LSPEC;
+    g_utDefInstance.logNumZoneDiscrBitsPlusOne = UT_DEF_DISCRBITS;
+    return &g_utDefInstance;
+}
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_zone_table_bucket_t * * doInitRows(
+        heni_level_t numRows,
+        size_t zonesPerRow
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_level_t   level;
+    HENI_PASSERT(numRows > 0);
+    HENI_PASSERT(zonesPerRow > 0 && zonesPerRow <= UT_DEF_ZT_ZONES_PER_ROW);
+    for (level = 0; level < numRows; ++level)
+    {
+        g_utDefZoneTableBuckets[level] = &(g_utDefZoneTableAllBuckets[level * UT_DEF_ZT_ZONES_PER_ROW]);
+    }
+    return &(g_utDefZoneTableBuckets[0]);
+}
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_zone_t * doInitZone(
+        heni_zone_t * zone
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    return zone;
+}
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_zone_lid_t sampleLID(
+        uint8_t seed
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_lspec_t      lspec = heniKernelInstanceGetLabelSpecForInstancePtr(&g_utDefInstance);
+    heni_zone_lid_t   lid = heniLabelSpecGetZoneLIDMinAssignable(lspec) + seed;
+    HENI_PASSERT(heniLabelSpecIsZoneLIDAssignable(lid, lspec));
+    return lid;
+}
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_zone_lid_t invalidLID() HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_lspec_t   lspec = heniKernelInstanceGetLabelSpecForInstancePtr(&g_utDefInstance);
+    return heniLabelSpecGetZoneLIDInvalid(lspec);
+}
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_zone_discr_t sampleDiscr(
+        uint8_t seed
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+
+    uint8_t             numBits = heniKernelInstanceGetNumZoneDiscrBitsForInstancePtr(&g_utDefInstance);
+    heni_zone_discr_t   discr = heniZoneDiscrSpecGetZoneDiscrMinAssignable(numBits) + seed;
+    HENI_PASSERT(heniZoneDiscrSpecIsZoneDiscrAssignable(discr, numBits));
+    return discr;
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                            Individual tests                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_UT_FUNCT_DEF_PREFIX void
+init_ShouldContainNoElements(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_zone_table_t         zt;
+    heni_zone_table_titer_t   zti;
+    heni_level_t              level, maxLevel;
+
+    heniZoneTableInit(&zt, doInitInst(), doInitRows(UT_MAX_ZT_ROWS, UT_DEF_ZT_ZONES_PER_ROW), UT_DEF_ZT_ZONES_PER_ROW);
+
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 0, invalidLID(), sampleDiscr(0)), NULL);
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 1, sampleLID(1), sampleDiscr(1)), NULL);
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 2, sampleLID(2), sampleDiscr(2)), NULL);
+
+    for (level = 0, maxLevel = utMaxLevel(); level <= maxLevel; ++level)
+    {
+        heniZoneTableTIterSetAtLevel(&zti, &zt, level);
+        HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+    }
+
+    heniZoneTableCleanup(&zt);
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+addOneAtLevelZero_ShouldContainOneElementAtLevelZero(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_zone_table_t         zt;
+    heni_zone_table_titer_t   zti;
+    heni_zone_t               ze1;
+    heni_level_t              level, maxLevel;
+
+    heniZoneTableInit(&zt, doInitInst(), doInitRows(UT_MAX_ZT_ROWS, UT_DEF_ZT_ZONES_PER_ROW), UT_DEF_ZT_ZONES_PER_ROW);
+    heniZoneTableAddNonexisting(&zt, 0, invalidLID(), sampleDiscr(0), doInitZone(&ze1));
+
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 0, invalidLID(), sampleDiscr(0)), &ze1);
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 0, invalidLID(), sampleDiscr(1)), NULL);
+
+    heniZoneTableTIterSetAtLevel(&zti, &zt, 0);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &ze1);
+    HENI_UT_CHECK_EQ(heniZoneTableTIterGetLevel(&zti), 0, HENI_PRI_LEVEL);
+    HENI_UT_CHECK_EQ(heniZoneTableTIterGetLID(&zti), invalidLID(), HENI_PRI_ZONE_LID);
+    HENI_UT_CHECK_EQ(heniZoneTableTIterGetDiscr(&zti), sampleDiscr(0), HENI_PRI_ZONE_DISCR);
+    heniZoneTableTIterAdvancePreservingLevel(&zti);
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+
+    for (level = 1, maxLevel = utMaxLevel(); level <= maxLevel; ++level)
+    {
+        heniZoneTableTIterSetAtLevel(&zti, &zt, level);
+        HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+    }
+
+    heniZoneTableRemoveExisting(&zt, 0, invalidLID(), sampleDiscr(0));
+    heniZoneTableTIterSetAtLevel(&zti, &zt, 0);
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+
+    heniZoneTableCleanup(&zt);
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+addInReverseOrder_ShouldLevelContainAllInOrder(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_zone_table_t         zt;
+    heni_zone_table_titer_t   zti;
+    heni_zone_t               ze[UT_DEF_ZT_ZONES_PER_ROW];
+    heni_level_t              level, maxLevel;
+    size_t                    i;
+
+    heniZoneTableInit(&zt, doInitInst(), doInitRows(UT_MAX_ZT_ROWS, UT_DEF_ZT_ZONES_PER_ROW), UT_DEF_ZT_ZONES_PER_ROW);
+    /* LIDs 1, 1, 1, 2, 3, 3 with ascending discriminators, added backwards. */
+    heniZoneTableAddNonexisting(&zt, 2, sampleLID(3), sampleDiscr(4), doInitZone(&(ze[5])));
+    heniZoneTableAddNonexisting(&zt, 2, sampleLID(3), sampleDiscr(0), doInitZone(&(ze[4])));
+    heniZoneTableAddNonexisting(&zt, 2, sampleLID(2), sampleDiscr(1), doInitZone(&(ze[3])));
+    heniZoneTableAddNonexisting(&zt, 2, sampleLID(1), sampleDiscr(5), doInitZone(&(ze[2])));
+    heniZoneTableAddNonexisting(&zt, 2, sampleLID(1), sampleDiscr(3), doInitZone(&(ze[1])));
+    heniZoneTableAddNonexisting(&zt, 2, sampleLID(1), sampleDiscr(1), doInitZone(&(ze[0])));
+
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 2, sampleLID(1), sampleDiscr(1)), &(ze[0]));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 2, sampleLID(1), sampleDiscr(3)), &(ze[1]));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 2, sampleLID(1), sampleDiscr(5)), &(ze[2]));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 2, sampleLID(2), sampleDiscr(1)), &(ze[3]));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 2, sampleLID(3), sampleDiscr(0)), &(ze[4]));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 2, sampleLID(3), sampleDiscr(4)), &(ze[5]));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 2, sampleLID(1), sampleDiscr(2)), NULL);
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 2, sampleLID(0), sampleDiscr(1)), NULL);
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 2, sampleLID(4), sampleDiscr(1)), NULL);
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 1, sampleLID(1), sampleDiscr(1)), NULL);
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 3, sampleLID(1), sampleDiscr(1)), NULL);
+
+    for (level = 0, maxLevel = utMaxLevel(); level <= maxLevel; ++level)
+    {
+        heniZoneTableTIterSetAtLevel(&zti, &zt, level);
+        if (level == 2)
+        {
+            for (i = 0; i < UT_DEF_ZT_ZONES_PER_ROW; ++i)
+            {
+                HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+                HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[i]));
+                HENI_UT_CHECK_EQ(heniZoneTableTIterGetLevel(&zti), 2, HENI_PRI_LEVEL);
+                heniZoneTableTIterAdvancePreservingLevel(&zti);
+            }
+            HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+        }
+        else
+        {
+            HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+        }
+    }
+
+    heniZoneTableTIterSetAtLevelAndLID(&zti, &zt, 2, sampleLID(1));
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[0]));
+    heniZoneTableTIterAdvancePreservingLevelAndLID(&zti);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[1]));
+    heniZoneTableTIterAdvancePreservingLevelAndLID(&zti);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[2]));
+    heniZoneTableTIterAdvancePreservingLevelAndLID(&zti);
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+
+    heniZoneTableTIterSetAtLevelAndLID(&zti, &zt, 2, sampleLID(3));
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[4]));
+    heniZoneTableTIterAdvancePreservingLevelAndLID(&zti);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[5]));
+    heniZoneTableTIterAdvancePreservingLevelAndLID(&zti);
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+
+    heniZoneTableTIterSetAtLevelAndLID(&zti, &zt, 2, sampleLID(0));
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+    heniZoneTableTIterSetAtLevelAndLID(&zti, &zt, 2, sampleLID(4));
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+    heniZoneTableTIterSetAtLevelAndLIDAndDiscr(&zti, &zt, 2, sampleLID(3), sampleDiscr(4));
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[5]));
+    heniZoneTableTIterSetAtLevelAndLIDAndDiscr(&zti, &zt, 2, sampleLID(3), sampleDiscr(3));
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+
+    heniZoneTableTIterSetAtLevel(&zti, &zt, 2);
+    for (i = 0; i < UT_DEF_ZT_ZONES_PER_ROW; ++i)
+    {
+        heniZoneTableRemoveExisting(
+                &zt,
+                2,
+                heniZoneTableTIterGetLID(&zti),
+                heniZoneTableTIterGetDiscr(&zti)
+        );
+        heniZoneTableTIterSetAtLevel(&zti, &zt, 2);
+        if (i + 1 < UT_DEF_ZT_ZONES_PER_ROW)
+        {
+            HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+            HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[i + 1]));
+        }
+    }
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+
+    heniZoneTableCleanup(&zt);
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+removeDirectlyFromMiddle_ShouldRemainingElementsStayInOrder(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_zone_table_t         zt;
+    heni_zone_table_titer_t   zti;
+    heni_zone_t               ze[4];
+
+    heniZoneTableInit(&zt, doInitInst(), doInitRows(UT_MAX_ZT_ROWS, UT_DEF_ZT_ZONES_PER_ROW), UT_DEF_ZT_ZONES_PER_ROW);
+    heniZoneTableAddNonexisting(&zt, 1, sampleLID(1), sampleDiscr(0), doInitZone(&(ze[0])));
+    heniZoneTableAddNonexisting(&zt, 1, sampleLID(2), sampleDiscr(0), doInitZone(&(ze[1])));
+    heniZoneTableAddNonexisting(&zt, 1, sampleLID(3), sampleDiscr(0), doInitZone(&(ze[2])));
+    heniZoneTableAddNonexisting(&zt, 1, sampleLID(4), sampleDiscr(0), doInitZone(&(ze[3])));
+
+    heniZoneTableRemoveExisting(&zt, 1, sampleLID(2), sampleDiscr(0));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 1, sampleLID(1), sampleDiscr(0)), &(ze[0]));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 1, sampleLID(2), sampleDiscr(0)), NULL);
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 1, sampleLID(3), sampleDiscr(0)), &(ze[2]));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 1, sampleLID(4), sampleDiscr(0)), &(ze[3]));
+
+    heniZoneTableTIterSetAtLevel(&zti, &zt, 1);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[0]));
+    heniZoneTableTIterAdvancePreservingLevel(&zti);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[2]));
+    heniZoneTableTIterAdvancePreservingLevel(&zti);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[3]));
+    heniZoneTableTIterAdvancePreservingLevel(&zti);
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+
+    heniZoneTableAddNonexisting(&zt, 1, sampleLID(2), sampleDiscr(0), doInitZone(&(ze[1])));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 1, sampleLID(2), sampleDiscr(0)), &(ze[1]));
+    heniZoneTableRemoveExisting(&zt, 1, sampleLID(4), sampleDiscr(0));
+    heniZoneTableRemoveExisting(&zt, 1, sampleLID(1), sampleDiscr(0));
+    heniZoneTableTIterSetAtLevel(&zti, &zt, 1);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[1]));
+    heniZoneTableTIterAdvancePreservingLevel(&zti);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[2]));
+    heniZoneTableTIterAdvancePreservingLevel(&zti);
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+
+    heniZoneTableRemoveExisting(&zt, 1, sampleLID(2), sampleDiscr(0));
+    heniZoneTableRemoveExisting(&zt, 1, sampleLID(3), sampleDiscr(0));
+    heniZoneTableCleanup(&zt);
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+removeViaTIterWithSameLID_ShouldStopAtNextLID(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_zone_table_t         zt;
+    heni_zone_table_titer_t   zti;
+    heni_zone_t               ze[4];
+
+    heniZoneTableInit(&zt, doInitInst(), doInitRows(UT_MAX_ZT_ROWS, UT_DEF_ZT_ZONES_PER_ROW), UT_DEF_ZT_ZONES_PER_ROW);
+    heniZoneTableAddNonexisting(&zt, 3, sampleLID(1), sampleDiscr(1), doInitZone(&(ze[0])));
+    heniZoneTableAddNonexisting(&zt, 3, sampleLID(2), sampleDiscr(1), doInitZone(&(ze[1])));
+    heniZoneTableAddNonexisting(&zt, 3, sampleLID(2), sampleDiscr(2), doInitZone(&(ze[2])));
+    heniZoneTableAddNonexisting(&zt, 3, sampleLID(3), sampleDiscr(1), doInitZone(&(ze[3])));
+
+    heniZoneTableTIterSetAtLevelAndLID(&zti, &zt, 3, sampleLID(2));
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[1]));
+    heniZoneTableTIterRemoveAndAdvancePreservingLevelAndLID(&zti);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[2]));
+    heniZoneTableTIterRemoveAndAdvancePreservingLevelAndLID(&zti);
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 3, sampleLID(2), sampleDiscr(1)), NULL);
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableFind(&zt, 3, sampleLID(2), sampleDiscr(2)), NULL);
+
+    heniZoneTableTIterSetAtLevel(&zti, &zt, 3);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[0]));
+    heniZoneTableTIterRemoveAndAdvancePreservingLevel(&zti);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[3]));
+    heniZoneTableTIterRemoveAndAdvancePreservingLevel(&zti);
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+
+    heniZoneTableTIterSetAtLevel(&zti, &zt, 3);
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+
+    heniZoneTableCleanup(&zt);
+}
+
+
+
+HENI_UT_FUNCT_DEF_PREFIX void
+iterConversionsWithRemovals_ShouldResumeAtSuccessor(
+) HENI_UT_FUNCT_DEF_SUFFIX
+{
+    heni_zone_table_t         zt;
+    heni_zone_t               ze[4];
+    heni_zone_table_titer_t   zti;
+    heni_zone_table_piter_t   ztpi;
+
+    heniZoneTableInit(&zt, doInitInst(), doInitRows(UT_MAX_ZT_ROWS, UT_DEF_ZT_ZONES_PER_ROW), UT_DEF_ZT_ZONES_PER_ROW);
+    heniZoneTableAddNonexisting(&zt, 2, sampleLID(1), sampleDiscr(1), doInitZone(&(ze[0])));
+    heniZoneTableAddNonexisting(&zt, 2, sampleLID(1), sampleDiscr(3), doInitZone(&(ze[1])));
+    heniZoneTableAddNonexisting(&zt, 2, sampleLID(1), sampleDiscr(5), doInitZone(&(ze[2])));
+    heniZoneTableAddNonexisting(&zt, 2, sampleLID(4), sampleDiscr(1), doInitZone(&(ze[3])));
+
+    heniZoneTableTIterSetAtLevelAndLIDAndDiscr(&zti, &zt, 2, sampleLID(1), sampleDiscr(3));
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    heniZoneTableTIterToPIter(&zti, &ztpi);
+    memset(&zti, 0x11, sizeof(zti));
+    heniZoneTablePIterToTIterPreservingLevelAndLIDAndDiscr(&ztpi, &zti);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[1]));
+
+    heniZoneTableRemoveExisting(&zt, 2, sampleLID(1), sampleDiscr(3));
+    memset(&zti, 0x22, sizeof(zti));
+    heniZoneTablePIterToTIterPreservingLevel(&ztpi, &zti);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[2]));
+    memset(&zti, 0x33, sizeof(zti));
+    heniZoneTablePIterToTIterPreservingLevelAndLID(&ztpi, &zti);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[2]));
+    memset(&zti, 0x44, sizeof(zti));
+    heniZoneTablePIterToTIterPreservingLevelAndLIDAndDiscr(&ztpi, &zti);
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+
+    heniZoneTableRemoveExisting(&zt, 2, sampleLID(1), sampleDiscr(5));
+    memset(&zti, 0x55, sizeof(zti));
+    heniZoneTablePIterToTIterPreservingLevel(&ztpi, &zti);
+    HENI_UT_CHECK(heniZoneTableTIterIsActive(&zti));
+    HENI_UT_CHECK_PTR_EQ(heniZoneTableTIterGetZone(&zti), &(ze[3]));
+    memset(&zti, 0x66, sizeof(zti));
+    heniZoneTablePIterToTIterPreservingLevelAndLID(&ztpi, &zti);
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+
+    heniZoneTableRemoveExisting(&zt, 2, sampleLID(4), sampleDiscr(1));
+    memset(&zti, 0x77, sizeof(zti));
+    heniZoneTablePIterToTIterPreservingLevel(&ztpi, &zti);
+    HENI_UT_CHECK(! heniZoneTableTIterIsActive(&zti));
+
+    heniZoneTableRemoveExisting(&zt, 2, sampleLID(1), sampleDiscr(1));
+    heniZoneTableCleanup(&zt);
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                          The main test method                          *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniUnitTestSynchronouslyRunAll(
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_RUN_TEST(init_ShouldContainNoElements);
+    HENI_UT_RUN_TEST(addOneAtLevelZero_ShouldContainOneElementAtLevelZero);
+    HENI_UT_RUN_TEST(addInReverseOrder_ShouldLevelContainAllInOrder);
+    HENI_UT_RUN_TEST(removeDirectlyFromMiddle_ShouldRemainingElementsStayInOrder);
+    HENI_UT_RUN_TEST(removeViaTIterWithSameLID_ShouldStopAtNextLID);
+    HENI_UT_RUN_TEST(iterConversionsWithRemovals_ShouldResumeAtSuccessor);
+}
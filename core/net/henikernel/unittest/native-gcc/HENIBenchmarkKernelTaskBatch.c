@@ -0,0 +1,404 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "HENIFrame.h"
+#include "HENIKernel.h"
+#include "HENIUnitTest.h"
+#include "HENICommonStubLinkAddress.h"
+
+
+/**
+ * @file
+ * HENI: A throughput benchmark of the packet-processing
+ * tasks of a HENI kernel as a function of the task batch
+ * limit. Each round pushes a burst of outgoing packets
+ * and incoming frames through the kernel and counts the
+ * scheduler dispatches that were necessary to drain them.
+ * Incoming frames are handed to the kernel as soon as
+ * it has a reassembly buffer for them, like a radio
+ * driver with a deep receive queue would do.
+ */
+
+
+enum
+{
+    BM_DEF_BURST_SIZE = 64,
+    BM_DEF_NUM_ROUNDS = 20000,
+    BM_DEF_PAYLOAD_SIZE = 32,
+};
+
+
+typedef struct bm_def_packet_slot_s
+{
+    heni_packet_t            packet;
+    uint8_t                  used;
+} bm_def_packet_slot_t;
+
+typedef struct bm_def_buffer_s
+{
+    heni_iobuf_list_t        iol;
+    heni_iobuf_list_node_t   ioln;
+    uint8_t                  data[BM_DEF_PAYLOAD_SIZE];
+} bm_def_buffer_t;
+
+
+heni_kernel_t              g_bmDefKernel;
+heni_instance_t            g_bmDefInstance;
+uint8_t                    g_bmDefInstanceUsed;
+bm_def_packet_slot_t       g_bmDefPackets[2 * BM_DEF_BURST_SIZE];
+bm_def_buffer_t            g_bmDefTxBuffers[BM_DEF_BURST_SIZE];
+bm_def_buffer_t            g_bmDefRxBuffers[BM_DEF_BURST_SIZE];
+
+heni_iobuf_list_t *        g_bmDefFramesInFlight[BM_DEF_BURST_SIZE];
+size_t                     g_bmDefNumFramesInFlight;
+heni_iobuf_list_t *        g_bmDefPacketsBeingReceived[BM_DEF_BURST_SIZE];
+size_t                     g_bmDefNumPacketsBeingReceived;
+size_t                     g_bmDefNumRxFramesDelivered;
+size_t                     g_bmDefNumRxFramesOutstanding;
+
+uint8_t                    g_bmDefComputationsPostponed;
+unsigned long              g_bmDefNumDispatches;
+unsigned long              g_bmDefNumPacketsSent;
+unsigned long              g_bmDefNumFramesReceived;
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                          Kernel environment                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_EXT_FUNCT_DEF_PREFIX heni_instance_t * heniKernelInstanceAlloc(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    if (g_bmDefInstanceUsed)
+    {
+        return NULL;
+    }
+    g_bmDefInstanceUsed = 1;
+    return &g_bmDefInstance;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelInstanceFree(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid,
+        heni_instance_t * inst
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    g_bmDefInstanceUsed = 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX heni_packet_t * heniPacketAlloc(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    size_t   i;
+    for (i = 0; i < sizeof(g_bmDefPackets) / sizeof(g_bmDefPackets[0]); ++i)
+    {
+        if (! g_bmDefPackets[i].used)
+        {
+            g_bmDefPackets[i].used = 1;
+            return &g_bmDefPackets[i].packet;
+        }
+    }
+    return NULL;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniPacketFree(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid,
+        heni_packet_t * packet
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    ((bm_def_packet_slot_t *)packet)->used = 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelPostponeComputations(
+        heni_kernel_t * ker
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_CHECK(! g_bmDefComputationsPostponed);
+    g_bmDefComputationsPostponed = 1;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelInstanceStopDone(
+        heni_kernel_t * ker,
+        heni_instance_id_t iid
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelInstanceStopAllDone(
+        heni_kernel_t * ker
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX int_fast8_t heniKernelFrameSendStart(
+        heni_kernel_t * ker,
+        heni_frame_addr_t const * faddr,
+        heni_iobuf_list_t * fpld
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_CHECK(g_bmDefNumFramesInFlight < BM_DEF_BURST_SIZE);
+    g_bmDefFramesInFlight[g_bmDefNumFramesInFlight++] = fpld;
+    return 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniPacketSendFinish(
+        heni_kernel_t * ker,
+        heni_packet_addr_t const * paddr,
+        heni_iobuf_list_t * ppld,
+        heni_packet_tx_info_t const * psts
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    ++g_bmDefNumPacketsSent;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX int_fast8_t heniPacketReceiveStart(
+        heni_kernel_t * ker,
+        heni_packet_addr_t const * paddr,
+        heni_iobuf_list_t * ppld,
+        heni_packet_rx_info_t const * psts
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    HENI_UT_CHECK(g_bmDefNumPacketsBeingReceived < BM_DEF_BURST_SIZE);
+    g_bmDefPacketsBeingReceived[g_bmDefNumPacketsBeingReceived++] = ppld;
+    return 0;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniKernelFrameReceiveFinish(
+        heni_kernel_t * ker,
+        heni_iobuf_list_t * fpld
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    ++g_bmDefNumFramesReceived;
+    --g_bmDefNumRxFramesOutstanding;
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                            Helper functions                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_PRV_FUNCT_DEF_PREFIX void doInitBuffer(
+        bm_def_buffer_t * buf
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    memset(buf->data, 0x5a, sizeof(buf->data));
+    heniIOBufListInit(&buf->iol);
+    heniIOBufNodeInitMem(&buf->ioln, buf->data, sizeof(buf->data));
+    heniIOBufNodeAddBack(&buf->iol, &buf->ioln);
+}
+
+
+
+/**
+ * Initializes a buffer with a single-fragment frame,
+ * that is, a fragment header with a zero offset and
+ * no more fragments, followed by the payload.
+ */
+HENI_PRV_FUNCT_DEF_PREFIX void doInitFrameBuffer(
+        bm_def_buffer_t * buf,
+        uint8_t tag
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    memset(buf->data, 0x5a, sizeof(buf->data));
+    memset(buf->data, 0x00, HENI_KERNEL_FRAGMENT_HEADER_SIZE);
+    buf->data[0] = tag;
+    heniIOBufListInit(&buf->iol);
+    heniIOBufNodeInitMem(&buf->ioln, buf->data, sizeof(buf->data));
+    heniIOBufNodeAddBack(&buf->iol, &buf->ioln);
+}
+
+
+
+/**
+ * Runs the kernel, completing frames and receptions
+ * as the environment would, until there is nothing
+ * left to do.
+ */
+HENI_PRV_FUNCT_DEF_PREFIX void doRunUntilIdle(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_frame_addr_t      faddr;
+    heni_frame_rx_info_t   finfo;
+
+    heniFrameAddrReset(&faddr);
+    heniLinkAddrStubFill(heniFrameAddrGetSrcLinkAddrPtr(&faddr), 42);
+    heniLinkAddrFetchMine(heniFrameAddrGetDstLinkAddrPtr(&faddr));
+    memset(&finfo, 0, sizeof(finfo));
+    for (;;)
+    {
+        if (g_bmDefNumRxFramesDelivered < BM_DEF_BURST_SIZE &&
+                g_bmDefNumRxFramesOutstanding < HENI_KERNEL_MAX_REASSEMBLIES_PER_INSTANCE)
+        {
+            HENI_UT_CHECK(
+                    heniKernelFrameReceiveStart(
+                            &g_bmDefKernel,
+                            &faddr,
+                            &g_bmDefRxBuffers[g_bmDefNumRxFramesDelivered++].iol,
+                            &finfo
+                    ) == 0
+            );
+            ++g_bmDefNumRxFramesOutstanding;
+        }
+        else if (g_bmDefComputationsPostponed)
+        {
+            g_bmDefComputationsPostponed = 0;
+            ++g_bmDefNumDispatches;
+            heniKernelResumeComputations(&g_bmDefKernel);
+        }
+        else if (g_bmDefNumFramesInFlight > 0)
+        {
+            heni_frame_tx_info_t   finfo;
+            heni_iobuf_list_t *    fpld = g_bmDefFramesInFlight[0];
+            /* Frames complete in the order of their submission. */
+            memmove(&g_bmDefFramesInFlight[0], &g_bmDefFramesInFlight[1],
+                    (--g_bmDefNumFramesInFlight) * sizeof(g_bmDefFramesInFlight[0]));
+            heniFrameTxInfoReset(&finfo);
+            heniKernelFrameSendFinish(&g_bmDefKernel, fpld, &finfo);
+        }
+        else if (g_bmDefNumPacketsBeingReceived > 0)
+        {
+            heniPacketReceiveFinish(
+                    &g_bmDefKernel,
+                    g_bmDefPacketsBeingReceived[--g_bmDefNumPacketsBeingReceived]
+            );
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doRunRound(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_packet_addr_t     paddr;
+    size_t                 i;
+
+    heniPacketAddrReset(&paddr);
+    heniPacketAddrSetInstanceID(&paddr, HENI_INSTANCE_ID_MIN);
+    for (i = 0; i < BM_DEF_BURST_SIZE; ++i)
+    {
+        HENI_UT_CHECK(heniPacketSendStart(&g_bmDefKernel, &paddr, &g_bmDefTxBuffers[i].iol) == 0);
+    }
+    g_bmDefNumRxFramesDelivered = 0;
+    doRunUntilIdle();
+    HENI_UT_CHECK(g_bmDefNumRxFramesOutstanding == 0);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX double doGetTimeInSec(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    struct timespec   ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doBenchmarkBatchLimit(
+        heni_kernel_task_batch_t limit
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    double          start;
+    double          elapsed;
+    unsigned long   numPackets;
+    unsigned        round;
+
+    HENI_UT_CHECK(heniKernelInit(&g_bmDefKernel) == 0);
+    heniKernelAccessorsSetTaskBatchLimit(&g_bmDefKernel, limit);
+    HENI_UT_CHECK(heniKernelInstanceStart(&g_bmDefKernel, HENI_INSTANCE_ID_MIN) == 0);
+    g_bmDefNumDispatches = 0;
+    g_bmDefNumPacketsSent = 0;
+    g_bmDefNumFramesReceived = 0;
+
+    start = doGetTimeInSec();
+    for (round = 0; round < BM_DEF_NUM_ROUNDS; ++round)
+    {
+        doRunRound();
+    }
+    elapsed = doGetTimeInSec() - start;
+
+    numPackets = (unsigned long)BM_DEF_NUM_ROUNDS * BM_DEF_BURST_SIZE;
+    HENI_UT_CHECK(g_bmDefNumPacketsSent == numPackets);
+    HENI_UT_CHECK(g_bmDefNumFramesReceived == numPackets);
+    printf("[BM] batch %3u: %10.0f packets/s, %6.3f dispatches/packet\n",
+            (unsigned)limit,
+            (double)(2 * numPackets) / elapsed,
+            (double)g_bmDefNumDispatches / (double)(2 * numPackets));
+
+    heniKernelInstanceStopAllTrigger(&g_bmDefKernel);
+    g_bmDefNumRxFramesDelivered = BM_DEF_BURST_SIZE;
+    doRunUntilIdle();
+    HENI_UT_CHECK(! g_bmDefInstanceUsed);
+    heniKernelCleanup(&g_bmDefKernel);
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                         The main benchmark method                      *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+int main(int argc, char * argv[])
+{
+    static heni_kernel_task_batch_t const   limits[] = { 1, 2, 4, 8, 16, 32, 64 };
+    size_t                                  i;
+
+    for (i = 0; i < BM_DEF_BURST_SIZE; ++i)
+    {
+        doInitBuffer(&g_bmDefTxBuffers[i]);
+        doInitFrameBuffer(&g_bmDefRxBuffers[i], (uint8_t)i);
+    }
+    printf("[BM] HENI kernel task batching: %u rounds of %u outgoing and %u incoming packets\n",
+            (unsigned)BM_DEF_NUM_ROUNDS, (unsigned)BM_DEF_BURST_SIZE, (unsigned)BM_DEF_BURST_SIZE);
+    for (i = 0; i < sizeof(limits) / sizeof(limits[0]); ++i)
+    {
+        doBenchmarkBatchLimit(limits[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,247 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "HENILinkAddress.h"
+#include "HENINeighborTable.h"
+#include "HENIUnitTest.h"
+
+
+/**
+ * @file
+ * HENI: A benchmark of neighbor lookups in a HENI
+ * neighbor table at the densities of our deployments.
+ * Each lookup corresponds to a received frame, which
+ * comes either from a neighbor in the table or from
+ * a node that is not (yet) a neighbor. The same source
+ * is built for each neighbor table backend.
+ */
+
+
+enum
+{
+    BM_DEF_MAX_NEIGHBORS = 200,
+    BM_DEF_NUM_MISS_ADDRS = 256,
+    BM_DEF_HASHED_BUCKETS = 16,
+    BM_DEF_NUM_OPS = 4000000,
+};
+
+#if HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS
+/* At most three quarters of the slots are used. */
+#define BM_DEF_NUM_ELEMS(n) \
+    (((n) * 4 / 3 + (HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM) - 1) / (HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM))
+#else
+#define BM_DEF_NUM_ELEMS(n) (BM_DEF_HASHED_BUCKETS)
+#endif /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
+
+
+struct heni_kernel_s
+{
+    int PLACEHOLDER;
+};
+
+heni_kernel_t                  g_bmDefKernel;
+heni_neighbor_table_elem_t     g_bmDefNTBuffer[BM_DEF_NUM_ELEMS(BM_DEF_MAX_NEIGHBORS)];
+heni_neighbor_t                g_bmDefNeighbors[BM_DEF_MAX_NEIGHBORS];
+heni_link_addr_container_t     g_bmDefHitAddrs[BM_DEF_MAX_NEIGHBORS];
+heni_link_addr_container_t     g_bmDefMissAddrs[BM_DEF_NUM_MISS_ADDRS];
+unsigned long                  g_bmDefRandState;
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                      Link-layer address environment                    *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_EXT_FUNCT_DEF_PREFIX int_fast8_t heniLinkAddrCmp(
+        uint8_t const * laddrPtr1,
+        uint8_t const * laddrPtr2
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    int   res = memcmp(laddrPtr1, laddrPtr2, HENI_LINK_ADDR_MAX_BYTE_SIZE);
+    return res < 0 ? (int_fast8_t)-1 : (res > 0 ? (int_fast8_t)1 : (int_fast8_t)0);
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX size_t heniLinkAddrHash(
+        uint8_t const * laddrPtr
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    /* FNV-1a, as a real port would use for EUI-64 addresses. */
+    uint32_t   res = 2166136261UL;
+    size_t     i;
+    for (i = 0; i < HENI_LINK_ADDR_MAX_BYTE_SIZE; ++i)
+    {
+        res = (res ^ laddrPtr[i]) * 16777619UL;
+    }
+    return (size_t)res;
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniLinkAddrCopy(
+        uint8_t const * laddrSrcPtr,
+        uint8_t * laddrDstPtr
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    memcpy(laddrDstPtr, laddrSrcPtr, HENI_LINK_ADDR_MAX_BYTE_SIZE);
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX void heniLinkAddrInvalidate(
+        uint8_t * laddrPtr
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    memset(laddrPtr, 0xff, HENI_LINK_ADDR_MAX_BYTE_SIZE);
+}
+
+
+
+HENI_EXT_FUNCT_DEF_PREFIX int_fast8_t heniLinkAddrIsValid(
+        uint8_t const * laddrPtr
+) HENI_EXT_FUNCT_DEF_SUFFIX
+{
+    return laddrPtr[0] != 0xff ? (int_fast8_t)1 : (int_fast8_t)0;
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                            Helper functions                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_PRV_FUNCT_DEF_PREFIX unsigned long doRand(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    g_bmDefRandState = g_bmDefRandState * 1103515245UL + 12345UL;
+    return (g_bmDefRandState >> 16) & 0x7fffUL;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doFillAddr(
+        heni_link_addr_container_t * cont,
+        unsigned long idx
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    /* An EUI-64 with a common vendor prefix. */
+    memset(&(cont->data8[0]), 0, HENI_LINK_ADDR_MAX_BYTE_SIZE);
+    cont->data8[0] = 0x00;
+    cont->data8[1] = 0x12;
+    cont->data8[2] = 0x4b;
+    cont->data8[3] = 0x00;
+    cont->data8[4] = (uint8_t)(idx >> 8);
+    cont->data8[5] = (uint8_t)idx;
+    cont->data8[6] = (uint8_t)doRand();
+    cont->data8[7] = (uint8_t)doRand();
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX double doGetTimeInSec(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    struct timespec   ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                          Individual benchmarks                         *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_PRV_FUNCT_DEF_PREFIX void doBenchmarkNumNeighbors(
+        size_t numNbrs
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_neighbor_table_t   nbt;
+    double                  start, hitNs, missNs;
+    unsigned long           op, numMisses;
+    size_t                  i;
+
+    heniNeighborTableInit(&nbt, &g_bmDefKernel, g_bmDefNTBuffer, BM_DEF_NUM_ELEMS(numNbrs));
+    for (i = 0; i < numNbrs; ++i)
+    {
+        heniNeighborTableAddNonexisting(&nbt, &(g_bmDefHitAddrs[i].data8[0]), &(g_bmDefNeighbors[i]));
+    }
+
+    /* Frames from neighbors. */
+    start = doGetTimeInSec();
+    for (op = 0; op < BM_DEF_NUM_OPS; ++op)
+    {
+        i = (size_t)(op * 37) % numNbrs;
+        HENI_UT_CHECK(heniNeighborTableFind(&nbt, &(g_bmDefHitAddrs[i].data8[0])) == &(g_bmDefNeighbors[i]));
+    }
+    hitNs = (doGetTimeInSec() - start) * 1e9 / (double)BM_DEF_NUM_OPS;
+
+    /* Frames from other nodes. */
+    numMisses = 0;
+    start = doGetTimeInSec();
+    for (op = 0; op < BM_DEF_NUM_OPS; ++op)
+    {
+        i = (size_t)(op * 37) % BM_DEF_NUM_MISS_ADDRS;
+        numMisses += heniNeighborTableFind(&nbt, &(g_bmDefMissAddrs[i].data8[0])) == NULL ? 1 : 0;
+    }
+    missNs = (doGetTimeInSec() - start) * 1e9 / (double)BM_DEF_NUM_OPS;
+    HENI_UT_CHECK(numMisses == BM_DEF_NUM_OPS);
+
+    printf("[BM] %3u neighbors in %3u elements: %6.1f ns/hit, %6.1f ns/miss\n",
+            (unsigned)numNbrs, (unsigned)BM_DEF_NUM_ELEMS(numNbrs), hitNs, missNs);
+
+    for (i = 0; i < numNbrs; ++i)
+    {
+        heniNeighborTableRemoveExisting(&nbt, &(g_bmDefHitAddrs[i].data8[0]));
+    }
+    heniNeighborTableCleanup(&nbt);
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                         The main benchmark method                      *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+int main(int argc, char * argv[])
+{
+    static size_t const   numNbrs[] = { 50, 100, 150, 200 };
+    size_t                i;
+
+    g_bmDefRandState = 1;
+    for (i = 0; i < BM_DEF_MAX_NEIGHBORS; ++i)
+    {
+        doFillAddr(&(g_bmDefHitAddrs[i]), i);
+    }
+    for (i = 0; i < BM_DEF_NUM_MISS_ADDRS; ++i)
+    {
+        doFillAddr(&(g_bmDefMissAddrs[i]), BM_DEF_MAX_NEIGHBORS + i);
+    }
+#if HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS
+    printf("[BM] HENI neighbor table with fingerprints, %u slots per element\n",
+            (unsigned)HENI_NEIGHBOR_TABLE_SLOTS_PER_ELEM);
+#else
+    printf("[BM] HENI neighbor table with hashed buckets\n");
+#endif /* HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS */
+    for (i = 0; i < sizeof(numNbrs) / sizeof(numNbrs[0]); ++i)
+    {
+        doBenchmarkNumNeighbors(numNbrs[i]);
+    }
+    return 0;
+}
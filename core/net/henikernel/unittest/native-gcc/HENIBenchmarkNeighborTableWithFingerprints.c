@@ -0,0 +1,9 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+#define HENI_NEIGHBOR_TABLE_WITH_FINGERPRINTS 1
+#include "HENIBenchmarkNeighborTable.c"
@@ -0,0 +1,243 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+#include <stdio.h>
+#include <time.h>
+#include "HENIZoneTable.h"
+#include "HENIUnitTest.h"
+
+
+/**
+ * @file
+ * HENI: A benchmark of the operations of a HENI zone
+ * table as a function of the number of zones in a row.
+ * The zones are inserted in a pseudorandom order and
+ * then looked up, both successfully and unsuccessfully,
+ * enumerated, and removed. The same source is built
+ * for each zone table backend.
+ */
+
+
+enum
+{
+    BM_DEF_MAX_ZONES = 1024,
+    BM_DEF_HASHED_BUCKETS = 16,
+    BM_DEF_LSPEC = 9,               /* 2 levels of 16-bit LIDs */
+    BM_DEF_DISCRBITS = 4,
+    BM_DEF_LEVEL = 1,
+    BM_DEF_LID_STRIDE = 7,
+    BM_DEF_NUM_OPS = 4000000,
+};
+
+
+heni_instance_t                g_bmDefInstance;
+#if HENI_ZONE_TABLE_WITH_SORTED_ROWS
+heni_zone_table_bucket_t       g_bmDefZoneTableAllBuckets[BM_DEF_MAX_ZONES];
+#else
+heni_zone_table_bucket_t       g_bmDefZoneTableAllBuckets[BM_DEF_HASHED_BUCKETS];
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
+heni_zone_table_bucket_t *     g_bmDefZoneTableBuckets[2];
+heni_zone_t                    g_bmDefZones[BM_DEF_MAX_ZONES];
+heni_zone_lid_t                g_bmDefLIDs[BM_DEF_MAX_ZONES];
+unsigned long                  g_bmDefRandState;
+unsigned long                  g_bmDefSink;
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                            Helper functions                            *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_PRV_FUNCT_DEF_PREFIX unsigned long doRand(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    g_bmDefRandState = g_bmDefRandState * 1103515245UL + 12345UL;
+    return (g_bmDefRandState >> 16) & 0x7fffUL;
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX heni_zone_discr_t doGetDiscr(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    return heniZoneDiscrSpecGetZoneDiscrMinAssignable(
+            heniKernelInstanceGetNumZoneDiscrBitsForInstancePtr(&g_bmDefInstance)
+    );
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doInitLIDs(
+        size_t numZones
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_lspec_t      lspec = BM_DEF_LSPEC;
+    heni_zone_lid_t   minLID = heniLabelSpecGetZoneLIDMinAssignable(lspec);
+    size_t            i;
+
+    /* Distinct LIDs with gaps for misses, shuffled. */
+    for (i = 0; i < numZones; ++i)
+    {
+        g_bmDefLIDs[i] = minLID + (heni_zone_lid_t)(i * BM_DEF_LID_STRIDE);
+        HENI_PASSERT(heniLabelSpecIsZoneLIDAssignable(g_bmDefLIDs[i], lspec));
+    }
+    for (i = numZones - 1; i > 0; --i)
+    {
+        size_t            j = (size_t)(doRand() % (i + 1));
+        heni_zone_lid_t   tmp = g_bmDefLIDs[i];
+        g_bmDefLIDs[i] = g_bmDefLIDs[j];
+        g_bmDefLIDs[j] = tmp;
+    }
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX void doInitTable(
+        heni_zone_table_t * zt,
+        size_t numZones
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    size_t   bucketCount;
+    g_bmDefInstance.ker = NULL;
+    g_bmDefInstance.iid = 1;
+    g_bmDefInstance.lspec = BM_DEF_LSPEC;
+    g_bmDefInstance.logNumZoneDiscrBitsPlusOne = BM_DEF_DISCRBITS;
+#if HENI_ZONE_TABLE_WITH_SORTED_ROWS
+    bucketCount = numZones;
+#else
+    bucketCount = BM_DEF_HASHED_BUCKETS;
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
+    g_bmDefZoneTableBuckets[0] = &(g_bmDefZoneTableAllBuckets[0]);
+    g_bmDefZoneTableBuckets[1] = &(g_bmDefZoneTableAllBuckets[0]); /* unused */
+    heniZoneTableInit(zt, &g_bmDefInstance, &(g_bmDefZoneTableBuckets[0]), bucketCount);
+}
+
+
+
+HENI_PRV_FUNCT_DEF_PREFIX double doGetTimeInSec(
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    struct timespec   ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                          Individual benchmarks                         *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+HENI_PRV_FUNCT_DEF_PREFIX void doBenchmarkNumZones(
+        size_t numZones
+) HENI_PRV_FUNCT_DEF_SUFFIX
+{
+    heni_zone_table_t         zt;
+    heni_zone_table_titer_t   zti;
+    heni_zone_discr_t         discr;
+    double                    start, insertNs, hitNs, missNs, iterNs;
+    unsigned long             numReps, rep, op;
+    size_t                    i;
+
+    g_bmDefRandState = 1;
+    doInitTable(&zt, numZones);
+    doInitLIDs(numZones);
+    discr = doGetDiscr();
+    numReps = BM_DEF_NUM_OPS / numZones;
+
+    /* Insertion and removal in a random order. */
+    start = doGetTimeInSec();
+    for (rep = 0; rep < numReps / 4; ++rep)
+    {
+        for (i = 0; i < numZones; ++i)
+        {
+            heniZoneTableAddNonexisting(&zt, BM_DEF_LEVEL, g_bmDefLIDs[i], discr, &(g_bmDefZones[i]));
+        }
+        for (i = 0; i < numZones; ++i)
+        {
+            heniZoneTableRemoveExisting(&zt, BM_DEF_LEVEL, g_bmDefLIDs[i], discr);
+        }
+    }
+    insertNs = (doGetTimeInSec() - start) * 1e9 / (double)(2 * (numReps / 4) * numZones);
+
+    for (i = 0; i < numZones; ++i)
+    {
+        heniZoneTableAddNonexisting(&zt, BM_DEF_LEVEL, g_bmDefLIDs[i], discr, &(g_bmDefZones[i]));
+    }
+
+    /* Successful lookups. */
+    start = doGetTimeInSec();
+    for (op = 0; op < BM_DEF_NUM_OPS; ++op)
+    {
+        i = (size_t)(op * 37) % numZones;
+        HENI_UT_CHECK(heniZoneTableFind(&zt, BM_DEF_LEVEL, g_bmDefLIDs[i], discr) == &(g_bmDefZones[i]));
+    }
+    hitNs = (doGetTimeInSec() - start) * 1e9 / (double)BM_DEF_NUM_OPS;
+
+    /* Unsuccessful lookups, falling into the gaps between LIDs. */
+    g_bmDefSink = 0;
+    start = doGetTimeInSec();
+    for (op = 0; op < BM_DEF_NUM_OPS; ++op)
+    {
+        i = (size_t)(op * 37) % numZones;
+        g_bmDefSink += (unsigned long)(heniZoneTableFind(&zt, BM_DEF_LEVEL, g_bmDefLIDs[i] + 1, discr) == NULL);
+    }
+    missNs = (doGetTimeInSec() - start) * 1e9 / (double)BM_DEF_NUM_OPS;
+    HENI_UT_CHECK(g_bmDefSink == BM_DEF_NUM_OPS);
+
+    /* Enumeration of the entire row. */
+    start = doGetTimeInSec();
+    for (rep = 0; rep < numReps; ++rep)
+    {
+        for (heniZoneTableTIterSetAtLevel(&zti, &zt, BM_DEF_LEVEL);
+                heniZoneTableTIterIsActive(&zti);
+                heniZoneTableTIterAdvancePreservingLevel(&zti))
+        {
+            g_bmDefSink += (unsigned long)heniZoneTableTIterGetLID(&zti);
+        }
+    }
+    iterNs = (doGetTimeInSec() - start) * 1e9 / (double)(numReps * numZones);
+
+    printf("[BM] %4u zones: %7.1f ns/insert+remove, %7.1f ns/hit, %7.1f ns/miss, %5.1f ns/iterated zone\n",
+            (unsigned)numZones, insertNs, hitNs, missNs, iterNs);
+
+    for (i = 0; i < numZones; ++i)
+    {
+        heniZoneTableRemoveExisting(&zt, BM_DEF_LEVEL, g_bmDefLIDs[i], discr);
+    }
+    heniZoneTableCleanup(&zt);
+}
+
+
+
+/* ---------------------------------------------------------------------- *
+ *                                                                        *
+ *                         The main benchmark method                      *
+ *                                                                        *
+ * ---------------------------------------------------------------------- */
+
+int main(int argc, char * argv[])
+{
+    static size_t const   numZones[] = { 64, 256, 1024 };
+    size_t                i;
+
+#if HENI_ZONE_TABLE_WITH_SORTED_ROWS
+    printf("[BM] HENI zone table with sorted rows\n");
+#else
+    printf("[BM] HENI zone table with %u hashed buckets per row\n",
+            (unsigned)BM_DEF_HASHED_BUCKETS);
+#endif /* HENI_ZONE_TABLE_WITH_SORTED_ROWS */
+    for (i = 0; i < sizeof(numZones) / sizeof(numZones[0]); ++i)
+    {
+        doBenchmarkNumZones(numZones[i]);
+    }
+    return 0;
+}
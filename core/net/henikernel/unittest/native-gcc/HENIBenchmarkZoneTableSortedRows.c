@@ -0,0 +1,9 @@
+/*
+ * HENI: Hierarchical Embedded Network Infrastructure
+ *
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ */
+#define HENI_ZONE_TABLE_WITH_SORTED_ROWS 1
+#include "HENIBenchmarkZoneTable.c"
@@ -1491,6 +1491,13 @@ struct uip_stats {
     uip_stats_t recv;     /**< Number of recived ND6 packets */
     uip_stats_t sent;     /**< Number of sent ND6 packets */
   } nd6;
+  struct {
+    uip_stats_t reassembled; /**< Number of packets reassembled from
+                                  6LoWPAN fragments. */
+    uip_stats_t drop;     /**< Number of 6LoWPAN fragments dropped. */
+    uip_stats_t timeout;  /**< Number of partly reassembled packets
+                               dropped after SICSLOWPAN_REASS_MAXAGE. */
+  } frag;
 #endif /*NETSTACK_CONF_WITH_IPV6*/
 };
 
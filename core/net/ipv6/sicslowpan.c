@@ -251,6 +251,34 @@ static uint16_t my_tag;
 /* Assuming that the worst growth for uncompression is 38 bytes */
 #define SICSLOWPAN_FIRST_FRAGMENT_SIZE (SICSLOWPAN_FRAGMENT_SIZE + 38)
 
+/* REASS_IN_PLACE gives each reassembly a buffer for the whole IPv6
+ * packet, into which every fragment is written at its offset as it
+ * arrives, instead of storing the fragments in the shared fragment
+ * buffers. The buffers are allocated from a pool of REASS_POOL_SIZE
+ * bytes, by the size of the packet, so a pool that holds few packets
+ * of the largest size holds many small ones. The number of concurrent
+ * reassemblies is limited by REASS_CONTEXTS and by what fits in the
+ * pool. A new packet that does not fit is dropped: reassemblies in
+ * progress are only evicted once their timers have expired, since
+ * evicting them for newer ones under interleaved traffic would lose
+ * both packets.
+ **/
+#ifdef SICSLOWPAN_CONF_REASS_IN_PLACE
+#define SICSLOWPAN_REASS_IN_PLACE SICSLOWPAN_CONF_REASS_IN_PLACE
+#else
+#define SICSLOWPAN_REASS_IN_PLACE 0
+#endif
+
+/* By default, the pool holds a packet of the largest size for every
+   context, which takes REASS_CONTEXTS * (UIP_BUFSIZE - UIP_LLH_LEN)
+   bytes of RAM. */
+#ifdef SICSLOWPAN_CONF_REASS_POOL_SIZE
+#define SICSLOWPAN_REASS_POOL_SIZE SICSLOWPAN_CONF_REASS_POOL_SIZE
+#else
+#define SICSLOWPAN_REASS_POOL_SIZE \
+  (SICSLOWPAN_REASS_CONTEXTS * (UIP_BUFSIZE - UIP_LLH_LEN))
+#endif
+
 /* all information needed for reassembly */
 struct sicslowpan_frag_info {
   /** When reassembling, the source address of the fragments being merged */
@@ -268,13 +296,32 @@ struct sicslowpan_frag_info {
 
   /** Fragment size of first fragment */
   uint16_t first_frag_len;
+#if SICSLOWPAN_REASS_IN_PLACE
+  /** The buffer of the packet in the reassembly pool, into which all
+   fragments are written, and its size. */
+  uint8_t *buf;
+  uint16_t buf_size;
+#else /* SICSLOWPAN_REASS_IN_PLACE */
   /** First fragment - needs a larger buffer since the size is uncompressed size
    and we need to know total size to know when we have received last fragment. */
-  uint8_t first_frag[SICSLOWPAN_FIRST_FRAGMENT_SIZE];
+  uint8_t buf[SICSLOWPAN_FIRST_FRAGMENT_SIZE];
+#endif /* SICSLOWPAN_REASS_IN_PLACE */
 };
 
 static struct sicslowpan_frag_info frag_info[SICSLOWPAN_REASS_CONTEXTS];
 
+#if SICSLOWPAN_REASS_IN_PLACE
+static union {
+  uint8_t data[SICSLOWPAN_REASS_POOL_SIZE];
+  uint32_t align;
+} reass_pool;
+
+/* Buffers are word aligned, as the headers are accessed through them */
+#define REASS_BUF_ALIGN(len) (((len) + 3) & ~3)
+#endif /* SICSLOWPAN_REASS_IN_PLACE */
+
+#if !SICSLOWPAN_REASS_IN_PLACE
+
 struct sicslowpan_frag_buf {
   /* the index of the frag_info */
   uint8_t index;
@@ -286,14 +333,19 @@ struct sicslowpan_frag_buf {
 };
 
 static struct sicslowpan_frag_buf frag_buf[SICSLOWPAN_FRAGMENT_BUFFERS];
+#endif /* !SICSLOWPAN_REASS_IN_PLACE */
 
 /*---------------------------------------------------------------------------*/
 static int
 clear_fragments(uint8_t frag_info_index)
 {
-  int i, clear_count;
+  int clear_count;
+#if !SICSLOWPAN_REASS_IN_PLACE
+  int i;
+#endif /* !SICSLOWPAN_REASS_IN_PLACE */
   clear_count = 0;
   frag_info[frag_info_index].len = 0;
+#if !SICSLOWPAN_REASS_IN_PLACE
   for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
     if(frag_buf[i].len > 0 && frag_buf[i].index == frag_info_index) {
       /* deallocate the buffer */
@@ -301,6 +353,7 @@ clear_fragments(uint8_t frag_info_index)
       clear_count++;
     }
   }
+#endif /* !SICSLOWPAN_REASS_IN_PLACE */
   return clear_count;
 }
 /*---------------------------------------------------------------------------*/
@@ -313,12 +366,66 @@ timeout_fragments(int not_context)
     if(frag_info[i].len > 0 && i != not_context &&
        timer_expired(&frag_info[i].reass_timer)) {
       /* This context can be freed */
+      UIP_STAT(++uip_stat.frag.timeout);
       count += clear_fragments(i);
     }
   }
   return count;
 }
 /*---------------------------------------------------------------------------*/
+#if SICSLOWPAN_REASS_IN_PLACE
+/* Allocate a buffer for a packet of len bytes to a context that is not
+   in use, from the first gap in the pool between the buffers of the
+   reassemblies in progress. The buffer also holds a first fragment of
+   the largest size, which is uncompressed before its length is
+   checked. */
+static int
+alloc_reass_buf(uint8_t index, uint16_t len)
+{
+  uint16_t start, begin;
+  int i, moved;
+
+  len = REASS_BUF_ALIGN(MAX(len, SICSLOWPAN_FIRST_FRAGMENT_SIZE));
+  start = 0;
+  do {
+    moved = 0;
+    for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+      if(frag_info[i].len == 0) {
+        continue;
+      }
+      begin = frag_info[i].buf - reass_pool.data;
+      if(start < begin + frag_info[i].buf_size && begin < start + len) {
+        start = begin + frag_info[i].buf_size;
+        moved = 1;
+      }
+    }
+  } while(moved && start + len <= SICSLOWPAN_REASS_POOL_SIZE);
+
+  if(start + len > SICSLOWPAN_REASS_POOL_SIZE) {
+    return 0;
+  }
+  frag_info[index].buf = reass_pool.data + start;
+  frag_info[index].buf_size = len;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+store_fragment(uint8_t index, uint8_t offset)
+{
+  uint16_t len;
+
+  /* copy the data from packetbuf straight to its offset in the packet */
+  len = packetbuf_datalen() - packetbuf_hdr_len;
+  if(((uint16_t)offset << 3) + len > frag_info[index].buf_size) {
+    return -1;
+  }
+  memcpy(frag_info[index].buf + ((uint16_t)offset << 3),
+         packetbuf_ptr + packetbuf_hdr_len, len);
+
+  PRINTF("Fragsize: %d\n", len);
+  return len;
+}
+#else /* SICSLOWPAN_REASS_IN_PLACE */
 static int
 store_fragment(uint8_t index, uint8_t offset)
 {
@@ -340,6 +447,7 @@ store_fragment(uint8_t index, uint8_t offset)
   /* failed */
   return -1;
 }
+#endif /* SICSLOWPAN_REASS_IN_PLACE */
 /*---------------------------------------------------------------------------*/
 /* add a new fragment to the buffer */
 static int8_t
@@ -354,9 +462,18 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
     for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
       /* clear all fragment info with expired timer to free all fragment buffers */
       if(frag_info[i].len > 0 && timer_expired(&frag_info[i].reass_timer)) {
+        UIP_STAT(++uip_stat.frag.timeout);
 	clear_fragments(i);
       }
 
+      /* A first fragment sent again restarts its own reassembly
+         rather than taking another context. */
+      if(frag_info[i].len > 0 && frag_info[i].tag == tag &&
+         linkaddr_cmp(&frag_info[i].sender, packetbuf_addr(PACKETBUF_ADDR_SENDER))) {
+        clear_fragments(i);
+        found = i;
+      }
+
       /* We use len as indication on used or not used */
       if(found < 0 && frag_info[i].len == 0) {
         /* We remember the first free fragment info but must continue
@@ -367,8 +484,21 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
 
     if(found < 0) {
       PRINTF("*** Failed to store new fragment session - tag: %d\n", tag);
+      UIP_STAT(++uip_stat.frag.drop);
+      return -1;
+    }
+#if SICSLOWPAN_REASS_IN_PLACE
+    if(frag_size > UIP_BUFSIZE - UIP_LLH_LEN) {
+      PRINTF("*** Fragmented packet too large - tag: %d size: %d\n", tag, frag_size);
+      UIP_STAT(++uip_stat.frag.drop);
       return -1;
     }
+    if(!alloc_reass_buf(found, frag_size)) {
+      PRINTF("*** No room in the reassembly pool - tag: %d size: %d\n", tag, frag_size);
+      UIP_STAT(++uip_stat.frag.drop);
+      return -1;
+    }
+#endif /* SICSLOWPAN_REASS_IN_PLACE */
 
     /* Found a free fragment info to store data in */
     frag_info[found].len = frag_size;
@@ -394,6 +524,7 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
   if(found < 0) {
     /* no entry found for storing the new fragment */
     PRINTF("*** Failed to store N-fragment - could not find session - tag: %d offset: %d\n", tag, offset);
+    UIP_STAT(++uip_stat.frag.drop);
     return -1;
   }
 
@@ -409,6 +540,7 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
     /* should we also clear all fragments since we failed to store
        this fragment? */
     PRINTF("*** Failed to store fragment - packet reassembly will fail tag:%d l\n", frag_info[i].tag);
+    UIP_STAT(++uip_stat.frag.drop);
     return -1;
   }
 }
@@ -418,10 +550,15 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
 static void
 copy_frags2uip(int context)
 {
+#if SICSLOWPAN_REASS_IN_PLACE
+  /* The fragments are in place already */
+  memcpy((uint8_t *)UIP_IP_BUF, (uint8_t *)frag_info[context].buf,
+         frag_info[context].len);
+#else /* SICSLOWPAN_REASS_IN_PLACE */
   int i;
 
   /* Copy from the fragment context info buffer first */
-  memcpy((uint8_t *)UIP_IP_BUF, (uint8_t *)frag_info[context].first_frag,
+  memcpy((uint8_t *)UIP_IP_BUF, (uint8_t *)frag_info[context].buf,
 	 frag_info[context].first_frag_len);
   for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
     /* And also copy all matching fragments */
@@ -430,6 +567,8 @@ copy_frags2uip(int context)
 	     (uint8_t *)frag_buf[i].data, frag_buf[i].len);
     }
   }
+#endif /* SICSLOWPAN_REASS_IN_PLACE */
+  UIP_STAT(++uip_stat.frag.reassembled);
   /* deallocate all the fragments for this context */
   clear_fragments(context);
 }
@@ -1562,7 +1701,7 @@ input(void)
         return;
       }
 
-      buffer = frag_info[frag_context].first_frag;
+      buffer = frag_info[frag_context].buf;
 
       break;
     case SICSLOWPAN_DISPATCH_FRAGN:
@@ -1666,6 +1805,16 @@ input(void)
     }
   }
 
+#if SICSLOWPAN_CONF_FRAG && SICSLOWPAN_REASS_IN_PLACE
+  if(first_fragment &&
+     uncomp_hdr_len + packetbuf_payload_len > frag_info[frag_context].buf_size) {
+    PRINTF("SICSLOWPAN: first fragment dropped, larger than its packet\n");
+    UIP_STAT(++uip_stat.frag.drop);
+    clear_fragments(frag_context);
+    return;
+  }
+#endif /* SICSLOWPAN_CONF_FRAG && SICSLOWPAN_REASS_IN_PLACE */
+
   /* copy the payload if buffer is non-null - which is only the case with first fragment
      or packets that are non fragmented */
   if(buffer != NULL) {
@@ -75,6 +75,27 @@ MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 static int num_routes = 0;
 static void rm_routelist_callback(nbr_table_item_t *ptr);
 
+#if UIP_DS6_ROUTE_TRIE
+/* A node of the route trie. The trie is path compressed: a node has
+   either a route or two children, and its prefix is that of the route
+   or the longest prefix common to both subtrees. The bits of the
+   prefix beyond length are undefined. A child is selected by the bit
+   of a destination address that follows the prefix of the node.
+   Several routes may share a prefix; the node then points to one of
+   them and counts them all. */
+struct route_trie_node {
+  struct route_trie_node *child[2];
+  uip_ds6_route_t *route;
+  uip_ipaddr_t prefix;
+  uint8_t length;
+  uint16_t count;
+};
+
+/* A trie of n routes has at most n - 1 nodes without a route. */
+MEMB(routetriememb, struct route_trie_node, 2 * UIP_DS6_ROUTE_NB);
+static struct route_trie_node *route_trie;
+#endif /* UIP_DS6_ROUTE_TRIE */
+
 #endif /* (UIP_CONF_MAX_ROUTES != 0) */
 
 /* Default routes are held on the defaultrouterlist and their
@@ -162,6 +183,10 @@ uip_ds6_route_init(void)
 #if (UIP_CONF_MAX_ROUTES != 0)
   memb_init(&routememb);
   list_init(routelist);
+#if UIP_DS6_ROUTE_TRIE
+  memb_init(&routetriememb);
+  route_trie = NULL;
+#endif /* UIP_DS6_ROUTE_TRIE */
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
 #endif /* (UIP_CONF_MAX_ROUTES != 0) */
@@ -174,6 +199,178 @@ uip_ds6_route_init(void)
 #endif
 }
 #if (UIP_CONF_MAX_ROUTES != 0)
+#if UIP_DS6_ROUTE_TRIE
+/*---------------------------------------------------------------------------*/
+static int
+addr_bit(const uip_ipaddr_t *addr, uint8_t bit)
+{
+  return (addr->u8[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+/*---------------------------------------------------------------------------*/
+/* The number of bits, from bit from on, that two addresses have in
+   common, not going past bit to. */
+static uint8_t
+common_bits(const uip_ipaddr_t *a, const uip_ipaddr_t *b,
+            uint8_t from, uint8_t to)
+{
+  uint8_t bit;
+  uint8_t diff;
+
+  bit = from;
+  while(bit < to) {
+    diff = (a->u8[bit >> 3] ^ b->u8[bit >> 3]) << (bit & 7);
+    if(diff != 0) {
+      while(!(diff & 0x80)) {
+        diff <<= 1;
+        bit++;
+      }
+      return bit < to ? bit - from : to - from;
+    }
+    bit = (bit & ~7) + 8;
+  }
+  return to - from;
+}
+/*---------------------------------------------------------------------------*/
+static struct route_trie_node *
+route_trie_alloc(uip_ds6_route_t *route, const uip_ipaddr_t *prefix,
+                 uint8_t length)
+{
+  struct route_trie_node *n;
+
+  n = memb_alloc(&routetriememb);
+  if(n != NULL) {
+    n->child[0] = n->child[1] = NULL;
+    n->route = route;
+    n->count = route != NULL;
+    uip_ipaddr_copy(&n->prefix, prefix);
+    n->length = length;
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static int
+route_trie_add(uip_ds6_route_t *route)
+{
+  struct route_trie_node **link;
+  struct route_trie_node *n, *split, *leaf;
+  uint8_t length, matched, common;
+
+  length = route->length;
+  matched = 0;
+  link = &route_trie;
+  while((n = *link) != NULL) {
+    common = matched + common_bits(&route->ipaddr, &n->prefix, matched,
+                                   MIN(length, n->length));
+    if(common < n->length) {
+      /* The route diverges from the prefix of n, or ends within it:
+         insert a node between n and its parent. */
+      split = route_trie_alloc(common == length ? route : NULL,
+                               &route->ipaddr, common);
+      if(split == NULL) {
+        return 0;
+      }
+      if(common < length) {
+        leaf = route_trie_alloc(route, &route->ipaddr, length);
+        if(leaf == NULL) {
+          memb_free(&routetriememb, split);
+          return 0;
+        }
+        split->child[addr_bit(&route->ipaddr, common)] = leaf;
+      }
+      split->child[addr_bit(&n->prefix, common)] = n;
+      *link = split;
+      return 1;
+    }
+    if(n->length == length) {
+      /* An earlier route to the same prefix keeps being used. */
+      if(n->route == NULL) {
+        n->route = route;
+      }
+      n->count++;
+      return 1;
+    }
+    matched = n->length;
+    link = &n->child[addr_bit(&route->ipaddr, matched)];
+  }
+  *link = route_trie_alloc(route, &route->ipaddr, length);
+  return *link != NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+route_trie_rm(uip_ds6_route_t *route)
+{
+  struct route_trie_node **link, **parent_link;
+  struct route_trie_node *n, *parent;
+
+  parent_link = NULL;
+  link = &route_trie;
+  while((n = *link) != NULL && n->length < route->length) {
+    parent_link = link;
+    link = &n->child[addr_bit(&route->ipaddr, n->length)];
+  }
+  if(n == NULL || n->route == NULL || n->length != route->length ||
+     !uip_ipaddr_prefixcmp(&n->prefix, &route->ipaddr, n->length)) {
+    return;
+  }
+
+  if(--n->count > 0) {
+    if(n->route == route) {
+      /* Fall back on another route to the same prefix. The route has
+         already been removed from the list. */
+      for(n->route = list_head(routelist);
+          n->route->length != route->length ||
+            !uip_ipaddr_prefixcmp(&n->route->ipaddr, &route->ipaddr,
+                                  route->length);
+          n->route = list_item_next(n->route));
+    }
+    return;
+  }
+
+  n->route = NULL;
+  if(n->child[0] != NULL && n->child[1] != NULL) {
+    /* Still needed to join the two subtrees. */
+    return;
+  }
+  *link = n->child[0] != NULL ? n->child[0] : n->child[1];
+  memb_free(&routetriememb, n);
+
+  /* A parent without a route that is left with a single child is no
+     longer needed either. */
+  if(*link == NULL && parent_link != NULL) {
+    parent = *parent_link;
+    if(parent->route == NULL) {
+      *parent_link = parent->child[parent->child[0] == NULL];
+      memb_free(&routetriememb, parent);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+route_trie_lookup(const uip_ipaddr_t *addr)
+{
+  struct route_trie_node *n;
+  uip_ds6_route_t *found_route;
+  uint8_t matched;
+
+  found_route = NULL;
+  matched = 0;
+  for(n = route_trie; n != NULL;
+      n = n->child[addr_bit(addr, matched)]) {
+    if(common_bits(addr, &n->prefix, matched, n->length)
+       != n->length - matched) {
+      break;
+    }
+    if(n->route != NULL) {
+      found_route = n->route;
+    }
+    matched = n->length;
+    if(matched == 128) {
+      break;
+    }
+  }
+  return found_route;
+}
+#endif /* UIP_DS6_ROUTE_TRIE */
 /*---------------------------------------------------------------------------*/
 static uip_lladdr_t *
 uip_ds6_route_nexthop_lladdr(uip_ds6_route_t *route)
@@ -254,15 +451,20 @@ uip_ds6_route_t *
 uip_ds6_route_lookup(uip_ipaddr_t *addr)
 {
 #if (UIP_CONF_MAX_ROUTES != 0)
-  uip_ds6_route_t *r;
   uip_ds6_route_t *found_route;
+#if !UIP_DS6_ROUTE_TRIE
+  uip_ds6_route_t *r;
   uint8_t longestmatch;
+#endif /* !UIP_DS6_ROUTE_TRIE */
 
   PRINTF("uip-ds6-route: Looking up route for ");
   PRINT6ADDR(addr);
   PRINTF("\n");
 
 
+#if UIP_DS6_ROUTE_TRIE
+  found_route = route_trie_lookup(addr);
+#else /* UIP_DS6_ROUTE_TRIE */
   found_route = NULL;
   longestmatch = 0;
   for(r = uip_ds6_route_head();
@@ -278,6 +480,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
       }
     }
   }
+#endif /* UIP_DS6_ROUTE_TRIE */
 
   if(found_route != NULL) {
     PRINTF("uip-ds6-route: Found route: ");
@@ -289,6 +492,11 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     PRINTF("uip-ds6-route: No route found\n");
   }
 
+#if !UIP_DS6_ROUTE_TRIE || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  /* With the trie, the order of the list does not speed up lookups,
+     and moving a route within it takes time linear in the number of
+     routes, so this is only done when the order is used for evicting
+     routes. */
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -298,6 +506,7 @@ uip_ds6_route_lookup(uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#endif /* !UIP_DS6_ROUTE_TRIE || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
 
   return found_route;
 #else /* (UIP_CONF_MAX_ROUTES != 0) */
@@ -437,6 +646,16 @@ uip_ds6_route_add(uip_ipaddr_t *ipaddr, uint8_t length,
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
 
+#if UIP_DS6_ROUTE_TRIE
+  if(!route_trie_add(r)) {
+    /* This should not happen, as the trie has room for two nodes per
+       route. */
+    PRINTF("uip_ds6_route_add: could not allocate route trie node\n");
+    uip_ds6_route_rm(r);
+    return NULL;
+  }
+#endif /* UIP_DS6_ROUTE_TRIE */
+
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
 #endif
@@ -479,6 +698,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
 
     /* Remove the route from the route list */
     list_remove(routelist, route);
+#if UIP_DS6_ROUTE_TRIE
+    route_trie_rm(route);
+#endif /* UIP_DS6_ROUTE_TRIE */
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
@@ -88,6 +88,17 @@ void uip_ds6_notification_rm(struct uip_ds6_notification *n);
 #define UIP_DS6_ROUTE_NB 4
 #endif /* UIP_CONF_MAX_ROUTES */
 
+/** \brief Index the routing table with a binary trie of the route
+ *  prefixes, so that route lookups take time proportional to the
+ *  address length rather than to the number of routes. Meant for
+ *  border routers and storing-mode RPL roots with many routes; the
+ *  trie costs two nodes of RAM per route. */
+#ifdef UIP_CONF_DS6_ROUTE_TRIE
+#define UIP_DS6_ROUTE_TRIE UIP_CONF_DS6_ROUTE_TRIE
+#else /* UIP_CONF_DS6_ROUTE_TRIE */
+#define UIP_DS6_ROUTE_TRIE 0
+#endif /* UIP_CONF_DS6_ROUTE_TRIE */
+
 /** \brief define some additional RPL related route state and
  *  neighbor callback for RPL - if not a DS6_ROUTE_STATE is already set */
 #ifndef UIP_DS6_ROUTE_STATE_TYPE
@@ -611,7 +611,7 @@ send_packet(mac_callback_t mac_callback, void *mac_callback_ptr,
   }
 
   transmit_len = packetbuf_totlen();
-  NETSTACK_RADIO.prepare(packetbuf_hdrptr(), transmit_len);
+  mac_radio_prepare_packetbuf(&NETSTACK_RADIO);
 
   if(!is_broadcast && !is_receiver_awake) {
 #if WITH_PHASE_OPTIMIZATION
@@ -51,6 +51,8 @@
 #include "lib/list.h"
 #include "lib/memb.h"
 
+#include "net/nbr-table.h"
+
 #include <string.h>
 
 #include <stdio.h>
@@ -100,6 +102,18 @@ struct qbuf_metadata {
   uint8_t max_transmissions;
 };
 
+/* Index the neighbor queues in the neighbor table, which finds the
+   queue of a unicast neighbor without walking a list. The queues are
+   allocated from the CSMA_MAX_NEIGHBOR_QUEUES pool, which then defaults
+   to a queue for every neighbor in the table plus the broadcast queue.
+   The broadcast queue, and the queues the neighbor table has no entry
+   for, because it was full or removed the entry, are kept in the list. */
+#ifdef CSMA_CONF_WITH_NBR_TABLE
+#define CSMA_WITH_NBR_TABLE CSMA_CONF_WITH_NBR_TABLE
+#else
+#define CSMA_WITH_NBR_TABLE 0
+#endif /* CSMA_CONF_WITH_NBR_TABLE */
+
 /* Every neighbor has its own packet queue */
 struct neighbor_queue {
   struct neighbor_queue *next;
@@ -108,11 +122,17 @@ struct neighbor_queue {
   uint8_t transmissions;
   uint8_t collisions;
   LIST_STRUCT(queued_packet_list);
+#if CSMA_WITH_NBR_TABLE
+  /* The neighbor table entry of the queue, NULL if it is in the list */
+  struct neighbor_queue **index;
+#endif /* CSMA_WITH_NBR_TABLE */
 };
 
 /* The maximum number of co-existing neighbor queues */
 #ifdef CSMA_CONF_MAX_NEIGHBOR_QUEUES
 #define CSMA_MAX_NEIGHBOR_QUEUES CSMA_CONF_MAX_NEIGHBOR_QUEUES
+#elif CSMA_WITH_NBR_TABLE
+#define CSMA_MAX_NEIGHBOR_QUEUES (NBR_TABLE_MAX_NEIGHBORS + 1)
 #else
 #define CSMA_MAX_NEIGHBOR_QUEUES 2
 #endif /* CSMA_CONF_MAX_NEIGHBOR_QUEUES */
@@ -125,18 +145,60 @@ struct neighbor_queue {
 #endif /* CSMA_CONF_MAX_PACKET_PER_NEIGHBOR */
 
 #define MAX_QUEUED_PACKETS QUEUEBUF_NUM
+#if CSMA_WITH_NBR_TABLE
+NBR_TABLE(struct neighbor_queue *, neighbor_queue_index);
+#endif /* CSMA_WITH_NBR_TABLE */
 MEMB(neighbor_memb, struct neighbor_queue, CSMA_MAX_NEIGHBOR_QUEUES);
+LIST(neighbor_list);
 MEMB(packet_memb, struct rdc_buf_list, MAX_QUEUED_PACKETS);
 MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
-LIST(neighbor_list);
 
 static void packet_sent(void *ptr, int status, int num_transmissions);
 static void transmit_packet_list(void *ptr);
 /*---------------------------------------------------------------------------*/
+#if CSMA_WITH_NBR_TABLE
+/* Move a queue from the neighbor table to the list, leaving its
+   packets, including one the RDC is sending, where they are. */
+static void
+neighbor_queue_unindex(struct neighbor_queue *n)
+{
+  n->index = NULL;
+  list_add(neighbor_list, n);
+}
+/*---------------------------------------------------------------------------*/
+/* Called when the neighbor table removes a neighbor to make room for
+   another, which it may do even if the neighbor is locked. */
+static void
+neighbor_queue_removed(void *item)
+{
+  struct neighbor_queue **index = item;
+
+  if(*index != NULL) {
+    PRINTF("csma: neighbor removed, keeping its queue in the list\n");
+    neighbor_queue_unindex(*index);
+  }
+}
+#endif /* CSMA_WITH_NBR_TABLE */
+/*---------------------------------------------------------------------------*/
 static struct neighbor_queue *
 neighbor_queue_from_addr(const linkaddr_t *addr)
 {
-  struct neighbor_queue *n = list_head(neighbor_list);
+  struct neighbor_queue *n;
+
+#if CSMA_WITH_NBR_TABLE
+  struct neighbor_queue **index;
+
+  if(!linkaddr_cmp(addr, &linkaddr_null)) {
+    index = nbr_table_get_from_lladdr(neighbor_queue_index, addr);
+    /* The entry may have been given another address since */
+    if(index != NULL && *index != NULL &&
+       linkaddr_cmp(&(*index)->addr, addr)) {
+      return *index;
+    }
+  }
+#endif /* CSMA_WITH_NBR_TABLE */
+
+  n = list_head(neighbor_list);
   while(n != NULL) {
     if(linkaddr_cmp(&n->addr, addr)) {
       return n;
@@ -146,6 +208,65 @@ neighbor_queue_from_addr(const linkaddr_t *addr)
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+static struct neighbor_queue *
+neighbor_queue_new(const linkaddr_t *addr)
+{
+  struct neighbor_queue *n;
+#if CSMA_WITH_NBR_TABLE
+  struct neighbor_queue **index;
+#endif /* CSMA_WITH_NBR_TABLE */
+
+  n = memb_alloc(&neighbor_memb);
+  if(n != NULL) {
+    /* Init neighbor entry */
+    linkaddr_copy(&n->addr, addr);
+    n->transmissions = 0;
+    n->collisions = CSMA_MIN_BE;
+    /* Init packet list for this neighbor */
+    LIST_STRUCT_INIT(n, queued_packet_list);
+#if CSMA_WITH_NBR_TABLE
+    /* The broadcast queue stays in the list, as linkaddr_null is also
+       the key of the neighbor table's address-less entry */
+    if(!linkaddr_cmp(addr, &linkaddr_null)) {
+      index = nbr_table_get_from_lladdr(neighbor_queue_index, addr);
+      if(index != NULL && *index != NULL) {
+        /* The entry of another queue, which was given this address */
+        neighbor_queue_unindex(*index);
+      }
+      index = nbr_table_add_lladdr(neighbor_queue_index, addr,
+                                   NBR_TABLE_REASON_MAC, NULL);
+      if(index != NULL) {
+        /* Keep the neighbor while it has packets queued */
+        nbr_table_lock(neighbor_queue_index, index);
+        *index = n;
+        n->index = index;
+        return n;
+      }
+      /* The neighbor table is full, use the list */
+    }
+    n->index = NULL;
+#endif /* CSMA_WITH_NBR_TABLE */
+    /* Add neighbor to the list */
+    list_add(neighbor_list, n);
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static void
+neighbor_queue_free(struct neighbor_queue *n)
+{
+  ctimer_stop(&n->transmit_timer);
+#if CSMA_WITH_NBR_TABLE
+  if(n->index != NULL) {
+    nbr_table_remove(neighbor_queue_index, n->index);
+  } else
+#endif /* CSMA_WITH_NBR_TABLE */
+  {
+    list_remove(neighbor_list, n);
+  }
+  memb_free(&neighbor_memb, n);
+}
+/*---------------------------------------------------------------------------*/
 static clock_time_t
 backoff_period(void)
 {
@@ -218,9 +339,7 @@ free_packet(struct neighbor_queue *n, struct rdc_buf_list *p, int status)
       schedule_transmission(n);
     } else {
       /* This was the last packet in the queue, we free the neighbor */
-      ctimer_stop(&n->transmit_timer);
-      list_remove(neighbor_list, n);
-      memb_free(&neighbor_memb, n);
+      neighbor_queue_free(n);
     }
   }
 }
@@ -388,17 +507,7 @@ send_packet(mac_callback_t sent, void *ptr)
   n = neighbor_queue_from_addr(addr);
   if(n == NULL) {
     /* Allocate a new neighbor entry */
-    n = memb_alloc(&neighbor_memb);
-    if(n != NULL) {
-      /* Init neighbor entry */
-      linkaddr_copy(&n->addr, addr);
-      n->transmissions = 0;
-      n->collisions = CSMA_MIN_BE;
-      /* Init packet list for this neighbor */
-      LIST_STRUCT_INIT(n, queued_packet_list);
-      /* Add neighbor to the list */
-      list_add(neighbor_list, n);
-    }
+    n = neighbor_queue_new(addr);
   }
 
   if(n != NULL) {
@@ -447,8 +556,7 @@ send_packet(mac_callback_t sent, void *ptr)
       }
       /* The packet allocation failed. Remove and free neighbor entry if empty. */
       if(list_length(n->queued_packet_list) == 0) {
-        list_remove(neighbor_list, n);
-        memb_free(&neighbor_memb, n);
+        neighbor_queue_free(n);
       }
     } else {
       PRINTF("csma: Neighbor queue full\n");
@@ -493,6 +601,10 @@ init(void)
   memb_init(&packet_memb);
   memb_init(&metadata_memb);
   memb_init(&neighbor_memb);
+#if CSMA_WITH_NBR_TABLE
+  nbr_table_register(neighbor_queue_index,
+                     (nbr_table_callback *)neighbor_queue_removed);
+#endif /* CSMA_WITH_NBR_TABLE */
 }
 /*---------------------------------------------------------------------------*/
 const struct mac_driver csma_driver = {
@@ -176,7 +176,7 @@ create_frame(int type, int do_create)
   linkaddr_copy((linkaddr_t *)&params.src_addr,
                 packetbuf_addr(PACKETBUF_ADDR_SENDER));
 
-  params.payload = packetbuf_dataptr();
+  /* The payload itself is not needed to build the header. */
   params.payload_len = packetbuf_datalen();
   hdr_len = frame802154_hdrlen(&params);
   if(!do_create) {
@@ -31,6 +31,7 @@
  */
 
 #include "net/mac/mac.h"
+#include "net/packetbuf.h"
 
 #define DEBUG 0
 #if DEBUG
@@ -65,3 +66,47 @@ mac_call_sent_callback(mac_callback_t sent, void *ptr, int status, int num_tx)
   }
 }
 /*---------------------------------------------------------------------------*/
+static int
+prepare_segments(const struct radio_driver *radio)
+{
+  struct radio_segment segs[PACKETBUF_MAX_SEGMENTS + 1];
+  const struct radio_segment *refsegs;
+  uint8_t num_refsegs;
+  uint8_t i;
+
+  refsegs = packetbuf_referenced_segments(&num_refsegs);
+  segs[0].ptr = packetbuf_hdrptr();
+  segs[0].len = packetbuf_hdrlen();
+  for(i = 0; i < num_refsegs; i++) {
+    segs[i + 1] = refsegs[i];
+  }
+  return radio->prepare_segments(segs, num_refsegs + 1);
+}
+/*---------------------------------------------------------------------------*/
+int
+mac_radio_prepare_packetbuf(const struct radio_driver *radio)
+{
+  uint8_t num_refsegs;
+
+  if(packetbuf_referenced_segments(&num_refsegs) != NULL &&
+     radio->prepare_segments != NULL) {
+    return prepare_segments(radio);
+  }
+  packetbuf_copy_reference();
+  return radio->prepare(packetbuf_hdrptr(), packetbuf_totlen());
+}
+/*---------------------------------------------------------------------------*/
+int
+mac_radio_send_packetbuf(const struct radio_driver *radio)
+{
+  uint8_t num_refsegs;
+
+  if(packetbuf_referenced_segments(&num_refsegs) != NULL &&
+     radio->prepare_segments != NULL) {
+    prepare_segments(radio);
+    return radio->transmit(packetbuf_totlen());
+  }
+  packetbuf_copy_reference();
+  return radio->send(packetbuf_hdrptr(), packetbuf_totlen());
+}
+/*---------------------------------------------------------------------------*/
@@ -48,6 +48,20 @@ typedef void (* mac_callback_t)(void *ptr, int status, int transmissions);
 
 void mac_call_sent_callback(mac_callback_t sent, void *ptr, int status, int num_tx);
 
+/**
+ * Prepare the radio with the frame in the packetbuf. If the packetbuf
+ * references external segments and the radio can gather them, the
+ * header and the segments are handed to the radio without copying;
+ * otherwise the frame is flattened and passed to prepare().
+ */
+int mac_radio_prepare_packetbuf(const struct radio_driver *radio);
+
+/**
+ * Prepare and transmit the frame in the packetbuf, in the same way as
+ * mac_radio_prepare_packetbuf() prepares it.
+ */
+int mac_radio_send_packetbuf(const struct radio_driver *radio);
+
 /**
  * The structure of a MAC protocol driver in Contiki.
  */
@@ -48,7 +48,7 @@ static void
 send_packet(mac_callback_t sent, void *ptr)
 {
   int ret;
-  if(NETSTACK_RADIO.send(packetbuf_hdrptr(), packetbuf_totlen()) == RADIO_TX_OK) {
+  if(mac_radio_send_packetbuf(&NETSTACK_RADIO) == RADIO_TX_OK) {
     ret = MAC_TX_OK;
   } else {
     ret =  MAC_TX_ERR;
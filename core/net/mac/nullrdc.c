@@ -131,7 +131,7 @@ send_one_packet(mac_callback_t sent, void *ptr)
     uint8_t dsn;
     dsn = ((uint8_t *)packetbuf_hdrptr())[2] & 0xff;
 
-    NETSTACK_RADIO.prepare(packetbuf_hdrptr(), packetbuf_totlen());
+    mac_radio_prepare_packetbuf(&NETSTACK_RADIO);
 
     is_broadcast = packetbuf_holds_broadcast();
 
@@ -210,7 +210,7 @@ send_one_packet(mac_callback_t sent, void *ptr)
 
 #else /* ! NULLRDC_802154_AUTOACK */
 
-    switch(NETSTACK_RADIO.send(packetbuf_hdrptr(), packetbuf_totlen())) {
+    switch(mac_radio_send_packetbuf(&NETSTACK_RADIO)) {
     case RADIO_TX_OK:
       ret = MAC_TX_OK;
       break;
@@ -150,7 +150,7 @@ send_packet(mac_callback_t sent, void *ptr)
   linkaddr_copy((linkaddr_t *)&params.src_addr, &linkaddr_node_addr);
 #endif
 
-  params.payload = packetbuf_dataptr();
+  /* The payload itself is not needed to build the header. */
   params.payload_len = packetbuf_datalen();
   len = frame802154_hdrlen(&params);
   if(packetbuf_hdralloc(len)) {
@@ -161,7 +161,7 @@ send_packet(mac_callback_t sent, void *ptr)
     PRINTADDR(params.dest_addr);
     PRINTF("%u %u (%u)\n", len, packetbuf_datalen(), packetbuf_totlen());
 
-    ret = NETSTACK_RADIO.send(packetbuf_hdrptr(), packetbuf_totlen());
+    ret = mac_radio_send_packetbuf(&NETSTACK_RADIO);
     if(sent) {
       switch(ret) {
       case RADIO_TX_OK:
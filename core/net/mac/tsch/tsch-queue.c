@@ -77,6 +77,33 @@ LIST(neighbor_list);
 struct tsch_neighbor *n_broadcast;
 struct tsch_neighbor *n_eb;
 
+#if TSCH_QUEUE_WITH_READY_INDEX
+/* Unicast neighbors whose queue became non-empty, handed over from the
+ * process adding packets to the slot operation. The size is a power of two
+ * that can hold all unicast neighbors. */
+#if TSCH_QUEUE_MAX_NEIGHBOR_QUEUES <= 5
+#define READY_RINGBUF_SIZE 4
+#elif TSCH_QUEUE_MAX_NEIGHBOR_QUEUES <= 9
+#define READY_RINGBUF_SIZE 8
+#elif TSCH_QUEUE_MAX_NEIGHBOR_QUEUES <= 17
+#define READY_RINGBUF_SIZE 16
+#elif TSCH_QUEUE_MAX_NEIGHBOR_QUEUES <= 33
+#define READY_RINGBUF_SIZE 32
+#elif TSCH_QUEUE_MAX_NEIGHBOR_QUEUES <= 65
+#define READY_RINGBUF_SIZE 64
+#elif TSCH_QUEUE_MAX_NEIGHBOR_QUEUES <= 129
+#define READY_RINGBUF_SIZE 128
+#else
+#error TSCH_QUEUE_WITH_READY_INDEX supports at most 129 neighbor queues
+#endif
+static struct tsch_neighbor *ready_array[READY_RINGBUF_SIZE];
+static struct ringbufindex ready_ringbuf;
+/* Round-robin list of unicast neighbors with packets, owned by the slot
+ * operation. It is circular and points to the neighbor served last, so
+ * the search for a packet starts at the one after it. */
+static struct tsch_neighbor *ready_last;
+#endif /* TSCH_QUEUE_WITH_READY_INDEX */
+
 /*---------------------------------------------------------------------------*/
 /* Add a TSCH neighbor */
 struct tsch_neighbor *
@@ -206,6 +233,42 @@ tsch_queue_flush_nbr_queue(struct tsch_neighbor *n)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if TSCH_QUEUE_WITH_READY_INDEX
+/* Moves the neighbors handed over by tsch_queue_add_packet to the end of
+ * the round-robin list. Call only from the slot operation or with the lock. */
+static void
+ready_list_update(void)
+{
+  int16_t get_index;
+  while((get_index = ringbufindex_peek_get(&ready_ringbuf)) != -1) {
+    struct tsch_neighbor *n = ready_array[get_index];
+    ringbufindex_get(&ready_ringbuf);
+    if(ready_last == NULL) {
+      n->ready_next = n;
+    } else {
+      n->ready_next = ready_last->ready_next;
+      ready_last->ready_next = n;
+    }
+    ready_last = n;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Removes a neighbor from the round-robin list, given the one before it */
+static void
+ready_list_remove(struct tsch_neighbor *prev, struct tsch_neighbor *n)
+{
+  if(prev == n) {
+    ready_last = NULL;
+  } else {
+    prev->ready_next = n->ready_next;
+    if(ready_last == n) {
+      ready_last = prev;
+    }
+  }
+  n->is_ready = 0;
+}
+#endif /* TSCH_QUEUE_WITH_READY_INDEX */
+/*---------------------------------------------------------------------------*/
 /* Remove TSCH neighbor queue */
 static void
 tsch_queue_remove_nbr(struct tsch_neighbor *n)
@@ -216,6 +279,19 @@ tsch_queue_remove_nbr(struct tsch_neighbor *n)
       /* Remove neighbor from list */
       list_remove(neighbor_list, n);
 
+#if TSCH_QUEUE_WITH_READY_INDEX
+      /* Its queue is empty, but the slot operation may not have noticed yet */
+      if(n->is_ready) {
+        struct tsch_neighbor *prev;
+        ready_list_update();
+        prev = ready_last;
+        while(prev->ready_next != n) {
+          prev = prev->ready_next;
+        }
+        ready_list_remove(prev, n);
+      }
+#endif /* TSCH_QUEUE_WITH_READY_INDEX */
+
       tsch_release_lock();
 
       /* Flush queue */
@@ -237,6 +313,10 @@ tsch_queue_add_packet(const linkaddr_t *addr, mac_callback_t sent, void *ptr)
   if(!tsch_is_locked()) {
     n = tsch_queue_add_nbr(addr);
     if(n != NULL) {
+#if TSCH_QUEUE_WITH_STATS
+      /* Counted back out below if the packet makes it to the queue */
+      n->packets_dropped++;
+#endif /* TSCH_QUEUE_WITH_STATS */
       put_index = ringbufindex_peek_put(&n->tx_ringbuf);
       if(put_index != -1) {
         p = memb_alloc(&packet_memb);
@@ -256,6 +336,25 @@ tsch_queue_add_packet(const linkaddr_t *addr, mac_callback_t sent, void *ptr)
             ringbufindex_put(&n->tx_ringbuf);
             PRINTF("TSCH-queue: packet is added put_index=%u, packet=%p\n",
                    put_index, p);
+#if TSCH_QUEUE_WITH_READY_INDEX
+            /* The slot operation clears is_ready only once it has found
+             * the queue empty and taken the neighbor out of its list */
+            if(!n->is_broadcast && !n->is_ready) {
+              int16_t ready_index = ringbufindex_peek_put(&ready_ringbuf);
+              if(ready_index != -1) {
+                n->is_ready = 1;
+                ready_array[ready_index] = n;
+                ringbufindex_put(&ready_ringbuf);
+              }
+            }
+#endif /* TSCH_QUEUE_WITH_READY_INDEX */
+#if TSCH_QUEUE_WITH_STATS
+            n->packets_dropped--;
+            n->packets_queued++;
+            if(ringbufindex_elements(&n->tx_ringbuf) > n->max_queue_len) {
+              n->max_queue_len = ringbufindex_elements(&n->tx_ringbuf);
+            }
+#endif /* TSCH_QUEUE_WITH_STATS */
             return p;
           } else {
             memb_free(&packet_memb, p);
@@ -400,6 +499,37 @@ struct tsch_packet *
 tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link *link)
 {
   if(!tsch_is_locked()) {
+#if TSCH_QUEUE_WITH_READY_INDEX
+    struct tsch_neighbor *prev;
+    struct tsch_neighbor *last;
+    struct tsch_neighbor *curr_nbr;
+    struct tsch_packet *p;
+    ready_list_update();
+    /* Visit each neighbor with packets once, starting after the one served last */
+    prev = last = ready_last;
+    while(ready_last != NULL) {
+      curr_nbr = prev->ready_next;
+      if(ringbufindex_empty(&curr_nbr->tx_ringbuf)) {
+        ready_list_remove(prev, curr_nbr);
+      } else {
+        if(curr_nbr->tx_links_count == 0) {
+          /* Only look up for neighbors we do not have a tx link to */
+          p = tsch_queue_get_packet_for_nbr(curr_nbr, link);
+          if(p != NULL) {
+            ready_last = curr_nbr;
+            if(n != NULL) {
+              *n = curr_nbr;
+            }
+            return p;
+          }
+        }
+        prev = curr_nbr;
+      }
+      if(curr_nbr == last) {
+        break;
+      }
+    }
+#else /* TSCH_QUEUE_WITH_READY_INDEX */
     struct tsch_neighbor *curr_nbr = list_head(neighbor_list);
     struct tsch_packet *p = NULL;
     while(curr_nbr != NULL) {
@@ -415,6 +545,7 @@ tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link
       }
       curr_nbr = list_item_next(curr_nbr);
     }
+#endif /* TSCH_QUEUE_WITH_READY_INDEX */
   }
   return NULL;
 }
@@ -474,6 +605,10 @@ tsch_queue_init(void)
   list_init(neighbor_list);
   memb_init(&neighbor_memb);
   memb_init(&packet_memb);
+#if TSCH_QUEUE_WITH_READY_INDEX
+  ringbufindex_init(&ready_ringbuf, READY_RINGBUF_SIZE);
+  ready_last = NULL;
+#endif /* TSCH_QUEUE_WITH_READY_INDEX */
   /* Add virtual EB and the broadcast neighbors */
   n_eb = tsch_queue_add_nbr(&tsch_eb_address);
   n_broadcast = tsch_queue_add_nbr(&tsch_broadcast_address);
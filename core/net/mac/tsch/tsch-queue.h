@@ -77,6 +77,23 @@
 #define TSCH_QUEUE_MAX_NEIGHBOR_QUEUES ((NBR_TABLE_CONF_MAX_NEIGHBORS) + 2)
 #endif
 
+/* Keep the unicast neighbors that have packets queued in a round-robin
+ * list, so that shared slots pick one without walking all neighbors, and
+ * do not favor the neighbors that were added first */
+#ifdef TSCH_QUEUE_CONF_WITH_READY_INDEX
+#define TSCH_QUEUE_WITH_READY_INDEX TSCH_QUEUE_CONF_WITH_READY_INDEX
+#else
+#define TSCH_QUEUE_WITH_READY_INDEX 0
+#endif
+
+/* Count, for each neighbor, the packets queued and dropped towards it,
+ * and the peak length of its queue */
+#ifdef TSCH_QUEUE_CONF_WITH_STATS
+#define TSCH_QUEUE_WITH_STATS TSCH_QUEUE_CONF_WITH_STATS
+#else
+#define TSCH_QUEUE_WITH_STATS 0
+#endif
+
 /* TSCH CSMA-CA parameters, see IEEE 802.15.4e-2012 */
 /* Min backoff exponent */
 #ifdef TSCH_CONF_MAC_MIN_BE
@@ -140,6 +157,17 @@ struct tsch_neighbor {
   struct tsch_packet *tx_array[TSCH_QUEUE_NUM_PER_NEIGHBOR];
   /* Circular buffer of pointers to packet. */
   struct ringbufindex tx_ringbuf;
+#if TSCH_QUEUE_WITH_READY_INDEX
+  /* Next neighbor in the round-robin list of neighbors with packets */
+  struct tsch_neighbor *ready_next;
+  /* Is the neighbor in the round-robin list, or about to enter it? */
+  uint8_t is_ready;
+#endif /* TSCH_QUEUE_WITH_READY_INDEX */
+#if TSCH_QUEUE_WITH_STATS
+  uint16_t packets_queued; /* Packets added to the queue */
+  uint16_t packets_dropped; /* Packets refused for lack of space */
+  uint8_t max_queue_len; /* Peak number of packets in the queue */
+#endif /* TSCH_QUEUE_WITH_STATS */
 };
 
 /***** External Variables *****/
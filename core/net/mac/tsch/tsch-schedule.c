@@ -69,6 +69,87 @@ MEMB(slotframe_memb, struct tsch_slotframe, TSCH_SCHEDULE_MAX_SLOTFRAMES);
 /* List of slotframes (each slotframe holds its own list of links) */
 LIST(slotframe_list);
 
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+/* Links of all slotframes, sorted by timeslot. The links of a slotframe
+ * occupy a contiguous run, and runs follow the order of the slotframes
+ * in slotframe_memb. Links sharing a timeslot keep their list order. */
+static struct tsch_link *link_index[TSCH_SCHEDULE_MAX_LINKS];
+/* Number of links in the run of each slotframe of slotframe_memb */
+static uint16_t link_index_len[TSCH_SCHEDULE_MAX_SLOTFRAMES];
+
+/*---------------------------------------------------------------------------*/
+/* Returns the number of the run of a slotframe */
+static int
+link_index_run(const struct tsch_slotframe *sf)
+{
+  return sf - (struct tsch_slotframe *)slotframe_memb.mem;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the position in link_index where a given run starts */
+static uint16_t
+link_index_start(int run)
+{
+  uint16_t start = 0;
+  int i;
+  for(i = 0; i < run; i++) {
+    start += link_index_len[i];
+  }
+  return start;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the offset, within a run, of its first link after a timeslot */
+static uint16_t
+link_index_after(struct tsch_link **links, uint16_t len, uint16_t timeslot)
+{
+  uint16_t low = 0;
+  uint16_t high = len;
+  while(low < high) {
+    uint16_t mid = (low + high) / 2;
+    if(links[mid]->timeslot <= timeslot) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+/*---------------------------------------------------------------------------*/
+/* Inserts a new link into the run of its slotframe */
+static void
+link_index_add(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  int run = link_index_run(sf);
+  uint16_t start = link_index_start(run);
+  uint16_t end = link_index_start(TSCH_SCHEDULE_MAX_SLOTFRAMES);
+  uint16_t pos = start + link_index_after(&link_index[start],
+                                          link_index_len[run], l->timeslot);
+  memmove(&link_index[pos + 1], &link_index[pos],
+          (end - pos) * sizeof(link_index[0]));
+  link_index[pos] = l;
+  link_index_len[run]++;
+}
+/*---------------------------------------------------------------------------*/
+/* Removes a link from the run of its slotframe */
+static void
+link_index_remove(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  int run = link_index_run(sf);
+  uint16_t start = link_index_start(run);
+  uint16_t end = link_index_start(TSCH_SCHEDULE_MAX_SLOTFRAMES);
+  uint16_t pos = start + link_index_after(&link_index[start],
+                                          link_index_len[run], l->timeslot);
+  while(pos > start && link_index[pos - 1]->timeslot == l->timeslot) {
+    pos--;
+    if(link_index[pos] == l) {
+      memmove(&link_index[pos], &link_index[pos + 1],
+              (end - pos - 1) * sizeof(link_index[0]));
+      link_index_len[run]--;
+      return;
+    }
+  }
+}
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
+
 /* Adds and returns a slotframe (NULL if failure) */
 struct tsch_slotframe *
 tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
@@ -209,6 +290,9 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
           address = &linkaddr_null;
         }
         linkaddr_copy(&l->addr, address);
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+        link_index_add(slotframe, l);
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
 
         PRINTF("TSCH-schedule: add_link %u %u %u %u %u %u\n",
                slotframe->handle, link_options, link_type, timeslot, channel_offset, TSCH_LOG_ID_FROM_LINKADDR(address));
@@ -255,6 +339,9 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
              slotframe->handle, l->link_options, l->timeslot, l->channel_offset,
              TSCH_LOG_ID_FROM_LINKADDR(&l->addr));
 
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+      link_index_remove(slotframe, l);
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
       list_remove(slotframe->links_list, l);
       memb_free(&link_memb, l);
 
@@ -294,6 +381,19 @@ tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe, uint16_t ti
 {
   if(!tsch_is_locked()) {
     if(slotframe != NULL) {
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+      int run = link_index_run(slotframe);
+      struct tsch_link **links = &link_index[link_index_start(run)];
+      uint16_t pos = link_index_after(links, link_index_len[run], timeslot);
+      /* Go back to the first link at this timeslot, in list order */
+      while(pos > 0 && links[pos - 1]->timeslot == timeslot) {
+        pos--;
+      }
+      if(pos < link_index_len[run] && links[pos]->timeslot == timeslot) {
+        return links[pos];
+      }
+      return NULL;
+#else /* TSCH_SCHEDULE_WITH_LINK_INDEX */
       struct tsch_link *l = list_head(slotframe->links_list);
       /* Loop over all items. Assume there is max one link per timeslot */
       while(l != NULL) {
@@ -303,11 +403,66 @@ tsch_schedule_get_link_by_timeslot(struct tsch_slotframe *slotframe, uint16_t ti
         l = list_item_next(l);
       }
       return l;
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
     }
   }
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+/* Time, in timeslots, from a timeslot of a slotframe to the next occurrence of a link */
+static uint16_t
+time_to_link(const struct tsch_slotframe *sf, const struct tsch_link *l, uint16_t timeslot)
+{
+  return l->timeslot > timeslot ?
+         l->timeslot - timeslot :
+         sf->size.val + l->timeslot - timeslot;
+}
+/*---------------------------------------------------------------------------*/
+/* Weighs a link against the best and backup links found so far */
+static void
+select_link(struct tsch_link *l, uint16_t time_to_timeslot,
+            struct tsch_link **curr_best, uint16_t *time_to_curr_best,
+            struct tsch_link **curr_backup)
+{
+  if(*curr_best == NULL || time_to_timeslot < *time_to_curr_best) {
+    *time_to_curr_best = time_to_timeslot;
+    *curr_best = l;
+    *curr_backup = NULL;
+  } else if(time_to_timeslot == *time_to_curr_best) {
+    struct tsch_link *new_best = NULL;
+    /* Two links are overlapping, we need to select one of them.
+     * By standard: prioritize Tx links first, second by lowest handle */
+    if(((*curr_best)->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
+      /* Both or neither links have Tx, select the one with lowest handle */
+      if(l->slotframe_handle < (*curr_best)->slotframe_handle) {
+        new_best = l;
+      }
+    } else {
+      /* Select the link that has the Tx option */
+      if(l->link_options & LINK_OPTION_TX) {
+        new_best = l;
+      }
+    }
+
+    /* Maintain backup_link */
+    if(*curr_backup == NULL) {
+      /* Check if 'l' best can be used as backup */
+      if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
+        *curr_backup = l;
+      }
+      /* Check if curr_best can be used as backup */
+      if(new_best != *curr_best && ((*curr_best)->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
+        *curr_backup = *curr_best;
+      }
+    }
+
+    /* Maintain curr_best */
+    if(new_best != NULL) {
+      *curr_best = new_best;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
 /* Returns the next active link after a given ASN, and a backup link (for the same ASN, with Rx flag) */
 struct tsch_link *
 tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset,
@@ -325,52 +480,31 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
     while(sf != NULL) {
       /* Get timeslot from ASN, given the slotframe length */
       uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+      int run = link_index_run(sf);
+      struct tsch_link **links = &link_index[link_index_start(run)];
+      uint16_t len = link_index_len[run];
+      uint16_t next = link_index_after(links, len, timeslot);
+      uint16_t i;
+      /* Only the links at the first timeslot of the slotframe (reached
+       * in the next slotframe cycle) and those at the first timeslot
+       * after the current one can be the earliest occurring */
+      for(i = 0; i < next && links[i]->timeslot == links[0]->timeslot; i++) {
+        select_link(links[i], time_to_link(sf, links[i], timeslot),
+                    &curr_best, &time_to_curr_best, &curr_backup);
+      }
+      for(i = next; i < len && links[i]->timeslot == links[next]->timeslot; i++) {
+        select_link(links[i], time_to_link(sf, links[i], timeslot),
+                    &curr_best, &time_to_curr_best, &curr_backup);
+      }
+#else /* TSCH_SCHEDULE_WITH_LINK_INDEX */
       struct tsch_link *l = list_head(sf->links_list);
       while(l != NULL) {
-        uint16_t time_to_timeslot =
-          l->timeslot > timeslot ?
-          l->timeslot - timeslot :
-          sf->size.val + l->timeslot - timeslot;
-        if(curr_best == NULL || time_to_timeslot < time_to_curr_best) {
-          time_to_curr_best = time_to_timeslot;
-          curr_best = l;
-          curr_backup = NULL;
-        } else if(time_to_timeslot == time_to_curr_best) {
-          struct tsch_link *new_best = NULL;
-          /* Two links are overlapping, we need to select one of them.
-           * By standard: prioritize Tx links first, second by lowest handle */
-          if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
-            /* Both or neither links have Tx, select the one with lowest handle */
-            if(l->slotframe_handle < curr_best->slotframe_handle) {
-              new_best = l;
-            }
-          } else {
-            /* Select the link that has the Tx option */
-            if(l->link_options & LINK_OPTION_TX) {
-              new_best = l;
-            }
-          }
-
-          /* Maintain backup_link */
-          if(curr_backup == NULL) {
-            /* Check if 'l' best can be used as backup */
-            if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
-              curr_backup = l;
-            }
-            /* Check if curr_best can be used as backup */
-            if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
-              curr_backup = curr_best;
-            }
-          }
-
-          /* Maintain curr_best */
-          if(new_best != NULL) {
-            curr_best = new_best;
-          }
-        }
-
+        select_link(l, time_to_link(sf, l, timeslot),
+                    &curr_best, &time_to_curr_best, &curr_backup);
         l = list_item_next(l);
       }
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
       sf = list_item_next(sf);
     }
     if(time_offset != NULL) {
@@ -391,6 +525,9 @@ tsch_schedule_init(void)
     memb_init(&link_memb);
     memb_init(&slotframe_memb);
     list_init(slotframe_list);
+#if TSCH_SCHEDULE_WITH_LINK_INDEX
+    memset(link_index_len, 0, sizeof(link_index_len));
+#endif /* TSCH_SCHEDULE_WITH_LINK_INDEX */
     tsch_release_lock();
     return 1;
   } else {
@@ -72,6 +72,16 @@
 #define TSCH_SCHEDULE_MAX_LINKS 32
 #endif
 
+/* Keep the links of each slotframe sorted by timeslot, so that the next
+ * active link is found with a binary search per slotframe rather than by
+ * walking all links at every slot wake-up. Costs one pointer per link,
+ * so it is off by default. */
+#ifdef TSCH_SCHEDULE_CONF_WITH_LINK_INDEX
+#define TSCH_SCHEDULE_WITH_LINK_INDEX TSCH_SCHEDULE_CONF_WITH_LINK_INDEX
+#else
+#define TSCH_SCHEDULE_WITH_LINK_INDEX 0
+#endif
+
 /********** Constants *********/
 
 /* Link options */
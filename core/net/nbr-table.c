@@ -83,6 +83,22 @@ static unsigned num_tables;
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_WITH_HASH_INDEX
+#if (NBR_TABLE_HASH_SIZE & (NBR_TABLE_HASH_SIZE - 1)) != 0
+#error NBR_TABLE_HASH_SIZE must be a power of two
+#endif
+/* Neighbor indices plus one, 0 meaning none */
+#if NBR_TABLE_MAX_NEIGHBORS < 255
+typedef uint8_t hash_link_t;
+#else
+typedef uint16_t hash_link_t;
+#endif
+/* For each hash bucket, the first neighbor in the bucket */
+static hash_link_t hash_buckets[NBR_TABLE_HASH_SIZE];
+/* For each neighbor, the next neighbor in its bucket */
+static hash_link_t hash_next[NBR_TABLE_MAX_NEIGHBORS];
+#endif /* NBR_TABLE_WITH_HASH_INDEX */
+
 /*---------------------------------------------------------------------------*/
 /* Get a key from a neighbor index */
 static nbr_table_key_t *
@@ -125,17 +141,68 @@ key_from_item(nbr_table_t *table, const nbr_table_item_t *item)
 {
   return key_from_index(index_from_item(table, item));
 }
+#if NBR_TABLE_WITH_HASH_INDEX
+/*---------------------------------------------------------------------------*/
+static unsigned
+hash_lladdr(const linkaddr_t *lladdr)
+{
+  unsigned h = 0;
+  int i;
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    h = h * 31 + lladdr->u8[i];
+  }
+  return (h ^ (h >> 8)) & (NBR_TABLE_HASH_SIZE - 1);
+}
+/*---------------------------------------------------------------------------*/
+/* Add a key to the hash index, under its current link-layer address */
+static void
+hash_add(nbr_table_key_t *key)
+{
+  int index = index_from_key(key);
+  hash_link_t *bucket = &hash_buckets[hash_lladdr(&key->lladdr)];
+  hash_next[index] = *bucket;
+  *bucket = index + 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Remove a key from the hash index, before its link-layer address changes */
+static void
+hash_remove(nbr_table_key_t *key)
+{
+  hash_link_t link = index_from_key(key) + 1;
+  hash_link_t *prev = &hash_buckets[hash_lladdr(&key->lladdr)];
+  while(*prev != 0) {
+    if(*prev == link) {
+      *prev = hash_next[link - 1];
+      return;
+    }
+    prev = &hash_next[*prev - 1];
+  }
+}
+#endif /* NBR_TABLE_WITH_HASH_INDEX */
 /*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
 {
+#if NBR_TABLE_WITH_HASH_INDEX
+  hash_link_t link;
+#else /* NBR_TABLE_WITH_HASH_INDEX */
   nbr_table_key_t *key;
+#endif /* NBR_TABLE_WITH_HASH_INDEX */
   /* Allow lladdr-free insertion, useful e.g. for IPv6 ND.
    * Only one such entry is possible at a time, indexed by linkaddr_null. */
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_WITH_HASH_INDEX
+  link = hash_buckets[hash_lladdr(lladdr)];
+  while(link != 0) {
+    if(linkaddr_cmp(lladdr, &key_from_index(link - 1)->lladdr)) {
+      return link - 1;
+    }
+    link = hash_next[link - 1];
+  }
+#else /* NBR_TABLE_WITH_HASH_INDEX */
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -143,6 +210,7 @@ index_from_lladdr(const linkaddr_t *lladdr)
     }
     key = list_item_next(key);
   }
+#endif /* NBR_TABLE_WITH_HASH_INDEX */
   return -1;
 }
 /*---------------------------------------------------------------------------*/
@@ -195,6 +263,9 @@ remove_key(nbr_table_key_t *least_used_key)
   used_map[index_from_key(least_used_key)] = 0;
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, least_used_key);
+#if NBR_TABLE_WITH_HASH_INDEX
+  hash_remove(least_used_key);
+#endif /* NBR_TABLE_WITH_HASH_INDEX */
 }
 /*---------------------------------------------------------------------------*/
 static nbr_table_key_t *
@@ -359,6 +430,9 @@ nbr_table_add_lladdr(nbr_table_t *table, const linkaddr_t *lladdr, nbr_table_rea
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_WITH_HASH_INDEX
+    hash_add(key);
+#endif /* NBR_TABLE_WITH_HASH_INDEX */
   }
 
   /* Get item in the current table */
@@ -450,7 +524,13 @@ nbr_table_update_lladdr(const linkaddr_t *old_addr, const linkaddr_t *new_addr,
    * Copy the new lladdr into the key - since we know that there is no
    * conflicting entry.
    */
+#if NBR_TABLE_WITH_HASH_INDEX
+  hash_remove(key);
+#endif /* NBR_TABLE_WITH_HASH_INDEX */
   memcpy(&key->lladdr, new_addr, sizeof(linkaddr_t));
+#if NBR_TABLE_WITH_HASH_INDEX
+  hash_add(key);
+#endif /* NBR_TABLE_WITH_HASH_INDEX */
   return 1;
 }
 /*---------------------------------------------------------------------------*/
@@ -46,6 +46,34 @@
 #define NBR_TABLE_MAX_NEIGHBORS 8
 #endif /* NBR_TABLE_CONF_MAX_NEIGHBORS */
 
+/* Index the neighbors with a hash table keyed on their link-layer
+ * address, so that a lookup takes constant time rather than a scan of
+ * all neighbors. Worthwhile with many neighbors; costs one or two bytes
+ * of RAM per neighbor and per hash bucket. */
+#ifdef NBR_TABLE_CONF_WITH_HASH_INDEX
+#define NBR_TABLE_WITH_HASH_INDEX NBR_TABLE_CONF_WITH_HASH_INDEX
+#else /* NBR_TABLE_CONF_WITH_HASH_INDEX */
+#define NBR_TABLE_WITH_HASH_INDEX 0
+#endif /* NBR_TABLE_CONF_WITH_HASH_INDEX */
+
+/* The number of hash buckets, a power of two. Defaults to the smallest
+ * one not below the number of neighbors. */
+#ifdef NBR_TABLE_CONF_HASH_SIZE
+#define NBR_TABLE_HASH_SIZE NBR_TABLE_CONF_HASH_SIZE
+#elif NBR_TABLE_MAX_NEIGHBORS <= 8
+#define NBR_TABLE_HASH_SIZE 8
+#elif NBR_TABLE_MAX_NEIGHBORS <= 16
+#define NBR_TABLE_HASH_SIZE 16
+#elif NBR_TABLE_MAX_NEIGHBORS <= 32
+#define NBR_TABLE_HASH_SIZE 32
+#elif NBR_TABLE_MAX_NEIGHBORS <= 64
+#define NBR_TABLE_HASH_SIZE 64
+#elif NBR_TABLE_MAX_NEIGHBORS <= 128
+#define NBR_TABLE_HASH_SIZE 128
+#else
+#define NBR_TABLE_HASH_SIZE 256
+#endif /* NBR_TABLE_CONF_HASH_SIZE */
+
 /* An item in a neighbor table */
 typedef void nbr_table_item_t;
 
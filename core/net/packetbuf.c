@@ -56,6 +56,9 @@ struct packetbuf_addr packetbuf_addrs[PACKETBUF_NUM_ADDRS];
 static uint16_t buflen, bufptr;
 static uint8_t hdrlen;
 
+static const struct radio_segment *refsegs;
+static uint8_t num_refsegs;
+
 /* The declarations below ensure that the packet buffer is aligned on
    an even 32-bit boundary. On some platforms (most notably the
    msp430 or OpenRISC), having a potentially misaligned packet buffer may lead to
@@ -77,6 +80,8 @@ packetbuf_clear(void)
 {
   buflen = bufptr = 0;
   hdrlen = 0;
+  refsegs = NULL;
+  num_refsegs = 0;
 
   packetbuf_attr_clear();
 }
@@ -114,7 +119,17 @@ packetbuf_copyto(void *to)
     return 0;
   }
   memcpy(to, packetbuf_hdrptr(), hdrlen);
-  memcpy((uint8_t *)to + hdrlen, packetbuf_dataptr(), buflen);
+  if(refsegs != NULL) {
+    uint8_t *ptr = (uint8_t *)to + hdrlen;
+    uint8_t i;
+
+    for(i = 0; i < num_refsegs; i++) {
+      memcpy(ptr, refsegs[i].ptr, refsegs[i].len);
+      ptr += refsegs[i].len;
+    }
+  } else {
+    memcpy((uint8_t *)to + hdrlen, packetbuf_dataptr(), buflen);
+  }
   return hdrlen + buflen;
 }
 /*---------------------------------------------------------------------------*/
@@ -127,8 +142,9 @@ packetbuf_hdralloc(int size)
     return 0;
   }
 
-  /* shift data to the right */
-  for(i = packetbuf_totlen() - 1; i >= 0; i--) {
+  /* shift data to the right; referenced data is not stored here */
+  for(i = (refsegs != NULL ? packetbuf_hdrlen() : packetbuf_totlen()) - 1;
+      i >= 0; i--) {
     packetbuf[i + size] = packetbuf[i];
   }
   hdrlen += size;
@@ -142,11 +158,62 @@ packetbuf_hdrreduce(int size)
     return 0;
   }
 
+  packetbuf_copy_reference();
+
   bufptr += size;
   buflen -= size;
   return 1;
 }
 /*---------------------------------------------------------------------------*/
+int
+packetbuf_reference_segments(const struct radio_segment *segs,
+                             uint8_t num_segs)
+{
+  uint16_t len;
+  uint8_t i;
+
+  packetbuf_clear();
+  if(num_segs > PACKETBUF_MAX_SEGMENTS) {
+    return 0;
+  }
+  len = 0;
+  for(i = 0; i < num_segs; i++) {
+    if(segs[i].len > PACKETBUF_SIZE - len) {
+      return 0;
+    }
+    len += segs[i].len;
+  }
+  refsegs = segs;
+  num_refsegs = num_segs;
+  buflen = len;
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+const struct radio_segment *
+packetbuf_referenced_segments(uint8_t *num_segs)
+{
+  *num_segs = num_refsegs;
+  return refsegs;
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_copy_reference(void)
+{
+  uint8_t *ptr;
+  uint8_t i;
+
+  if(refsegs == NULL) {
+    return;
+  }
+  ptr = packetbuf + packetbuf_hdrlen();
+  for(i = 0; i < num_refsegs; i++) {
+    memcpy(ptr, refsegs[i].ptr, refsegs[i].len);
+    ptr += refsegs[i].len;
+  }
+  refsegs = NULL;
+  num_refsegs = 0;
+}
+/*---------------------------------------------------------------------------*/
 void
 packetbuf_set_datalen(uint16_t len)
 {
@@ -157,6 +224,7 @@ packetbuf_set_datalen(uint16_t len)
 void *
 packetbuf_dataptr(void)
 {
+  packetbuf_copy_reference();
   return packetbuf + packetbuf_hdrlen();
 }
 /*---------------------------------------------------------------------------*/
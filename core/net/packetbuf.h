@@ -54,6 +54,7 @@
 
 #include "contiki-conf.h"
 #include "net/linkaddr.h"
+#include "dev/radio.h"
 #include "net/llsec/llsec802154.h"
 #include "net/mac/tsch/tsch-conf.h"
 
@@ -66,6 +67,15 @@
 #define PACKETBUF_SIZE 128
 #endif
 
+/**
+ * \brief      The maximum number of segments the packetbuf can reference
+ */
+#ifdef PACKETBUF_CONF_MAX_SEGMENTS
+#define PACKETBUF_MAX_SEGMENTS PACKETBUF_CONF_MAX_SEGMENTS
+#else
+#define PACKETBUF_MAX_SEGMENTS 4
+#endif
+
 #ifdef PACKETBUF_CONF_WITH_PACKET_TYPE
 #define PACKETBUF_WITH_PACKET_TYPE PACKETBUF_CONF_WITH_PACKET_TYPE
 #else
@@ -211,6 +221,49 @@ int packetbuf_hdralloc(int size);
  */
 int packetbuf_hdrreduce(int size);
 
+/**
+ * \brief      Point the packetbuf data to external segments, for outbound packets
+ * \param segs The segments, in the order in which they form the data
+ * \param num_segs The number of segments
+ * \retval     The length of the referenced data, or zero if it does not fit
+ *
+ *             This function clears the packetbuf and makes its data
+ *             portion refer to the given segments instead of holding
+ *             a copy of them. The segments and the memory they point
+ *             to must remain valid until the packet has been handed
+ *             to the radio or copied. Headers allocated afterwards are
+ *             stored in the packetbuf as usual, so that a radio driver
+ *             can gather the header and the segments without an
+ *             intermediate copy. Accessing the data with
+ *             packetbuf_dataptr() copies the segments into the
+ *             packetbuf first. Since packetbuf_hdrptr() does not,
+ *             RDC drivers must hand the frame to the radio with
+ *             mac_radio_prepare_packetbuf() or
+ *             mac_radio_send_packetbuf(), or call
+ *             packetbuf_copy_reference() before using
+ *             packetbuf_hdrptr() and packetbuf_totlen() themselves.
+ *
+ */
+int packetbuf_reference_segments(const struct radio_segment *segs,
+                                 uint8_t num_segs);
+
+/**
+ * \brief      Get the external segments referenced by the packetbuf
+ * \param num_segs A pointer to the number of segments, set by the function
+ * \retval     A pointer to the segments, or NULL if the data is in the packetbuf
+ *
+ */
+const struct radio_segment *packetbuf_referenced_segments(uint8_t *num_segs);
+
+/**
+ * \brief      Copy the external segments into the packetbuf
+ *
+ *             This function does nothing if the packetbuf does not
+ *             reference external segments.
+ *
+ */
+void packetbuf_copy_reference(void);
+
 /* Packet attributes stuff below: */
 
 typedef uint16_t packetbuf_attr_t;
@@ -311,18 +311,6 @@ rpl_process_srh_header(void)
 }
 /*---------------------------------------------------------------------------*/
 static int
-count_matching_bytes(const void *p1, const void *p2, size_t n)
-{
-  int i = 0;
-  for(i = 0; i < n; i++) {
-    if(((uint8_t *)p1)[i] != ((uint8_t *)p2)[i]) {
-      return i;
-    }
-  }
-  return n;
-}
-/*---------------------------------------------------------------------------*/
-static int
 insert_srh_header(void)
 {
   /* Implementation of RFC6554 */
@@ -364,38 +352,20 @@ insert_srh_header(void)
     return 0;
   }
 
-  if(!rpl_ns_is_node_reachable(dag, &UIP_IP_BUF->destipaddr)) {
+  /* Compute path length and compression factors. For simplicity, we
+     use cmpri == cmpre: the number of bytes that all nodes in the path
+     have in common with the destination. */
+  if(!rpl_ns_get_path(dag, dest_node, &path_len, &cmpri)) {
     PRINTF("RPL: SRH no path found to destination\n");
     return 0;
   }
+  cmpre = cmpri;
 
-  /* Compute path length and compression factors (we use cmpri == cmpre) */
-  path_len = 0;
-  node = dest_node->parent;
-  /* For simplicity, we use cmpri = cmpre */
-  cmpri = 15;
-  cmpre = 15;
-
-  if(node == root_node) {
+  if(path_len == 0) {
     PRINTF("RPL: SRH no need to insert SRH\n");
     return 1;
   }
 
-  while(node != NULL && node != root_node) {
-
-    rpl_ns_get_node_global_addr(&node_addr, node);
-
-    /* How many bytes in common between all nodes in the path? */
-    cmpri = MIN(cmpri, count_matching_bytes(&node_addr, &UIP_IP_BUF->destipaddr, 16));
-    cmpre = cmpri;
-
-    PRINTF("RPL: SRH Hop ");
-    PRINT6ADDR(&node_addr);
-    PRINTF("\n");
-    node = node->parent;
-    path_len++;
-  }
-
   /* Extension header length: fixed headers + (n-1) * (16-ComprI) + (16-ComprE)*/
   ext_len = RPL_RH_LEN + RPL_SRH_LEN
       + (path_len - 1) * (16 - cmpre)
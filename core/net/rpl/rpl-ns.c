@@ -63,6 +63,20 @@ static int num_nodes;
 LIST(nodelist);
 MEMB(nodememb, rpl_ns_node_t, RPL_NS_LINK_NUM);
 
+#if RPL_NS_WITH_HASH_INDEX
+#if (RPL_NS_HASH_SIZE & (RPL_NS_HASH_SIZE - 1)) != 0
+#error RPL_NS_HASH_SIZE must be a power of two
+#endif
+/* For each hash bucket, the list of its nodes, chained through hash_next */
+static rpl_ns_node_t *node_hash[RPL_NS_HASH_SIZE];
+#endif /* RPL_NS_WITH_HASH_INDEX */
+
+#if RPL_NS_WITH_PATH_CACHE
+/* Incremented whenever a parent link changes or a node goes away, which
+   invalidates all cached paths. 0 marks a node without a cached path. */
+static uint16_t topology_version;
+#endif /* RPL_NS_WITH_PATH_CACHE */
+
 /*---------------------------------------------------------------------------*/
 int
 rpl_ns_num_nodes(void)
@@ -80,17 +94,78 @@ node_matches_address(const rpl_dag_t *dag, const rpl_ns_node_t *node, const uip_
       && !memcmp(addr, &node->dag->dag_id, 8)
       && !memcmp(((const unsigned char *)addr) + 8, node->link_identifier, 8);
 }
+#if RPL_NS_WITH_HASH_INDEX
+/*---------------------------------------------------------------------------*/
+static rpl_ns_node_t **
+hash_bucket(const unsigned char *link_identifier)
+{
+  unsigned h = 0;
+  int i;
+  for(i = 0; i < 8; i++) {
+    h = h * 31 + link_identifier[i];
+  }
+  return &node_hash[(h ^ (h >> 8)) & (RPL_NS_HASH_SIZE - 1)];
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_add(rpl_ns_node_t *node)
+{
+  rpl_ns_node_t **bucket = hash_bucket(node->link_identifier);
+  node->hash_next = *bucket;
+  *bucket = node;
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_remove(rpl_ns_node_t *node)
+{
+  rpl_ns_node_t **prev;
+  for(prev = hash_bucket(node->link_identifier); *prev != NULL;
+      prev = &(*prev)->hash_next) {
+    if(*prev == node) {
+      *prev = node->hash_next;
+      return;
+    }
+  }
+}
+#endif /* RPL_NS_WITH_HASH_INDEX */
+#if RPL_NS_WITH_PATH_CACHE
+/*---------------------------------------------------------------------------*/
+static void
+topology_changed(void)
+{
+  rpl_ns_node_t *l;
+  if(++topology_version == 0) {
+    /* Wrapped around: make sure no old path looks valid */
+    for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
+      l->path_version = 0;
+    }
+    topology_version = 1;
+  }
+}
+#endif /* RPL_NS_WITH_PATH_CACHE */
 /*---------------------------------------------------------------------------*/
 rpl_ns_node_t *
 rpl_ns_get_node(const rpl_dag_t *dag, const uip_ipaddr_t *addr)
 {
   rpl_ns_node_t *l;
+#if RPL_NS_WITH_HASH_INDEX
+  if(addr == NULL) {
+    return NULL;
+  }
+  for(l = *hash_bucket(((const unsigned char *)addr) + 8); l != NULL;
+      l = l->hash_next) {
+    if(node_matches_address(dag, l, addr)) {
+      return l;
+    }
+  }
+#else /* RPL_NS_WITH_HASH_INDEX */
   for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
     /* Compare prefix and node identifier */
     if(node_matches_address(dag, l, addr)) {
       return l;
     }
   }
+#endif /* RPL_NS_WITH_HASH_INDEX */
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
@@ -107,6 +182,71 @@ rpl_ns_is_node_reachable(const rpl_dag_t *dag, const uip_ipaddr_t *addr)
   return node != NULL && node == root_node;
 }
 /*---------------------------------------------------------------------------*/
+static int
+count_matching_bytes(const void *p1, const void *p2, size_t n)
+{
+  int i = 0;
+  for(i = 0; i < n; i++) {
+    if(((uint8_t *)p1)[i] != ((uint8_t *)p2)[i]) {
+      return i;
+    }
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+/* Get the source route from the root to a node: the number of hops
+ * between them, and how many leading bytes all these hops have in
+ * common with the address of the node (at most 15). Returns 0 if the
+ * node is not reachable from the root. */
+int
+rpl_ns_get_path(const rpl_dag_t *dag, rpl_ns_node_t *dest_node, uint8_t *path_len, uint8_t *cmpr)
+{
+  int max_depth = RPL_NS_LINK_NUM;
+  rpl_ns_node_t *root_node;
+  rpl_ns_node_t *node;
+  uip_ipaddr_t dest_addr;
+  uip_ipaddr_t node_addr;
+  uint8_t len;
+  uint8_t c;
+
+#if RPL_NS_WITH_PATH_CACHE
+  if(dest_node->path_version == topology_version) {
+    *path_len = dest_node->path_len;
+    *cmpr = dest_node->path_cmpr;
+    return 1;
+  }
+#endif /* RPL_NS_WITH_PATH_CACHE */
+
+  root_node = rpl_ns_get_node(dag, dag != NULL ? &dag->dag_id : NULL);
+  if(root_node == NULL) {
+    return 0;
+  }
+
+  rpl_ns_get_node_global_addr(&dest_addr, dest_node);
+  len = 0;
+  c = 15;
+  node = dest_node == root_node ? root_node : dest_node->parent;
+  while(node != NULL && node != root_node && max_depth > 0) {
+    rpl_ns_get_node_global_addr(&node_addr, node);
+    c = MIN(c, count_matching_bytes(&node_addr, &dest_addr, 16));
+    node = node->parent;
+    len++;
+    max_depth--;
+  }
+  if(node != root_node) {
+    return 0;
+  }
+
+  *path_len = len;
+  *cmpr = c;
+#if RPL_NS_WITH_PATH_CACHE
+  dest_node->path_version = topology_version;
+  dest_node->path_len = len;
+  dest_node->path_cmpr = c;
+#endif /* RPL_NS_WITH_PATH_CACHE */
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
 void
 rpl_ns_expire_parent(rpl_dag_t *dag, const uip_ipaddr_t *child, const uip_ipaddr_t *parent)
 {
@@ -142,14 +282,28 @@ rpl_ns_update_node(rpl_dag_t *dag, const uip_ipaddr_t *child, const uip_ipaddr_t
       return NULL;
     }
     child_node->parent = NULL;
+    child_node->dag = NULL;
+    memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
+#if RPL_NS_WITH_HASH_INDEX
+    hash_add(child_node);
+#endif /* RPL_NS_WITH_HASH_INDEX */
+#if RPL_NS_WITH_PATH_CACHE
+    child_node->path_version = 0;
+#endif /* RPL_NS_WITH_PATH_CACHE */
     list_add(nodelist, child_node);
     num_nodes++;
   }
 
+#if RPL_NS_WITH_PATH_CACHE
+  old_parent_node = child_node->parent;
+  if(child_node->dag != dag) {
+    topology_changed();
+  }
+#endif /* RPL_NS_WITH_PATH_CACHE */
+
   /* Initialize node */
   child_node->dag = dag;
   child_node->lifetime = lifetime;
-  memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
 
   /* Is the node reachable before the update? */
   if(rpl_ns_is_node_reachable(dag, child)) {
@@ -167,6 +321,12 @@ rpl_ns_update_node(rpl_dag_t *dag, const uip_ipaddr_t *child, const uip_ipaddr_t
     child_node->parent = parent_node;
   }
 
+#if RPL_NS_WITH_PATH_CACHE
+  if(child_node->parent != old_parent_node) {
+    topology_changed();
+  }
+#endif /* RPL_NS_WITH_PATH_CACHE */
+
   return child_node;
 }
 /*---------------------------------------------------------------------------*/
@@ -176,6 +336,12 @@ rpl_ns_init(void)
   num_nodes = 0;
   memb_init(&nodememb);
   list_init(nodelist);
+#if RPL_NS_WITH_HASH_INDEX
+  memset(node_hash, 0, sizeof(node_hash));
+#endif /* RPL_NS_WITH_HASH_INDEX */
+#if RPL_NS_WITH_PATH_CACHE
+  topology_version = 1;
+#endif /* RPL_NS_WITH_PATH_CACHE */
 }
 /*---------------------------------------------------------------------------*/
 rpl_ns_node_t *
@@ -221,6 +387,12 @@ rpl_ns_periodic(void)
       }
       /* No child found, deallocate node */
       list_remove(nodelist, l);
+#if RPL_NS_WITH_HASH_INDEX
+      hash_remove(l);
+#endif /* RPL_NS_WITH_HASH_INDEX */
+#if RPL_NS_WITH_PATH_CACHE
+      topology_changed();
+#endif /* RPL_NS_WITH_PATH_CACHE */
       memb_free(&nodememb, l);
       num_nodes--;
     }
@@ -49,6 +49,31 @@
 #define RPL_NS_LINK_NUM 32
 #endif /* RPL_NS_CONF_LINK_NUM */
 
+/* Index the nodes with a hash table keyed on their link identifier, so
+ * that finding the node of an address takes constant time rather than
+ * a scan of all nodes. Worthwhile on roots that serve many nodes. */
+#ifdef RPL_NS_CONF_WITH_HASH_INDEX
+#define RPL_NS_WITH_HASH_INDEX RPL_NS_CONF_WITH_HASH_INDEX
+#else /* RPL_NS_CONF_WITH_HASH_INDEX */
+#define RPL_NS_WITH_HASH_INDEX 0
+#endif /* RPL_NS_CONF_WITH_HASH_INDEX */
+
+/* The number of hash buckets, a power of two. */
+#ifdef RPL_NS_CONF_HASH_SIZE
+#define RPL_NS_HASH_SIZE RPL_NS_CONF_HASH_SIZE
+#else /* RPL_NS_CONF_HASH_SIZE */
+#define RPL_NS_HASH_SIZE 64
+#endif /* RPL_NS_CONF_HASH_SIZE */
+
+/* Remember, for each node, the length and address compression of its
+ * source route, until the topology changes. This spares walking the
+ * path twice for every packet that gets a source routing header. */
+#ifdef RPL_NS_CONF_WITH_PATH_CACHE
+#define RPL_NS_WITH_PATH_CACHE RPL_NS_CONF_WITH_PATH_CACHE
+#else /* RPL_NS_CONF_WITH_PATH_CACHE */
+#define RPL_NS_WITH_PATH_CACHE 0
+#endif /* RPL_NS_CONF_WITH_PATH_CACHE */
+
 typedef struct rpl_ns_node {
   struct rpl_ns_node *next;
   uint32_t lifetime;
@@ -56,6 +81,16 @@ typedef struct rpl_ns_node {
   /* Store only IPv6 link identifiers as all nodes in the DAG share the same prefix */
   unsigned char link_identifier[8];
   struct rpl_ns_node *parent;
+#if RPL_NS_WITH_HASH_INDEX
+  /* The next node in the same hash bucket */
+  struct rpl_ns_node *hash_next;
+#endif /* RPL_NS_WITH_HASH_INDEX */
+#if RPL_NS_WITH_PATH_CACHE
+  /* The topology version the cached path is valid for, 0 if none */
+  uint16_t path_version;
+  uint8_t path_len;
+  uint8_t path_cmpr;
+#endif /* RPL_NS_WITH_PATH_CACHE */
 } rpl_ns_node_t;
 
 int rpl_ns_num_nodes(void);
@@ -66,6 +101,7 @@ rpl_ns_node_t *rpl_ns_node_head(void);
 rpl_ns_node_t *rpl_ns_node_next(rpl_ns_node_t *item);
 rpl_ns_node_t *rpl_ns_get_node(const rpl_dag_t *dag, const uip_ipaddr_t *addr);
 int rpl_ns_is_node_reachable(const rpl_dag_t *dag, const uip_ipaddr_t *addr);
+int rpl_ns_get_path(const rpl_dag_t *dag, rpl_ns_node_t *dest_node, uint8_t *path_len, uint8_t *cmpr);
 void rpl_ns_get_node_global_addr(uip_ipaddr_t *addr, rpl_ns_node_t *node);
 void rpl_ns_periodic(void);
 
@@ -46,7 +46,16 @@
 #include "contiki.h"
 #include "lib/list.h"
 
+#include <stddef.h>
+
+/* Callback timers set before the ctimer process has started. Once it
+   has, a pending callback timer is marked by pointing its next field
+   at itself, so that it can be found from its event timer in constant
+   time. */
 LIST(ctimer_list);
+#define ARMED(c) ((c)->next = (c))
+#define DISARMED(c) ((c)->next = NULL)
+#define IS_ARMED(c) ((c)->next == (c))
 
 static char initialized;
 
@@ -65,28 +74,42 @@ PROCESS_THREAD(ctimer_process, ev, data)
   struct ctimer *c;
   PROCESS_BEGIN();
 
-  for(c = list_head(ctimer_list); c != NULL; c = c->next) {
+  while((c = list_pop(ctimer_list)) != NULL) {
     etimer_set(&c->etimer, c->etimer.timer.interval);
+    ARMED(c);
   }
   initialized = 1;
 
   while(1) {
     PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_TIMER);
-    for(c = list_head(ctimer_list); c != NULL; c = c->next) {
-      if(&c->etimer == data) {
-	list_remove(ctimer_list, c);
-	PROCESS_CONTEXT_BEGIN(c->p);
-	if(c->f != NULL) {
-	  c->f(c->ptr);
-	}
-	PROCESS_CONTEXT_END(c->p);
-	break;
+    c = (struct ctimer *)((char *)data - offsetof(struct ctimer, etimer));
+    /* Events of timers that have been stopped or set again since
+       their event timers expired have been cancelled, so the timer is
+       still valid here. */
+    if(IS_ARMED(c) && etimer_expired(&c->etimer)) {
+      DISARMED(c);
+      PROCESS_CONTEXT_BEGIN(c->p);
+      if(c->f != NULL) {
+        c->f(c->ptr);
       }
+      PROCESS_CONTEXT_END(c->p);
     }
   }
   PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
+/* A pending callback timer whose event timer has expired has an event
+   on its way to the ctimer process. The event is cancelled when the
+   timer is stopped or set again, so that it never refers to a timer
+   that may since have been freed. */
+static void
+cancel_event(struct ctimer *c)
+{
+  if(IS_ARMED(c) && etimer_expired(&c->etimer)) {
+    process_cancel_event(&ctimer_process, PROCESS_EVENT_TIMER, &c->etimer);
+  }
+}
+/*---------------------------------------------------------------------------*/
 void
 ctimer_init(void)
 {
@@ -111,50 +134,57 @@ ctimer_set_with_process(struct ctimer *c, clock_time_t t,
   c->f = f;
   c->ptr = ptr;
   if(initialized) {
+    cancel_event(c);
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
     etimer_set(&c->etimer, t);
     PROCESS_CONTEXT_END(&ctimer_process);
+    ARMED(c);
   } else {
     c->etimer.timer.interval = t;
+    list_add(ctimer_list, c);
   }
-
-  list_add(ctimer_list, c);
 }
 /*---------------------------------------------------------------------------*/
 void
 ctimer_reset(struct ctimer *c)
 {
   if(initialized) {
+    cancel_event(c);
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
     etimer_reset(&c->etimer);
     PROCESS_CONTEXT_END(&ctimer_process);
+    ARMED(c);
+  } else {
+    list_add(ctimer_list, c);
   }
-
-  list_add(ctimer_list, c);
 }
 /*---------------------------------------------------------------------------*/
 void
 ctimer_restart(struct ctimer *c)
 {
   if(initialized) {
+    cancel_event(c);
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
     etimer_restart(&c->etimer);
     PROCESS_CONTEXT_END(&ctimer_process);
+    ARMED(c);
+  } else {
+    list_add(ctimer_list, c);
   }
-
-  list_add(ctimer_list, c);
 }
 /*---------------------------------------------------------------------------*/
 void
 ctimer_stop(struct ctimer *c)
 {
   if(initialized) {
+    cancel_event(c);
     etimer_stop(&c->etimer);
+    DISARMED(c);
   } else {
     c->etimer.next = NULL;
     c->etimer.p = PROCESS_NONE;
+    list_remove(ctimer_list, c);
   }
-  list_remove(ctimer_list, c);
 }
 /*---------------------------------------------------------------------------*/
 int
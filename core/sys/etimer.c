@@ -49,6 +49,17 @@
 #include "sys/etimer.h"
 #include "sys/process.h"
 
+#if ETIMER_WITH_HEAP
+/* The pending event timers form a pairing heap, ordered by expiration
+   time, with the timer that expires first at its root. Every timer
+   points to its first child and to its next sibling. Its prev pointer
+   points to its previous sibling, or to its parent if it is the first
+   child, and is NULL for timers that are not in the heap. */
+#else /* ETIMER_WITH_HEAP */
+/* The list of pending event timers, sorted by expiration time. Timers
+   that have already expired, but have not been handled yet, are at its
+   front. */
+#endif /* ETIMER_WITH_HEAP */
 static struct etimer *timerlist;
 static clock_time_t next_expiration;
 
@@ -57,29 +68,202 @@ PROCESS(etimer_process, "Event timer");
 static void
 update_time(void)
 {
-  clock_time_t tdist;
-  clock_time_t now;
-  struct etimer *t;
-
   if (timerlist == NULL) {
     next_expiration = 0;
   } else {
-    now = clock_time();
-    t = timerlist;
-    /* Must calculate distance to next time into account due to wraps */
-    tdist = t->timer.start + t->timer.interval - now;
-    for(t = t->next; t != NULL; t = t->next) {
-      if(t->timer.start + t->timer.interval - now < tdist) {
-	tdist = t->timer.start + t->timer.interval - now;
+    next_expiration = timerlist->timer.start + timerlist->timer.interval;
+  }
+}
+/*---------------------------------------------------------------------------*/
+#if ETIMER_WITH_HEAP
+/* Distances to the expiration times must be taken from the present
+   time due to wraps. Expired timers precede all others. */
+static clock_time_t
+time_left(struct etimer *t, clock_time_t now)
+{
+  if((clock_time_t)(now - t->timer.start) < t->timer.interval) {
+    return t->timer.start + t->timer.interval - now;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Merge two heaps, of which the roots have no siblings. */
+static struct etimer *
+link_timers(struct etimer *a, struct etimer *b, clock_time_t now)
+{
+  struct etimer *t;
+
+  if(time_left(b, now) < time_left(a, now)) {
+    t = a;
+    a = b;
+    b = t;
+  }
+  b->prev = a;
+  b->next = a->child;
+  if(a->child != NULL) {
+    a->child->prev = b;
+  }
+  a->child = b;
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+/* Merge a list of sibling heaps into one: in pairs from left to right,
+   and then the pairs from right to left. */
+static struct etimer *
+merge_pairs(struct etimer *first, clock_time_t now)
+{
+  struct etimer *a, *b, *pairs;
+
+  pairs = NULL;
+  while(first != NULL) {
+    a = first;
+    b = a->next;
+    first = b != NULL ? b->next : NULL;
+    a->next = a->prev = NULL;
+    if(b != NULL) {
+      b->next = b->prev = NULL;
+      a = link_timers(a, b, now);
+    }
+    a->next = pairs;
+    pairs = a;
+  }
+
+  while(pairs != NULL) {
+    a = pairs;
+    pairs = a->next;
+    a->next = NULL;
+    first = first != NULL ? link_timers(first, a, now) : a;
+  }
+  return first;
+}
+/*---------------------------------------------------------------------------*/
+static int
+remove_timer(struct etimer *timer)
+{
+  struct etimer *children;
+  clock_time_t now;
+
+  now = clock_time();
+  if(timer == timerlist) {
+    timerlist = merge_pairs(timer->child, now);
+  } else if(timer->prev != NULL) {
+    if(timer->prev->child == timer) {
+      timer->prev->child = timer->next;
+    } else {
+      timer->prev->next = timer->next;
+    }
+    if(timer->next != NULL) {
+      timer->next->prev = timer->prev;
+    }
+    children = merge_pairs(timer->child, now);
+    if(children != NULL) {
+      timerlist = link_timers(timerlist, children, now);
+    }
+  } else {
+    return 0;
+  }
+  timer->child = timer->next = timer->prev = NULL;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+insert_timer(struct etimer *timer)
+{
+  timer->child = timer->next = timer->prev = NULL;
+  if(timerlist == NULL) {
+    timerlist = timer;
+  } else {
+    timerlist = link_timers(timerlist, timer, clock_time());
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_process_timers(struct process *p)
+{
+  struct etimer *t, *last, *next;
+  clock_time_t now;
+
+  /* Take the heap apart, one timer at a time, and build it anew from
+     the timers of the other processes. */
+  now = clock_time();
+  t = timerlist;
+  timerlist = NULL;
+  while(t != NULL) {
+    if(t->child != NULL) {
+      /* The children of the timer are taken apart after it. */
+      for(last = t->child; last->next != NULL; last = last->next);
+      last->next = t->next;
+      t->next = t->child;
+    }
+    next = t->next;
+    t->child = t->next = t->prev = NULL;
+    if(t->p != p) {
+      timerlist = timerlist != NULL ? link_timers(timerlist, t, now) : t;
+    }
+    t = next;
+  }
+}
+#else /* ETIMER_WITH_HEAP */
+/*---------------------------------------------------------------------------*/
+static int
+remove_timer(struct etimer *timer)
+{
+  struct etimer **tp;
+
+  for(tp = &timerlist; *tp != NULL; tp = &(*tp)->next) {
+    if(*tp == timer) {
+      *tp = timer->next;
+      timer->next = NULL;
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+insert_timer(struct etimer *timer)
+{
+  struct etimer **tp;
+  struct etimer *t;
+  clock_time_t now;
+  clock_time_t tdist;
+
+  tp = &timerlist;
+  now = clock_time();
+  if((clock_time_t)(now - timer->timer.start) < timer->timer.interval) {
+    /* Distances to the expiration times must be taken from the
+       present time due to wraps. Expired timers precede all others. */
+    tdist = timer->timer.start + timer->timer.interval - now;
+    for(t = *tp; t != NULL; tp = &t->next, t = t->next) {
+      if((clock_time_t)(now - t->timer.start) < t->timer.interval &&
+         (clock_time_t)(t->timer.start + t->timer.interval - now) > tdist) {
+        break;
       }
     }
-    next_expiration = now + tdist;
+  }
+  timer->next = *tp;
+  *tp = timer;
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_process_timers(struct process *p)
+{
+  struct etimer **tp;
+
+  tp = &timerlist;
+  while(*tp != NULL) {
+    if((*tp)->p == p) {
+      *tp = (*tp)->next;
+    } else {
+      tp = &(*tp)->next;
+    }
   }
 }
+#endif /* ETIMER_WITH_HEAP */
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(etimer_process, ev, data)
 {
-  struct etimer *t, *u;
+  struct etimer *t;
 	
   PROCESS_BEGIN();
 
@@ -89,53 +273,29 @@ PROCESS_THREAD(etimer_process, ev, data)
     PROCESS_YIELD();
 
     if(ev == PROCESS_EVENT_EXITED) {
-      struct process *p = data;
-
-      while(timerlist != NULL && timerlist->p == p) {
-	timerlist = timerlist->next;
-      }
-
-      if(timerlist != NULL) {
-	t = timerlist;
-	while(t->next != NULL) {
-	  if(t->next->p == p) {
-	    t->next = t->next->next;
-	  } else
-	    t = t->next;
-	}
-      }
+      remove_process_timers(data);
+      update_time();
       continue;
     } else if(ev != PROCESS_EVENT_POLL) {
       continue;
     }
 
-  again:
-    
-    u = NULL;
-    
-    for(t = timerlist; t != NULL; t = t->next) {
-      if(timer_expired(&t->timer)) {
-	if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
-	  
-	  /* Reset the process ID of the event timer, to signal that the
-	     etimer has expired. This is later checked in the
-	     etimer_expired() function. */
-	  t->p = PROCESS_NONE;
-	  if(u != NULL) {
-	    u->next = t->next;
-	  } else {
-	    timerlist = t->next;
-	  }
-	  t->next = NULL;
-	  update_time();
-	  goto again;
-	} else {
-	  etimer_request_poll();
-	}
+    /* Only the front of the list needs to be checked. */
+    while(timerlist != NULL && timer_expired(&timerlist->timer)) {
+      t = timerlist;
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
+
+        /* Reset the process ID of the event timer, to signal that the
+           etimer has expired. This is later checked in the
+           etimer_expired() function. */
+        t->p = PROCESS_NONE;
+        remove_timer(t);
+      } else {
+        etimer_request_poll();
+        break;
       }
-      u = t;
     }
-    
+    update_time();
   }
   
   PROCESS_END();
@@ -150,26 +310,15 @@ etimer_request_poll(void)
 static void
 add_timer(struct etimer *timer)
 {
-  struct etimer *t;
-
   etimer_request_poll();
 
   if(timer->p != PROCESS_NONE) {
-    for(t = timerlist; t != NULL; t = t->next) {
-      if(t == timer) {
-	/* Timer already on list, bail out. */
-        timer->p = PROCESS_CURRENT();
-	update_time();
-	return;
-      }
-    }
+    /* The timer may already be on the list, at a different position. */
+    remove_timer(timer);
   }
 
-  /* Timer not on list. */
   timer->p = PROCESS_CURRENT();
-  timer->next = timerlist;
-  timerlist = timer;
-
+  insert_timer(timer);
   update_time();
 }
 /*---------------------------------------------------------------------------*/
@@ -206,6 +355,9 @@ void
 etimer_adjust(struct etimer *et, int timediff)
 {
   et->timer.start += timediff;
+  if(remove_timer(et)) {
+    insert_timer(et);
+  }
   update_time();
 }
 /*---------------------------------------------------------------------------*/
@@ -242,25 +394,8 @@ etimer_next_expiration_time(void)
 void
 etimer_stop(struct etimer *et)
 {
-  struct etimer *t;
-
-  /* First check if et is the first event timer on the list. */
-  if(et == timerlist) {
-    timerlist = timerlist->next;
+  if(remove_timer(et)) {
     update_time();
-  } else {
-    /* Else walk through the list and try to find the item before the
-       et timer. */
-    for(t = timerlist; t != NULL && t->next != et; t = t->next);
-
-    if(t != NULL) {
-      /* We've found the item before the event timer that we are about
-	 to remove. We point the items next pointer to the event after
-	 the removed item. */
-      t->next = et->next;
-
-      update_time();
-    }
   }
 
   /* Remove the next pointer from the item to be removed. */
@@ -65,6 +65,23 @@
 #include "sys/timer.h"
 #include "sys/process.h"
 
+/**
+ * \brief Keep the pending event timers in a heap
+ *
+ * By default, the pending event timers are kept on a list sorted by
+ * expiration time, so setting a timer takes time proportional to the
+ * number of pending timers. With ETIMER_CONF_WITH_HEAP, they are kept
+ * in a pairing heap instead, where this takes logarithmic time, at the
+ * cost of two more pointers in every struct etimer. Event timers must
+ * then be zero-initialized before they are first set, as static ones
+ * and ones allocated with memb are.
+ */
+#ifdef ETIMER_CONF_WITH_HEAP
+#define ETIMER_WITH_HEAP ETIMER_CONF_WITH_HEAP
+#else /* ETIMER_CONF_WITH_HEAP */
+#define ETIMER_WITH_HEAP 0
+#endif /* ETIMER_CONF_WITH_HEAP */
+
 /**
  * A timer.
  *
@@ -77,6 +94,10 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_WITH_HEAP
+  struct etimer *child;
+  struct etimer *prev;
+#endif /* ETIMER_WITH_HEAP */
 };
 
 /**
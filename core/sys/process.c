@@ -65,12 +65,45 @@ struct event_data {
   struct process *p;
 };
 
-static process_num_events_t nevents, fevent;
+/*
+ * A ring of pending events. With PROCESS_CONF_PRIORITIES, there is
+ * one ring per priority level and the high-priority ring is always
+ * drained first.
+ */
+struct event_queue {
+  struct event_data *events;
+  process_num_events_t size, nevents, fevent;
+};
+
 static struct event_data events[PROCESS_CONF_NUMEVENTS];
+#if PROCESS_CONF_PRIORITIES
+static struct event_data high_events[PROCESS_CONF_NUMEVENTS_HIGH];
+#define NUM_QUEUES 2
+#else /* PROCESS_CONF_PRIORITIES */
+#define NUM_QUEUES 1
+#endif /* PROCESS_CONF_PRIORITIES */
+
+static struct event_queue queues[NUM_QUEUES] = {
+  { events, PROCESS_CONF_NUMEVENTS, 0, 0 },
+#if PROCESS_CONF_PRIORITIES
+  { high_events, PROCESS_CONF_NUMEVENTS_HIGH, 0, 0 },
+#endif /* PROCESS_CONF_PRIORITIES */
+};
+
+/* The total number of queued events, over all priority levels. */
+static unsigned short nevents;
 
 #if PROCESS_CONF_STATS
 process_num_events_t process_maxevents;
-#endif
+#if PROCESS_CONF_PRIORITIES
+process_num_events_t process_maxevents_high;
+#endif /* PROCESS_CONF_PRIORITIES */
+#endif /* PROCESS_CONF_STATS */
+
+#if PROCESS_CONF_EVENT_STATS
+unsigned short process_event_posted[PROCESS_NUM_EVENT_TYPES];
+unsigned short process_event_dropped[PROCESS_NUM_EVENT_TYPES];
+#endif /* PROCESS_CONF_EVENT_STATS */
 
 static volatile unsigned char poll_requested;
 
@@ -207,12 +240,23 @@ process_exit(struct process *p)
 void
 process_init(void)
 {
+  unsigned char i;
+
   lastevent = PROCESS_EVENT_MAX;
 
-  nevents = fevent = 0;
+  for(i = 0; i < NUM_QUEUES; i++) {
+    queues[i].nevents = queues[i].fevent = 0;
+  }
+  nevents = 0;
 #if PROCESS_CONF_STATS
   process_maxevents = 0;
+#if PROCESS_CONF_PRIORITIES
+  process_maxevents_high = 0;
+#endif /* PROCESS_CONF_PRIORITIES */
 #endif /* PROCESS_CONF_STATS */
+#if PROCESS_CONF_EVENT_STATS
+  process_event_stats_reset();
+#endif /* PROCESS_CONF_EVENT_STATS */
 
   process_current = process_list = NULL;
 }
@@ -249,6 +293,7 @@ do_event(void)
   process_data_t data;
   struct process *receiver;
   struct process *p;
+  struct event_queue *q;
   
   /*
    * If there are any events in the queue, take the first one and walk
@@ -259,16 +304,23 @@ do_event(void)
    */
 
   if(nevents > 0) {
+
+    /* There are events that we should deliver. Take them from the
+       highest priority level that has any. */
+    q = &queues[NUM_QUEUES - 1];
+    while(q->nevents == 0) {
+      --q;
+    }
+
+    ev = q->events[q->fevent].ev;
     
-    /* There are events that we should deliver. */
-    ev = events[fevent].ev;
-    
-    data = events[fevent].data;
-    receiver = events[fevent].p;
+    data = q->events[q->fevent].data;
+    receiver = q->events[q->fevent].p;
 
     /* Since we have seen the new event, we move pointer upwards
        and decrease the number of events. */
-    fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
+    q->fevent = (q->fevent + 1) % q->size;
+    --q->nevents;
     --nevents;
 
     /* If this is a broadcast event, we deliver it to all events, in
@@ -322,6 +374,7 @@ int
 process_post(struct process *p, process_event_t ev, process_data_t data)
 {
   process_num_events_t snum;
+  struct event_queue *q;
 
   if(PROCESS_CURRENT() == NULL) {
     PRINTF("process_post: NULL process posts event %d to process '%s', nevents %d\n",
@@ -332,7 +385,21 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
 	   p == PROCESS_BROADCAST? "<broadcast>": PROCESS_NAME_STRING(p), nevents);
   }
   
-  if(nevents == PROCESS_CONF_NUMEVENTS) {
+  q = &queues[0];
+#if PROCESS_CONF_PRIORITIES
+  /* Timer events and events for high-priority processes bypass the
+     normal queue. They never fall back to it when their own queue is
+     full, as that could reorder the events within it. */
+  if(ev == PROCESS_EVENT_TIMER ||
+     (p != PROCESS_BROADCAST && p->priority != PROCESS_PRIORITY_NORMAL)) {
+    q = &queues[1];
+  }
+#endif /* PROCESS_CONF_PRIORITIES */
+
+  if(q->nevents == q->size) {
+#if PROCESS_CONF_EVENT_STATS
+    process_event_dropped[ev]++;
+#endif /* PROCESS_CONF_EVENT_STATS */
 #if DEBUG
     if(p == PROCESS_BROADCAST) {
       printf("soft panic: event queue is full when broadcast event %d was posted from %s\n", ev, PROCESS_NAME_STRING(process_current));
@@ -343,21 +410,81 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
     return PROCESS_ERR_FULL;
   }
   
-  snum = (process_num_events_t)(fevent + nevents) % PROCESS_CONF_NUMEVENTS;
-  events[snum].ev = ev;
-  events[snum].data = data;
-  events[snum].p = p;
+  snum = (process_num_events_t)((q->fevent + q->nevents) % q->size);
+  q->events[snum].ev = ev;
+  q->events[snum].data = data;
+  q->events[snum].p = p;
+  ++q->nevents;
   ++nevents;
 
 #if PROCESS_CONF_STATS
   if(nevents > process_maxevents) {
     process_maxevents = nevents;
   }
+#if PROCESS_CONF_PRIORITIES
+  if(q != &queues[0] && q->nevents > process_maxevents_high) {
+    process_maxevents_high = q->nevents;
+  }
+#endif /* PROCESS_CONF_PRIORITIES */
 #endif /* PROCESS_CONF_STATS */
+#if PROCESS_CONF_EVENT_STATS
+  process_event_posted[ev]++;
+#endif /* PROCESS_CONF_EVENT_STATS */
   
   return PROCESS_ERR_OK;
 }
 /*---------------------------------------------------------------------------*/
+int
+process_cancel_event(struct process *p, process_event_t ev,
+                     process_data_t data)
+{
+  struct event_queue *q;
+  struct event_data *e;
+  process_num_events_t i, kept;
+  int cancelled;
+
+  cancelled = 0;
+  for(q = &queues[0]; q < &queues[NUM_QUEUES]; q++) {
+    /* Move the events that are kept towards the front of the ring. */
+    kept = 0;
+    for(i = 0; i < q->nevents; i++) {
+      e = &q->events[(q->fevent + i) % q->size];
+      if(e->p == p && e->ev == ev && e->data == data) {
+        continue;
+      }
+      if(kept != i) {
+        q->events[(q->fevent + kept) % q->size] = *e;
+      }
+      kept++;
+    }
+    cancelled += q->nevents - kept;
+    nevents -= q->nevents - kept;
+    q->nevents = kept;
+  }
+  return cancelled;
+}
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_PRIORITIES
+void
+process_set_priority(struct process *p, unsigned char priority)
+{
+  p->priority = priority;
+}
+#endif /* PROCESS_CONF_PRIORITIES */
+/*---------------------------------------------------------------------------*/
+#if PROCESS_CONF_EVENT_STATS
+void
+process_event_stats_reset(void)
+{
+  unsigned short i;
+
+  for(i = 0; i < PROCESS_NUM_EVENT_TYPES; i++) {
+    process_event_posted[i] = 0;
+    process_event_dropped[i] = 0;
+  }
+}
+#endif /* PROCESS_CONF_EVENT_STATS */
+/*---------------------------------------------------------------------------*/
 void
 process_post_synch(struct process *p, process_event_t ev, process_data_t data)
 {
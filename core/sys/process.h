@@ -88,6 +88,45 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/*
+ * If PROCESS_CONF_PRIORITIES is set, the kernel keeps a second,
+ * high-priority event queue of PROCESS_CONF_NUMEVENTS_HIGH entries
+ * that is always drained before the normal one. Timer events, and
+ * events posted to processes marked with process_set_priority(), go
+ * to the high-priority queue, so that they are not delayed by an
+ * application backlog. Events are delivered in the order they were
+ * posted only within each queue: a timer event overtakes the normal
+ * events already queued for the same process, even for a process of
+ * normal priority, and a broadcast event, which always goes to the
+ * normal queue, lags behind the events posted later directly to a
+ * high-priority process. When the high-priority queue is full,
+ * posting such events fails with PROCESS_ERR_FULL rather than falling
+ * back to the normal queue.
+ */
+#ifndef PROCESS_CONF_PRIORITIES
+#define PROCESS_CONF_PRIORITIES 0
+#endif /* PROCESS_CONF_PRIORITIES */
+
+#ifndef PROCESS_CONF_NUMEVENTS_HIGH
+#define PROCESS_CONF_NUMEVENTS_HIGH 8
+#endif /* PROCESS_CONF_NUMEVENTS_HIGH */
+
+#define PROCESS_PRIORITY_NORMAL 0
+#define PROCESS_PRIORITY_HIGH   1
+
+/*
+ * If PROCESS_CONF_EVENT_STATS is set, the kernel counts, for every
+ * event type, the events that were posted and those that were
+ * dropped because the queue was full. This costs four bytes of RAM
+ * per event type, so it is meant for sizing the queues rather than
+ * for deployment.
+ */
+#ifndef PROCESS_CONF_EVENT_STATS
+#define PROCESS_CONF_EVENT_STATS 0
+#endif /* PROCESS_CONF_EVENT_STATS */
+
+#define PROCESS_NUM_EVENT_TYPES 256
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -323,6 +362,9 @@ struct process {
   PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
   struct pt pt;
   unsigned char state, needspoll;
+#if PROCESS_CONF_PRIORITIES
+  unsigned char priority;
+#endif /* PROCESS_CONF_PRIORITIES */
 };
 
 /**
@@ -364,6 +406,25 @@ CCIF void process_start(struct process *p, process_data_t data);
  */
 CCIF int process_post(struct process *p, process_event_t ev, process_data_t data);
 
+/**
+ * Cancel a posted event that has not been delivered yet.
+ *
+ * This function removes all events that match the given process,
+ * event and data from the event queues, for instance because the data
+ * is about to become invalid. The order of the remaining events is
+ * kept. It takes time proportional to the number of queued events.
+ *
+ * \param p The process to which the event was posted.
+ *
+ * \param ev The event that was posted.
+ *
+ * \param data The auxiliary data that was posted with the event.
+ *
+ * \return The number of events that were cancelled.
+ */
+int process_cancel_event(struct process *p, process_event_t ev,
+                         process_data_t data);
+
 /**
  * Post a synchronous event to a process.
  *
@@ -452,6 +513,63 @@ process_current = p
  */
 CCIF process_event_t process_alloc_event(void);
 
+/**
+ * \brief      Set the scheduling priority of a process.
+ * \param p    The process
+ * \param priority PROCESS_PRIORITY_NORMAL or PROCESS_PRIORITY_HIGH
+ *
+ *             Events posted to a process of high priority are
+ *             delivered before all pending events of normal
+ *             priority. Without PROCESS_CONF_PRIORITIES, all
+ *             processes have the same priority and this does
+ *             nothing.
+ */
+#if PROCESS_CONF_PRIORITIES
+CCIF void process_set_priority(struct process *p, unsigned char priority);
+#else /* PROCESS_CONF_PRIORITIES */
+#define process_set_priority(p, priority)
+#endif /* PROCESS_CONF_PRIORITIES */
+
+/** @} */
+
+/**
+ * \name Event queue statistics
+ * @{
+ */
+
+#if PROCESS_CONF_STATS
+/**
+ * The largest number of events that have been queued at the same
+ * time, over all priority levels.
+ */
+extern process_num_events_t process_maxevents;
+#if PROCESS_CONF_PRIORITIES
+/**
+ * The largest number of events that have been in the high-priority
+ * event queue at the same time.
+ */
+extern process_num_events_t process_maxevents_high;
+#endif /* PROCESS_CONF_PRIORITIES */
+#endif /* PROCESS_CONF_STATS */
+
+#if PROCESS_CONF_EVENT_STATS
+/**
+ * The number of events of each type that have been queued by
+ * process_post().
+ */
+extern unsigned short process_event_posted[PROCESS_NUM_EVENT_TYPES];
+/**
+ * The number of events of each type that process_post() has
+ * rejected with PROCESS_ERR_FULL.
+ */
+extern unsigned short process_event_dropped[PROCESS_NUM_EVENT_TYPES];
+
+/**
+ * Reset the per-event-type counters.
+ */
+void process_event_stats_reset(void);
+#endif /* PROCESS_CONF_EVENT_STATS */
+
 /** @} */
 
 /**
@@ -891,6 +891,21 @@ prepare(const void *payload, unsigned short payload_len)
 }
 /*---------------------------------------------------------------------------*/
 static int
+prepare_segments(const struct radio_segment *segs, unsigned short num_segs)
+{
+  int offset = 0;
+  int len;
+  unsigned short i;
+
+  for(i = 0; i < num_segs && offset < TX_BUF_PAYLOAD_LEN; i++) {
+    len = MIN(segs[i].len, TX_BUF_PAYLOAD_LEN - offset);
+    memcpy(&tx_buf[TX_BUF_HDR_LEN + offset], segs[i].ptr, len);
+    offset += len;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
 transmit(unsigned short transmit_len)
 {
   int ret;
@@ -1642,6 +1657,7 @@ const struct radio_driver ieee_mode_driver = {
   set_value,
   get_object,
   set_object,
+  prepare_segments,
 };
 /*---------------------------------------------------------------------------*/
 /**
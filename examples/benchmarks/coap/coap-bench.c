@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A native benchmark of CoAP observe notifications: one resource
+ *         with NUM_OBSERVERS observers, each with a token of a different
+ *         length, is notified NUM_ROUNDS times. It reports the time per
+ *         notification and the number of GET handler calls. The link
+ *         step wraps coap_send_message(), so that the datagrams are
+ *         captured instead of sent. Every notification, non-confirmable
+ *         or confirmable, is compared byte for byte against a message
+ *         serialized for its observer, and the confirmable ones, sent
+ *         every COAP_OBSERVE_REFRESH_INTERVAL rounds, are then
+ *         acknowledged. Build with
+ *         DEFINES=COAP_OBSERVE_RENDER_ONCE=0 to compare against rendering
+ *         every notification separately.
+ */
+
+#include "contiki.h"
+#include "rest-engine.h"
+#include "er-coap.h"
+#include "er-coap-observe.h"
+#include "er-coap-transactions.h"
+
+#include "bench-tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_OBSERVERS COAP_MAX_OBSERVERS
+#define NUM_ROUNDS    2000
+
+static void res_get_handler(void *request, void *response, uint8_t *buffer,
+                            uint16_t preferred_size, int32_t *offset);
+
+EVENT_RESOURCE(res_bench, "obs", res_get_handler, NULL, NULL, NULL, NULL);
+
+static uint32_t reading;
+static unsigned long handler_calls;
+
+/* The datagrams of a round, in the order they were sent */
+struct sent_message {
+  uip_ipaddr_t addr;
+  uint16_t len;
+  uint8_t data[COAP_MAX_PACKET_SIZE];
+};
+static struct sent_message sent[NUM_OBSERVERS];
+static int num_sent;
+
+void __wrap_coap_send_message(uip_ipaddr_t *addr, uint16_t port,
+                              uint8_t *data, uint16_t length);
+/*---------------------------------------------------------------------------*/
+/* Called instead of coap_send_message(), see the Makefile */
+void
+__wrap_coap_send_message(uip_ipaddr_t *addr, uint16_t port, uint8_t *data,
+                         uint16_t length)
+{
+  if(num_sent == NUM_OBSERVERS || length > COAP_MAX_PACKET_SIZE) {
+    printf("coap-bench: unexpected datagram of %u bytes\n", length);
+    exit(1);
+  }
+  uip_ipaddr_copy(&sent[num_sent].addr, addr);
+  sent[num_sent].len = length;
+  memcpy(sent[num_sent].data, data, length);
+  ++num_sent;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill_response(void *response, uint8_t *buffer, uint16_t preferred_size)
+{
+  uint8_t etag[4];
+
+  /* The ETag precedes and Content-Format and Max-Age follow Observe */
+  memcpy(etag, &reading, sizeof(etag));
+  coap_set_header_etag(response, etag, sizeof(etag));
+  coap_set_header_content_format(response, APPLICATION_JSON);
+  coap_set_header_max_age(response, 60);
+  coap_set_payload(response, buffer,
+                   snprintf((char *)buffer, preferred_size,
+                            "{\"temp\":%lu.%02lu,\"seq\":%lu}",
+                            (unsigned long)(reading % 4000) / 100,
+                            (unsigned long)reading % 100,
+                            (unsigned long)reading));
+}
+/*---------------------------------------------------------------------------*/
+static void
+res_get_handler(void *request, void *response, uint8_t *buffer,
+                uint16_t preferred_size, int32_t *offset)
+{
+  ++handler_calls;
+  fill_response(response, buffer, preferred_size);
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_observers(void)
+{
+  coap_packet_t request[1];
+  coap_packet_t response[1];
+  uint8_t token[COAP_TOKEN_LEN];
+  int i;
+
+  for(i = 0; i < NUM_OBSERVERS; ++i) {
+    uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfe80, 0, 0, 0, 0, 0, 0, i + 1);
+    UIP_UDP_BUF->srcport = UIP_HTONS(COAP_DEFAULT_PORT);
+    memset(token, i, sizeof(token));
+
+    coap_init_message(request, COAP_TYPE_CON, COAP_GET, i);
+    coap_set_header_uri_path(request, "bench");
+    coap_set_header_observe(request, 0);
+    coap_set_token(request, token, 1 + i % COAP_TOKEN_LEN);
+    coap_init_message(response, COAP_TYPE_ACK, CONTENT_2_05, i);
+    coap_observe_handler(&res_bench, request, response);
+  }
+  if(list_length(coap_get_observers()) != NUM_OBSERVERS) {
+    printf("coap-bench: could not add %u observers\n", NUM_OBSERVERS);
+    exit(1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static coap_observer_t *
+find_observer(const uip_ipaddr_t *addr)
+{
+  coap_observer_t *obs;
+
+  for(obs = list_head(coap_get_observers()); obs != NULL; obs = obs->next) {
+    if(uip_ipaddr_cmp(&obs->addr, addr)) {
+      return obs;
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Checks the notifications of a round, one for each observer, and
+   acknowledges the confirmable ones. Returns how many were confirmable. */
+static int
+check_and_ack(void)
+{
+  static coap_observer_t *notified[NUM_OBSERVERS];
+  coap_observer_t *obs;
+  coap_transaction_t *t;
+  coap_packet_t expected[1];
+  coap_message_type_t type;
+  uint8_t packet[COAP_MAX_PACKET_SIZE + 1];
+  uint8_t payload[REST_MAX_CHUNK_SIZE];
+  uint32_t observe;
+  uint16_t mid;
+  size_t len;
+  int confirmable = 0;
+  int i, j;
+
+  if(num_sent != NUM_OBSERVERS) {
+    printf("coap-bench: %d notifications for %u observers\n",
+           num_sent, NUM_OBSERVERS);
+    exit(1);
+  }
+  for(i = 0; i < num_sent; ++i) {
+    obs = find_observer(&sent[i].addr);
+    for(j = 0; j < i; ++j) {
+      if(notified[j] == obs) {
+        obs = NULL;
+      }
+    }
+    mid = (sent[i].data[2] << 8) | sent[i].data[3];
+    if(obs == NULL || sent[i].len < COAP_HEADER_LEN || mid != obs->last_mid) {
+      printf("coap-bench: notification %d not for a new observer\n", i);
+      exit(1);
+    }
+    notified[i] = obs;
+
+    observe = obs->obs_counter - 1;
+    type = observe % COAP_OBSERVE_REFRESH_INTERVAL == 0
+      ? COAP_TYPE_CON : COAP_TYPE_NON;
+    coap_init_message(expected, type, CONTENT_2_05, mid);
+    fill_response(expected, payload, sizeof(payload));
+    coap_set_header_observe(expected, observe);
+    coap_set_token(expected, obs->token, obs->token_len);
+    len = coap_serialize_message(expected, packet);
+    if(len != sent[i].len || memcmp(packet, sent[i].data, len) != 0) {
+      printf("coap-bench: wrong notification for MID %u\n", mid);
+      exit(1);
+    }
+
+    t = coap_get_transaction_by_mid(mid);
+    if((t != NULL) != (type == COAP_TYPE_CON)) {
+      printf("coap-bench: transaction of MID %u %s\n", mid,
+             t != NULL ? "kept" : "lost");
+      exit(1);
+    }
+    if(t != NULL) {
+      ++confirmable;
+      coap_clear_transaction(t);
+    }
+  }
+  num_sent = 0;
+  return confirmable;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(coap_bench_process, "CoAP observe benchmark");
+AUTOSTART_PROCESSES(&coap_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coap_bench_process, ev, data)
+{
+  static unsigned long confirmable;
+  static double ns;
+  double start;
+  int i;
+
+  PROCESS_BEGIN();
+
+  rest_init_engine();
+  rest_activate_resource(&res_bench, "bench");
+  add_observers();
+
+  confirmable = 0;
+  ns = 0;
+  for(i = 0; i < NUM_ROUNDS; ++i) {
+    ++reading;
+    start = bench_now_ns();
+    coap_notify_observers(&res_bench);
+    ns += bench_now_ns() - start;
+    confirmable += check_and_ack();
+  }
+
+  printf("[BM] CoAP observe render once %u, %u observers\n",
+         (unsigned)COAP_OBSERVE_RENDER_ONCE, NUM_OBSERVERS);
+  printf("[BM] notify: %8.1f ns/notification, %lu handler calls, "
+         "%lu notifications checked, %lu of them confirmable\n",
+         ns / ((double)NUM_ROUNDS * NUM_OBSERVERS), handler_calls,
+         (unsigned long)NUM_ROUNDS * NUM_OBSERVERS, confirmable);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A native benchmark of opening Coffee files that are not cached,
+ *         on the emulated flash, with 100 to 1500 small files, for files
+ *         that exist and for ones that do not. Files are removed and
+ *         created again in between, and every open is checked against
+ *         the contents written. Build with DEFINES=COFFEE_NAME_INDEX_SIZE=0
+ *         to compare against the flash scans.
+ *
+ *         A second part keeps a rolling log of records that fill half of
+ *         the flash, and yields between records, as a logger would. It
+ *         reports the worst time to write a record and where the sectors
+ *         got erased. Build with DEFINES=COFFEE_BACKGROUND_GC=0 to compare
+ *         against collecting the garbage when space runs out.
+ */
+
+#include "contiki.h"
+#include "cfs/cfs.h"
+#include "cfs/cfs-coffee.h"
+
+#include "bench-tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUM_OPENS 20000UL
+
+#define RECORD_SIZE    4000
+#define LIVE_RECORDS   128
+#define NUM_RECORDS    4000
+
+static unsigned long rand_state;
+/*---------------------------------------------------------------------------*/
+static unsigned
+next_rand(void)
+{
+  rand_state = rand_state * 1103515245UL + 12345UL;
+  return (unsigned)((rand_state >> 16) & 0x7fffUL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+make_name(char *name, unsigned generation, unsigned n)
+{
+  sprintf(name, "log-%u-%u", generation, n);
+}
+/*---------------------------------------------------------------------------*/
+static void
+create_file(unsigned generation, unsigned n)
+{
+  char name[16];
+  int fd;
+
+  make_name(name, generation, n);
+  /* Files opened for writing get COFFEE_DYN_SIZE bytes otherwise */
+  if(cfs_coffee_reserve(name, strlen(name)) < 0) {
+    printf("coffee-bench: cannot reserve %s\n", name);
+    exit(1);
+  }
+  /* Each file holds its name */
+  fd = cfs_open(name, CFS_WRITE);
+  if(fd < 0 || cfs_write(fd, name, strlen(name)) != strlen(name)) {
+    printf("coffee-bench: cannot create %s\n", name);
+    exit(1);
+  }
+  cfs_close(fd);
+}
+/*---------------------------------------------------------------------------*/
+/* Opens files of a given generation, which must exist iff "exist" is set,
+   and checks their contents */
+static double
+run_opens(unsigned generation, unsigned num, int exist)
+{
+  char name[16];
+  char stored[16];
+  unsigned long op;
+  unsigned n;
+  double start;
+  int fd, len;
+
+  rand_state = 1;
+  start = bench_now_ns();
+  for(op = 0; op < NUM_OPENS; ++op) {
+    n = next_rand() % num;
+    make_name(name, generation, n);
+    fd = cfs_open(name, CFS_READ);
+    if(exist) {
+      len = fd < 0 ? -1 : cfs_read(fd, stored, sizeof(stored) - 1);
+      if(len >= 0) {
+        stored[len] = '\0';
+      }
+      if(len < 0 || strcmp(stored, name) != 0) {
+        printf("coffee-bench: %s not found\n", name);
+        exit(1);
+      }
+    } else if(fd >= 0) {
+      printf("coffee-bench: %s found\n", name);
+      exit(1);
+    }
+    cfs_close(fd);
+  }
+  return (bench_now_ns() - start) / NUM_OPENS;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill_record(char *buf, unsigned n)
+{
+  memset(buf, n % 251 + 1, RECORD_SIZE);
+  sprintf(buf, "rec-%u", n);
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_record(unsigned n)
+{
+  static char buf[RECORD_SIZE];
+  char name[16];
+  int fd;
+
+  fill_record(buf, n);
+  sprintf(name, "rec-%u", n);
+  if(cfs_coffee_reserve(name, RECORD_SIZE) < 0) {
+    printf("coffee-bench: cannot reserve %s\n", name);
+    exit(1);
+  }
+  fd = cfs_open(name, CFS_WRITE);
+  if(fd < 0 || cfs_write(fd, buf, RECORD_SIZE) != RECORD_SIZE) {
+    printf("coffee-bench: cannot write %s\n", name);
+    exit(1);
+  }
+  cfs_close(fd);
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_record(unsigned n)
+{
+  static char expected[RECORD_SIZE];
+  static char stored[RECORD_SIZE];
+  char name[16];
+  int fd;
+
+  fill_record(expected, n);
+  sprintf(name, "rec-%u", n);
+  fd = cfs_open(name, CFS_READ);
+  if(fd < 0 || cfs_read(fd, stored, RECORD_SIZE) != RECORD_SIZE ||
+     memcmp(stored, expected, RECORD_SIZE) != 0) {
+    printf("coffee-bench: %s is corrupt\n", name);
+    exit(1);
+  }
+  cfs_close(fd);
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_record(unsigned n)
+{
+  char name[16];
+
+  sprintf(name, "rec-%u", n);
+  if(cfs_remove(name) < 0) {
+    printf("coffee-bench: cannot remove %s\n", name);
+    exit(1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(coffee_bench_process, "Coffee benchmark");
+AUTOSTART_PROCESSES(&coffee_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(coffee_bench_process, ev, data)
+{
+  static const unsigned nums[] = { 100, 500, 1500 };
+  static unsigned record;
+  static double worst_ns, total_ns;
+  struct cfs_coffee_gc_stats stats;
+  unsigned long erasures, min_erasures, max_erasures;
+  char name[16];
+  unsigned n, i;
+  double hit_ns, miss_ns, start;
+
+  PROCESS_BEGIN();
+
+  printf("[BM] name index size %u\n", (unsigned)COFFEE_NAME_INDEX_SIZE);
+  for(n = 0; n < sizeof(nums) / sizeof(nums[0]); ++n) {
+    cfs_coffee_format();
+    for(i = 0; i < nums[n]; ++i) {
+      create_file(0, i);
+    }
+    /* Replace every third file by one of a new generation */
+    for(i = 0; i < nums[n]; i += 3) {
+      make_name(name, 0, i);
+      if(cfs_remove(name) < 0) {
+        printf("coffee-bench: cannot remove %s\n", name);
+        exit(1);
+      }
+      create_file(1, i);
+      create_file(0, i);
+    }
+    hit_ns = run_opens(0, nums[n], 1);
+    miss_ns = run_opens(2, nums[n], 0);
+    printf("[BM] %4u files: %8.1f ns/open of a file, %8.1f ns/open of a missing file\n",
+           nums[n], hit_ns, miss_ns);
+  }
+
+  printf("[BM] background GC %u\n", (unsigned)COFFEE_BACKGROUND_GC);
+  cfs_coffee_format();
+  worst_ns = total_ns = 0;
+  for(record = 0; record < NUM_RECORDS; ++record) {
+    start = bench_now_ns();
+    write_record(record);
+    start = bench_now_ns() - start;
+    total_ns += start;
+    if(start > worst_ns) {
+      worst_ns = start;
+    }
+    if(record >= LIVE_RECORDS) {
+      remove_record(record - LIVE_RECORDS);
+    }
+    PROCESS_PAUSE();
+  }
+  for(i = NUM_RECORDS - LIVE_RECORDS; i < NUM_RECORDS; ++i) {
+    check_record(i);
+  }
+
+  cfs_coffee_get_gc_stats(&stats);
+  min_erasures = max_erasures = cfs_coffee_get_sector_erasures(0);
+  for(i = 1; cfs_coffee_get_sector_erasures(i) > 0; ++i) {
+    erasures = cfs_coffee_get_sector_erasures(i);
+    if(erasures < min_erasures) {
+      min_erasures = erasures;
+    }
+    if(erasures > max_erasures) {
+      max_erasures = erasures;
+    }
+  }
+  printf("[BM] %u records: %8.1f ns/record on average, %8.1f ns worst\n",
+         NUM_RECORDS, total_ns / NUM_RECORDS, worst_ns);
+  printf("[BM] erasures: %lu foreground, %lu background, %lu to %lu per sector\n",
+         stats.foreground_erasures, stats.background_erasures,
+         min_erasures, max_erasures);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A native benchmark of CRC16 throughput, in MB/s, on 127-byte
+ *         frames and on 4 KB blocks, both for crc16_add() fed byte by
+ *         byte and for crc16_data() as configured. The two are checked
+ *         to agree first. Build with DEFINES=CRC16_CONF_SLICE_BY=1 (or
+ *         4), or with DEFINES=CRC16_CONF_WITH_TABLE=0, to compare the
+ *         variants of crc16_data().
+ */
+
+#include "contiki.h"
+#include "lib/crc16.h"
+#include "lib/random.h"
+
+#include "bench-tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define FRAME_LEN   127
+#define BLOCK_LEN   4096
+#define TOTAL_BYTES (256UL * 1024 * 1024)
+
+static unsigned char buf[BLOCK_LEN];
+/*---------------------------------------------------------------------------*/
+static unsigned short
+crc16_bytewise(const unsigned char *data, int len, unsigned short acc)
+{
+  while(len-- > 0) {
+    acc = crc16_add(*data++, acc);
+  }
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench(const char *name, int len,
+      unsigned short (*crc)(const unsigned char *, int, unsigned short))
+{
+  unsigned long i;
+  unsigned long rounds;
+  unsigned short acc;
+  double start;
+
+  rounds = TOTAL_BYTES / len;
+  acc = 0;
+  start = bench_now_ns();
+  for(i = 0; i < rounds; ++i) {
+    /* Chaining the CRCs keeps the calls from being optimized away */
+    acc = crc(buf, len, acc);
+  }
+  start = bench_now_ns() - start;
+  printf("[BM] %s, %4d-byte buffers: %8.1f MB/s (%04x)\n",
+         name, len, (rounds * len) / (start / 1e9) / 1e6, acc);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(crc_bench_process, "CRC16 benchmark");
+AUTOSTART_PROCESSES(&crc_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(crc_bench_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < BLOCK_LEN; ++i) {
+    buf[i] = random_rand();
+  }
+  for(i = 0; i <= 64; ++i) {
+    if(crc16_data(buf + i, BLOCK_LEN - 64, i) !=
+       crc16_bytewise(buf + i, BLOCK_LEN - 64, i)) {
+      printf("crc-bench: crc16_data() disagrees with crc16_add()\n");
+      exit(1);
+    }
+  }
+
+  printf("[BM] CRC16 table %u, slice by %u\n",
+         (unsigned)CRC16_CONF_WITH_TABLE, (unsigned)CRC16_CONF_SLICE_BY);
+  bench("crc16_add ", FRAME_LEN, crc16_bytewise);
+  bench("crc16_add ", BLOCK_LEN, crc16_bytewise);
+  bench("crc16_data", FRAME_LEN, crc16_data);
+  bench("crc16_data", BLOCK_LEN, crc16_data);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A native benchmark of the software AES-128 and of CCM* on
+ *         frames with 20 bytes of header and 80 bytes of payload, in
+ *         time and, on x86, in cycles per byte. AES is checked against
+ *         the FIPS-197 example first, and every frame is decrypted and
+ *         checked again. Build with DEFINES=AES_128_CONF_WITH_T_TABLE=0
+ *         to compare against the byte-wise AES.
+ */
+
+#include "contiki.h"
+#include "lib/aes-128.h"
+#include "lib/ccm-star.h"
+
+#include "bench-tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define CYCLES() __rdtsc()
+#else
+#define CYCLES() 0
+#endif
+
+#define NUM_BLOCKS  1000000UL
+#define NUM_FRAMES  100000UL
+#define HDR_LEN     20
+#define PAYLOAD_LEN 80
+#define MIC_LEN     8
+
+/* FIPS-197, appendix C.1 */
+static const uint8_t fips_key[AES_128_KEY_LENGTH] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+static const uint8_t fips_plaintext[AES_128_BLOCK_SIZE] = {
+  0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+  0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff };
+static const uint8_t fips_ciphertext[AES_128_BLOCK_SIZE] = {
+  0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+  0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a };
+/*---------------------------------------------------------------------------*/
+static void
+bench_aes(void)
+{
+  uint8_t block[AES_128_BLOCK_SIZE];
+  unsigned long i;
+  unsigned long long cycles;
+  double start;
+
+  AES_128.set_key(fips_key);
+  memcpy(block, fips_plaintext, sizeof(block));
+  AES_128.encrypt(block);
+  if(memcmp(block, fips_ciphertext, sizeof(block)) != 0) {
+    printf("crypto-bench: wrong AES-128 ciphertext\n");
+    exit(1);
+  }
+
+  start = bench_now_ns();
+  cycles = CYCLES();
+  for(i = 0; i < NUM_BLOCKS; ++i) {
+    AES_128.encrypt(block);
+  }
+  cycles = CYCLES() - cycles;
+  start = bench_now_ns() - start;
+  printf("[BM] AES-128: %6.2f ns/byte, %6.1f cycles/byte (%02x)\n",
+         start / (NUM_BLOCKS * AES_128_BLOCK_SIZE),
+         (double)cycles / (NUM_BLOCKS * AES_128_BLOCK_SIZE), block[0]);
+}
+/*---------------------------------------------------------------------------*/
+static void
+bench_ccm_star(void)
+{
+  uint8_t nonce[CCM_STAR_NONCE_LENGTH];
+  uint8_t hdr[HDR_LEN];
+  uint8_t payload[PAYLOAD_LEN];
+  uint8_t sent[PAYLOAD_LEN];
+  uint8_t mic[MIC_LEN];
+  uint8_t check[MIC_LEN];
+  unsigned long i;
+  unsigned long long cycles;
+  double ns;
+
+  CCM_STAR.set_key(fips_key);
+  memset(nonce, 0xa5, sizeof(nonce));
+  memset(hdr, 0x3c, sizeof(hdr));
+  ns = 0;
+  cycles = 0;
+  for(i = 0; i < NUM_FRAMES; ++i) {
+    double start;
+    unsigned long long start_cycles;
+
+    /* A different frame counter and payload every time */
+    memcpy(nonce + 8, &i, 4);
+    memset(payload, i, sizeof(payload));
+    memcpy(sent, payload, sizeof(payload));
+
+    start = bench_now_ns();
+    start_cycles = CYCLES();
+    CCM_STAR.aead(nonce, payload, PAYLOAD_LEN, hdr, HDR_LEN, mic, MIC_LEN, 1);
+    cycles += CYCLES() - start_cycles;
+    ns += bench_now_ns() - start;
+
+    if(memcmp(payload, sent, sizeof(payload)) == 0) {
+      printf("crypto-bench: payload not encrypted\n");
+      exit(1);
+    }
+    CCM_STAR.aead(nonce, payload, PAYLOAD_LEN, hdr, HDR_LEN, check, MIC_LEN, 0);
+    if(memcmp(payload, sent, sizeof(payload)) != 0 ||
+       memcmp(mic, check, sizeof(mic)) != 0) {
+      printf("crypto-bench: frame %lu does not decrypt\n", i);
+      exit(1);
+    }
+  }
+  printf("[BM] CCM*: %6.2f ns/byte, %6.1f cycles/byte of %u-byte frames\n",
+         ns / (NUM_FRAMES * (HDR_LEN + PAYLOAD_LEN)),
+         (double)cycles / (NUM_FRAMES * (HDR_LEN + PAYLOAD_LEN)),
+         HDR_LEN + PAYLOAD_LEN);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(crypto_bench_process, "Crypto benchmark");
+AUTOSTART_PROCESSES(&crypto_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(crypto_bench_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("[BM] AES-128 T-table %u\n", (unsigned)AES_128_CONF_WITH_T_TABLE);
+  bench_aes();
+  bench_ccm_star();
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A native benchmark of CSMA queueing on a forwarding node with
+ *         2 to 64 neighbor queues, one of which is the broadcast queue,
+ *         each of which gets two packets queued at a time. It reports the
+ *         time to queue a packet, and how many packets were dropped and
+ *         how many sent, over the null RDC. The second pass runs with the
+ *         neighbor table filled by another, locked table, so that CSMA
+ *         gets no entries in it.
+ *         Build with DEFINES=CSMA_CONF_WITH_NBR_TABLE=0 to compare against
+ *         the list of CSMA_CONF_MAX_NEIGHBOR_QUEUES neighbor queues.
+ */
+
+#include "contiki.h"
+#include "net/mac/csma.h"
+#include "net/packetbuf.h"
+#include "net/nbr-table.h"
+
+#include "bench-tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_NEIGHBORS         64
+#define PACKETS_PER_NEIGHBOR  2
+#define NUM_ROUNDS            500
+#define MAX_PAUSES            1000
+
+static unsigned long num_sent, num_dropped, outstanding;
+
+/* Fills the neighbor table in the second pass */
+NBR_TABLE(uint8_t, other_table);
+/*---------------------------------------------------------------------------*/
+static void
+packet_sent(void *ptr, int status, int num_tx)
+{
+  if(status == MAC_TX_OK) {
+    ++num_sent;
+  } else {
+    ++num_dropped;
+  }
+  --outstanding;
+}
+/*---------------------------------------------------------------------------*/
+/* Adds locked entries until the neighbor table has no room left. The
+   entries of the first pass, which no table uses now, are only reused
+   when the neighbor table policy allows it. */
+static unsigned
+fill_nbr_table(void)
+{
+  linkaddr_t addr;
+  uint8_t *item;
+  unsigned i;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.u8[0] = 0x03;
+  for(i = 0; i < NBR_TABLE_MAX_NEIGHBORS; ++i) {
+    addr.u8[LINKADDR_SIZE - 2] = i >> 8;
+    addr.u8[LINKADDR_SIZE - 1] = i;
+    item = nbr_table_add_lladdr(other_table, &addr,
+                                NBR_TABLE_REASON_UNDEFINED, NULL);
+    if(item == NULL) {
+      break;
+    }
+    nbr_table_lock(other_table, item);
+  }
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+static void
+queue_packet(unsigned pass, unsigned neighbor, unsigned neighbors)
+{
+  linkaddr_t addr;
+
+  packetbuf_clear();
+  memset(packetbuf_dataptr(), neighbor, 50);
+  packetbuf_set_datalen(50);
+  if(neighbor == neighbors - 1) {
+    /* The last queue is the broadcast queue */
+    linkaddr_copy(&addr, &linkaddr_null);
+  } else {
+    memset(&addr, 0, sizeof(addr));
+    addr.u8[0] = 0x02;
+    /* New neighbors in each pass */
+    addr.u8[1] = pass;
+    addr.u8[LINKADDR_SIZE - 1] = neighbor + 1;
+  }
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &addr);
+  ++outstanding;
+  csma_driver.send(packet_sent, NULL);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(csma_bench_process, "CSMA benchmark");
+AUTOSTART_PROCESSES(&csma_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(csma_bench_process, ev, data)
+{
+  static unsigned full, neighbors, round, pauses;
+  static double queue_ns;
+  unsigned neighbor, packet;
+  double start;
+
+  PROCESS_BEGIN();
+
+  csma_driver.init();
+  nbr_table_register(other_table, NULL);
+
+  printf("[BM] CSMA queues in the neighbor table %u\n",
+         (unsigned)CSMA_CONF_WITH_NBR_TABLE);
+  for(full = 0; full <= 1; ++full) {
+    if(full) {
+      printf("[BM] Neighbor table filled with %u other entries\n",
+             fill_nbr_table());
+    }
+    for(neighbors = 2; neighbors <= MAX_NEIGHBORS; neighbors *= 2) {
+      num_sent = num_dropped = 0;
+      queue_ns = 0;
+      for(round = 0; round < NUM_ROUNDS; ++round) {
+        start = bench_now_ns();
+        for(packet = 0; packet < PACKETS_PER_NEIGHBOR; ++packet) {
+          for(neighbor = 0; neighbor < neighbors; ++neighbor) {
+            queue_packet(full, neighbor, neighbors);
+          }
+        }
+        queue_ns += bench_now_ns() - start;
+        /* Let the transmit timers send the queued packets */
+        for(pauses = 0; outstanding > 0 && pauses < MAX_PAUSES; ++pauses) {
+          PROCESS_PAUSE();
+        }
+        if(outstanding > 0) {
+          printf("csma-bench: %lu packets not sent\n", outstanding);
+          exit(1);
+        }
+      }
+      printf("[BM] %2u neighbors: %6.1f ns/packet queued, %6lu sent, %6lu dropped\n",
+             neighbors, queue_ns / (NUM_ROUNDS * PACKETS_PER_NEIGHBOR * neighbors),
+             num_sent, num_dropped);
+    }
+  }
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
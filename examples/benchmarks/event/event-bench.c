@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A native benchmark of the process event queue: how many
+ *         queued application events a timer event has to wait for,
+ *         and the cost of posting and delivering an event.
+ */
+
+#include "contiki.h"
+#include "sys/etimer.h"
+
+#include "bench-tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BATCH_SIZE 16
+#define NUM_BATCHES 100000UL
+
+static process_event_t app_event;
+static struct etimer et;
+static unsigned num_app_events;
+static int app_events_before_timer;
+/*---------------------------------------------------------------------------*/
+PROCESS(sink_process, "event sink");
+PROCESS_THREAD(sink_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD();
+    if(ev == app_event) {
+      ++num_app_events;
+    } else if(ev == PROCESS_EVENT_TIMER) {
+      app_events_before_timer = num_app_events;
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+/* A timer expires behind a backlog of application events. The
+   scheduler is run from here until all of them have been handled. */
+static int
+run_backlog(unsigned backlog)
+{
+  unsigned i;
+
+  num_app_events = 0;
+  app_events_before_timer = -1;
+  for(i = 0; i < backlog; ++i) {
+    process_post(&sink_process, app_event, NULL);
+  }
+  PROCESS_CONTEXT_BEGIN(&sink_process);
+  etimer_set(&et, 0);
+  PROCESS_CONTEXT_END(&sink_process);
+  etimer_request_poll();
+  while(num_app_events < backlog || app_events_before_timer < 0) {
+    process_run();
+  }
+  return app_events_before_timer;
+}
+/*---------------------------------------------------------------------------*/
+static double
+run_throughput(void)
+{
+  unsigned long batch;
+  unsigned i;
+  double start;
+
+  start = bench_now_ns();
+  for(batch = 0; batch < NUM_BATCHES; ++batch) {
+    for(i = 0; i < BATCH_SIZE; ++i) {
+      process_post(&sink_process, app_event, NULL);
+    }
+    while(process_run() > 0);
+  }
+  return (bench_now_ns() - start) / (NUM_BATCHES * BATCH_SIZE);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(event_bench_process, "event benchmark");
+AUTOSTART_PROCESSES(&event_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(event_bench_process, ev, data)
+{
+  static const unsigned backlogs[] = { 8, 16, 24 };
+  unsigned n;
+
+  PROCESS_BEGIN();
+
+  app_event = process_alloc_event();
+  process_start(&sink_process, NULL);
+
+  printf("[BM] priorities %s, queue of %u events\n",
+         PROCESS_CONF_PRIORITIES ? "on" : "off", PROCESS_CONF_NUMEVENTS);
+  for(n = 0; n < sizeof(backlogs) / sizeof(backlogs[0]); ++n) {
+    printf("[BM] %4u queued events: timer event delivered after %d of them\n",
+           backlogs[n], run_backlog(backlogs[n]));
+  }
+  printf("[BM] %8.1f ns/event posted and delivered\n", run_throughput());
+#if PROCESS_CONF_STATS
+  printf("[BM] queue high-water mark: %u\n", process_maxevents);
+#if PROCESS_CONF_PRIORITIES
+  printf("[BM] high-priority queue high-water mark: %u\n",
+         process_maxevents_high);
+#endif /* PROCESS_CONF_PRIORITIES */
+#endif /* PROCESS_CONF_STATS */
+#if PROCESS_CONF_EVENT_STATS
+  printf("[BM] application events: %u posted, %u dropped\n",
+         process_event_posted[app_event], process_event_dropped[app_event]);
+  printf("[BM] timer events: %u posted, %u dropped\n",
+         process_event_posted[PROCESS_EVENT_TIMER],
+         process_event_dropped[PROCESS_EVENT_TIMER]);
+#endif /* PROCESS_CONF_EVENT_STATS */
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
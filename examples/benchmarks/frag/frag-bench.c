@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A native benchmark of 6LoWPAN reassembly with 1 to 16 senders
+ *         whose fragments arrive interleaved, as at a border router under
+ *         convergecast traffic. Every reassembled packet is checked
+ *         against the one that was sent. Build with
+ *         DEFINES=SICSLOWPAN_CONF_REASS_IN_PLACE=0 to compare against the
+ *         shared fragment buffers.
+ */
+
+#include "contiki.h"
+#include "net/ip/uip.h"
+#include "net/ipv6/sicslowpan.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/rime/rime.h"
+
+#include "bench-tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SENDERS      16
+#define NUM_PACKETS      16000U
+#define PACKET_SIZE      384
+/* The first fragment carries the IPv6 header and 56 bytes after it */
+#define FRAG1_DATA_SIZE  96
+#define FRAGN_DATA_SIZE  96
+#define NUM_FRAGMENTS    (1 + (PACKET_SIZE - FRAG1_DATA_SIZE) / FRAGN_DATA_SIZE)
+
+static unsigned long delivered, corrupt;
+/*---------------------------------------------------------------------------*/
+/* The packets are not valid IPv6, so that uIP drops them after they have
+   been checked. Bytes 1 and 2 identify the sender and the packet. They
+   are made in advance so as not to be timed. */
+static uint8_t packets[MAX_SENDERS][256][PACKET_SIZE];
+/*---------------------------------------------------------------------------*/
+static void
+make_packets(void)
+{
+  unsigned sender, seqno, i;
+  uint8_t *packet;
+
+  for(sender = 0; sender < MAX_SENDERS; ++sender) {
+    for(seqno = 0; seqno < 256; ++seqno) {
+      packet = packets[sender][seqno];
+      packet[0] = 0;
+      packet[1] = sender;
+      packet[2] = seqno;
+      for(i = 3; i < PACKET_SIZE; ++i) {
+        packet[i] = i * 7 + sender * 13 + seqno;
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_input(void)
+{
+  uint8_t *packet;
+
+  packet = packets[uip_buf[UIP_LLH_LEN + 1] % MAX_SENDERS][uip_buf[UIP_LLH_LEN + 2]];
+  if(uip_len != PACKET_SIZE ||
+     memcmp(&uip_buf[UIP_LLH_LEN], packet, PACKET_SIZE) != 0) {
+    ++corrupt;
+  } else {
+    ++delivered;
+  }
+}
+RIME_SNIFFER(checker, check_input, NULL);
+/*---------------------------------------------------------------------------*/
+/* Puts fragment n of a packet into packetbuf and passes it to 6LoWPAN */
+static void
+input_fragment(unsigned sender, unsigned seqno, unsigned n)
+{
+  uint8_t *packet;
+  uint8_t *frame;
+  linkaddr_t addr;
+  unsigned offset, len;
+
+  packet = packets[sender][seqno & 0xff];
+  packetbuf_clear();
+  frame = packetbuf_dataptr();
+  frame[1] = PACKET_SIZE & 0xff;
+  frame[2] = seqno >> 8;
+  frame[3] = seqno & 0xff;
+  if(n == 0) {
+    frame[0] = SICSLOWPAN_DISPATCH_FRAG1 | (PACKET_SIZE >> 8);
+    frame[4] = SICSLOWPAN_DISPATCH_IPV6;
+    memcpy(frame + 5, packet, FRAG1_DATA_SIZE);
+    len = 5 + FRAG1_DATA_SIZE;
+  } else {
+    offset = FRAG1_DATA_SIZE + (n - 1) * FRAGN_DATA_SIZE;
+    frame[0] = SICSLOWPAN_DISPATCH_FRAGN | (PACKET_SIZE >> 8);
+    frame[4] = offset >> 3;
+    memcpy(frame + 5, packet + offset, FRAGN_DATA_SIZE);
+    len = 5 + FRAGN_DATA_SIZE;
+  }
+  packetbuf_set_datalen(len);
+
+  memset(&addr, 0, sizeof(addr));
+  addr.u8[0] = 0x02;
+  addr.u8[LINKADDR_SIZE - 1] = sender + 1;
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &addr);
+
+  sicslowpan_driver.input();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(frag_bench_process, "6LoWPAN reassembly benchmark");
+AUTOSTART_PROCESSES(&frag_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(frag_bench_process, ev, data)
+{
+  unsigned senders, sender, seqno, n;
+  uip_stats_t dropped;
+  double start;
+
+  PROCESS_BEGIN();
+
+  make_packets();
+  rime_sniffer_add(&checker);
+
+  printf("[BM] reassembly in place %u\n", (unsigned)SICSLOWPAN_CONF_REASS_IN_PLACE);
+  for(senders = 1; senders <= MAX_SENDERS; senders *= 2) {
+    delivered = corrupt = 0;
+    dropped = uip_stat.frag.drop;
+    start = bench_now_ns();
+    /* Each sender sends its packets one after another, and the
+       fragments of all senders are interleaved */
+    for(seqno = 0; seqno < NUM_PACKETS / senders; ++seqno) {
+      for(n = 0; n < NUM_FRAGMENTS; ++n) {
+        for(sender = 0; sender < senders; ++sender) {
+          input_fragment(sender, seqno, n);
+        }
+      }
+    }
+    start = bench_now_ns() - start;
+    if(corrupt > 0) {
+      printf("frag-bench: %lu corrupt packets\n", corrupt);
+      exit(1);
+    }
+    printf("[BM] %2u senders: %7.1f ns/fragment, %5lu of %5u packets reassembled, %5u fragments dropped\n",
+           senders, start / (NUM_PACKETS / senders * senders * NUM_FRAGMENTS),
+           delivered, NUM_PACKETS / senders * senders,
+           (unsigned)(uip_stats_t)(uip_stat.frag.drop - dropped));
+  }
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
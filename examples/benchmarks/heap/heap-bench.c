@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A native benchmark of the managed (mmem) and segregated-fit
+ *         (sfmem) memory allocators: the cost of freeing a random block
+ *         and allocating a block of random size in a 4 KB heap holding
+ *         32 to 128 blocks, and how many allocations fail.
+ */
+
+#include "contiki.h"
+#include "lib/mmem.h"
+#include "lib/sfmem.h"
+
+#include "bench-tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_OPS 200000UL
+#define MAX_BLOCKS 128
+
+struct allocator {
+  const char *name;
+  int (*alloc)(struct mmem *m, unsigned int size);
+  void (*release)(struct mmem *m);
+};
+
+static const struct allocator allocators[] = {
+  { "mmem", mmem_alloc, mmem_free },
+  { "sfmem", sfmem_alloc, sfmem_free },
+};
+
+static struct mmem blocks[MAX_BLOCKS];
+static unsigned char allocated[MAX_BLOCKS];
+static unsigned long num_failed;
+static unsigned long rand_state;
+/*---------------------------------------------------------------------------*/
+static unsigned
+next_rand(void)
+{
+  rand_state = rand_state * 1103515245UL + 12345UL;
+  return (unsigned)((rand_state >> 16) & 0x7fffUL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+alloc_block(const struct allocator *a, unsigned i, unsigned max_size)
+{
+  allocated[i] = a->alloc(&blocks[i], 1 + next_rand() % max_size);
+  if(!allocated[i]) {
+    ++num_failed;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Allocates num blocks and then, NUM_OPS times, frees a random block
+   and allocates one of a random size in its place. The average block
+   size is chosen such that the blocks fill about three quarters of
+   the heap. */
+static double
+run(const struct allocator *a, unsigned num)
+{
+  unsigned long op;
+  unsigned i, max_size;
+  double start, ns;
+
+  max_size = 2 * 2048 / num;
+  rand_state = 1;
+  num_failed = 0;
+  for(i = 0; i < num; ++i) {
+    alloc_block(a, i, max_size);
+  }
+  start = bench_now_ns();
+  for(op = 0; op < NUM_OPS; ++op) {
+    i = next_rand() % num;
+    if(allocated[i]) {
+      a->release(&blocks[i]);
+    }
+    alloc_block(a, i, max_size);
+  }
+  ns = (bench_now_ns() - start) / NUM_OPS;
+  for(i = num; i > 0; --i) {
+    if(allocated[i - 1]) {
+      a->release(&blocks[i - 1]);
+    }
+  }
+  return ns;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(heap_bench_process, "heap benchmark");
+AUTOSTART_PROCESSES(&heap_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(heap_bench_process, ev, data)
+{
+  static const unsigned nums[] = { 32, 64, 128 };
+  unsigned n, k;
+  double ns;
+
+  PROCESS_BEGIN();
+
+  mmem_init();
+  sfmem_init();
+
+  for(n = 0; n < sizeof(nums) / sizeof(nums[0]); ++n) {
+    for(k = 0; k < sizeof(allocators) / sizeof(allocators[0]); ++k) {
+      ns = run(&allocators[k], nums[n]);
+      printf("[BM] %3u blocks, %-5s: %7.1f ns/free+alloc, %5.2f%% allocations failed\n",
+             nums[n], allocators[k].name, ns,
+             100.0 * num_failed / (NUM_OPS + nums[n]));
+    }
+  }
+  printf("[BM] sfmem after the runs: %u bytes free, largest block %u bytes\n",
+         sfmem_avail(), sfmem_largest());
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
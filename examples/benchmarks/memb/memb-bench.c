@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A native benchmark of memb_alloc() and memb_free() on nearly
+ *         full pools of 8 to 256 blocks, compared with the linear scans
+ *         that memb used before it kept a free list.
+ */
+
+#include "contiki.h"
+#include "lib/memb.h"
+
+#include "bench-tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_OPS 2000000UL
+
+/* A block the size of a typical table entry. */
+struct bench_block {
+  struct bench_block *next;
+  uint8_t payload[28];
+};
+
+MEMB(memb8, struct bench_block, 8);
+MEMB(memb16, struct bench_block, 16);
+MEMB(memb32, struct bench_block, 32);
+MEMB(memb64, struct bench_block, 64);
+MEMB(memb128, struct bench_block, 128);
+MEMB(memb256, struct bench_block, 256);
+
+static struct memb *pools[] = {
+  &memb8, &memb16, &memb32, &memb64, &memb128, &memb256
+};
+
+static void *blocks[256];
+static unsigned long rand_state;
+/*---------------------------------------------------------------------------*/
+/* The previous implementation, kept for comparison. */
+static void *
+scan_alloc(struct memb *m)
+{
+  int i;
+
+  for(i = 0; i < m->num; ++i) {
+    if(m->count[i] == 0) {
+      ++(m->count[i]);
+      return (void *)((char *)m->mem + (i * m->size));
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static char
+scan_free(struct memb *m, void *ptr)
+{
+  int i;
+  char *ptr2;
+
+  ptr2 = (char *)m->mem;
+  for(i = 0; i < m->num; ++i) {
+    if(ptr2 == (char *)ptr) {
+      if(m->count[i] > 0) {
+        --(m->count[i]);
+      }
+      return m->count[i];
+    }
+    ptr2 += m->size;
+  }
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+next_rand(void)
+{
+  rand_state = rand_state * 1103515245UL + 12345UL;
+  return (unsigned)((rand_state >> 16) & 0x7fffUL);
+}
+/*---------------------------------------------------------------------------*/
+/* Fills a pool and then, NUM_OPS times, frees a random block and
+   allocates a replacement, which is the pattern of a busy table. */
+static double
+run(struct memb *m, void *(*alloc)(struct memb *),
+    char (*release)(struct memb *, void *))
+{
+  unsigned long op;
+  unsigned i;
+  double start;
+
+  memb_init(m);
+  for(i = 0; i < m->num; ++i) {
+    blocks[i] = alloc(m);
+  }
+  rand_state = 1;
+  start = bench_now_ns();
+  for(op = 0; op < NUM_OPS; ++op) {
+    i = next_rand() % m->num;
+    if(release(m, blocks[i]) != 0) {
+      printf("memb-bench: free failed\n");
+      exit(1);
+    }
+    blocks[i] = alloc(m);
+    if(blocks[i] == NULL) {
+      printf("memb-bench: alloc failed\n");
+      exit(1);
+    }
+  }
+  return (bench_now_ns() - start) / NUM_OPS;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(memb_bench_process, "memb benchmark");
+AUTOSTART_PROCESSES(&memb_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(memb_bench_process, ev, data)
+{
+  unsigned i;
+  double scan_ns, list_ns;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < sizeof(pools) / sizeof(pools[0]); ++i) {
+    scan_ns = run(pools[i], scan_alloc, scan_free);
+    list_ns = run(pools[i], memb_alloc, memb_free);
+    printf("[BM] %3u blocks: %7.1f ns/free+alloc with scans, %5.1f ns/free+alloc with free list\n",
+           pools[i]->num, scan_ns, list_ns);
+  }
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A native benchmark of neighbor table lookups by link-layer
+ *         address, with 16 to 256 neighbors, for neighbors that are in
+ *         the table and for ones that are not. Build with
+ *         DEFINES=NBR_TABLE_CONF_WITH_HASH_INDEX=0 to compare against
+ *         the linear scan.
+ */
+
+#include "contiki.h"
+#include "net/nbr-table.h"
+
+#include "bench-tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_LOOKUPS 1000000UL
+
+struct bench_nbr {
+  uint16_t seq;
+};
+
+NBR_TABLE(struct bench_nbr, bench_nbrs);
+
+static unsigned long rand_state;
+/*---------------------------------------------------------------------------*/
+static unsigned
+next_rand(void)
+{
+  rand_state = rand_state * 1103515245UL + 12345UL;
+  return (unsigned)((rand_state >> 16) & 0x7fffUL);
+}
+/*---------------------------------------------------------------------------*/
+/* Neighbors in a deployment typically share all but the last bytes of
+   their addresses. */
+static void
+make_lladdr(linkaddr_t *lladdr, unsigned n)
+{
+  linkaddr_copy(lladdr, &linkaddr_null);
+  lladdr->u8[0] = 0x02;
+  lladdr->u8[LINKADDR_SIZE - 2] = (n >> 8) & 0xff;
+  lladdr->u8[LINKADDR_SIZE - 1] = n & 0xff;
+}
+/*---------------------------------------------------------------------------*/
+static double
+run_lookups(unsigned num, unsigned offset)
+{
+  linkaddr_t lladdr;
+  unsigned long op;
+  unsigned found;
+  double start;
+
+  rand_state = 1;
+  found = 0;
+  start = bench_now_ns();
+  for(op = 0; op < NUM_LOOKUPS; ++op) {
+    make_lladdr(&lladdr, offset + next_rand() % num);
+    if(nbr_table_get_from_lladdr(bench_nbrs, &lladdr) != NULL) {
+      ++found;
+    }
+  }
+  if(found != (offset == 0 ? NUM_LOOKUPS : 0)) {
+    printf("nbr-bench: unexpected lookup result\n");
+    exit(1);
+  }
+  return (bench_now_ns() - start) / NUM_LOOKUPS;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(nbr_bench_process, "neighbor table benchmark");
+AUTOSTART_PROCESSES(&nbr_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(nbr_bench_process, ev, data)
+{
+  static const unsigned nums[] = { 16, 64, 256 };
+  linkaddr_t lladdr;
+  unsigned n, i;
+  double hit_ns, miss_ns;
+
+  PROCESS_BEGIN();
+
+  nbr_table_register(bench_nbrs, NULL);
+
+  printf("[BM] hash index %s\n", NBR_TABLE_WITH_HASH_INDEX ? "on" : "off");
+  i = 0;
+  for(n = 0; n < sizeof(nums) / sizeof(nums[0]); ++n) {
+    if(nums[n] > NBR_TABLE_MAX_NEIGHBORS) {
+      break;
+    }
+    for(; i < nums[n]; ++i) {
+      make_lladdr(&lladdr, i);
+      if(nbr_table_add_lladdr(bench_nbrs, &lladdr,
+                              NBR_TABLE_REASON_UNDEFINED, NULL) == NULL) {
+        printf("nbr-bench: add failed\n");
+        exit(1);
+      }
+    }
+    hit_ns = run_lookups(nums[n], 0);
+    miss_ns = run_lookups(nums[n], 0x1000);
+    printf("[BM] %3u neighbors: %6.1f ns/lookup of a neighbor, %6.1f ns/lookup of a stranger\n",
+           nums[n], hit_ns, miss_ns);
+  }
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A native benchmark of IPv6 routing table lookups with 1000 to
+ *         5000 host routes and a few prefix routes, as on a border
+ *         router. Build with DEFINES=UIP_CONF_DS6_ROUTE_TRIE=0 to compare
+ *         against the linear scan.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+
+#include "bench-tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_HOSTS 5000
+#define NUM_PREFIXES 16
+#define NUM_LOOKUPS 100000UL
+#define NUM_CHURN_OPS 10000UL
+
+static uip_ipaddr_t nexthop;
+static unsigned long rand_state;
+/*---------------------------------------------------------------------------*/
+static unsigned
+next_rand(void)
+{
+  rand_state = rand_state * 1103515245UL + 12345UL;
+  return (unsigned)((rand_state >> 16) & 0x7fffUL);
+}
+/*---------------------------------------------------------------------------*/
+/* Host n lives in one of the prefixes, with a scattered interface
+   identifier. */
+static void
+host_addr(uip_ipaddr_t *addr, unsigned n)
+{
+  uint32_t iid = n * 2654435761UL;
+
+  uip_ip6addr(addr, 0xfd00, 0, 0, n % NUM_PREFIXES, 0x0212, 0x7400,
+              iid >> 16, iid & 0xffff);
+}
+/*---------------------------------------------------------------------------*/
+/* The longest matching route, found the slow way. */
+static uip_ds6_route_t *
+scan_lookup(uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r, *found;
+
+  found = NULL;
+  for(r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+    if((found == NULL || r->length > found->length) &&
+       uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length)) {
+      found = r;
+    }
+  }
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_lookup(uip_ipaddr_t *addr)
+{
+  if(uip_ds6_route_lookup(addr) != scan_lookup(addr)) {
+    printf("route-bench: wrong route found\n");
+    exit(1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_route(uip_ipaddr_t *addr, uint8_t length)
+{
+  if(uip_ds6_route_add(addr, length, &nexthop) == NULL) {
+    printf("route-bench: add failed\n");
+    exit(1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static double
+run_lookups(unsigned num)
+{
+  uip_ipaddr_t addr;
+  unsigned long op;
+  double start;
+
+  rand_state = 1;
+  start = bench_now_ns();
+  for(op = 0; op < NUM_LOOKUPS; ++op) {
+    host_addr(&addr, next_rand() % num);
+    uip_ds6_route_lookup(&addr);
+  }
+  return (bench_now_ns() - start) / NUM_LOOKUPS;
+}
+/*---------------------------------------------------------------------------*/
+/* Removes a random host route and adds it again. */
+static double
+run_churn(unsigned num)
+{
+  uip_ipaddr_t addr;
+  unsigned long op;
+  double start;
+
+  rand_state = 2;
+  start = bench_now_ns();
+  for(op = 0; op < NUM_CHURN_OPS; ++op) {
+    host_addr(&addr, next_rand() % num);
+    uip_ds6_route_rm(uip_ds6_route_lookup(&addr));
+    add_route(&addr, 128);
+  }
+  return (bench_now_ns() - start) / NUM_CHURN_OPS;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(route_bench_process, "route benchmark");
+AUTOSTART_PROCESSES(&route_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(route_bench_process, ev, data)
+{
+  static const unsigned nums[] = { 1000, 2000, 5000 };
+  static uip_lladdr_t lladdr = { { 0x02, 0x12, 0x74, 0, 0, 0, 0, 1 } };
+  uip_ipaddr_t addr;
+  unsigned n, i;
+  double lookup_ns, churn_ns;
+
+  PROCESS_BEGIN();
+
+  /* Wait for the IPv6 stack to come up. */
+  PROCESS_PAUSE();
+
+  uip_ip6addr(&nexthop, 0xfe80, 0, 0, 0, 0x0012, 0x7400, 0, 1);
+  uip_ds6_nbr_add(&nexthop, &lladdr, 1, NBR_REACHABLE,
+                  NBR_TABLE_REASON_UNDEFINED, NULL);
+  for(i = 0; i < NUM_PREFIXES; ++i) {
+    uip_ip6addr(&addr, 0xfd00, 0, 0, i, 0, 0, 0, 0);
+    add_route(&addr, 64);
+  }
+
+  printf("[BM] route trie %s\n", UIP_DS6_ROUTE_TRIE ? "on" : "off");
+  i = 0;
+  for(n = 0; n < sizeof(nums) / sizeof(nums[0]); ++n) {
+    if(nums[n] + NUM_PREFIXES > UIP_DS6_ROUTE_NB) {
+      break;
+    }
+    for(; i < nums[n]; ++i) {
+      host_addr(&addr, i);
+      add_route(&addr, 128);
+    }
+    lookup_ns = run_lookups(nums[n]);
+    churn_ns = run_churn(nums[n]);
+    /* Check hosts, prefixes, and unknown destinations. */
+    for(i = 0; i < nums[n] + 100; ++i) {
+      host_addr(&addr, i);
+      check_lookup(&addr);
+      addr.u8[15] ^= 1;
+      check_lookup(&addr);
+    }
+    i = nums[n];
+    printf("[BM] %4u routes: %8.1f ns/lookup, %8.1f ns/remove+add\n",
+           nums[n] + NUM_PREFIXES, lookup_ns, churn_ns);
+  }
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A native benchmark of the source routes that a non-storing
+ *         RPL root computes for every downward packet, in a tree of 100
+ *         to 1000 nodes. Build with DEFINES=RPL_NS_CONF_WITH_HASH_INDEX=0,
+ *         RPL_NS_CONF_WITH_PATH_CACHE=0 to compare against the linear
+ *         scan and the uncached path walk.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/rpl/rpl.h"
+#include "net/rpl/rpl-ns.h"
+
+#include "bench-tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_PATHS 100000UL
+/* Each node has up to this many children. */
+#define FAN_OUT 3
+
+static rpl_dag_t *dag;
+static unsigned long rand_state;
+/*---------------------------------------------------------------------------*/
+static unsigned
+next_rand(void)
+{
+  rand_state = rand_state * 1103515245UL + 12345UL;
+  return (unsigned)((rand_state >> 16) & 0x7fffUL);
+}
+/*---------------------------------------------------------------------------*/
+/* Node 0 is the root. */
+static void
+node_addr(uip_ipaddr_t *addr, unsigned n)
+{
+  if(n == 0) {
+    uip_ipaddr_copy(addr, &dag->dag_id);
+  } else {
+    uip_ip6addr(addr, 0xfd00, 0, 0, 0, 0x0212, 0x7400, n >> 8, n & 0xff);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* A DAO from node n, which sits below node (n - 1) / FAN_OUT. */
+static void
+update_node(unsigned n)
+{
+  uip_ipaddr_t child, parent;
+
+  node_addr(&child, n);
+  node_addr(&parent, (n - 1) / FAN_OUT);
+  if(rpl_ns_update_node(dag, &child, &parent, 0xffffffff) == NULL) {
+    printf("srh-bench: update failed\n");
+    exit(1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The number of hops between node n and the root. */
+static uint8_t
+hops_to_root(unsigned n)
+{
+  uint8_t hops;
+
+  for(hops = 0; n != 0; n = (n - 1) / FAN_OUT) {
+    hops++;
+  }
+  return hops - 1;
+}
+/*---------------------------------------------------------------------------*/
+/* What the root does per downward packet before writing the header. */
+static double
+run_paths(unsigned num)
+{
+  uip_ipaddr_t addr;
+  rpl_ns_node_t *dest_node;
+  unsigned long op;
+  unsigned n;
+  uint8_t path_len, cmpr;
+  double start;
+
+  rand_state = 1;
+  start = bench_now_ns();
+  for(op = 0; op < NUM_PATHS; ++op) {
+    n = 1 + next_rand() % num;
+    node_addr(&addr, n);
+    dest_node = rpl_ns_get_node(dag, &addr);
+    if(dest_node == NULL || rpl_ns_get_node(dag, &dag->dag_id) == NULL ||
+       !rpl_ns_get_path(dag, dest_node, &path_len, &cmpr) ||
+       path_len != hops_to_root(n)) {
+      printf("srh-bench: wrong path\n");
+      exit(1);
+    }
+  }
+  return (bench_now_ns() - start) / NUM_PATHS;
+}
+/*---------------------------------------------------------------------------*/
+/* A DAO that refreshes a node with the parent it already has. */
+static double
+run_updates(unsigned num)
+{
+  unsigned long op;
+  double start;
+
+  rand_state = 2;
+  start = bench_now_ns();
+  for(op = 0; op < NUM_PATHS; ++op) {
+    update_node(1 + next_rand() % num);
+  }
+  return (bench_now_ns() - start) / NUM_PATHS;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(srh_bench_process, "source route benchmark");
+AUTOSTART_PROCESSES(&srh_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(srh_bench_process, ev, data)
+{
+  static const unsigned nums[] = { 100, 300, 1000 };
+  uip_ipaddr_t root_addr;
+  unsigned n, i;
+  double path_ns, update_ns;
+
+  PROCESS_BEGIN();
+
+  /* Wait for the IPv6 stack to come up. */
+  PROCESS_PAUSE();
+
+  uip_ip6addr(&root_addr, 0xfd00, 0, 0, 0, 0, 0, 0, 1);
+  dag = rpl_set_root(RPL_DEFAULT_INSTANCE, &root_addr);
+  if(dag == NULL) {
+    printf("srh-bench: no DAG\n");
+    exit(1);
+  }
+
+  printf("[BM] hash index %s, path cache %s\n",
+         RPL_NS_WITH_HASH_INDEX ? "on" : "off",
+         RPL_NS_WITH_PATH_CACHE ? "on" : "off");
+  i = 1;
+  for(n = 0; n < sizeof(nums) / sizeof(nums[0]); ++n) {
+    if(nums[n] >= RPL_NS_LINK_NUM) {
+      break;
+    }
+    for(; i <= nums[n]; ++i) {
+      update_node(i);
+    }
+    path_ns = run_paths(nums[n]);
+    update_ns = run_updates(nums[n]);
+    printf("[BM] %4u nodes: %8.1f ns/source route, %8.1f ns/DAO\n",
+           nums[n], path_ns, update_ns);
+  }
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
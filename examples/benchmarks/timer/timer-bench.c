@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A native benchmark of event and callback timers: the cost of
+ *         setting one of 10 to 1000 pending event timers again, and the
+ *         throughput of expiring that many event or callback timers at
+ *         once.
+ */
+
+#include "contiki.h"
+#include "sys/etimer.h"
+#include "sys/ctimer.h"
+
+#include "bench-tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_TIMERS 1000
+#define NUM_SET_OPS 20000UL
+
+static struct etimer etimers[MAX_TIMERS];
+static struct ctimer ctimers[MAX_TIMERS];
+static unsigned num_fired;
+static unsigned long rand_state;
+/*---------------------------------------------------------------------------*/
+static unsigned
+next_rand(void)
+{
+  rand_state = rand_state * 1103515245UL + 12345UL;
+  return (unsigned)((rand_state >> 16) & 0x7fffUL);
+}
+/*---------------------------------------------------------------------------*/
+/* An interval long enough for the timer not to expire during a run. */
+static clock_time_t
+long_interval(void)
+{
+  return 100 * CLOCK_SECOND + next_rand() % (100 * CLOCK_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+static double
+run_set(unsigned num)
+{
+  unsigned long op;
+  unsigned i;
+  double start, ns;
+
+  rand_state = 1;
+  for(i = 0; i < num; ++i) {
+    etimer_set(&etimers[i], long_interval());
+  }
+  start = bench_now_ns();
+  for(op = 0; op < NUM_SET_OPS; ++op) {
+    etimer_set(&etimers[next_rand() % num], long_interval());
+  }
+  ns = (bench_now_ns() - start) / NUM_SET_OPS;
+  for(i = 0; i < num; ++i) {
+    etimer_stop(&etimers[i]);
+  }
+  return ns;
+}
+/*---------------------------------------------------------------------------*/
+static void
+ctimer_fired(void *ptr)
+{
+  ++num_fired;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(sink_process, "timer sink");
+PROCESS_THREAD(sink_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER);
+    ++num_fired;
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+/* All timers expire at once. The scheduler is run from here until they
+   have been handled, so that the host main loop does not skew the
+   results. */
+static double
+run_expire(unsigned num, int callback)
+{
+  unsigned i;
+  double start;
+
+  num_fired = 0;
+  start = bench_now_ns();
+  for(i = 0; i < num; ++i) {
+    if(callback) {
+      ctimer_set(&ctimers[i], 0, ctimer_fired, NULL);
+    } else {
+      PROCESS_CONTEXT_BEGIN(&sink_process);
+      etimer_set(&etimers[i], 0);
+      PROCESS_CONTEXT_END(&sink_process);
+    }
+  }
+  while(num_fired < num) {
+    etimer_request_poll();
+    process_run();
+  }
+  return (bench_now_ns() - start) / num;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(timer_bench_process, "timer benchmark");
+AUTOSTART_PROCESSES(&timer_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(timer_bench_process, ev, data)
+{
+  static const unsigned nums[] = { 10, 100, 1000 };
+  unsigned n;
+  double set_ns, etimer_ns, ctimer_ns;
+
+  PROCESS_BEGIN();
+
+  process_start(&sink_process, NULL);
+  /* Let the callback timer process start. */
+  PROCESS_PAUSE();
+
+  for(n = 0; n < sizeof(nums) / sizeof(nums[0]); ++n) {
+    set_ns = run_set(nums[n]);
+    etimer_ns = run_expire(nums[n], 0);
+    ctimer_ns = run_expire(nums[n], 1);
+    printf("[BM] %4u timers: %8.1f ns/set, %8.1f ns/expired etimer, %8.1f ns/expired ctimer\n",
+           nums[n], set_ns, etimer_ns, ctimer_ns);
+  }
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
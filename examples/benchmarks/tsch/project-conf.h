@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#define TSCH_LOG_CONF_LEVEL 0
+#define TSCH_SCHEDULE_CONF_MAX_LINKS 256
+#ifndef TSCH_SCHEDULE_CONF_WITH_LINK_INDEX
+#define TSCH_SCHEDULE_CONF_WITH_LINK_INDEX 1
+#endif /* TSCH_SCHEDULE_CONF_WITH_LINK_INDEX */
+
+/* 64 neighbors, plus the broadcast and EB queues */
+#define QUEUEBUF_CONF_NUM 128
+#define TSCH_QUEUE_CONF_NUM_PER_NEIGHBOR 8
+#define TSCH_QUEUE_CONF_MAX_NEIGHBOR_QUEUES 66
+#ifndef TSCH_QUEUE_CONF_WITH_READY_INDEX
+#define TSCH_QUEUE_CONF_WITH_READY_INDEX 1
+#endif /* TSCH_QUEUE_CONF_WITH_READY_INDEX */
+#define TSCH_QUEUE_CONF_WITH_STATS 1
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+/**
+ * \file
+ *         A native benchmark of the TSCH work that runs at every slot
+ *         wake-up. First, the search for the next active link, with an
+ *         Orchestra-like schedule of up to 256 links, reporting the mean
+ *         and the worst time per slot. Build with
+ *         DEFINES=TSCH_SCHEDULE_CONF_WITH_LINK_INDEX=0 to compare against
+ *         the walk over all links; the checksums must match. Second, the
+ *         pick of a unicast packet in a shared slot, with 64 neighbors of
+ *         which all or only the last added have packets, reporting the
+ *         time per pick and how evenly the neighbors are served. Build
+ *         with DEFINES=TSCH_QUEUE_CONF_WITH_READY_INDEX=0 to compare
+ *         against the walk over all neighbors.
+ */
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-queue.h"
+#include "net/mac/tsch/tsch-schedule.h"
+
+#include "bench-tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Slots visited per schedule, and calls timed at each of them */
+#define NUM_SLOTS 2000
+#define NUM_ROUNDS 5
+#define NUM_REPEATS 20
+/* Size of the slotframe holding the unicast links */
+#define UNICAST_SIZE 257
+/* Unicast neighbors, and shared slots run with them */
+#define NUM_NBRS 64
+#define NUM_SHARED_SLOTS 1000000UL
+
+/* The rest of TSCH does not build on native: stand in for the parts
+   that the schedule and the queue use. */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff } };
+const linkaddr_t tsch_eb_address = { { 0 } };
+struct tsch_link *current_link;
+int tsch_is_coordinator = 1;
+
+void
+tsch_set_ka_timeout(uint32_t timeout)
+{
+}
+void
+tsch_schedule_keepalive(void)
+{
+}
+
+int
+tsch_is_locked(void)
+{
+  return 0;
+}
+int
+tsch_get_lock(void)
+{
+  return 1;
+}
+void
+tsch_release_lock(void)
+{
+}
+
+static unsigned long rand_state;
+/*---------------------------------------------------------------------------*/
+static unsigned
+next_rand(void)
+{
+  rand_state = rand_state * 1103515245UL + 12345UL;
+  return (unsigned)((rand_state >> 16) & 0x7fffUL);
+}
+/*---------------------------------------------------------------------------*/
+/* An EB slotframe, a shared slotframe and a unicast slotframe whose
+   timeslots are installed in random order, with a mix of Tx, Rx and
+   Tx|Rx links, some of which are then moved around. */
+static struct tsch_slotframe *
+build_schedule(unsigned num)
+{
+  struct tsch_slotframe *sf;
+  linkaddr_t addr;
+  unsigned i;
+
+  tsch_schedule_remove_all_slotframes();
+  sf = tsch_schedule_add_slotframe(0, 397);
+  tsch_schedule_add_link(sf, LINK_OPTION_TX, LINK_TYPE_ADVERTISING_ONLY,
+                         &tsch_broadcast_address, 0, 0);
+  sf = tsch_schedule_add_slotframe(1, 31);
+  tsch_schedule_add_link(sf, LINK_OPTION_TX | LINK_OPTION_RX | LINK_OPTION_SHARED,
+                         LINK_TYPE_NORMAL, &tsch_broadcast_address, 0, 1);
+  sf = tsch_schedule_add_slotframe(2, UNICAST_SIZE);
+  rand_state = 1;
+  /* Leave a link free for the moves */
+  for(i = 0; i < num - 3; ++i) {
+    static const uint8_t options[] = {
+      LINK_OPTION_TX, LINK_OPTION_RX, LINK_OPTION_TX | LINK_OPTION_RX | LINK_OPTION_SHARED
+    };
+    uint16_t timeslot;
+
+    do {
+      timeslot = next_rand() % UNICAST_SIZE;
+    } while(tsch_schedule_get_link_by_timeslot(sf, timeslot) != NULL);
+    linkaddr_copy(&addr, &linkaddr_null);
+    addr.u8[LINKADDR_SIZE - 1] = i;
+    if(tsch_schedule_add_link(sf, options[i % 3], LINK_TYPE_NORMAL,
+                              &addr, timeslot, 2) == NULL) {
+      printf("tsch-bench: add failed\n");
+      exit(1);
+    }
+  }
+  for(i = 0; i < num / 4; ++i) {
+    struct tsch_link *l;
+    uint16_t timeslot;
+
+    l = tsch_schedule_get_link_by_timeslot(sf, next_rand() % UNICAST_SIZE);
+    if(l == NULL) {
+      continue;
+    }
+    do {
+      timeslot = next_rand() % UNICAST_SIZE;
+    } while(tsch_schedule_get_link_by_timeslot(sf, timeslot) != NULL);
+    tsch_schedule_add_link(sf, l->link_options, LINK_TYPE_NORMAL,
+                           &l->addr, timeslot, 2);
+    tsch_schedule_remove_link(sf, l);
+  }
+  return sf;
+}
+/*---------------------------------------------------------------------------*/
+static void
+run_slots(unsigned num)
+{
+  struct tsch_asn_t asn;
+  struct tsch_link *backup;
+  struct tsch_link *l;
+  unsigned long checksum;
+  uint16_t offset;
+  double total, worst, start, ns, slot_ns;
+  unsigned slot, round, r;
+
+  TSCH_ASN_INIT(asn, 0, 0);
+  checksum = 0;
+  total = 0;
+  worst = 0;
+  for(slot = 0; slot < NUM_SLOTS; ++slot) {
+    /* Keep the fastest of a few rounds, to leave out preemptions */
+    slot_ns = 0;
+    for(round = 0; round < NUM_ROUNDS; ++round) {
+      start = bench_now_ns();
+      for(r = 0; r < NUM_REPEATS; ++r) {
+        l = tsch_schedule_get_next_active_link(&asn, &offset, &backup);
+      }
+      ns = (bench_now_ns() - start) / NUM_REPEATS;
+      if(round == 0 || ns < slot_ns) {
+        slot_ns = ns;
+      }
+    }
+    ns = slot_ns;
+    total += ns;
+    if(ns > worst) {
+      worst = ns;
+    }
+    if(l == NULL) {
+      printf("tsch-bench: no active link\n");
+      exit(1);
+    }
+    checksum = checksum * 31 + l->slotframe_handle * 1000UL + l->timeslot;
+    checksum = checksum * 31 + offset;
+    checksum = checksum * 31 + (backup != NULL ? backup->timeslot + 1 : 0);
+    /* Wake up at the next active link, as the slot operation does */
+    TSCH_ASN_INC(asn, offset);
+  }
+  printf("[BM] %3u links: %6.1f ns/slot on average, %6.1f ns/slot at worst, checksum %08lx\n",
+         num, total / NUM_SLOTS, worst, checksum & 0xffffffffUL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+make_nbr_addr(linkaddr_t *addr, unsigned i)
+{
+  linkaddr_copy(addr, &linkaddr_null);
+  addr->u8[0] = 0x02;
+  addr->u8[LINKADDR_SIZE - 1] = i + 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_packet(unsigned i)
+{
+  linkaddr_t addr;
+
+  make_nbr_addr(&addr, i);
+  packetbuf_clear();
+  packetbuf_set_datalen(40);
+  if(tsch_queue_add_packet(&addr, NULL, NULL) == NULL) {
+    printf("tsch-bench: enqueue failed\n");
+    exit(1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Runs shared slots, each sending the packet picked to the neighbor and
+   queueing a new one for it if all neighbors are to stay busy */
+static void
+run_shared_slots(int all_busy)
+{
+  static unsigned long served[NUM_NBRS];
+  struct tsch_link link;
+  struct tsch_neighbor *n;
+  struct tsch_packet *p;
+  linkaddr_t addr;
+  unsigned long slot, least, most;
+  double start, ns;
+  unsigned i, num_served;
+
+  tsch_queue_init();
+  /* Neighbors that stay idle come first in the neighbor list */
+  for(i = 0; i < NUM_NBRS; ++i) {
+    if(all_busy || i == NUM_NBRS - 1) {
+      add_packet(i);
+    } else {
+      make_nbr_addr(&addr, i);
+      tsch_queue_add_nbr(&addr);
+    }
+  }
+  memset(served, 0, sizeof(served));
+  memset(&link, 0, sizeof(link));
+  link.link_options = LINK_OPTION_TX | LINK_OPTION_RX | LINK_OPTION_SHARED;
+  ns = 0;
+  for(slot = 0; slot < NUM_SHARED_SLOTS; ++slot) {
+    /* Time the pick only, not the sending and queueing around it */
+    start = bench_now_ns();
+    p = tsch_queue_get_unicast_packet_for_any(&n, &link);
+    ns += bench_now_ns() - start;
+    if(p == NULL) {
+      printf("tsch-bench: no packet\n");
+      exit(1);
+    }
+    served[n->addr.u8[LINKADDR_SIZE - 1] - 1]++;
+    tsch_queue_remove_packet_from_queue(n);
+    tsch_queue_free_packet(p);
+    add_packet(n->addr.u8[LINKADDR_SIZE - 1] - 1);
+  }
+  ns /= NUM_SHARED_SLOTS;
+  num_served = 0;
+  least = NUM_SHARED_SLOTS;
+  most = 0;
+  for(i = 0; i < NUM_NBRS; ++i) {
+    if(served[i] != 0) {
+      num_served++;
+    }
+    if(served[i] < least) {
+      least = served[i];
+    }
+    if(served[i] > most) {
+      most = served[i];
+    }
+  }
+  printf("[BM] %2u of %u neighbors busy: %6.1f ns/pick, %2u served, %lu to %lu packets each\n",
+         all_busy ? NUM_NBRS : 1, NUM_NBRS, ns, num_served,
+         all_busy ? least : most, most);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS(tsch_bench_process, "TSCH schedule benchmark");
+AUTOSTART_PROCESSES(&tsch_bench_process);
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(tsch_bench_process, ev, data)
+{
+  static const unsigned nums[] = { 16, 64, 256 };
+  unsigned n;
+
+  PROCESS_BEGIN();
+
+  tsch_queue_init();
+  tsch_schedule_init();
+
+  printf("[BM] link index %s\n", TSCH_SCHEDULE_WITH_LINK_INDEX ? "on" : "off");
+  for(n = 0; n < sizeof(nums) / sizeof(nums[0]); ++n) {
+    if(nums[n] > TSCH_SCHEDULE_MAX_LINKS) {
+      break;
+    }
+    build_schedule(nums[n]);
+    run_slots(nums[n]);
+  }
+  tsch_schedule_remove_all_slotframes();
+
+  printf("[BM] ready index %s\n", TSCH_QUEUE_WITH_READY_INDEX ? "on" : "off");
+  run_shared_slots(0);
+  run_shared_slots(1);
+  exit(0);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -34,4 +34,13 @@
 
 #define UNIT_TEST_PRINT_FUNCTION test_print_report
 
+/* Build with DEFINES=CRC16_CONF_SLICE_BY=1 (or 4), or with
+   DEFINES=CRC16_CONF_WITH_TABLE=0, to test the other CRC16 variants. */
+#ifndef CRC16_CONF_WITH_TABLE
+#define CRC16_CONF_WITH_TABLE 1
+#endif /* CRC16_CONF_WITH_TABLE */
+#ifndef CRC16_CONF_SLICE_BY
+#define CRC16_CONF_SLICE_BY 8
+#endif /* CRC16_CONF_SLICE_BY */
+
 #endif /* !_PROJECT_CONF_H_ */
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+#include <stdio.h>
+
+#include "contiki.h"
+#include "unit-test.h"
+
+#include "lib/crc16.h"
+#include "lib/random.h"
+
+PROCESS(test_process, "crc16.c test");
+AUTOSTART_PROCESSES(&test_process);
+
+#define DATA_LEN 67
+
+static unsigned char buf[DATA_LEN + 8];
+
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+
+static unsigned short
+crc16_bytewise(const unsigned char *p, int len, unsigned short acc)
+{
+  while(len-- > 0) {
+    acc = crc16_add(*p++, acc);
+  }
+  return acc;
+}
+
+UNIT_TEST_REGISTER(test_crc16_check, "Check");
+UNIT_TEST(test_crc16_check)
+{
+  static const unsigned char check[] = "123456789";
+
+  UNIT_TEST_BEGIN();
+
+  /* The standard check value of CRC-16/KERMIT */
+  UNIT_TEST_ASSERT(crc16_bytewise(check, 9, 0) == 0x2189);
+  UNIT_TEST_ASSERT(crc16_data(check, 9, 0) == 0x2189);
+  UNIT_TEST_ASSERT(crc16_data(check, 0, 0x1234) == 0x1234);
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_crc16_data, "Data");
+UNIT_TEST(test_crc16_data)
+{
+  int offset;
+  int len;
+  unsigned short acc;
+
+  UNIT_TEST_BEGIN();
+
+  /* Every length and alignment, starting from random accumulators */
+  for(offset = 0; offset < 8; offset++) {
+    for(len = 0; len <= DATA_LEN; len++) {
+      acc = random_rand();
+      UNIT_TEST_ASSERT(crc16_data(buf + offset, len, acc) ==
+                       crc16_bytewise(buf + offset, len, acc));
+    }
+  }
+
+  UNIT_TEST_END();
+}
+
+UNIT_TEST_REGISTER(test_crc16_stream, "Stream");
+UNIT_TEST(test_crc16_stream)
+{
+  int split;
+  unsigned short acc;
+  unsigned short expected;
+
+  UNIT_TEST_BEGIN();
+
+  expected = crc16_bytewise(buf, DATA_LEN, 0);
+
+  /* Checksumming in two pieces must not depend on where the data is cut */
+  for(split = 0; split <= DATA_LEN; split++) {
+    acc = crc16_data(buf, split, 0);
+    acc = crc16_data(buf + split, DATA_LEN - split, acc);
+    UNIT_TEST_ASSERT(acc == expected);
+  }
+
+  /* Nor on mixing whole blocks with single bytes */
+  acc = crc16_data(buf, 5, 0);
+  acc = crc16_add(buf[5], acc);
+  acc = crc16_data(buf + 6, DATA_LEN - 6, acc);
+  UNIT_TEST_ASSERT(acc == expected);
+
+  UNIT_TEST_END();
+}
+
+PROCESS_THREAD(test_process, ev, data)
+{
+  unsigned i;
+
+  PROCESS_BEGIN();
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  for(i = 0; i < sizeof(buf); i++) {
+    buf[i] = random_rand();
+  }
+
+  UNIT_TEST_RUN(test_crc16_check);
+  UNIT_TEST_RUN(test_crc16_data);
+  UNIT_TEST_RUN(test_crc16_stream);
+
+  printf("=check-me= DONE\n");
+  PROCESS_END();
+}
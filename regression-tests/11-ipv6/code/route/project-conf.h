@@ -0,0 +1,7 @@
+#define UNIT_TEST_PRINT_FUNCTION test_print_report
+
+/* Build with DEFINES=UIP_CONF_DS6_ROUTE_TRIE=0 to test the linear
+   route lookup instead. */
+#ifndef UIP_CONF_DS6_ROUTE_TRIE
+#define UIP_CONF_DS6_ROUTE_TRIE 1
+#endif /* UIP_CONF_DS6_ROUTE_TRIE */
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "unit-test.h"
+
+#include "net/ip/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-ds6-route.h"
+
+PROCESS(test_process, "Route table test");
+AUTOSTART_PROCESSES(&test_process);
+
+static uip_ipaddr_t nexthop1, nexthop2;
+static uip_ipaddr_t prefix, host;
+
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_neighbor(uip_ipaddr_t *ipaddr, uint8_t id)
+{
+  uip_lladdr_t lladdr;
+
+  memset(&lladdr, id, sizeof(lladdr));
+  uip_ip6addr(ipaddr, 0xfe80, 0, 0, 0, 0, 0, 0, id);
+  uip_ds6_nbr_add(ipaddr, &lladdr, 1, NBR_REACHABLE,
+                  NBR_TABLE_REASON_IPV6_ND, NULL);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_route_longest_match, "Longest match");
+UNIT_TEST(test_route_longest_match)
+{
+  uip_ds6_route_t *r64, *r128;
+
+  UNIT_TEST_BEGIN();
+
+  r128 = uip_ds6_route_add(&host, 128, &nexthop2);
+  r64 = uip_ds6_route_add(&prefix, 64, &nexthop1);
+  UNIT_TEST_ASSERT(r64 != NULL && r128 != NULL);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&host) == r128);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&prefix) == r64);
+
+  uip_ds6_route_rm(r128);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&host) == r64);
+  uip_ds6_route_rm(r64);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&host) == NULL);
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_route_duplicate, "Duplicate prefix");
+UNIT_TEST(test_route_duplicate)
+{
+  uip_ds6_route_t *older, *newer;
+
+  UNIT_TEST_BEGIN();
+
+  /* uip_ds6_route_add() replaces the route that the destination
+     address matches best. A route to the address of the prefix hides
+     an older route to the prefix, which is given with another address
+     in it, so that a second route to the prefix is added. */
+  UNIT_TEST_ASSERT(uip_ds6_route_add(&prefix, 128, &nexthop2) != NULL);
+  older = uip_ds6_route_add(&host, 64, &nexthop1);
+  newer = uip_ds6_route_add(&prefix, 64, &nexthop1);
+  UNIT_TEST_ASSERT(older != NULL && newer != NULL && older != newer);
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == 2);
+
+  /* Either route may be used while both exist, but the other one must
+     be used once one of them is removed. */
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&host) != NULL);
+  uip_ds6_route_rm(newer);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&host) == older);
+  uip_ds6_route_rm(older);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&host) == NULL);
+
+  UNIT_TEST_ASSERT(uip_ds6_route_add(&prefix, 128, &nexthop2) != NULL);
+  older = uip_ds6_route_add(&host, 64, &nexthop1);
+  newer = uip_ds6_route_add(&prefix, 64, &nexthop1);
+  UNIT_TEST_ASSERT(older != NULL && newer != NULL && older != newer);
+  uip_ds6_route_rm(older);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&host) == newer);
+  uip_ds6_route_rm(newer);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&host) == NULL);
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  add_neighbor(&nexthop1, 1);
+  add_neighbor(&nexthop2, 2);
+  uip_ip6addr(&prefix, 0xaaaa, 0, 0, 0, 0, 0, 0, 0);
+  uip_ip6addr(&host, 0xaaaa, 0, 0, 0, 0, 0, 0, 5);
+
+  UNIT_TEST_RUN(test_route_longest_match);
+  UNIT_TEST_RUN(test_route_duplicate);
+
+  printf("=check-me= DONE\n");
+  PROCESS_END();
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2017, University of Warsaw
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * This file is part of the Contiki operating system.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "unit-test.h"
+
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "net/mac/mac.h"
+#include "heni-wrapper.h"
+
+PROCESS(test_process, "HENI reception test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* The largest 802.15.4 frame without its FCS */
+#define MAX_FRAME_LEN (127 - 2)
+#define MAX_FRAMES 8
+#define PAYLOAD_LEN 40
+/* Takes several frames of the real framer */
+#define LONG_PAYLOAD_LEN 250
+
+static uint8_t frames[MAX_FRAMES][PACKETBUF_SIZE];
+static int frame_lens[MAX_FRAMES];
+static int num_frames;
+static int num_oversized;
+static heni_iobuf_list_node_t tx_node;
+static heni_iobuf_list_t tx_list;
+static uint8_t tx_payload[LONG_PAYLOAD_LEN];
+static uint8_t rx_payload[LONG_PAYLOAD_LEN];
+static int rx_len;
+static int num_sent;
+static int num_received;
+
+static void
+test_print_report(const unit_test_t *utp)
+{
+  printf("=check-me= ");
+  if(utp->result == unit_test_failure) {
+    printf("FAILED   - %s: exit at L%u\n", utp->descr, utp->exit_line);
+  } else {
+    printf("SUCCEEDED - %s\n", utp->descr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* A MAC layer that only frames and records the frames that HENI sends */
+static void
+loopback_send(mac_callback_t sent, void *ptr)
+{
+  int len;
+
+  if(NETSTACK_FRAMER.create() < 0 || num_frames == MAX_FRAMES) {
+    mac_call_sent_callback(sent, ptr, MAC_TX_ERR_FATAL, 1);
+    return;
+  }
+  len = packetbuf_copyto(frames[num_frames]);
+  if(len == 0 || len > MAX_FRAME_LEN) {
+    ++num_oversized;
+  }
+  frame_lens[num_frames++] = len;
+  mac_call_sent_callback(sent, ptr, MAC_TX_OK, 1);
+}
+static void
+loopback_init(void)
+{
+}
+static void
+loopback_input(void)
+{
+  NETSTACK_NETWORK.input();
+}
+static int
+loopback_on(void)
+{
+  return 1;
+}
+static int
+loopback_off(int keep_radio_on)
+{
+  return 1;
+}
+static unsigned short
+loopback_channel_check_interval(void)
+{
+  return 0;
+}
+const struct mac_driver loopback_mac_driver = {
+  "loopback",
+  loopback_init,
+  loopback_send,
+  loopback_input,
+  loopback_on,
+  loopback_off,
+  loopback_channel_check_interval,
+};
+/*---------------------------------------------------------------------------*/
+static void
+test_sent(heni_packet_addr_t const *paddr, heni_iobuf_list_t *ppld,
+              heni_packet_tx_info_t const *psts)
+{
+  ++num_sent;
+}
+static int
+test_received(heni_packet_addr_t const *paddr, heni_iobuf_list_t *ppld,
+                  heni_packet_rx_info_t const *psts)
+{
+  heni_iobuf_list_fiter_t iter;
+
+  ++num_received;
+  rx_len = heniIOBufListGetCapacity(ppld);
+  if(rx_len <= sizeof(rx_payload)) {
+    heniIOBufListFIterInit(&iter, ppld);
+    heniIOBufListFIterTryCopyIntoOneBufAndAdvance(&iter, rx_payload, rx_len);
+  }
+  heniReceiveFinish(ppld);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Hands a recorded frame to HENI once the framer has parsed it */
+static void
+receive_frame(int i)
+{
+  packetbuf_clear();
+  packetbuf_copyfrom(frames[i], frame_lens[i]);
+  if(NETSTACK_FRAMER.parse() < 0) {
+    return;
+  }
+  NETSTACK_MAC.input();
+}
+/*---------------------------------------------------------------------------*/
+static int
+send_payload(int len)
+{
+  heni_packet_addr_t paddr;
+  int i;
+
+  for(i = 0; i < len; ++i) {
+    tx_payload[i] = i;
+  }
+  heniIOBufNodeInitMem(&tx_node, tx_payload, len);
+  heniIOBufListInit(&tx_list);
+  heniIOBufNodeAddBack(&tx_list, &tx_node);
+  heniPacketAddrReset(&paddr);
+  heniPacketAddrSetHopLimit(&paddr, 1);
+  heniPacketAddrSetInstanceID(&paddr, 1);
+  num_frames = 0;
+  return heniStartSending(1, &paddr, &tx_list);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_heni_rx_payload, "Payload");
+UNIT_TEST(test_heni_rx_payload)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(send_payload(PAYLOAD_LEN) == 0);
+  UNIT_TEST_ASSERT(num_sent == 1 && num_frames == 1);
+
+  receive_frame(0);
+  UNIT_TEST_ASSERT(num_received == 1);
+  UNIT_TEST_ASSERT(rx_len == PAYLOAD_LEN);
+  UNIT_TEST_ASSERT(memcmp(rx_payload, tx_payload, PAYLOAD_LEN) == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_heni_rx_queuebufs, "Queuebufs");
+UNIT_TEST(test_heni_rx_queuebufs)
+{
+  int free_before;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* Every received frame returns its queuebuf once finished */
+  free_before = queuebuf_numfree();
+  for(i = 0; i < 2 * QUEUEBUF_NUM; ++i) {
+    receive_frame(0);
+  }
+  UNIT_TEST_ASSERT(num_received == 1 + 2 * QUEUEBUF_NUM);
+  UNIT_TEST_ASSERT(queuebuf_numfree() == free_before);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(test_heni_rx_fragments, "Fragments");
+UNIT_TEST(test_heni_rx_fragments)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* Each fragment fits into a frame once the framer adds its header */
+  UNIT_TEST_ASSERT(send_payload(LONG_PAYLOAD_LEN) == 0);
+  UNIT_TEST_ASSERT(num_sent == 2 && num_frames > 1);
+  UNIT_TEST_ASSERT(num_oversized == 0);
+
+  rx_len = 0;
+  for(i = 0; i < num_frames; ++i) {
+    receive_frame(i);
+  }
+  UNIT_TEST_ASSERT(num_received == 2 + 2 * QUEUEBUF_NUM);
+  UNIT_TEST_ASSERT(rx_len == LONG_PAYLOAD_LEN);
+  UNIT_TEST_ASSERT(memcmp(rx_payload, tx_payload, LONG_PAYLOAD_LEN) == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  heniSetCallbacks(test_sent, test_received);
+
+  UNIT_TEST_RUN(test_heni_rx_payload);
+  UNIT_TEST_RUN(test_heni_rx_queuebufs);
+  UNIT_TEST_RUN(test_heni_rx_fragments);
+
+  printf("=check-me= DONE\n");
+  PROCESS_END();
+}